@@ -0,0 +1,34 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+#include <cstddef>
+
+/**
+ * @brief Process-wide count of heap allocations, for profiling copy costs
+ *
+ * Counting is opt-in. allocation_hooks.cpp replaces the global operator
+ * new / delete with malloc / free plus a relaxed atomic increment, but only
+ * when PLAYWISE_COUNT_ALLOCATIONS is defined; the test runner defines it
+ * and includes that file, while regular builds keep the default allocator
+ * and these counters stay at zero. With the hooks in, every allocation made
+ * through new (including std::string and container storage) is counted;
+ * read the counters before and after a block of work and subtract.
+ *
+ * Time Complexity: O(1) per allocation and per query
+ * Space Complexity: O(1)
+ */
+class AllocationCounter {
+public:
+    static long long allocations();  // operator new calls so far
+    static long long bytes();        // bytes requested so far
+    static bool isCounting();        // false unless the hooks are linked in
+
+    // Called by the replacement allocation functions
+    static void record(std::size_t size);
+    static bool enableCounting();
+
+    // Allocations per song for the copy, move and emplace ingestion paths
+    static void benchmarkSongIngestion(int songCount);
+};
+
+#endif // ALLOCATION_COUNTER_H
@@ -0,0 +1,116 @@
+#ifndef COMPRESSED_HISTORY_H
+#define COMPRESSED_HISTORY_H
+
+#include "history_log.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Compact long-term play history in fixed-size varint blocks
+ *
+ * Plays are stored as (time, song reference, seconds listened) with the
+ * song references of a HistoryLog dictionary rather than Song copies.
+ * Every BLOCK_EVENTS plays form a block. Inside a block the fields are
+ * stored column by column (time deltas from the previous play, song
+ * references, listened seconds), so each column decodes in its own tight
+ * loop. A column is packed as LEB128 varints, or at a fixed byte width
+ * when that costs at most an eighth more: fixed widths decode without
+ * branches, while varints win on columns whose values span several
+ * lengths. A block header keeps the first and last timestamps, the count,
+ * the column widths and the block's byte range, so a time query skips
+ * whole blocks without decoding them.
+ *
+ * Plays must be appended in time order; an earlier timestamp is raised to
+ * the previous one, as in HistoryLog.
+ *
+ * Time Complexity Analysis:
+ * - append: O(1) amortized (a block is encoded when it fills)
+ * - decode_block: O(BLOCK_EVENTS)
+ * - for_each_between: O(log b + k) for b blocks and k plays in the
+ *   touched blocks
+ *
+ * Space Complexity: about 7 bytes per play on typical traces plus 32
+ * bytes per block
+ */
+class CompressedHistory {
+public:
+    static const int BLOCK_EVENTS = 1024;
+
+    struct Event {
+        std::int64_t playedAtMillis;
+        std::uint32_t songRef;
+        std::uint32_t listenedSeconds;
+    };
+
+    struct BlockHeader {
+        std::int64_t firstMillis;
+        std::int64_t lastMillis;
+        std::uint32_t eventCount;
+        std::uint32_t byteOffset;
+        std::uint32_t byteLength;
+        std::uint8_t columnWidths[3];  // per column: 0 = varints, else bytes per value
+        std::uint8_t reserved;
+    };
+
+private:
+    std::vector<BlockHeader> blocks;
+    std::vector<std::uint8_t> bytes;
+    std::vector<Event> pending;  // the open block, encoded when full or on finish
+    std::int64_t lastMillis;
+    size_t eventCount;
+
+    // Helper methods
+    void sealBlock();
+    size_t firstBlockEndingAtOrAfter(std::int64_t millis) const;
+
+public:
+    CompressedHistory();
+
+    // Building
+    void append(std::int64_t playedAtMillis, std::uint32_t songRef, int listenedSeconds);
+    void finish();  // encodes the open block
+    void clear();
+
+    // Every live record of a log, using its song references
+    static CompressedHistory fromLog(const HistoryLog& log);
+
+    // Size
+    size_t get_event_count() const;
+    size_t get_block_count() const;   // encoded blocks
+    size_t get_encoded_bytes() const; // block data plus headers
+    const BlockHeader& get_block_header(size_t block) const;
+
+    // Decoding: out needs room for BLOCK_EVENTS events; returns the count
+    size_t decode_block(size_t block, Event* out) const;
+
+    // Visits plays with from <= playedAtMillis < to in time order, skipping
+    // blocks by their headers; includes the open block
+    template <typename Visitor>
+    void for_each_between(std::int64_t fromMillis, std::int64_t toMillis, Visitor visit) const {
+        if (!(fromMillis < toMillis)) return;
+        std::vector<Event> decoded(BLOCK_EVENTS);
+        for (size_t block = firstBlockEndingAtOrAfter(fromMillis); block < blocks.size(); block++) {
+            if (blocks[block].firstMillis >= toMillis) return;
+            size_t count = decode_block(block, decoded.data());
+            for (size_t i = 0; i < count; i++) {
+                if (decoded[i].playedAtMillis >= fromMillis && decoded[i].playedAtMillis < toMillis) {
+                    visit(decoded[i]);
+                }
+            }
+        }
+        for (const Event& event : pending) {
+            if (event.playedAtMillis >= toMillis) return;
+            if (event.playedAtMillis >= fromMillis) visit(event);
+        }
+    }
+
+    // Persistence (the open block is encoded first)
+    bool save_to_file(const std::string& filename);
+    bool load_from_file(const std::string& filename);
+
+    // Performance analysis
+    static void benchmarkCompression(int events);
+};
+
+#endif // COMPRESSED_HISTORY_H
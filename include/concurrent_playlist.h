@@ -0,0 +1,77 @@
+#ifndef CONCURRENT_PLAYLIST_H
+#define CONCURRENT_PLAYLIST_H
+
+#include "song_database.h"
+#include "persistent_playlist.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+
+/**
+ * @brief Shared playlist edited concurrently by many sessions
+ *
+ * The playlist is a pointer to an immutable PersistentPlaylist version.
+ * Readers load the pointer and iterate that snapshot for as long as they
+ * like; later edits never touch it. Writers are optimistic: an edit is
+ * computed against the version it loaded (copying only the O(log n) nodes
+ * on the edited path) and published with a compare-and-swap on the
+ * pointer. If another writer published first the edit is recomputed
+ * against the newer version, so no lock is held while an edit is built
+ * and writers to different versions never wait on each other.
+ *
+ * Every edit takes effect at its successful compare-and-swap, which makes
+ * the history linearizable: positions in an edit always refer to the
+ * version the edit replaced. commit_if_unchanged lets a session publish a
+ * multi-step change built from a snapshot only if nobody edited since.
+ *
+ * Time Complexity Analysis:
+ * - snapshot / getSize: O(1)
+ * - insert_song_at / delete_song / move_song: O(log n) expected per attempt
+ * - apply: cost of the edit per attempt; attempts grow with write contention
+ *
+ * Space Complexity: O(n) plus O(log n) per edit still referenced by a snapshot
+ */
+class ConcurrentPlaylist {
+public:
+    typedef std::shared_ptr<const PersistentPlaylist> Snapshot;
+    // Builds the next version from the current one; returns false to abort
+    typedef std::function<bool(const PersistentPlaylist&, PersistentPlaylist&)> Edit;
+
+private:
+    Snapshot current;  // only accessed through the std::atomic_* shared_ptr functions
+    std::atomic<long long> commits;
+    std::atomic<long long> retries;
+
+    // Helper methods
+    bool publish(Snapshot& expected, const PersistentPlaylist& next);
+
+public:
+    // Constructors
+    ConcurrentPlaylist();
+    explicit ConcurrentPlaylist(const PersistentPlaylist& initial);
+
+    // Non-copyable: sessions share one instance
+    ConcurrentPlaylist(const ConcurrentPlaylist&) = delete;
+    ConcurrentPlaylist& operator=(const ConcurrentPlaylist&) = delete;
+
+    // Reading
+    Snapshot snapshot() const;
+    int getSize() const;
+
+    // Editing (each returns false if the position is invalid in the current version)
+    bool apply(const Edit& edit);
+    bool commit_if_unchanged(const Snapshot& base, const PersistentPlaylist& next);
+    bool insert_song_at(int position, SongHandle song);
+    bool add_song(SongHandle song);
+    bool delete_song(int position);
+    bool move_song(int fromIndex, int toIndex);
+
+    // Statistics
+    long long get_commit_count() const;
+    long long get_retry_count() const;
+
+    // Performance analysis
+    static void benchmarkConcurrentEdits(int playlistSize, int editsPerThread);
+};
+
+#endif // CONCURRENT_PLAYLIST_H
@@ -6,11 +6,15 @@
 #include "history.h"
 #include "rating_tree.h"
 #include "song_database.h"
+#include "playlist_manager.h"
+#include "heavy_hitters.h"
 #include <vector>
 #include <string>
 #include <map>
 #include <iostream>
 
+class PlayDistincts;
+
 /**
  * @brief Dashboard class implementing a live system dashboard for PlayWise
  * 
@@ -26,7 +30,13 @@
  * - User activity statistics
  * - Memory usage analysis
  * 
- * Time Complexity: O(n) for most operations where n is the number of songs
+ * Totals, averages, rating counts and top artists/genres are read from the
+ * SongStats aggregates the database and playlist keep up to date, so
+ * refreshing them does not walk the songs.
+ * 
+ * Time Complexity: O(1) for totals and averages, O(k log k) for top-k
+ * rankings over k distinct artists or genres, O(n) for the longest-songs list
+ * where n is the number of songs
  * Space Complexity: O(n) for storing aggregated data
  */
 class Dashboard {
@@ -36,6 +46,9 @@ private:
     History* playbackHistory;
     RatingTree* ratingTree;
     SongDatabase* songDatabase;
+    PlaylistManager* playlistManager;
+    PlayTrends* playTrends;        // optional, not owned
+    PlayDistincts* playDistincts;  // optional, not owned
     
     // Dashboard data
     struct SystemStats {
@@ -82,6 +95,10 @@ public:
     std::vector<Song> getTopSongs(int count, const std::string& criteria) const;
     std::vector<std::string> getTopArtists(int count) const;
     std::vector<std::string> getTopGenres(int count) const;
+    // HyperLogLog estimates from the attached PlayDistincts (0 if none)
+    long long getDistinctSongs(PlayTrends::Window window) const;
+    long long getDistinctArtists(PlayTrends::Window window) const;
+    long long getDistinctListeners(PlayTrends::Window window) const;
     
     // Real-time monitoring
     void start_monitoring();
@@ -103,6 +120,9 @@ public:
     void setHistory(History* history);
     void setRatingTree(RatingTree* tree);
     void setSongDatabase(SongDatabase* db);
+    void setPlaylistManager(PlaylistManager* manager);
+    void setPlayTrends(PlayTrends* trends);
+    void setPlayDistincts(PlayDistincts* distincts);
     
     // Utility functions
     void clear();
@@ -0,0 +1,126 @@
+#ifndef DISTINCT_COUNTS_H
+#define DISTINCT_COUNTS_H
+
+#include "song.h"
+#include "heavy_hitters.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief HyperLogLog estimate of how many distinct keys were added
+ *
+ * 2^precision one-byte registers; a key's 64-bit hash picks a register with
+ * its top bits and stores the largest leading-zero rank seen in the rest.
+ * The estimate is the bias-corrected harmonic mean of 2^register, with
+ * linear counting while many registers are still zero. Its standard error
+ * is about 1.04 / sqrt(2^precision) however many keys are added.
+ *
+ * Two sketches of the same precision merge by a register-wise maximum,
+ * which gives the sketch of the union. Merge and estimate walk the
+ * registers in fixed blocks of 16 (a byte max; 2^-register built from float
+ * exponent bits) that the compiler vectorizes without intrinsics.
+ *
+ * Time Complexity: O(1) per add, O(2^precision) per merge / estimate
+ * Space Complexity: 2^precision bytes
+ */
+class HyperLogLog {
+private:
+    int precision;
+    std::vector<std::uint8_t> registers;
+
+public:
+    static const int MIN_PRECISION = 4;
+    static const int MAX_PRECISION = 18;
+
+    explicit HyperLogLog(int precision = 12);
+
+    void add(std::uint64_t hash);
+    void add(const std::string& key);
+    bool merge(const HyperLogLog& other);  // false if the precisions differ
+    void clear();
+
+    long long estimate() const;
+    bool is_empty() const;
+    int get_precision() const;
+    size_t get_register_count() const;
+    double get_relative_error() const;  // 1.04 / sqrt(registers)
+};
+
+/**
+ * @brief Distinct songs, artists and listeners per time window and listener
+ *
+ * The last hour, day and week use the bucket layout of PlayTrends; each
+ * bucket holds a HyperLogLog of songs, artists and listeners, and a window
+ * query merges the live buckets' sketches. HyperLogLogs cannot subtract, so
+ * buckets are merged on demand instead of being kept as a running sum.
+ * All-time sketches and one song sketch per listener (at a lower precision)
+ * are kept alongside. Memory per window is fixed by the precision whatever
+ * the number of plays; only the per-listener sketches grow, with listeners.
+ *
+ * Plays are attributed to the current listener unless one is given.
+ *
+ * Time Complexity Analysis:
+ * - record_play: O(windows) plus O(2^precision) when buckets expire
+ * - distinct_*: O(buckets * 2^precision) for a window, O(2^precision) all time
+ *
+ * Space Complexity: 3 * (64 buckets + 1) * 2^precision bytes plus
+ * 2^userPrecision bytes per listener
+ */
+class PlayDistincts : public HistoryListener {
+private:
+    struct Sketches {
+        HyperLogLog songs;
+        HyperLogLog artists;
+        HyperLogLog listeners;
+        Sketches(int precision);
+        void clear();
+    };
+
+    int precision;
+    int userPrecision;
+    std::int64_t nowMillis;
+    std::string listener;
+    TimeBucketRing<Sketches> windows[3];
+    Sketches allTime;
+    std::unordered_map<std::string, HyperLogLog> listenerSongs;
+
+    // Helper methods
+    void initWindows();
+    HyperLogLog mergedWindow(PlayTrends::Window window, HyperLogLog Sketches::*member) const;
+
+public:
+    PlayDistincts(int precision = 12, int userPrecision = 10);
+
+    // Recording
+    void set_listener(const std::string& listener);
+    const std::string& get_listener() const;
+    void record_play(const Song& song, std::int64_t playedAtMillis);
+    void record_play(const Song& song, const std::string& listener, std::int64_t playedAtMillis);
+    void advance_to(std::int64_t nowMillis);  // expire buckets without a play
+    void clear();
+
+    // Estimated distinct counts
+    long long distinct_songs(PlayTrends::Window window) const;
+    long long distinct_artists(PlayTrends::Window window) const;
+    long long distinct_listeners(PlayTrends::Window window) const;
+    long long listener_distinct_songs(const std::string& listener) const;
+    // Distinct songs across a group of listeners (their sketches merged)
+    long long listeners_distinct_songs(const std::vector<std::string>& listeners) const;
+
+    // Merged song sketch of a window, e.g. to combine with another instance
+    HyperLogLog songs_sketch(PlayTrends::Window window) const;
+
+    double get_relative_error() const;
+    size_t get_memory_bytes() const;
+
+    // Performance analysis
+    static void benchmarkDistinctCounts(int events);
+
+    // HistoryListener
+    void onPlayRecorded(const Song& song, int listenedSeconds, std::int64_t playedAtMillis) override;
+};
+
+#endif // DISTINCT_COUNTS_H
@@ -0,0 +1,145 @@
+#ifndef EDIT_JOURNAL_H
+#define EDIT_JOURNAL_H
+
+#include "song.h"
+#include "playlist.h"
+#include "history.h"
+#include "rating_tree.h"
+#include "song_database.h"
+#include "favorite_songs_queue.h"
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <vector>
+
+/**
+ * @brief One journaled change with what is needed to reverse and replay it
+ *
+ * Only the touched song and the scalar values around it are kept:
+ * - PLAYLIST_INSERT: song added at position
+ * - PLAYLIST_DELETE: song removed from position
+ * - PLAYLIST_MOVE: moved from position to toPosition
+ * - PLAYLIST_RATING: song at position rated newValue, was oldValue
+ * - PLAYLIST_REVERSE: playlist of oldValue songs reversed (its own inverse)
+ * - SONG_RATING: song (database and rating tree) rated newValue, was oldValue
+ * - HISTORY_PLAY: song pushed on the history at playedAt, newValue seconds heard
+ * - FAVORITE_UPDATE: newValue seconds and oldValue plays added; songWasNew
+ *   if the update started tracking the song
+ */
+struct JournalEntry {
+    enum class Type {
+        PLAYLIST_INSERT,
+        PLAYLIST_DELETE,
+        PLAYLIST_MOVE,
+        PLAYLIST_RATING,
+        PLAYLIST_REVERSE,
+        SONG_RATING,
+        HISTORY_PLAY,
+        FAVORITE_UPDATE
+    };
+
+    Type type;
+    int position;
+    int toPosition;
+    int oldValue;
+    int newValue;
+    bool songWasNew;
+    bool chained;  // undone and redone together with the entry before it
+    Song song;
+    History::Clock::time_point playedAt;
+};
+
+/**
+ * @brief Multi-level undo/redo across playlist, history, ratings and favorites
+ *
+ * Edits made through the journal are applied to the components it was
+ * given and recorded as JournalEntry values; undo applies the inverse of
+ * the newest entry and moves it to the redo stack, redo applies it again.
+ * A new edit clears the redo stack. Edits can be grouped (begin_group /
+ * end_group) so one undo reverses them all, e.g. a play that updates both
+ * history and favorites.
+ *
+ * Nothing is snapshotted: an entry holds one song and a few integers, and
+ * its inverse is a single call on the component (a playlist delete for an
+ * insert, History::undo_last_play for a push, and so on). Entries are
+ * costed at their size plus their song's strings; when the total passes
+ * the cap the oldest undo entries are dropped.
+ *
+ * The journal assumes it sees every change to its components. Playlist
+ * entries check that the song they recorded is still at its position, so a
+ * change made around the journal makes the inverse fail; undo then reports
+ * an error, returns false and clears the journal rather than guess.
+ *
+ * Time Complexity Analysis:
+ * - edits, undo, redo: O(1) journal work plus the one component call they
+ *   make (O(log n) for positional playlist edits through the index, O(n)
+ *   for a reverse)
+ * - eviction: O(1) amortized per edit
+ *
+ * Space Complexity: O(entries), bounded by the byte cap
+ */
+class EditJournal {
+private:
+    Playlist* playlist;
+    History* history;
+    RatingTree* ratingTree;
+    SongDatabase* database;
+    FavoriteSongsQueue* favorites;
+
+    std::deque<JournalEntry> undoStack;  // oldest first, so eviction pops the front
+    std::vector<JournalEntry> redoStack;
+    size_t maxBytes;
+    size_t usedBytes;
+    int undoSteps;  // unchained entries in undoStack
+    int redoSteps;
+    int groupDepth;
+    bool groupStarted;  // an entry was recorded in the open group
+
+    // Helper methods
+    static size_t costOf(const JournalEntry& entry);
+    void record(JournalEntry&& entry);
+    void evictToCap();
+    bool applyForward(JournalEntry& entry);
+    bool applyInverse(const JournalEntry& entry);
+    bool applyRating(const std::string& songId, int rating);
+    bool playlistHolds(int position, const Song& song) const;  // song's id is at position
+
+public:
+    EditJournal(Playlist* playlist, History* history, RatingTree* ratingTree, SongDatabase* database,
+                FavoriteSongsQueue* favorites, size_t maxBytes = 1 << 20);
+
+    // Journaled edits; each returns false, recording nothing, if it cannot apply
+    bool add_song(const Song& song);
+    bool add_song_at(const Song& song, int position);
+    bool delete_song(int index);
+    bool move_song(int fromIndex, int toIndex);
+    bool set_song_rating(int index, int rating);       // playlist copy only
+    bool reverse_playlist();
+    bool rate_song(const std::string& songId, int rating);  // database and rating tree; 0 unrates
+    bool play_song(const Song& song, int listenedSeconds = -1);  // history push
+    bool update_favorite(const Song& song, int addedSeconds, bool countPlay);  // 0 and false: just track
+
+    // Grouping: edits between the outermost begin and end undo as one
+    void begin_group();
+    void end_group();
+
+    // Undo / redo
+    bool undo();
+    bool redo();
+    bool can_undo() const;
+    bool can_redo() const;
+    int get_undo_count() const;  // undo steps (groups count once)
+    int get_redo_count() const;
+    std::string describe_undo() const;  // newest undo step, "" if none
+    std::string describe_redo() const;
+
+    // Memory
+    void clear();
+    size_t get_memory_bytes() const;
+    size_t get_max_bytes() const;
+    void set_max_bytes(size_t maxBytes);
+
+    static std::string describe(const JournalEntry& entry);
+};
+
+#endif // EDIT_JOURNAL_H
@@ -6,6 +6,7 @@
 #include <vector>
 #include <unordered_map>
 #include <string>
+#include <utility>
 
 /**
  * @brief Sorted Queue of Favorite Songs
@@ -25,8 +26,8 @@ private:
         int totalListeningTime;  // in seconds
         int playCount;
         
-        SongWithDuration(const Song& s, int duration = 0, int count = 0)
-            : song(s), totalListeningTime(duration), playCount(count) {}
+        SongWithDuration(Song s, int duration = 0, int count = 0)
+            : song(std::move(s)), totalListeningTime(duration), playCount(count) {}
         
         // Comparison operator for priority queue (max heap)
         bool operator<(const SongWithDuration& other) const {
@@ -57,6 +58,9 @@ private:
     
     // Helper function to rebuild the priority queue
     void rebuildQueue();
+    
+    // Helper function to register a new favorite in the tracking maps
+    bool trackNewSong(const Song& song);
 
 public:
     // Constructor
@@ -64,6 +68,7 @@ public:
     
     // Add a song to favorites
     void addSong(const Song& song);
+    void addSong(Song&& song);
     
     // Remove a song from favorites
     void removeSong(const Song& song);
@@ -110,6 +115,11 @@ public:
     
     // Enhanced auto-sorting features
     void autoUpdateFromPlayback(const Song& song, int playbackDuration);
+    // Many (song, seconds) plays with a single queue rebuild
+    void autoUpdateFromPlaybackBatch(const std::vector<std::pair<const Song*, int>>& plays);
+    // Takes back an earlier update of seconds and plays; removes the song if
+    // that update is what started tracking it
+    void revertUpdate(const Song& song, int seconds, int plays, bool untrack);
     void syncWithHistory(const std::vector<Song>& playedSongs);
     std::vector<Song> getFavoritesByTimeRange(int minSeconds, int maxSeconds) const;
     double getAverageListeningTime() const;
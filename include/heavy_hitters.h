@@ -0,0 +1,295 @@
+#ifndef HEAVY_HITTERS_H
+#define HEAVY_HITTERS_H
+
+#include "song.h"
+#include "history.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief A key with its estimated count and how far the estimate may be off
+ *
+ * Both summaries below only overestimate: the true count lies in
+ * [count - errorBound, count].
+ */
+struct HeavyHitter {
+    std::string key;
+    long long count;
+    long long errorBound;
+};
+
+/**
+ * @brief Space-Saving top-k summary with a fixed number of counters
+ *
+ * Counters are kept in a stream summary: a list of buckets in ascending
+ * count order, each holding the counters that share its count. A key
+ * already tracked moves to the next bucket; a new key takes a free counter
+ * or replaces a counter of the smallest bucket, inheriting its count as
+ * the error. Any key counted more than total / capacity times is
+ * guaranteed to be tracked.
+ *
+ * Time Complexity Analysis:
+ * - add: O(1) average
+ * - top: O(k), walking buckets from the largest count down
+ * - estimate: O(1) average
+ *
+ * Space Complexity: O(capacity)
+ */
+class SpaceSaving {
+private:
+    struct Counter {
+        std::string key;
+        long long count;
+        long long error;
+        int bucket;
+        int prev;  // neighbours within the bucket
+        int next;
+    };
+    struct Bucket {
+        long long count;
+        int head;  // first counter
+        int prev;  // bucket with the next smaller count
+        int next;  // bucket with the next larger count
+    };
+
+    size_t capacity;
+    long long total;
+    std::vector<Counter> counters;
+    std::vector<Bucket> buckets;
+    std::vector<int> freeBuckets;
+    std::unordered_map<std::string, int> index;
+    int minBucket;
+    int maxBucket;
+
+    // Helper methods
+    int newBucket(long long count, int prev, int next);
+    void detach(int counter);
+    void attach(int counter, int bucket);
+    void increment(int counter);
+
+public:
+    explicit SpaceSaving(size_t capacity = 256);
+
+    void add(const std::string& key);
+    void clear();
+
+    std::vector<HeavyHitter> top(int k) const;
+    HeavyHitter estimate(const std::string& key) const;  // count 0 if untracked
+    std::vector<std::string> tracked_keys() const;
+    long long get_total() const;
+    size_t get_capacity() const;
+};
+
+/**
+ * @brief Count-Min sketch of key frequencies
+ *
+ * depth rows of width counters; a key adds one to a counter per row
+ * (positions derived from one hash by double hashing) and its estimate is
+ * the smallest of those counters. With probability 1 - e^-depth the
+ * estimate exceeds the true count by at most (e / width) * total. The
+ * sketch is linear, so a sketch of a time bucket can be subtracted from a
+ * running window sketch when the bucket expires.
+ *
+ * Time Complexity: O(depth) per add / estimate, O(width * depth) per subtract
+ * Space Complexity: O(width * depth)
+ */
+class CountMinSketch {
+private:
+    int width;
+    int depth;
+    long long total;
+    std::vector<std::uint32_t> cells;
+
+    size_t cellOf(int row, std::uint64_t hash) const;
+
+public:
+    CountMinSketch(int width = 1024, int depth = 4);
+
+    void add(std::uint64_t hash);
+    long long estimate(std::uint64_t hash) const;
+    void subtract(const CountMinSketch& other);  // other must have the same shape
+    void clear();
+
+    long long get_total() const;
+    double get_epsilon() const;  // e / width
+    double get_delta() const;    // e^-depth
+    long long error_bound() const;  // ceil(epsilon * total)
+
+    static std::uint64_t hashKey(const std::string& key);
+};
+
+/**
+ * @brief Ring of fixed-length time buckets behind a sliding window
+ *
+ * The newest bucket is the current one; the window covers bucketCount
+ * buckets ending with it. advance moves the current bucket forward to the
+ * one holding a timestamp and hands every reused bucket that was in use to
+ * the caller's expire step before marking it unused, so each window built
+ * on the ring follows the same expiry rules whatever its payload.
+ *
+ * Time Complexity: O(1) per lookup, O(bucketCount) per advance at most
+ * Space Complexity: O(bucketCount) payloads
+ */
+template <typename Payload>
+class TimeBucketRing {
+public:
+    static constexpr std::int64_t NO_BUCKET = std::numeric_limits<std::int64_t>::min();
+
+private:
+    struct Bucket {
+        std::int64_t startMillis;  // NO_BUCKET while unused
+        Payload payload;
+    };
+
+    std::int64_t bucketMillis;
+    std::vector<Bucket> buckets;
+    size_t newest;
+
+public:
+    TimeBucketRing() : bucketMillis(1), newest(0) {}
+
+    TimeBucketRing(std::int64_t bucketMillis, int bucketCount, const Payload& empty)
+        : bucketMillis(std::max<std::int64_t>(1, bucketMillis)),
+          buckets(std::max(1, bucketCount), Bucket{NO_BUCKET, empty}), newest(0) {}
+
+    // expire(Payload&) is called on each reused bucket before it restarts
+    template <typename Expire>
+    void advance(std::int64_t millis, Expire expire) {
+        std::int64_t bucketStart = millis - ((millis % bucketMillis) + bucketMillis) % bucketMillis;
+        Bucket& current = buckets[newest];
+        if (current.startMillis == NO_BUCKET) {
+            current.startMillis = bucketStart;
+            return;
+        }
+        if (bucketStart <= current.startMillis) return;
+
+        // Step the ring forward, expiring the buckets it reuses
+        std::int64_t steps = std::min<std::int64_t>((bucketStart - current.startMillis) / bucketMillis,
+                                                    static_cast<std::int64_t>(buckets.size()));
+        for (std::int64_t step = 0; step < steps; step++) {
+            newest = (newest + 1) % buckets.size();
+            Bucket& reused = buckets[newest];
+            if (reused.startMillis != NO_BUCKET) expire(reused.payload);
+            reused.startMillis = NO_BUCKET;
+        }
+        buckets[newest].startMillis = bucketStart;
+    }
+
+    // The current bucket for a play, or nullptr if the play is older than the window
+    Payload* bucket_for(std::int64_t playedAtMillis) {
+        Bucket& current = buckets[newest];
+        if (current.startMillis == NO_BUCKET) return nullptr;
+        std::int64_t windowStart =
+            current.startMillis - static_cast<std::int64_t>(buckets.size() - 1) * bucketMillis;
+        return playedAtMillis < windowStart ? nullptr : &current.payload;
+    }
+
+    // visit(const Payload&) is called on each bucket in use
+    template <typename Visit>
+    void for_each_live(Visit visit) const {
+        for (const Bucket& bucket : buckets) {
+            if (bucket.startMillis != NO_BUCKET) visit(bucket.payload);
+        }
+    }
+
+    size_t bucket_count() const { return buckets.size(); }
+};
+
+/**
+ * @brief Streaming top-played songs and artists, all time and per window
+ *
+ * All-time rankings use Space-Saving. The last hour, day and week are
+ * sliding windows made of time buckets (12 x 5 minutes, 24 x 1 hour and
+ * 28 x 6 hours): each bucket has a Count-Min sketch and a Space-Saving
+ * summary, and each window keeps the sum of its buckets' sketches. When a
+ * bucket expires its sketch is subtracted and the window's ranking is
+ * rebuilt from the keys its live buckets track; between expiries each play
+ * updates the ranking in place. A window therefore covers its length plus
+ * the unfinished current bucket.
+ *
+ * Window estimates carry the Count-Min bound (e / width) * plays in the
+ * window; all-time estimates carry the Space-Saving error of their counter.
+ * Plays older than the current bucket are counted in it if they still fall
+ * inside the window, otherwise only all time.
+ *
+ * Time Complexity Analysis:
+ * - record_play: O(depth * windows + rankedKeys) amortized
+ * - top_songs / top_artists: O(k)
+ *
+ * Space Complexity: O(counters + 64 buckets * (width * depth + counters / 4))
+ * per key kind
+ */
+class PlayTrends : public HistoryListener {
+public:
+    enum Window {
+        LAST_HOUR,
+        LAST_DAY,
+        LAST_WEEK,
+        ALL_TIME
+    };
+
+private:
+    struct TimeBucket {
+        CountMinSketch sketch;
+        SpaceSaving candidates;
+        TimeBucket(int width, int depth, size_t counters);
+    };
+
+    struct SlidingWindow {
+        TimeBucketRing<TimeBucket> buckets;
+        CountMinSketch sketch;            // sum of the live buckets
+        std::vector<HeavyHitter> ranked;  // best rankedKeys keys, descending
+    };
+
+    // One key kind (songs or artists)
+    struct Tracker {
+        SpaceSaving allTime;
+        SlidingWindow windows[3];
+    };
+
+    size_t counters;
+    int sketchWidth;
+    int sketchDepth;
+    size_t rankedKeys;
+    std::int64_t nowMillis;
+    Tracker songs;
+    Tracker artists;
+
+    // Helper methods
+    void initTracker(Tracker& tracker);
+    void advanceWindow(SlidingWindow& window, std::int64_t millis);
+    void rerank(SlidingWindow& window);
+    void updateRanking(SlidingWindow& window, const std::string& key, long long estimate);
+    void recordKey(Tracker& tracker, const std::string& key, std::int64_t playedAtMillis);
+    std::vector<HeavyHitter> top(const Tracker& tracker, int k, Window window) const;
+
+public:
+    // counters: Space-Saving counters for all-time rankings (a quarter per
+    // time bucket); sketchWidth x sketchDepth: Count-Min shape per bucket
+    PlayTrends(size_t counters = 256, int sketchWidth = 512, int sketchDepth = 4, size_t rankedKeys = 32);
+
+    void record_play(const Song& song, std::int64_t playedAtMillis);
+    void advance_to(std::int64_t nowMillis);  // expire buckets without a play
+    void clear();
+
+    // Song ids / artist names, most played first (k is capped by rankedKeys for windows)
+    std::vector<HeavyHitter> top_songs(int k, Window window) const;
+    std::vector<HeavyHitter> top_artists(int k, Window window) const;
+    long long get_play_count(Window window) const;
+    size_t get_memory_bytes() const;
+
+    // Bucket layout of a sliding window (not ALL_TIME)
+    static std::int64_t bucketMillisOf(Window window);
+    static int bucketCountOf(Window window);
+    static const char* windowName(Window window);
+
+    // HistoryListener
+    void onPlayRecorded(const Song& song, int listenedSeconds, std::int64_t playedAtMillis) override;
+};
+
+#endif // HEAVY_HITTERS_H
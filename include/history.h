@@ -2,42 +2,164 @@
 #define HISTORY_H
 
 #include "song.h"
-#include <stack>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
 #include <vector>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <iostream>
 
+class HistoryView;
+class HistoryLog;
+
+/**
+ * @brief Aggregates over the plays inside a time window
+ */
+struct PlayWindowStats {
+    int plays;
+    long long listenedSeconds;
+    int distinctSongs;
+};
+
+/**
+ * @brief Observer of recorded plays, used by stream consumers such as PlayTrends
+ * 
+ * onPlayRecorded is called after a new play is stored, with the seconds
+ * listened and the wall-clock time in milliseconds the log would stamp it
+ * with. Undone and evicted plays are not reported, and neither are plays
+ * reloaded by restore_tail_from_log.
+ */
+class HistoryListener {
+public:
+    virtual ~HistoryListener() {}
+    virtual void onPlayRecorded(const Song& song, int listenedSeconds, std::int64_t playedAtMillis) = 0;
+};
+
 /**
- * @brief History class implementing a stack for playback history management
+ * @brief History class implementing a ring buffer for playback history management
+ * 
+ * This class keeps the most recently played songs, allowing users to undo
+ * their last played song and re-add it to the current playlist. Plays are
+ * stored in a fixed-capacity ring buffer: once it is full, a new play
+ * overwrites the oldest slot in place, so nothing is shifted or copied
+ * when the oldest entry is evicted. Undo still behaves like a stack (LIFO).
+ * Slots are allocated lazily up to maxSize, so a large limit costs nothing
+ * until it is used.
+ * 
+ * Every play carries a steady_clock timestamp and the seconds actually
+ * listened. Plays are kept in time order (a timestamp earlier than the
+ * newest play is raised to it), so time windows are found by binary
+ * search over the ring.
  * 
- * This class maintains a stack of recently played songs, allowing users
- * to undo their last played song and re-add it to the current playlist.
- * It uses the LIFO (Last In, First Out) principle which perfectly
- * matches the "undo" behavior.
+ * With a HistoryLog attached the buffer is the hot tail of the on-disk
+ * log: each play is appended to the log as it is recorded and undo
+ * retracts it there too.
+ * 
+ * A per-song index (play count and sequence number of the latest play) is
+ * kept in step with every push, undo and eviction. Each slot also records
+ * the sequence of the same song's previous play, so undo can restore the
+ * latest play of a song that is still in the history without a scan.
  * 
  * Time Complexity Analysis:
- * - add_played_song: O(1) - push operation
- * - undo_last_play: O(1) - pop operation
- * - get_last_played: O(1) - top operation
+ * - add_played_song / emplace_played_song: O(1) amortized, including eviction
+ * - undo_last_play / get_last_played / get_recent_song: O(1)
+ * - recent_view: O(1); iterating k entries of the view is O(k)
+ * - remove_oldest_songs: O(k) to release k songs
+ * - set_max_size: O(n) to re-pack the buffer
+ * - contains_song / get_song_play_count / get_last_played_age: O(1) average
+ * - get_most_played: O(u log k) for u distinct songs in the history
+ * - count_plays_between / plays_between: O(log n)
+ * - window_stats: O(log n + k) for k plays in the window
  * - clear_history: O(n) - clear all elements
  * 
  * Space Complexity: O(n) where n is the number of songs in history
  */
 class History {
+public:
+    typedef std::chrono::steady_clock Clock;
+
 private:
-    std::stack<Song> playbackHistory;
+    std::vector<Song> ring;  // physical slots, at most maxSize
+    size_t start;            // slot of the oldest play
+    size_t held;             // plays currently stored
     int maxSize;  // Maximum number of songs to keep in history
+    
+    // Play-count index
+    struct PlayRecord {
+        int plays;                  // plays of this song still in the history
+        std::uint64_t lastSequence; // sequence number of its latest play
+    };
+    std::unordered_map<std::string, PlayRecord> playIndex;
+    // A node that left playIndex, reused by the next new song. Node handles
+    // cannot be copied, so copies of a History start without one
+    struct SpareRecord {
+        std::unordered_map<std::string, PlayRecord>::node_type node;
+    };
+    SpareRecord spareRecord;
+    struct PlayInfo {
+        std::uint64_t previousPlay;  // sequence of the same song's prior play
+        Clock::time_point playedAt;
+        int listenedSeconds;
+        std::uint64_t logIndex;      // record in the attached log
+    };
+    std::vector<PlayInfo> slotInfo;  // parallel to ring
+    std::uint64_t nextSequence;               // sequence of the next play
+    HistoryLog* log;                          // optional on-disk log, not owned or copied
+    std::vector<HistoryListener*> listeners;  // stream consumers, not owned or copied
+    
+    // Helper methods
+    size_t nextSlot();  // slot for a new play, evicting the oldest when full
+    size_t slotOf(size_t age) const;  // age 0 is the most recent play
+    size_t playsBefore(Clock::time_point moment) const;  // binary search, oldest first
+    void indexPlay(size_t slot, Clock::time_point playedAt, int listenedSeconds);  // after a new play is stored
+    void unindexNewest(size_t slot);  // before the newest play is undone
+    void unindexOldest(size_t slot);  // before the oldest play is evicted
+    void copyPlays(const History& other);  // plays and index only; they are not in this log
 
 public:
     // Constructors
     History();
     History(int maxSize);
+    // Copies take the plays but not the log or the stream consumers
+    History(const History& other);
+    History& operator=(const History& other);
+    
+    // Core operations: played now; a negative listenedSeconds means the full song
+    void add_played_song(const Song& song, int listenedSeconds = -1);
+    void add_played_song(Song&& song, int listenedSeconds = -1);
+    
+    // Play at an explicit time, e.g. when importing a listening log
+    void record_play(const Song& song, Clock::time_point playedAt, int listenedSeconds);
+    void record_play(Song&& song, Clock::time_point playedAt, int listenedSeconds);
     
-    // Core operations
-    void add_played_song(const Song& song);
+    // Records a song built in place from Song constructor arguments, played now in full
+    template <typename... Args>
+    void emplace_played_song(Args&&... args) {
+        size_t slot = nextSlot();
+        ring[slot] = Song(std::forward<Args>(args)...);
+        indexPlay(slot, Clock::now(), ring[slot].getDuration());
+    }
     Song undo_last_play();
     Song get_last_played() const;
     
+    // Random access: k = 0 is the most recent play (nullptr if out of range)
+    const Song* get_recent_song(int k) const;
+    
+    // Up to count most recent plays, newest first, without copying
+    HistoryView recent_view(int count) const;
+    
+    // When the k-th most recent play happened and how long it was listened to
+    Clock::time_point get_play_time(int k) const;
+    int get_listened_seconds(int k) const;
+    
+    // Time windows are half-open: from <= playedAt < to
+    int count_plays_between(Clock::time_point from, Clock::time_point to) const;
+    HistoryView plays_between(Clock::time_point from, Clock::time_point to) const;  // newest first
+    PlayWindowStats window_stats(Clock::time_point from, Clock::time_point to) const;
+    
     // Utility operations
     void clear_history();
     int get_size() const;
@@ -45,6 +167,18 @@ public:
     int get_max_size() const;
     void set_max_size(int maxSize);
     
+    // On-disk log: plays recorded from now on are appended to log (nullptr detaches)
+    void attach_log(HistoryLog* log);
+    HistoryLog* get_log() const;
+    // Replaces the in-memory history with the log's newest plays whose songs
+    // the log can still resolve; returns how many were loaded
+    int restore_tail_from_log();
+    
+    // Stream consumers: plays recorded from now on are reported to each
+    // listener. Undone plays stay reported.
+    void add_listener(HistoryListener* listener);
+    void remove_listener(HistoryListener* listener);
+    
     // Display operations
     void display_history() const;
     void display_recent_songs(int count) const;
@@ -54,9 +188,63 @@ public:
     bool contains_song(const std::string& songId) const;
     int get_song_play_count(const std::string& songId) const;
     
+    // Age of the song's latest play (0 = most recent), or -1 if not in history
+    int get_last_played_age(const std::string& songId) const;
+    
+    // Up to count (song id, play count) pairs, most played first; ties go
+    // to the more recently played song
+    std::vector<std::pair<std::string, int>> get_most_played(int count) const;
+    
     // Advanced features
     std::vector<Song> get_recent_songs(int count) const;
     void export_history_to_file(const std::string& filename) const;
 };
 
+/**
+ * @brief Read-only range over the most recent plays, newest first
+ * 
+ * Reads straight from the History's ring buffer; any change to the
+ * history invalidates the view. A view may start at an older play
+ * (firstAge > 0), as time-window views do.
+ */
+class HistoryView {
+private:
+    const History* history;
+    int firstAge;
+    int length;
+
+public:
+    class const_iterator {
+    private:
+        const History* history;
+        int age;
+    
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Song value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const Song* pointer;
+        typedef const Song& reference;
+        
+        const_iterator(const History* history, int age) : history(history), age(age) {}
+        const Song& operator*() const { return *history->get_recent_song(age); }
+        const Song* operator->() const { return history->get_recent_song(age); }
+        const_iterator& operator++() { age++; return *this; }
+        const_iterator operator++(int) { const_iterator previous = *this; age++; return previous; }
+        bool operator==(const const_iterator& other) const { return age == other.age; }
+        bool operator!=(const const_iterator& other) const { return age != other.age; }
+    };
+    
+    HistoryView(const History* history, int length) : history(history), firstAge(0), length(length) {}
+    HistoryView(const History* history, int firstAge, int length)
+        : history(history), firstAge(firstAge), length(length) {}
+    
+    const_iterator begin() const { return const_iterator(history, firstAge); }
+    const_iterator end() const { return const_iterator(history, firstAge + length); }
+    int size() const { return length; }
+    bool empty() const { return length == 0; }
+    const Song& operator[](int index) const { return *history->get_recent_song(firstAge + index); }
+    int age(int index) const { return firstAge + index; }  // for get_play_time and friends
+};
+
 #endif // HISTORY_H 
\ No newline at end of file
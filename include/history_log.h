@@ -0,0 +1,128 @@
+#ifndef HISTORY_LOG_H
+#define HISTORY_LOG_H
+
+#include "history.h"
+#include "song_database.h"
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Append-only, segmented on-disk log of every play
+ *
+ * The log lives in a directory: a song dictionary (songs.dict, one id per
+ * line, its line number is the song's reference) and numbered segment
+ * files (segment-000000.log, ...). A segment is a small header followed by
+ * fixed-size 16-byte records, so record i of the log sits at a computable
+ * offset. Records hold the wall-clock time in milliseconds, the song
+ * reference, the seconds listened and a flags word; songs are resolved
+ * back through the SongDatabase by id.
+ *
+ * Appends go to an in-memory buffer that is written out when it fills, on
+ * flush and on destruction; a segment is closed once it holds
+ * recordsPerSegment records. Timestamps never go backwards, so every
+ * segment is sorted by time. Reads memory-map whole segments (a plain read
+ * into a buffer on Windows), binary-search them for a time window and scan
+ * segments on separate threads. Records are never removed: retract marks a
+ * record (an undone play) so readers skip it.
+ *
+ * A History attached to the log is its hot tail: every play it records is
+ * appended here, undo retracts it, and restore_tail_from_log reloads the
+ * newest plays on startup.
+ *
+ * Time Complexity Analysis:
+ * - append / retract: O(1) amortized (plus a write every bufferCapacity appends)
+ * - window_stats: O(s log r + k / t) for s segments of r records, k
+ *   records in the window and t threads
+ * - recent_plays: O(k) for the k newest records
+ *
+ * Space Complexity: O(d + b) in memory for d dictionary ids and b buffered
+ * records; 16 bytes per play on disk
+ */
+class HistoryLog {
+public:
+    // Bit in LogRecord::flags
+    static const std::uint16_t RETRACTED = 1;
+    // Index returned when a record could not be appended
+    static const std::uint64_t NO_RECORD = ~static_cast<std::uint64_t>(0);
+
+    struct LogRecord {
+        std::int64_t playedAtMillis;    // system_clock milliseconds since the epoch
+        std::uint32_t songRef;          // line in songs.dict
+        std::uint16_t listenedSeconds;  // clamped to 65535
+        std::uint16_t flags;
+    };
+
+    // A record with its song id spelled out
+    struct LoggedPlay {
+        std::uint64_t index;  // position in the whole log
+        std::string songId;
+        std::int64_t playedAtMillis;
+        int listenedSeconds;
+    };
+
+private:
+    std::string directory;
+    SongDatabase* database;
+    int recordsPerSegment;
+    size_t bufferCapacity;
+
+    std::vector<std::string> songIds;                     // reference -> id
+    std::unordered_map<std::string, std::uint32_t> songRefs;  // id -> reference
+    size_t savedSongIds;                                  // dictionary lines on disk
+
+    std::vector<LogRecord> buffer;  // appended but not yet written
+    std::uint64_t savedRecords;     // records on disk, all segments
+    std::int64_t lastMillis;        // newest timestamp, keeps segments sorted
+    std::ofstream segmentOut;       // segment currently being filled
+    std::uint64_t openSegment;      // number of segmentOut's segment, NO_RECORD if none
+    bool healthy;
+
+    // Helper methods
+    std::string segmentPath(std::uint64_t segment) const;
+    std::string dictionaryPath() const;
+    void openExisting();
+    bool openSegmentForAppend(std::uint64_t segment);
+    std::uint32_t songRefFor(const std::string& songId);
+    std::uint64_t segmentCount() const;  // segments holding saved records
+
+public:
+    // Opens (creating if needed) the log in directory
+    HistoryLog(const std::string& directory, SongDatabase* database,
+               int recordsPerSegment = 1 << 20, size_t bufferCapacity = 4096);
+    ~HistoryLog();
+
+    HistoryLog(const HistoryLog&) = delete;
+    HistoryLog& operator=(const HistoryLog&) = delete;
+
+    // Writing
+    std::uint64_t append(const std::string& songId, std::int64_t playedAtMillis, int listenedSeconds);
+    bool retract(std::uint64_t index);
+    bool flush();
+
+    // Reading
+    bool is_open() const;
+    std::uint64_t get_record_count() const;
+    std::uint64_t get_segment_count() const;
+    const std::string& get_song_id(std::uint32_t songRef) const;
+    Song* find_song(const std::string& songId) const;  // through the SongDatabase
+
+    // Live records with from <= playedAtMillis < to; segments scanned on up
+    // to threadCount threads (0 = hardware concurrency)
+    PlayWindowStats window_stats(std::int64_t fromMillis, std::int64_t toMillis, int threadCount = 0) const;
+    void for_each_between(std::int64_t fromMillis, std::int64_t toMillis,
+                          const std::function<void(std::uint64_t, const LogRecord&)>& visit) const;
+
+    // Up to count newest live plays, oldest first
+    std::vector<LoggedPlay> recent_plays(int count) const;
+
+    static std::int64_t now_millis();
+
+    // Performance analysis
+    static void benchmarkHistoryLog(int plays);
+};
+
+#endif // HISTORY_LOG_H
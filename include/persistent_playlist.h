@@ -0,0 +1,131 @@
+#ifndef PERSISTENT_PLAYLIST_H
+#define PERSISTENT_PLAYLIST_H
+
+#include "song.h"
+#include "playlist.h"
+#include "song_database.h"
+#include <memory>
+#include <vector>
+#include <string>
+#include <functional>
+
+/**
+ * @brief Immutable playlist stored as a persistent implicit treap
+ * 
+ * Every edit returns a new PersistentPlaylist and leaves the original
+ * untouched. Only the O(log n) nodes on the edited path are copied; the rest
+ * of the tree is shared with the previous version, so keeping many versions
+ * costs memory proportional to the number of edits rather than to the
+ * playlist length. Entries are SongHandles resolved through a SongDatabase.
+ * 
+ * The treap stores no priorities: merges pick the root at random in
+ * proportion to subtree sizes, which keeps the expected depth O(log n) even
+ * though subtrees are shared between versions. Nodes are immutable once
+ * built, so any version can be read from any thread.
+ * 
+ * Time Complexity Analysis:
+ * - insert_song_at / delete_song / move_song / set_song_at: O(log n) expected
+ * - get_song_at: O(log n) expected
+ * - from_handles / to_handles: O(n)
+ * - copy / assignment: O(1)
+ * 
+ * Space Complexity: O(n) for the first version, O(log n) per edit after that
+ */
+class PersistentPlaylist {
+public:
+    struct Node {
+        SongHandle song;
+        int size;
+        std::shared_ptr<const Node> left;
+        std::shared_ptr<const Node> right;
+
+        Node(SongHandle song, std::shared_ptr<const Node> left, std::shared_ptr<const Node> right);
+    };
+    typedef std::shared_ptr<const Node> NodePtr;
+
+private:
+    NodePtr root;
+
+    explicit PersistentPlaylist(NodePtr root);
+
+    // Path-copying treap primitives
+    static int sizeOf(const NodePtr& node);
+    static NodePtr withChildren(const NodePtr& node, NodePtr left, NodePtr right);
+    static void split(const NodePtr& node, int count, NodePtr& left, NodePtr& right);
+    static NodePtr merge(const NodePtr& left, const NodePtr& right);
+    static NodePtr buildBalanced(const std::vector<SongHandle>& songs, int low, int high);
+    static bool chooseLeftRoot(int leftSize, int rightSize);
+
+public:
+    // Constructors
+    PersistentPlaylist();
+    static PersistentPlaylist from_handles(const std::vector<SongHandle>& songs);
+    static PersistentPlaylist from_playlist(const Playlist& playlist, const SongDatabase& db);
+
+    // Edits (each returns a new version; invalid positions return *this)
+    PersistentPlaylist insert_song_at(int position, SongHandle song) const;
+    PersistentPlaylist add_song(SongHandle song) const;
+    PersistentPlaylist delete_song(int position) const;
+    PersistentPlaylist move_song(int fromIndex, int toIndex) const;
+    PersistentPlaylist set_song_at(int position, SongHandle song) const;
+
+    // Queries
+    SongHandle get_song_at(int position) const;
+    int getSize() const;
+    bool isEmpty() const;
+    std::vector<SongHandle> to_handles() const;
+    void for_each(const std::function<void(SongHandle)>& visit) const;
+    Playlist to_playlist(const SongDatabase& db, const std::string& name) const;
+
+    // Structural sharing helpers
+    const Node* getRoot() const;
+    bool shares_root_with(const PersistentPlaylist& other) const;
+};
+
+/**
+ * @brief Version history of an editorial playlist
+ * 
+ * Stores every committed PersistentPlaylist. Because versions share
+ * structure, hundreds of versions cost little more than the edits that
+ * produced them. Rolling back only selects an earlier version; later edits
+ * branch from it and are appended, so no version is ever lost.
+ * 
+ * Time Complexity Analysis:
+ * - insert_song_at / delete_song / move_song: O(log n) expected
+ * - rollback / get_version: O(1)
+ * - count_unique_nodes: O(total distinct nodes)
+ * 
+ * Space Complexity: O(n + e log n) where e is the number of edits
+ */
+class PlaylistVersionHistory {
+private:
+    std::vector<PersistentPlaylist> versions;
+    std::vector<std::string> labels;
+    int currentVersion;
+
+    bool commitEdit(const PersistentPlaylist& next, bool valid, const std::string& label);
+
+public:
+    PlaylistVersionHistory();
+    explicit PlaylistVersionHistory(const PersistentPlaylist& initial);
+
+    // Editing (creates a new version from the current one)
+    int commit(const PersistentPlaylist& version, const std::string& label = "");
+    bool insert_song_at(int position, SongHandle song);
+    bool delete_song(int position);
+    bool move_song(int fromIndex, int toIndex);
+
+    // Version selection
+    bool rollback(int version);
+    const PersistentPlaylist& get_current() const;
+    const PersistentPlaylist& get_version(int version) const;
+    std::string get_label(int version) const;
+    int get_current_version() const;
+    int get_version_count() const;
+
+    // Memory analysis
+    size_t count_unique_nodes() const;
+    size_t estimate_memory() const;
+};
+
+#endif // PERSISTENT_PLAYLIST_H
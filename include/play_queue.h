@@ -0,0 +1,115 @@
+#ifndef PLAY_QUEUE_H
+#define PLAY_QUEUE_H
+
+#include "song.h"
+#include "playlist.h"
+#include "history.h"
+#include "favorite_songs_queue.h"
+#include <vector>
+#include <deque>
+#include <random>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @brief Play queue with a stable cursor over a Playlist
+ *
+ * The cursor is a pointer to the current PlaylistNode rather than an index,
+ * so stepping forward or back follows the list links and edits elsewhere in
+ * the playlist never shift it. The queue registers itself as a
+ * PlaylistListener: if the current song is deleted the cursor moves to the
+ * song that followed it, which becomes the next song played.
+ *
+ * Shuffle mode deals each cycle as a vector of nodes, drawn with the same
+ * Fisher-Yates steps as Playlist::shuffle, with a node -> slot map so a
+ * deleted song leaves the undrawn part in O(1). Edits elsewhere therefore
+ * never make a song repeat or get skipped within a cycle; songs added during
+ * a cycle join the next one. previous() steps back through at most
+ * SHUFFLE_BACK_LIMIT songs.
+ *
+ * Every song the cursor arrives on is recorded in the attached History and
+ * FavoriteSongsQueue (either may be null).
+ *
+ * Time Complexity Analysis:
+ * - next / previous / current: O(1) in order; O(1) expected in shuffle
+ *   mode plus O(n) to deal each cycle
+ * - play_next: O(log n) expected (the playlist's position index is updated)
+ * - jump_to: O(log n) expected
+ * - song deleted from the playlist: O(1) expected
+ * - recording a play: O(1) for History plus the favorites update
+ *
+ * Space Complexity: O(1) in order, O(n) in shuffle mode
+ */
+class PlayQueue : public PlaylistListener {
+public:
+    enum class RepeatMode {
+        OFF,
+        ONE,
+        ALL
+    };
+
+    static const size_t SHUFFLE_BACK_LIMIT = 100;
+
+private:
+    Playlist* playlist;
+    PlaylistNode* cursor;
+    bool cursorPending;  // cursor moved onto a song that has not been played yet
+    RepeatMode repeatMode;
+    bool shuffleEnabled;
+    unsigned int shuffleSeed;
+    std::mt19937 shuffleRng;
+    bool shuffleDealt;                       // a cycle is in progress
+    std::vector<PlaylistNode*> shuffleOrder;  // the cycle; slots from shuffleStep are undrawn
+    size_t shuffleStep;
+    std::unordered_map<PlaylistNode*, size_t> shuffleSlots;  // undrawn node -> slot
+    std::deque<PlaylistNode*> shuffleBack;   // latest songs played in shuffle mode, for previous()
+    std::deque<PlaylistNode*> upNext;        // play_next requests while shuffling
+    History* history;
+    FavoriteSongsQueue* favorites;
+
+    // Helper methods
+    const Song* arrive(PlaylistNode* node);
+    PlaylistNode* nextShuffled();
+    void dealShuffle(PlaylistNode* skip);
+    void dropShuffled(PlaylistNode* node);  // takes an undrawn song out of the cycle
+    void discardShuffle();
+    void pushShuffleBack(PlaylistNode* node);
+
+public:
+    // Constructors and Destructor
+    PlayQueue(Playlist* playlist, History* history = nullptr, FavoriteSongsQueue* favorites = nullptr);
+    ~PlayQueue();
+
+    // Non-copyable: registered with the playlist by address
+    PlayQueue(const PlayQueue&) = delete;
+    PlayQueue& operator=(const PlayQueue&) = delete;
+
+    // Playback control (each returns the song now playing, nullptr when stopped)
+    const Song* start();
+    const Song* next();
+    const Song* previous();
+    const Song* jump_to(int index);
+    void stop();
+
+    // Queue editing
+    bool play_next(const Song& song);
+
+    // Modes
+    void setRepeatMode(RepeatMode mode);
+    RepeatMode getRepeatMode() const;
+    void setShuffle(bool enabled, unsigned int seed = 0);
+    bool isShuffleEnabled() const;
+    static std::string getRepeatModeName(RepeatMode mode);
+
+    // State
+    const Song* current() const;
+    bool isPlaying() const;
+    Playlist* getPlaylist() const;
+
+    // PlaylistListener
+    void onNodeRemoving(PlaylistNode* node, PlaylistNode* successor) override;
+    void onPlaylistCleared() override;
+    void onPlaylistDestroyed() override;
+};
+
+#endif // PLAY_QUEUE_H
@@ -0,0 +1,210 @@
+#ifndef PLAYBACK_INGEST_H
+#define PLAYBACK_INGEST_H
+
+#include "favorite_songs_queue.h"
+#include "history.h"
+#include "song_database.h"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Bounded lock-free ring for many producers and one consumer
+ *
+ * Each cell carries a sequence number telling whether it is ready to be
+ * written (sequence == position) or read (sequence == position + 1). A
+ * producer claims a position with a compare-and-swap on enqueuePos, writes
+ * the value and publishes it by storing the next sequence; no producer
+ * ever waits for another. The pop side also claims positions with a
+ * compare-and-swap, so a producer may discard the oldest event while the
+ * consumer is reading. Capacity is rounded up to a power of two.
+ *
+ * Time Complexity: O(1) per push / pop attempt, lock-free
+ * Space Complexity: O(capacity)
+ */
+template <typename T>
+class MpscRing {
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+    alignas(64) std::atomic<size_t> enqueuePos;
+    alignas(64) std::atomic<size_t> dequeuePos;
+
+public:
+    explicit MpscRing(size_t capacity) : enqueuePos(0), dequeuePos(0) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        cells.reset(new Cell[size]);
+        for (size_t i = 0; i < size; i++) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        mask = size - 1;
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+
+    // Moves value in and returns true, or leaves it untouched if the ring is full
+    bool try_push(T&& value) {
+        size_t position = enqueuePos.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[position & mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+            if (difference == 0) {
+                if (enqueuePos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    cell.value = std::move(value);
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false;  // full: the cell still holds an unread value
+            } else {
+                position = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool try_pop(T& value) {
+        size_t position = dequeuePos.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[position & mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t difference =
+                static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1);
+            if (difference == 0) {
+                if (dequeuePos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    value = std::move(cell.value);
+                    cell.sequence.store(position + mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false;  // empty
+            } else {
+                position = dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    size_t capacity() const { return mask + 1; }
+
+    // Snapshot of the occupancy; exact only when no one else is pushing or popping
+    size_t size_approx() const {
+        size_t tail = enqueuePos.load(std::memory_order_relaxed);
+        size_t head = dequeuePos.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+};
+
+/**
+ * @brief A play reported by a session thread
+ */
+struct PlaybackEvent {
+    std::string songId;
+    int listenedSeconds;
+    History::Clock::time_point playedAt;
+};
+
+/**
+ * @brief What publish does when the ring is full
+ *
+ * BLOCK waits (yielding) for the consumer to make room; with no consumer
+ * thread running it drops instead of waiting forever. DROP_OLDEST
+ * discards the oldest queued event to make room for the new one. SAMPLE
+ * thins the stream once the ring is more than half full: the ingest then
+ * admits one event in sampleRate across all its producers, and drops the
+ * event if the ring is still full.
+ */
+enum class BackpressurePolicy {
+    BLOCK,
+    DROP_OLDEST,
+    SAMPLE
+};
+
+/**
+ * @brief Multi-producer ingestion of play events into History and favorites
+ *
+ * Any number of threads publish events into an MpscRing. One consumer
+ * (a background thread started with start(), or whoever calls drain())
+ * pops them in batches, resolves the song ids through the SongDatabase
+ * and applies the batch: each play is recorded in History and the whole
+ * batch updates FavoriteSongsQueue with one queue rebuild. History and
+ * favorites are not thread-safe, so while the consumer thread runs it is
+ * their only user; read them after stop(). The database is only read.
+ *
+ * Time Complexity Analysis:
+ * - publish: O(1) lock-free, plus the wait under BLOCK
+ * - drain: O(k) for k events plus one favorites rebuild per batch
+ *
+ * Space Complexity: O(capacity + batchSize)
+ */
+class PlaybackIngest {
+private:
+    MpscRing<PlaybackEvent> ring;
+    BackpressurePolicy policy;
+    int sampleRate;
+    size_t batchSize;
+
+    SongDatabase* database;
+    History* history;
+    FavoriteSongsQueue* favorites;
+
+    std::atomic<long long> published;   // accepted into the ring
+    std::atomic<long long> dropped;     // rejected or discarded under backpressure
+    std::atomic<long long> applied;     // recorded in history and favorites
+    std::atomic<long long> unresolved;  // ids the database does not know
+    std::atomic<unsigned int> pressured;  // events offered to SAMPLE while over half full
+
+    std::atomic<bool> running;
+    std::thread consumer;
+
+    // Consumer-side scratch, reused across batches
+    std::vector<PlaybackEvent> batch;
+    std::vector<std::pair<const Song*, int>> favoriteBatch;
+
+    // Helper methods
+    void applyBatch();
+    void consumeLoop();
+
+public:
+    PlaybackIngest(SongDatabase* database, History* history, FavoriteSongsQueue* favorites,
+                   size_t capacity = 4096, BackpressurePolicy policy = BackpressurePolicy::BLOCK,
+                   int sampleRate = 4, size_t batchSize = 256);
+    ~PlaybackIngest();
+
+    PlaybackIngest(const PlaybackIngest&) = delete;
+    PlaybackIngest& operator=(const PlaybackIngest&) = delete;
+
+    // Producer side, safe from any thread; false if the event was dropped
+    bool publish(const std::string& songId, int listenedSeconds);
+    bool publish(PlaybackEvent&& event);
+
+    // Consumer side: applies up to maxEvents queued events on this thread
+    int drain(int maxEvents);
+    void start();  // background consumer thread
+    void stop();   // stops the thread after the ring is empty
+    bool is_running() const;
+
+    // Statistics
+    long long get_published_count() const;
+    long long get_dropped_count() const;
+    long long get_applied_count() const;
+    long long get_unresolved_count() const;
+    size_t get_capacity() const;
+    BackpressurePolicy get_policy() const;
+    static const char* policyName(BackpressurePolicy policy);
+
+    // Performance analysis
+    static void benchmarkIngestion(int eventsPerRun);
+};
+
+#endif // PLAYBACK_INGEST_H
@@ -2,8 +2,16 @@
 #define PLAYLIST_H
 
 #include "song.h"
+#include "playlist_edit.h"
+#include "playlist_index.h"
+#include "song_stats.h"
+#include "sorting.h"
 #include <string>
 #include <iostream>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 /**
  * @brief Node structure for doubly linked list implementation
@@ -12,8 +20,30 @@ struct PlaylistNode {
     Song song;
     PlaylistNode* prev;
     PlaylistNode* next;
+    PlaylistIndexLinks links;  // maintained by the owning playlist's PlaylistIndex
     
     PlaylistNode(const Song& song) : song(song), prev(nullptr), next(nullptr) {}
+    PlaylistNode(Song&& song) : song(std::move(song)), prev(nullptr), next(nullptr) {}
+    
+    // Constructs the song in place from Song constructor arguments
+    template <typename... Args>
+    explicit PlaylistNode(std::in_place_t, Args&&... args)
+        : song(std::forward<Args>(args)...), prev(nullptr), next(nullptr) {}
+};
+
+/**
+ * @brief Observer of node removals, used by cursors such as PlayQueue
+ * 
+ * onNodeRemoving is called before a node is freed, with the node that now
+ * follows it in the playlist (nullptr at the end). Moves, sorts, shuffles
+ * and reverses keep every node alive, so they are not reported.
+ */
+class PlaylistListener {
+public:
+    virtual ~PlaylistListener() {}
+    virtual void onNodeRemoving(PlaylistNode* node, PlaylistNode* successor) = 0;
+    virtual void onPlaylistCleared() = 0;
+    virtual void onPlaylistDestroyed() = 0;
 };
 
 /**
@@ -21,28 +51,55 @@ struct PlaylistNode {
  * 
  * This class provides all the core playlist operations including adding,
  * deleting, moving, and reversing songs. It uses a doubly linked list
- * for efficient insertion and deletion operations.
+ * for efficient insertion and deletion operations. A PlaylistIndex threaded
+ * through the same nodes keeps positions and cumulative durations, so
+ * positional lookups and time-offset queries do not walk the list.
+ * SongStats aggregates (rating histogram, genre and artist counts) are
+ * updated by every mutation; edits made through the Song pointers returned
+ * by the search functions bypass them, so use set_song_rating and
+ * set_song_duration instead.
  * 
  * Time Complexity Analysis:
- * - add_song: O(1) at end, O(n) at specific position
- * - delete_song: O(n) to find, O(1) to delete
- * - move_song: O(n) to find both positions, O(1) to move
+ * - add_song / add_song_at: O(log n) expected
+ * - delete_song: O(log n) expected
+ * - move_song: O(log n) expected
+ * - get_song_at: O(log n) expected
+ * - get_total_duration / get_stats: O(1)
+ * - find_index_at_offset / get_offset_of / count_songs_within: O(log n) expected
+ * - apply_edits: O(k log n) expected for k edits, plus O(k log k) when the
+ *   move count is asked for
  * - reverse_playlist: O(n)
+ * - sort: O(n log n) comparisons, O(log n) extra space, no Song copies
  * - display: O(n)
  * 
  * Space Complexity: O(n) where n is the number of songs
  */
 class Playlist {
+    friend class ShuffleIterator;
+    friend class SmartPlaylist;
+    friend class PlayQueue;
+
 private:
     PlaylistNode* head;
     PlaylistNode* tail;
     std::string name;
     int size;
+    PlaylistIndex durationIndex;
+    SongStats stats;
+    std::vector<PlaylistListener*> listeners;  // not copied with the playlist
     
     // Helper methods
     PlaylistNode* getNodeAt(int index) const;
     void insertNode(PlaylistNode* newNode, PlaylistNode* afterNode);
+    void unlinkNode(PlaylistNode* node);
+    void spliceBefore(PlaylistNode* node, PlaylistNode* successor);  // list links only
+    void spliceOut(PlaylistNode* node);                              // list links only
     void removeNode(PlaylistNode* node);
+    void relinkNodes(const std::vector<PlaylistNode*>& nodes);
+    void notifyRemoving(PlaylistNode* node, PlaylistNode* successor);
+    void displaySummary() const;
+    static PlaylistNode* mergeRuns(PlaylistNode* left, PlaylistNode* right,
+                                   const std::function<bool(const Song&, const Song&)>& compare);
 
 public:
     // Constructors and Destructor
@@ -57,7 +114,15 @@ public:
     // Core playlist operations
     void add_song(const std::string& title, const std::string& artist, int duration);
     void add_song(const Song& song);
+    void add_song(Song&& song);
     void add_song_at(const Song& song, int position);
+    void add_song_at(Song&& song, int position);
+    
+    // Appends a song built in place from Song constructor arguments
+    template <typename... Args>
+    void emplace_song(Args&&... args) {
+        insertNode(new PlaylistNode(std::in_place, std::forward<Args>(args)...), tail);
+    }
     
     bool delete_song(int index);
     bool delete_song_by_id(const std::string& songId);
@@ -65,6 +130,11 @@ public:
     bool move_song(int from_index, int to_index);
     void reverse_playlist();
     
+    // Batch editing: validates every edit first, then applies all or nothing.
+    // Edits go to the index by position with no node lookups, and moves skip
+    // the song aggregates. countMoves also fills in the result's move count
+    PlaylistEditResult apply_edits(const std::vector<PlaylistEdit>& edits, bool countMoves = false);
+    
     // Utility operations
     void display() const;
     void display_reverse() const;
@@ -81,11 +151,69 @@ public:
     // Playlist management
     void clear();
     void shuffle();
+    void shuffle(unsigned int seed);
+    void sort(Sorting::SortCriteria criteria);  // stable, relinks nodes in place
     Song* get_song_at(int index);
     
+    // Time-offset queries (seconds from the start of the playlist)
+    long long get_total_duration() const;
+    int find_index_at_offset(long long seconds) const;   // -1 past the end
+    long long get_offset_of(int index) const;            // -1 for invalid index
+    int count_songs_within(long long seconds) const;     // songs that finish by the mark
+    bool set_song_duration(int index, int duration);
+    
+    // Running aggregates
+    const SongStats& get_stats() const;
+    bool set_song_rating(int index, int rating);  // 0 clears the rating
+    
     // Iterator-like functionality
     PlaylistNode* getHead() const;
     PlaylistNode* getTail() const;
+    
+    // Cursor support
+    void add_listener(PlaylistListener* listener);
+    void remove_listener(PlaylistListener* listener);
+};
+
+/**
+ * @brief Lazy shuffle-play order over a playlist
+ * 
+ * Produces a seeded random permutation of playlist positions one step at a
+ * time using an incremental Fisher-Yates shuffle. Only positions that have
+ * been displaced by a swap are remembered, so nothing is copied up front and
+ * starting playback does not depend on the playlist length. The same seed
+ * always yields the same order, which matches Playlist::shuffle(seed).
+ * 
+ * Time Complexity Analysis:
+ * - construction: O(1)
+ * - nextIndex: O(1) expected
+ * - nextSong: O(1) expected plus the position lookup in the playlist
+ * 
+ * Space Complexity: O(k) where k is the number of steps taken
+ */
+class ShuffleIterator {
+private:
+    const Playlist* playlist;
+    int total;
+    int step;
+    unsigned int seed;
+    std::mt19937 rng;
+    std::unordered_map<int, int> displaced;  // position -> value swapped into it
+    
+    int valueAt(int position) const;
+
+public:
+    ShuffleIterator(const Playlist& playlist, unsigned int seed);
+    
+    bool hasNext() const;
+    int nextIndex();          // -1 once every position has been produced
+    const Song* nextSong();   // nullptr once exhausted
+    int getStep() const;
+    unsigned int getSeed() const;
+    void reset();
+    
+    // Uniform value in [0, bound) drawn the same way on every platform
+    static int boundedRandom(std::mt19937& rng, int bound);
 };
 
 #endif // PLAYLIST_H 
\ No newline at end of file
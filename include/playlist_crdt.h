@@ -0,0 +1,178 @@
+#ifndef PLAYLIST_CRDT_H
+#define PLAYLIST_CRDT_H
+
+#include "song.h"
+#include "playlist.h"
+#include "song_database.h"
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <string>
+#include <vector>
+
+typedef std::uint32_t CrdtReplicaId;
+
+/**
+ * @brief Globally unique element identifier: Lamport counter, then replica
+ *
+ * Counters grow along every causal chain, so an element's id is larger
+ * than the id of anything its creator had already seen.
+ */
+struct CrdtElementId {
+    std::uint64_t counter;
+    CrdtReplicaId replica;
+
+    CrdtElementId() : counter(0), replica(0) {}
+    CrdtElementId(std::uint64_t counter, CrdtReplicaId replica) : counter(counter), replica(replica) {}
+
+    bool operator==(const CrdtElementId& other) const;
+    bool operator!=(const CrdtElementId& other) const;
+    bool operator<(const CrdtElementId& other) const;
+};
+
+struct CrdtElementIdHash {
+    size_t operator()(const CrdtElementId& id) const;
+};
+
+// Anchor for inserting at the front; returned as "no element" by lookups
+const CrdtElementId CRDT_ROOT_ID(0, 0);
+
+/**
+ * @brief One replicated edit; origin and seq number the origin's operations 1, 2, 3...
+ */
+struct CrdtOperation {
+    enum Type {
+        INSERT,
+        REMOVE
+    };
+
+    Type type;
+    CrdtReplicaId origin;
+    std::uint64_t seq;
+    CrdtElementId id;      // inserted element, or the element removed
+    CrdtElementId parent;  // element the insert was placed after
+    SongHandle song;
+
+    CrdtOperation() : type(INSERT), origin(0), seq(0), song(INVALID_SONG_HANDLE) {}
+};
+
+// Highest contiguous seq applied from each origin
+typedef std::map<CrdtReplicaId, std::uint64_t> CrdtVersionVector;
+
+/**
+ * @brief Replicated Growable Array (RGA) of songs for offline editing
+ *
+ * Every element records the element it was inserted after. A remote insert
+ * is placed directly after that parent, skipping any neighbours with a
+ * larger id (concurrent inserts at the same spot and their descendants), so
+ * every replica that applies the same operations, in any causal order,
+ * ends with the same sequence. Removal leaves a 4-byte-payload tombstone in
+ * place so concurrent inserts after it still land correctly.
+ *
+ * Replicas keep a log of the operations they have applied and a version
+ * vector. merge pulls only the operations the other replica has that this
+ * one has not seen. Each merge also records what the other replica had
+ * seen, which is what collect_garbage uses. An insert whose parent has not
+ * arrived is left unapplied and unseen, so a later merge sends it again;
+ * apply_operations retries it within the same batch. An operation is
+ * causally stable once every listed replica has seen it and this replica
+ * holds every operation those replicas made before seeing it; no operation
+ * still in flight can then refer to it. A tombstone is purged when its
+ * removal is stable and so is the insert of each element placed after it:
+ * any later insert then carries a larger id than everything around the
+ * tombstone, so its placement is the same with or without it. Stable
+ * operations are dropped from the log as well.
+ *
+ * Songs are SongHandles resolved through a SongDatabase. Moves are a remove
+ * plus an insert, so two replicas moving the same song concurrently both
+ * keep their copy.
+ *
+ * Time Complexity Analysis:
+ * - insert_after / remove: O(1) average plus concurrent siblings skipped
+ * - insert_at / remove_at / move / element_at: O(n) to find the position
+ * - merge: O(k) for k unseen operations, plus O(L) to scan the other log
+ * - collect_garbage: O(n + L)
+ * - to_handles / to_playlist: O(n) / O(n log n)
+ *
+ * Space Complexity: O(n + t + L) for n songs, t tombstones and L logged operations
+ */
+class PlaylistCRDT {
+private:
+    struct Element {
+        CrdtElementId id;
+        CrdtElementId parent;
+        SongHandle song;
+        bool removed;
+        std::uint64_t insertSeq;
+        CrdtReplicaId removeOrigin;
+        std::uint64_t removeSeq;
+        Element* prev;
+        Element* next;
+
+        Element(const CrdtOperation& insert);
+    };
+
+    CrdtReplicaId replicaId;
+    std::uint64_t clock;
+    std::uint64_t seq;
+    Element root;
+    std::unordered_map<CrdtElementId, Element*, CrdtElementIdHash> elements;
+    int visibleCount;
+    size_t tombstoneCount;
+
+    CrdtVersionVector version;
+    std::map<CrdtReplicaId, CrdtVersionVector> peerVersions;  // what each replica reported having seen
+    std::vector<CrdtOperation> log;
+
+    // Helper methods
+    Element* find(const CrdtElementId& id) const;
+    Element* visibleAt(int position) const;
+    bool integrate(const CrdtOperation& op);
+    CrdtOperation makeOperation(CrdtOperation::Type type);
+    bool hasSeen(const CrdtVersionVector& seen, CrdtReplicaId origin, std::uint64_t opSeq) const;
+    bool stableVersion(const std::vector<CrdtReplicaId>& replicas, CrdtVersionVector& stable) const;
+    void absorbVersions(CrdtReplicaId peer, const CrdtVersionVector& seen);
+
+public:
+    // Constructors and Destructor
+    explicit PlaylistCRDT(CrdtReplicaId replicaId);
+    ~PlaylistCRDT();
+
+    // Non-copyable: elements are linked by address
+    PlaylistCRDT(const PlaylistCRDT&) = delete;
+    PlaylistCRDT& operator=(const PlaylistCRDT&) = delete;
+
+    // Local edits by element (return CRDT_ROOT_ID / false if the anchor is unknown or removed)
+    CrdtElementId insert_after(const CrdtElementId& anchor, SongHandle song);
+    bool remove(const CrdtElementId& id);
+
+    // Local edits by visible position
+    CrdtElementId insert_at(int position, SongHandle song);
+    bool remove_at(int position);
+    bool move(int fromIndex, int toIndex);
+
+    // Synchronization
+    std::vector<CrdtOperation> operations_since(const CrdtVersionVector& seen) const;
+    int apply_operations(const std::vector<CrdtOperation>& operations);
+    int merge(const PlaylistCRDT& other);
+    size_t collect_garbage(const std::vector<CrdtReplicaId>& replicas);
+
+    // Queries
+    CrdtElementId element_at(int position) const;
+    SongHandle get_song(const CrdtElementId& id) const;
+    int getSize() const;
+    bool isEmpty() const;
+    size_t get_tombstone_count() const;
+    size_t get_log_size() const;
+    CrdtReplicaId get_replica_id() const;
+    const CrdtVersionVector& get_version() const;
+
+    // Conversion
+    std::vector<SongHandle> to_handles() const;
+    Playlist to_playlist(const SongDatabase& db, const std::string& name) const;
+
+    // Performance analysis
+    static void benchmarkMerge(int initialSize, int operationsPerReplica);
+};
+
+#endif // PLAYLIST_CRDT_H
@@ -0,0 +1,126 @@
+#ifndef PLAYLIST_EDIT_H
+#define PLAYLIST_EDIT_H
+
+#include "song.h"
+#include <vector>
+#include <string>
+#include <unordered_map>
+
+class Playlist;
+
+/**
+ * @brief A single playlist edit used by batch application
+ * 
+ * Positions follow the same rules as the matching Playlist call and refer
+ * to the playlist as it looks after every earlier edit in the batch:
+ * - INSERT: add_song_at(song, position)
+ * - DELETE: delete_song(position)
+ * - MOVE: move_song(position, toPosition)
+ */
+struct PlaylistEdit {
+    enum class Type {
+        INSERT,
+        DELETE,
+        MOVE
+    };
+
+    Type type;
+    int position;
+    int toPosition;
+    Song song;
+
+    static PlaylistEdit insert(const Song& song, int position);
+    static PlaylistEdit remove(int position);
+    static PlaylistEdit move(int fromIndex, int toIndex);
+};
+
+/**
+ * @brief Outcome of applying a batch of edits
+ * 
+ * On failure nothing was applied and failedEdit/error describe the first
+ * invalid edit. On success the counters describe the net difference between
+ * the playlist before and after the batch: songs that were inserted and
+ * survived, original songs that were deleted, and the minimum number of
+ * surviving original songs that changed relative order. moved is only
+ * worked out when asked for (see Playlist::apply_edits) and is 0 otherwise.
+ */
+struct PlaylistEditResult {
+    bool success;
+    int failedEdit;
+    std::string error;
+    int inserted;
+    int deleted;
+    int moved;
+
+    PlaylistEditResult() : success(false), failedEdit(-1), inserted(0), deleted(0), moved(0) {}
+};
+
+/**
+ * @brief Outcome of a three-way playlist merge
+ * 
+ * edits turns "ours" into the merged playlist and can be passed straight to
+ * Playlist::apply_edits. conflicts counts songs that both sides moved; in
+ * that case our position wins.
+ */
+struct PlaylistMergeResult {
+    std::vector<PlaylistEdit> edits;
+    int conflicts;
+    int mergedSize;
+    
+    PlaylistMergeResult() : conflicts(0), mergedSize(0) {}
+};
+
+/**
+ * @brief Helpers for building, applying, diffing and merging edit batches
+ * 
+ * Playlist::apply_edits is the batch path; applySequential replays the same
+ * edits one call at a time and serves as the baseline it is measured against.
+ * Both pay one O(log n) index update per edit, which dominates; the batch
+ * saves the node lookups and, for moves, the aggregate updates, and its real
+ * gain is that an invalid batch changes nothing.
+ * checkEdits validates a batch of k edits in O(k) by tracking the size.
+ * planEdits also works out the net diff including the move count: it replays
+ * the batch on an implicit treap of segments, each a run of original songs
+ * or one inserted song, in O(k log k) whatever the playlist size.
+ * 
+ * diff matches songs by id (the k-th copy of an id matches the k-th copy on
+ * the other side) and produces deletes, then the minimum number of moves
+ * (everything outside a longest increasing subsequence of kept songs), then
+ * inserts in target order. Positions are computed with a Fenwick tree over
+ * precomputed order keys, so the whole diff is O((n + m) log(n + m)).
+ * 
+ * merge applies the other side's deletes, inserts and moves on top of ours,
+ * anchoring each inserted or moved song after its predecessor in theirs.
+ */
+class PlaylistEditor {
+private:
+    static std::vector<const Song*> collectSongs(const Playlist& playlist);
+    static std::vector<int> toSymbols(const std::vector<const Song*>& songs,
+                                      std::unordered_map<std::string, int>& table);
+    static std::vector<PlaylistEdit> diffSongs(const std::vector<const Song*>& from,
+                                               const std::vector<const Song*>& to);
+    static void matchSongs(const std::vector<int>& fromSymbols, const std::vector<int>& toSymbols,
+                           int symbolCount, std::vector<int>& matchFrom, std::vector<int>& matchTo);
+    static std::vector<char> keptInOrder(const std::vector<int>& matchFrom);
+
+public:
+    static PlaylistEditResult applySequential(Playlist& playlist, const std::vector<PlaylistEdit>& edits);
+    static std::vector<PlaylistEdit> generateRandomEdits(int playlistSize, int editCount, unsigned int seed);
+    static void benchmarkBatchEdits(int playlistSize, int editCount);
+
+    // Synchronization
+    static std::vector<PlaylistEdit> diff(const Playlist& from, const Playlist& to);
+    static PlaylistMergeResult merge(const Playlist& base, const Playlist& ours, const Playlist& theirs);
+    static void benchmarkDiff(int playlistSize, int editCount);
+
+    // Number of surviving elements that must move, given their original
+    // indices in their new order (size minus longest increasing subsequence)
+    static int countMoved(const std::vector<int>& originalIndices);
+
+    // Validate a batch against a playlist of the given size without touching
+    // it; planEdits also fills in the net diff counters
+    static PlaylistEditResult checkEdits(int size, const std::vector<PlaylistEdit>& edits);
+    static PlaylistEditResult planEdits(int size, const std::vector<PlaylistEdit>& edits);
+};
+
+#endif // PLAYLIST_EDIT_H
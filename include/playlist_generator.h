@@ -0,0 +1,82 @@
+#ifndef PLAYLIST_GENERATOR_H
+#define PLAYLIST_GENERATOR_H
+
+#include "song.h"
+#include "playlist.h"
+#include "song_database.h"
+#include "smart_playlist.h"
+#include <string>
+#include <vector>
+#include <ctime>
+
+/**
+ * @brief What a generated playlist should look like
+ *
+ * rule selects the eligible songs (for example genre "Rock", rating 4-5).
+ * The total duration must land within toleranceSeconds of targetSeconds.
+ * artistSpacing is the smallest window of consecutive tracks in which an
+ * artist may appear only once: 3 means no artist repeats within 3 tracks,
+ * 0 or 1 disables the rule. seed varies the result between runs.
+ */
+struct PlaylistGeneratorRequest {
+    SmartPlaylistRule rule;
+    int targetSeconds;
+    int toleranceSeconds;
+    int artistSpacing;
+    unsigned int seed;
+
+    PlaylistGeneratorRequest() : targetSeconds(3600), toleranceSeconds(60), artistSpacing(3), seed(0) {}
+};
+
+/**
+ * @brief Outcome of a generation request
+ */
+struct PlaylistGeneratorResult {
+    bool success;
+    int totalDuration;
+    int songCount;
+    long long candidates;
+    std::string error;
+
+    PlaylistGeneratorResult() : success(false), totalDuration(0), songCount(0), candidates(0) {}
+};
+
+/**
+ * @brief Builds playlists that hit a duration target under an artist-spacing rule
+ *
+ * Candidates come from the SongDatabase genre index (or the handle table when
+ * no genre is given) and are bucketed by duration. The duration target is a
+ * bounded subset-sum over the distinct durations: each bucket is one item
+ * type whose multiplicity is the bucket size, so the DP costs O(D * T) for D
+ * distinct durations and a target of T seconds, independent of the number
+ * of candidates. Songs are then drawn from the chosen buckets preferring
+ * artists not picked yet, and ordered greedily (the artist with the most
+ * remaining songs that is not inside the spacing window goes next), which
+ * finds a valid order whenever one exists. If the draw cannot be spaced the
+ * search is retried with the buckets in a different order.
+ *
+ * Time Complexity: O(k + D * T) for k candidates in the genre
+ * Space Complexity: O(k + T)
+ */
+class PlaylistGenerator {
+public:
+    static const int MAX_TARGET_SECONDS = 24 * 3600;
+    static const int MAX_ATTEMPTS = 4;
+
+private:
+    // Helper methods
+    static long long collectCandidates(SongDatabase& db, const SmartPlaylistRule& rule, std::time_t now,
+                                       int limit, std::vector<std::vector<const Song*>>& byDuration);
+    static int solveDurations(const std::vector<std::vector<const Song*>>& byDuration, int target,
+                              int tolerance, unsigned int seed, std::vector<int>& counts);
+    static void drawSongs(std::vector<std::vector<const Song*>>& byDuration, const std::vector<int>& counts,
+                          unsigned int seed, std::vector<const Song*>& picked);
+    static bool arrange(std::vector<const Song*>& songs, int spacing);
+    static std::string artistKey(const std::string& artist);
+
+public:
+    static PlaylistGeneratorResult generate(SongDatabase& db, const PlaylistGeneratorRequest& request,
+                                            Playlist& out, std::time_t now = std::time(nullptr));
+};
+
+#endif // PLAYLIST_GENERATOR_H
@@ -0,0 +1,77 @@
+#ifndef PLAYLIST_INDEX_H
+#define PLAYLIST_INDEX_H
+
+#include <random>
+
+struct PlaylistNode;
+
+/**
+ * @brief Tree links embedded in every PlaylistNode for PlaylistIndex
+ *
+ * count and duration cover the node's whole subtree so positions and time
+ * offsets can be summed on the way down or up the tree.
+ */
+struct PlaylistIndexLinks {
+    PlaylistNode* parent;
+    PlaylistNode* left;
+    PlaylistNode* right;
+    unsigned int priority;
+    int count;
+    long long duration;
+
+    PlaylistIndexLinks() : parent(nullptr), left(nullptr), right(nullptr), priority(0), count(1), duration(0) {}
+};
+
+/**
+ * @brief Position and cumulative-duration index over a playlist's nodes
+ *
+ * An implicit treap threaded through the playlist's own nodes: in-order
+ * traversal matches the linked-list order, and every subtree knows how many
+ * songs it holds and how long they play. Parent links let a node find its
+ * own position without walking the list.
+ *
+ * Time Complexity Analysis:
+ * - insertAfter / insertAt / erase / eraseAt / refresh: O(log n) expected
+ * - rankOf / nodeAt / offsetOf / nodeAtOffset / countWithin: O(log n) expected
+ * - successorOf: O(1) expected for a node just inserted, O(log n) worst
+ * - totalDuration: O(1)
+ * - rebuild: O(n)
+ *
+ * Space Complexity: O(1) beyond the links stored in each node
+ */
+class PlaylistIndex {
+private:
+    PlaylistNode* root;
+    std::mt19937 rng;
+
+    // Treap primitives
+    static int countOf(const PlaylistNode* node);
+    static long long durationOf(const PlaylistNode* node);
+    static void pull(PlaylistNode* node);
+    static void split(PlaylistNode* node, int count, PlaylistNode*& left, PlaylistNode*& right);
+    static PlaylistNode* merge(PlaylistNode* left, PlaylistNode* right);
+    void resetLinks(PlaylistNode* node);
+
+public:
+    PlaylistIndex();
+
+    // Structure maintenance (called by Playlist alongside its list links)
+    void clear();
+    void rebuild(PlaylistNode* head);
+    void insertAfter(PlaylistNode* node, PlaylistNode* afterNode);
+    void insertAt(PlaylistNode* node, int index);
+    void erase(PlaylistNode* node);
+    PlaylistNode* eraseAt(int index);  // the node that was at index
+    void refresh(PlaylistNode* node);
+
+    // Queries
+    int rankOf(const PlaylistNode* node) const;
+    PlaylistNode* nodeAt(int index) const;
+    PlaylistNode* successorOf(const PlaylistNode* node) const;  // next in order, nullptr at the end
+    long long offsetOf(const PlaylistNode* node) const;
+    PlaylistNode* nodeAtOffset(long long seconds) const;
+    int countWithin(long long seconds) const;
+    long long totalDuration() const;
+};
+
+#endif // PLAYLIST_INDEX_H
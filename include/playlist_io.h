@@ -0,0 +1,98 @@
+#ifndef PLAYLIST_IO_H
+#define PLAYLIST_IO_H
+
+#include "song.h"
+#include "playlist.h"
+#include "song_database.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Outcome of a playlist import or export
+ *
+ * entries counts the songs read or written; on import, imported +
+ * unresolved + malformed == entries. Only JSONL lines can be malformed; an
+ * M3U location without a usable #EXTINF line is still resolved by id.
+ */
+struct PlaylistIOResult {
+    bool success;
+    long long entries;
+    long long imported;
+    long long unresolved;
+    long long malformed;
+    std::string error;
+
+    PlaylistIOResult() : success(false), entries(0), imported(0), unresolved(0), malformed(0) {}
+};
+
+/**
+ * @brief Streaming playlist import and export for extended M3U and JSON Lines
+ *
+ * Export walks the playlist once and writes through a fixed 1 MB buffer, so
+ * no intermediate copy of the playlist is ever built. Import reads one line
+ * at a time and parses entries into a reusable batch; each full batch is
+ * resolved against the SongDatabase (by id, then by title and artist) and
+ * appended to the playlist before the next batch is read. Working memory is
+ * therefore bounded by the buffer and batch sizes, not by the file length.
+ *
+ * M3U entries are written as "#EXTINF:<seconds>,<artist> - <title>" followed
+ * by the song id as the location. JSONL entries are flat objects with the
+ * keys id, title, artist, album, genre, duration, rating and added.
+ *
+ * Time Complexity: O(n) for n entries (O(1) average per resolution)
+ * Space Complexity: O(WRITE_BUFFER_SIZE + RESOLVE_BATCH_SIZE) working memory
+ */
+class PlaylistIO {
+public:
+    static const size_t WRITE_BUFFER_SIZE = 1 << 20;
+    static const size_t RESOLVE_BATCH_SIZE = 4096;
+
+private:
+    class BufferedWriter {
+    private:
+        std::FILE* file;
+        std::vector<char> buffer;
+        size_t used;
+        bool failed;
+
+    public:
+        explicit BufferedWriter(const std::string& filename);
+        ~BufferedWriter();
+
+        bool isOpen() const;
+        void write(const char* data, size_t length);
+        void write(const std::string& text);
+        void write(char c);
+        void writeInt(long long value);
+        bool flush();
+        bool close();
+    };
+
+    struct PendingEntry {
+        std::string id;
+        std::string title;
+        std::string artist;
+    };
+
+    // Helper methods
+    static void resolveBatch(std::vector<PendingEntry>& batch, size_t count, Playlist& playlist,
+                             SongDatabase& db, PlaylistIOResult& result);
+    static void writeJsonString(BufferedWriter& writer, const std::string& text);
+    static void writeM3uText(BufferedWriter& writer, const std::string& text);
+    static bool parseJsonString(const std::string& line, size_t& pos, std::string& out);
+    static bool skipJsonValue(const std::string& line, size_t& pos);
+    static bool parseJsonEntry(const std::string& line, PendingEntry& entry);
+    static bool parseExtinf(const std::string& line, PendingEntry& entry);
+
+public:
+    // Export
+    static PlaylistIOResult export_m3u(const Playlist& playlist, const std::string& filename);
+    static PlaylistIOResult export_jsonl(const Playlist& playlist, const std::string& filename);
+
+    // Import (appends resolved songs to the playlist)
+    static PlaylistIOResult import_m3u(Playlist& playlist, SongDatabase& db, const std::string& filename);
+    static PlaylistIOResult import_jsonl(Playlist& playlist, SongDatabase& db, const std::string& filename);
+};
+
+#endif // PLAYLIST_IO_H
@@ -0,0 +1,87 @@
+#ifndef PLAYLIST_MANAGER_H
+#define PLAYLIST_MANAGER_H
+
+#include "song.h"
+#include "playlist.h"
+#include "song_database.h"
+#include <unordered_map>
+#include <map>
+#include <vector>
+#include <string>
+#include <iostream>
+
+// Identifier of a playlist owned by a PlaylistManager (0 is never used)
+typedef unsigned int PlaylistId;
+const PlaylistId INVALID_PLAYLIST_ID = 0;
+
+/**
+ * @brief PlaylistManager class owning many lightweight playlists
+ *
+ * Each managed playlist stores SongHandles into a shared SongDatabase
+ * instead of Song copies, so an entry costs 4 bytes no matter how much
+ * metadata the song carries. Playlists are addressed by id through a hash
+ * map and kept in a name-ordered map for listing and renaming.
+ *
+ * Time Complexity Analysis:
+ * - create_playlist / delete_playlist / rename_playlist: O(log p)
+ * - find_playlist: O(log p)
+ * - add_song: O(1) amortized
+ * - insert_song_at / remove_song_at: O(n) element shift
+ * - list_playlists: O(p)
+ *
+ * Space Complexity: O(p + total entries) where p is the number of playlists
+ */
+class PlaylistManager {
+private:
+    struct PlaylistEntry {
+        PlaylistId id;
+        std::string name;
+        std::vector<SongHandle> songs;
+    };
+
+    SongDatabase* songDatabase;
+    std::unordered_map<PlaylistId, PlaylistEntry> playlists;
+    std::map<std::string, PlaylistId> playlistsByName;
+    PlaylistId nextId;
+
+    // Helper methods
+    PlaylistEntry* findEntry(PlaylistId id);
+    const PlaylistEntry* findEntry(PlaylistId id) const;
+
+public:
+    // Constructors
+    PlaylistManager();
+    explicit PlaylistManager(SongDatabase* db);
+
+    // Playlist lifecycle (names are unique)
+    PlaylistId create_playlist(const std::string& name);
+    bool delete_playlist(PlaylistId id);
+    bool rename_playlist(PlaylistId id, const std::string& newName);
+    PlaylistId find_playlist(const std::string& name) const;
+    std::vector<std::pair<PlaylistId, std::string>> list_playlists() const;
+    bool contains_playlist(PlaylistId id) const;
+
+    // Entry operations
+    bool add_song(PlaylistId id, const std::string& songId);
+    bool insert_song_at(PlaylistId id, const std::string& songId, int position);
+    bool remove_song_at(PlaylistId id, int position);
+    int get_playlist_size(PlaylistId id) const;
+    std::string get_playlist_name(PlaylistId id) const;
+    std::vector<const Song*> get_songs(PlaylistId id) const;
+
+    // Conversion to and from full playlists
+    PlaylistId import_playlist(const Playlist& playlist, const std::string& name = "");
+    Playlist to_playlist(PlaylistId id) const;
+
+    // Memory reporting
+    size_t get_playlist_memory(PlaylistId id) const;
+    size_t get_total_memory() const;
+    int get_playlist_count() const;
+    void display_playlists() const;
+
+    // Management
+    void clear();
+    void setSongDatabase(SongDatabase* db);
+};
+
+#endif // PLAYLIST_MANAGER_H
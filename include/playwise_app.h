@@ -10,6 +10,20 @@
 #include "dashboard.h"
 #include "song_cleaner.h"
 #include "favorite_songs_queue.h"
+#include "playlist_manager.h"
+#include "play_queue.h"
+#include "playlist_io.h"
+#include "playlist_generator.h"
+#include "concurrent_playlist.h"
+#include "playlist_crdt.h"
+#include "allocation_counter.h"
+#include "history_log.h"
+#include "playback_ingest.h"
+#include "compressed_history.h"
+#include "heavy_hitters.h"
+#include "distinct_counts.h"
+#include "sessionizer.h"
+#include "edit_journal.h"
 #include <string>
 #include <vector>
 
@@ -32,6 +46,14 @@ private:
     Dashboard* dashboard;
     SongCleaner* songCleaner;
     FavoriteSongsQueue* favoriteSongsQueue;
+    PlaylistManager* playlistManager;
+    PlayQueue* playQueue;
+    HistoryLog* historyLog;  // opened on demand from the system menu
+    PlayTrends* playTrends;  // top songs and artists, fed by the history
+    PlayDistincts* playDistincts;  // distinct songs, artists and listeners, fed by the history
+    SessionAggregator* sessionTotals;  // completed listening sessions
+    Sessionizer* sessionizer;  // fed by the history, emits into sessionTotals
+    EditJournal* editJournal;  // undo/redo of menu edits
 
     
     // Application state
@@ -51,6 +73,7 @@ private:
     void handleSongCleanerOperations();
     void handleFavoriteSongsOperations();
     void handleSimulatePlaybackOperations();
+    void handleUndoRedo(bool undo);
     
     // Utility methods
     void clearScreen();
@@ -21,7 +21,7 @@ struct RatingNode {
 /**
  * @brief RatingTree class implementing a Binary Search Tree for song rating management
  * 
- * This class organizes songs by their ratings (1-5 stars) in a BST structure.
+ * This class organizes songs by their ratings (1 to Song::MAX_RATING stars) in a BST structure.
  * Each node represents a rating bucket that can contain multiple songs with that rating.
  * This allows for efficient searching, insertion, and deletion by rating.
  * 
@@ -41,6 +41,7 @@ private:
     // Helper methods
     RatingNode* insertNode(RatingNode* node, int rating);
     RatingNode* findNode(RatingNode* node, int rating) const;
+    RatingNode* findOrCreateNode(int rating);
     RatingNode* deleteNode(RatingNode* node, int rating);
     RatingNode* findMin(RatingNode* node) const;
     void clearTree(RatingNode* node);
@@ -60,6 +61,7 @@ public:
 
     // Core operations
     void insert_song(const Song& song, int rating);
+    void insert_song(Song&& song, int rating);
     bool delete_song(const std::string& songId, int rating);
     std::vector<Song> search_by_rating(int rating) const;
     std::vector<Song> get_songs_by_rating(int rating) const;
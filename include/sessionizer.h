@@ -0,0 +1,167 @@
+#ifndef SESSIONIZER_H
+#define SESSIONIZER_H
+
+#include "song.h"
+#include "history_log.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief One play as seen by the sessionizer
+ */
+struct SessionPlay {
+    std::string listener;
+    const Song* song;
+    int listenedSeconds;  // -1 for the whole song
+    std::int64_t playedAtMillis;
+};
+
+/**
+ * @brief A run of plays by one listener without a long enough pause
+ */
+struct ListeningSession {
+    std::string listener;
+    std::int64_t startMillis;  // first play started
+    std::int64_t endMillis;    // last playback ended
+    std::int64_t lastPlayMillis;     // latest play started
+    std::int64_t lastPlayEndMillis;  // and ended; the gap is measured from here
+    int plays;
+    int skips;
+    long long listenedSeconds;
+    std::unordered_map<std::string, int> genreMix;  // genre -> plays
+
+    long long length_millis() const;
+    double skip_rate() const;
+    void absorb(const ListeningSession& later);  // appends a later session's plays
+};
+
+/**
+ * @brief Sums completed sessions: counts, lengths, skip rate and genre mix
+ *
+ * Meant as the sink of a Sessionizer (see as_sink); aggregates of separate
+ * streams combine with merge.
+ */
+class SessionAggregator {
+private:
+    long long sessions;
+    long long plays;
+    long long skips;
+    long long listenedSeconds;
+    long long lengthMillis;
+    long long longestMillis;
+    std::unordered_map<std::string, long long> genrePlays;
+
+public:
+    SessionAggregator();
+
+    void add(const ListeningSession& session);
+    void merge(const SessionAggregator& other);
+    void clear();
+    std::function<void(const ListeningSession&)> as_sink();  // adds to this aggregator
+
+    long long get_session_count() const;
+    long long get_play_count() const;
+    long long get_listened_seconds() const;
+    double get_average_length_minutes() const;
+    double get_longest_length_minutes() const;
+    double get_skip_rate() const;
+    std::vector<std::pair<std::string, long long>> top_genres(int count) const;
+    void display_summary() const;
+};
+
+/**
+ * @brief Splits the play stream into listening sessions, per listener
+ *
+ * Each listener has at most one open session. A play that starts more than
+ * the gap after the end of the session's latest play closes that session,
+ * which goes to the sink, and opens a new one; otherwise it extends the
+ * open session. An earlier, longer play that overlaps the latest one does
+ * not hold the session open. A play counts as a skip when less than 30 seconds and less
+ * than half of the song were heard. Sessions of listeners that went quiet
+ * are emitted by flush_idle, and all open sessions by flush_all.
+ *
+ * Plays should arrive in time order per listener; an earlier play joins
+ * the open session.
+ *
+ * Backfill sessionizes archived plays in parallel: the plays are cut into
+ * time-ordered chunks, each chunk is sessionized on its own thread, and the
+ * first and last session of every listener in a chunk are stitched to the
+ * neighbouring chunks on the calling thread, which alone calls the sink.
+ * Each split depends only on two consecutive plays of one listener, so the
+ * stitched sessions are exactly those of a streaming pass.
+ *
+ * Time Complexity Analysis:
+ * - record_play: O(1) average
+ * - flush_idle / flush_all: O(open sessions)
+ * - backfill: O(n / threads) per thread plus O(listeners * chunks) stitching
+ *
+ * Space Complexity: O(listeners with an open session)
+ */
+class Sessionizer : public HistoryListener {
+public:
+    typedef std::function<void(const ListeningSession&)> Sink;
+
+    static const std::int64_t DEFAULT_GAP_MILLIS = 30LL * 60 * 1000;
+    static const int SKIP_SECONDS = 30;
+
+private:
+    // One chunk of a backfill, sessionized on its own
+    struct ChunkSessions {
+        std::unordered_map<std::string, ListeningSession> heads;  // first session per listener
+        std::unordered_map<std::string, ListeningSession> tails;  // last one, if not also the first
+        std::vector<ListeningSession> middles;                    // complete on their own
+    };
+
+    Sink sink;
+    std::int64_t gapMillis;
+    std::string listener;
+    std::unordered_map<std::string, ListeningSession> openSessions;
+    long long emitted;
+
+    // Helper methods
+    void emit(const ListeningSession& session);
+    static ChunkSessions sessionizeChunk(const std::function<void(Sessionizer&)>& feed, std::int64_t gapMillis);
+    static void stitch(std::vector<ChunkSessions>& chunks, const Sink& sink, std::int64_t gapMillis);
+    // Cuts [0, count) into contiguous ranges, one thread each, then stitches
+    static void backfillRanges(size_t count, int threadCount,
+                               const std::function<void(Sessionizer&, size_t, size_t)>& feed,
+                               const Sink& sink, std::int64_t gapMillis);
+
+public:
+    explicit Sessionizer(Sink sink, std::int64_t gapMillis = DEFAULT_GAP_MILLIS);
+
+    // Streaming
+    void set_listener(const std::string& listener);  // for plays given without one
+    void record_play(const Song& song, int listenedSeconds, std::int64_t playedAtMillis);
+    void record_play(const SessionPlay& play);
+    int flush_idle(std::int64_t nowMillis);  // emits sessions quiet for more than the gap
+    int flush_all();
+    void clear();  // drops open sessions without emitting them
+
+    size_t get_open_count() const;
+    const ListeningSession* get_open_session(const std::string& listener) const;  // nullptr if none
+    long long get_emitted_count() const;
+    std::int64_t get_gap_millis() const;
+
+    static bool isSkip(const Song& song, int listenedSeconds);
+
+    // Bulk backfill; plays in time order. threadCount 0 = hardware concurrency
+    static void backfill(const std::vector<SessionPlay>& plays, const Sink& sink,
+                         std::int64_t gapMillis = DEFAULT_GAP_MILLIS, int threadCount = 0);
+    // Live records of a log with from <= playedAtMillis < to, all by listener
+    static void backfill(const HistoryLog& log, std::int64_t fromMillis, std::int64_t toMillis,
+                         const std::string& listener, const Sink& sink,
+                         std::int64_t gapMillis = DEFAULT_GAP_MILLIS, int threadCount = 0);
+
+    // Performance analysis
+    static void benchmarkBackfill(int plays);
+
+    // HistoryListener
+    void onPlayRecorded(const Song& song, int listenedSeconds, std::int64_t playedAtMillis) override;
+};
+
+#endif // SESSIONIZER_H
@@ -0,0 +1,108 @@
+#ifndef SMART_PLAYLIST_H
+#define SMART_PLAYLIST_H
+
+#include "song.h"
+#include "playlist.h"
+#include "song_database.h"
+#include "sorting.h"
+#include <set>
+#include <unordered_map>
+#include <string>
+#include <functional>
+#include <ctime>
+
+/**
+ * @brief Membership rule of a smart playlist
+ *
+ * Empty strings and zero limits mean "any". addedWithinDays compares the
+ * song's added timestamp (seconds since the epoch) against the given time.
+ */
+struct SmartPlaylistRule {
+    std::string genre;
+    std::string artist;
+    int minRating;
+    int maxRating;
+    int addedWithinDays;
+
+    SmartPlaylistRule() : minRating(0), maxRating(5), addedWithinDays(0) {}
+
+    bool matches(const Song& song, std::time_t now) const;
+    std::string describe() const;
+
+private:
+    static bool equalsIgnoreCase(const std::string& a, const std::string& b);
+};
+
+/**
+ * @brief Playlist defined by a rule that stays current as the catalog changes
+ *
+ * The rule is evaluated against the whole SongDatabase once, when the smart
+ * playlist is attached. After that it listens to the database and only looks
+ * at the song that changed: matching songs are linked into the underlying
+ * Playlist at their sorted position, songs that stop matching are unlinked.
+ * Members are kept in an ordered set keyed by the configured sort criteria
+ * (ties broken by id) so the neighbour of a new song is found without a scan.
+ * Songs that age out of an "added in the last N days" rule are dropped by
+ * expire, which walks a second set ordered by added time.
+ *
+ * Time Complexity Analysis:
+ * - attach: O(n log m) one-time evaluation over n database songs
+ * - onSongInserted / onSongUpdated / onSongDeleted: O(log m)
+ * - expire: O(k log m) for k expired songs
+ *
+ * Space Complexity: O(m) where m is the number of matching songs
+ */
+class SmartPlaylist : public SongDatabaseListener {
+private:
+    struct OrderCompare {
+        std::function<bool(const Song&, const Song&)> compare;
+        bool operator()(const PlaylistNode* a, const PlaylistNode* b) const;
+    };
+
+    Playlist playlist;
+    SmartPlaylistRule rule;
+    Sorting::SortCriteria criteria;
+    SongDatabase* songDatabase;
+    std::set<PlaylistNode*, OrderCompare> ordered;
+    std::set<std::pair<long long, PlaylistNode*>> byAddedTime;
+    std::unordered_map<std::string, PlaylistNode*> members;
+
+    // Helper methods
+    static long long addedTimeOf(const Song& song);
+    void insertMember(const Song& song);
+    void removeMember(PlaylistNode* node);
+    void clearMembers();
+
+public:
+    // Constructors and Destructor
+    SmartPlaylist(const std::string& name, const SmartPlaylistRule& rule,
+                  Sorting::SortCriteria criteria = Sorting::SortCriteria::TITLE_ASC);
+    ~SmartPlaylist();
+
+    // Non-copyable: registered with a database by address
+    SmartPlaylist(const SmartPlaylist&) = delete;
+    SmartPlaylist& operator=(const SmartPlaylist&) = delete;
+
+    // Database binding
+    void attach(SongDatabase* db);
+    void detach();
+    bool isAttached() const;
+
+    // SongDatabaseListener
+    void onSongInserted(const Song& song) override;
+    void onSongUpdated(const Song& song) override;
+    void onSongDeleted(const std::string& songId) override;
+
+    // Time-based maintenance
+    int expire(std::time_t now);
+
+    // Queries
+    const Playlist& getPlaylist() const;
+    const SmartPlaylistRule& getRule() const;
+    Sorting::SortCriteria getCriteria() const;
+    int getSize() const;
+    bool contains(const std::string& songId) const;
+    void display() const;
+};
+
+#endif // SMART_PLAYLIST_H
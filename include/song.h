@@ -11,6 +11,10 @@
  * duration, and rating. It serves as the fundamental data unit for the
  * playlist management system.
  * 
+ * String getters return const references, so comparisons and lookups do
+ * not copy. Constructors and setters take strings by value and move them
+ * into place: pass temporaries or std::move to avoid copying.
+ * 
  * Time Complexity: O(1) for all operations
  * Space Complexity: O(1) per song object
  */
@@ -20,38 +24,40 @@ private:
     std::string title;
     std::string artist;
     int duration;  // in seconds
-    int rating;    // 1-5 stars
+    int rating;    // 1 to MAX_RATING stars, 0 when unrated
     std::string album;
     std::string genre;
     std::string addedDate;
 
 public:
+    static const int MAX_RATING = 6;  // highest rating setRating accepts; 0 is unrated
+
     // Constructors
     Song();
-    Song(const std::string& id, const std::string& title, const std::string& artist, 
+    Song(std::string id, std::string title, std::string artist, 
          int duration, int rating = 0);
-    Song(const std::string& id, const std::string& title, const std::string& artist, 
-         int duration, int rating, const std::string& album, const std::string& genre);
+    Song(std::string id, std::string title, std::string artist, 
+         int duration, int rating, std::string album, std::string genre);
 
     // Getters
-    std::string getId() const;
-    std::string getTitle() const;
-    std::string getArtist() const;
+    const std::string& getId() const;
+    const std::string& getTitle() const;
+    const std::string& getArtist() const;
     int getDuration() const;
     int getRating() const;
-    std::string getAlbum() const;
-    std::string getGenre() const;
-    std::string getAddedDate() const;
+    const std::string& getAlbum() const;
+    const std::string& getGenre() const;
+    const std::string& getAddedDate() const;
 
     // Setters
-    void setId(const std::string& id);
-    void setTitle(const std::string& title);
-    void setArtist(const std::string& artist);
+    void setId(std::string id);
+    void setTitle(std::string title);
+    void setArtist(std::string artist);
     void setDuration(int duration);
     void setRating(int rating);
-    void setAlbum(const std::string& album);
-    void setGenre(const std::string& genre);
-    void setAddedDate(const std::string& date);
+    void setAlbum(std::string album);
+    void setGenre(std::string genre);
+    void setAddedDate(std::string date);
 
     // Utility methods
     std::string getDurationString() const;  
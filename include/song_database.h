@@ -2,12 +2,32 @@
 #define SONG_DATABASE_H
 
 #include "song.h"
+#include "song_stats.h"
 #include <unordered_map>
 #include <unordered_set>
 #include <string>
+#include <utility>
 #include <vector>
 #include <iostream>
 
+// Compact, stable reference to a song id interned by a SongDatabase
+typedef unsigned int SongHandle;
+const SongHandle INVALID_SONG_HANDLE = 0xFFFFFFFFu;
+
+/**
+ * @brief Observer notified after every successful change to a SongDatabase
+ * 
+ * Listeners are not owned by the database and must detach themselves with
+ * remove_listener before they are destroyed.
+ */
+class SongDatabaseListener {
+public:
+    virtual ~SongDatabaseListener() {}
+    virtual void onSongInserted(const Song& song) = 0;
+    virtual void onSongUpdated(const Song& song) = 0;
+    virtual void onSongDeleted(const std::string& songId) = 0;
+};
+
 /**
  * @brief SongDatabase class implementing a HashMap for instant song lookup
  * 
@@ -19,21 +39,58 @@
  * - insert_song: O(1) average
  * - search_by_id: O(1) average
  * - search_by_title: O(1) average
+ * - search_by_title_artist: O(1) average
+ * - search_by_genre / get_handles_by_genre: O(k) for k songs in the genre
  * - delete_song: O(1) average
  * - update_song: O(1) average
+ * - resolve_handle: O(1)
+ * - get_stats: O(1), kept current by insert, delete, update and clear
+ * 
+ * Song handles intern a song id the first time it is inserted and never
+ * change meaning afterwards. A handle resolves to nullptr while its song is
+ * deleted and resolves again if a song with the same id is re-inserted, so
+ * other components can hold 4-byte handles instead of Song copies.
  * 
  * Space Complexity: O(n) where n is the number of songs
  */
 class SongDatabase {
 private:
     std::unordered_map<std::string, Song> songsById;      // song_id -> Song
-    // Track unique composite keys (normalized title + artist) to prevent duplicates
-    std::unordered_set<std::string> titleArtistKeys; 
+    // Composite keys (normalized title + artist) -> song id; prevents duplicates
+    // and answers title/artist lookups
+    std::unordered_map<std::string, std::string> titleArtistKeys;
+    
+    // Handle table: handle -> live song (nullptr when deleted) and its id
+    std::unordered_map<std::string, SongHandle> handlesById;
+    std::vector<Song*> handleTable;
+    std::vector<std::string> handleIds;
+    
+    // Normalized genre -> handles of the live songs in that genre, stored
+    // contiguously; genrePositions[handle] is the handle's slot in its list
+    std::unordered_map<std::string, std::vector<SongHandle>> handlesByGenre;
+    std::vector<size_t> genrePositions;
+    
+    // Aggregates over the live songs
+    SongStats stats;
+    
+    // Change listeners (not copied with the database)
+    std::vector<SongDatabaseListener*> listeners;
     
     // Helper methods
     std::string normalizeString(const std::string& str) const;
+    static bool equalsIgnoreCase(const std::string& a, const std::string& b);
+    static bool containsIgnoreCase(const std::string& text, const std::string& lowerNeedle);
     bool isValidSongId(const std::string& songId) const;
+    bool acceptsNewSong(const Song& song, std::string& compositeKey) const;
+    void storeSong(Song&& song, std::string&& compositeKey);
     std::string generateCompositeKey(const std::string& title, const std::string& artist) const;
+    SongHandle internSongId(const std::string& songId);
+    void rebuildHandleTable();
+    void indexGenre(SongHandle handle, const std::string& genre);
+    void unindexGenre(SongHandle handle, const std::string& genre);
+    void notifyInserted(const Song& song);
+    void notifyUpdated(const Song& song);
+    void notifyDeleted(const std::string& songId);
 
 public:
     // Constructors and Destructor
@@ -46,6 +103,14 @@ public:
 
     // Core operations
     bool insert_song(const Song& song);
+    bool insert_song(Song&& song);
+    
+    // Inserts a song built from Song constructor arguments
+    template <typename... Args>
+    bool emplace_song(Args&&... args) {
+        return insert_song(Song(std::forward<Args>(args)...));
+    }
+    
     bool delete_song(const std::string& songId);
     bool update_song(const Song& song);
     bool update_song_rating(const std::string& songId, int newRating);
@@ -53,19 +118,34 @@ public:
     // Search operations
     Song* search_by_id(const std::string& songId);
     Song* search_by_title(const std::string& title);
+    Song* search_by_title_artist(const std::string& title, const std::string& artist);
     std::vector<Song> search_by_artist(const std::string& artist) const;
     std::vector<Song> search_by_album(const std::string& album) const;
     std::vector<Song> search_by_genre(const std::string& genre) const;
     
+    // Handle operations
+    SongHandle get_handle(const std::string& songId) const;
+    Song* resolve_handle(SongHandle handle);
+    const Song* resolve_handle(SongHandle handle) const;
+    std::string get_handle_id(SongHandle handle) const;
+    size_t get_handle_count() const;
+    std::vector<SongHandle> get_handles_by_genre(const std::string& genre) const;
+    
+    // Change notification
+    void add_listener(SongDatabaseListener* listener);
+    void remove_listener(SongDatabaseListener* listener);
+    
     // Utility operations
     void display_database() const;
     void display_stats() const;
+    const SongStats& get_stats() const;
     int get_size() const;
     bool is_empty() const;
     void clear();
     
     // Batch operations
     bool insert_songs(const std::vector<Song>& songs);
+    bool insert_songs(std::vector<Song>&& songs);  // moves each song in
     std::vector<Song> get_all_songs() const;
     std::vector<std::string> get_all_artists() const;
     std::vector<std::string> get_all_albums() const;
@@ -0,0 +1,72 @@
+#ifndef SONG_STATS_H
+#define SONG_STATS_H
+
+#include "song.h"
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Running aggregates over a collection of songs
+ *
+ * The owning container calls add / remove / update whenever a song enters,
+ * leaves or changes, so totals, the rating histogram and the genre and
+ * artist counts are always current without walking the songs. A rating
+ * is counted at its own value in both the histogram and the average, as
+ * Song stores it (setRating accepts up to 6; the constructor does not
+ * check); 0 and below mean unrated and are left out of the average. Genre
+ * and artist counts drop a key when its count reaches zero.
+ *
+ * Time Complexity Analysis:
+ * - add / remove / update: O(1) average
+ * - getters: O(1)
+ * - top_genres / top_artists: O(k log k) for k distinct keys
+ *
+ * Space Complexity: O(g + a) for g distinct genres and a distinct artists
+ */
+class SongStats {
+private:
+    int songCount;
+    long long totalDuration;
+    long long ratingSum;
+    int ratedCount;
+    int ratingCounts[Song::MAX_RATING + 1];
+    std::unordered_map<int, int> otherRatingCounts;  // ratings outside 0 to Song::MAX_RATING
+    std::unordered_map<std::string, int> genreCounts;
+    std::unordered_map<std::string, int> artistCounts;
+
+    // Helper methods
+    void countRating(int rating, int delta);
+    static void countKey(std::unordered_map<std::string, int>& counts, const std::string& key, int delta);
+    static std::vector<std::pair<std::string, int>> topKeys(const std::unordered_map<std::string, int>& counts,
+                                                            int count);
+
+public:
+    SongStats();
+
+    // Maintenance (called by the owning container)
+    void add(const Song& song);
+    void remove(const Song& song);
+    void update(const Song& before, const Song& after);
+    void clear();
+
+    // Queries
+    int getSongCount() const;
+    long long getTotalDuration() const;
+    double getAverageRating() const;
+    int getRatedCount() const;
+    int getRatingCount(int rating) const;
+    std::map<int, int> getRatingCounts() const;  // ratings held by at least one song
+    int getGenreCount(const std::string& genre) const;
+    int getArtistCount(const std::string& artist) const;
+    const std::unordered_map<std::string, int>& getGenreCounts() const;
+    const std::unordered_map<std::string, int>& getArtistCounts() const;
+
+    // Most common keys first, ties by name
+    std::vector<std::pair<std::string, int>> top_genres(int count) const;
+    std::vector<std::pair<std::string, int>> top_artists(int count) const;
+};
+
+#endif // SONG_STATS_H
@@ -46,6 +46,8 @@ public:
     static std::string getCriteriaName(SortCriteria criteria);
     static void sortPlaylist(std::vector<Song>& songs, SortCriteria criteria, const std::string& algorithm = "merge");
     static void benchmarkSorting(std::vector<Song>& songs);
+    static void benchmarkPlaylistSort(int playlistSize);
+    static std::function<bool(const Song&, const Song&)> getComparator(SortCriteria criteria);
     
     // Comparison functions
     static bool compareByTitle(const Song& a, const Song& b, bool ascending = true);
@@ -57,20 +59,19 @@ public:
 private:
     // Helper functions for merge sort
     static void mergeSortHelper(std::vector<Song>& songs, int left, int right, 
-                               std::function<bool(const Song&, const Song&)> compare);
+                               const std::function<bool(const Song&, const Song&)>& compare);
     static void merge(std::vector<Song>& songs, int left, int mid, int right,
-                     std::function<bool(const Song&, const Song&)> compare);
+                     const std::function<bool(const Song&, const Song&)>& compare);
     
     // Helper functions for quick sort
     static void quickSortHelper(std::vector<Song>& songs, int low, int high,
-                               std::function<bool(const Song&, const Song&)> compare);
+                               const std::function<bool(const Song&, const Song&)>& compare);
     static int partition(std::vector<Song>& songs, int low, int high,
-                        std::function<bool(const Song&, const Song&)> compare);
+                        const std::function<bool(const Song&, const Song&)>& compare);
     
 
     
     // Utility functions
-    static std::function<bool(const Song&, const Song&)> getComparator(SortCriteria criteria);
     static void swap(Song& a, Song& b);
 };
 
@@ -0,0 +1,196 @@
+#include "../include/allocation_counter.h"
+#include "../include/favorite_songs_queue.h"
+#include "../include/history.h"
+#include "../include/playlist.h"
+#include "../include/rating_tree.h"
+#include "../include/song_database.h"
+#include "../include/sorting.h"
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static std::atomic<long long> allocationCount(0);
+static std::atomic<long long> allocatedBytes(0);
+static std::atomic<bool> counting(false);
+
+// Counters
+long long AllocationCounter::allocations() {
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+long long AllocationCounter::bytes() {
+    return allocatedBytes.load(std::memory_order_relaxed);
+}
+
+bool AllocationCounter::isCounting() {
+    return counting.load(std::memory_order_relaxed);
+}
+
+void AllocationCounter::record(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(static_cast<long long>(size), std::memory_order_relaxed);
+}
+
+bool AllocationCounter::enableCounting() {
+    counting.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+// Performance analysis
+void AllocationCounter::benchmarkSongIngestion(int songCount) {
+    std::cout << "\n=== Song Ingestion Allocation Benchmark ===" << std::endl;
+    if (!isCounting()) {
+        std::cout << "Allocation counting is off in this build; rebuild with -DPLAYWISE_COUNT_ALLOCATIONS." << std::endl;
+        return;
+    }
+    std::cout << "Songs per flow: " << songCount
+              << " (title, artist, album and genre longer than the small-string buffer)" << std::endl;
+
+    // Fresh songs each time; building them costs the same on every path
+    auto makeSong = [](int i) {
+        return Song("bench-" + std::to_string(i), "Benchmark Title Number " + std::to_string(i),
+                    "Benchmark Artist " + std::to_string(i % 50), 120 + i % 240, 1 + i % 5,
+                    "Benchmark Album " + std::to_string(i % 200), "Progressive Rock");
+    };
+    auto perSong = [songCount](long long before) {
+        return static_cast<double>(AllocationCounter::allocations() - before) / songCount;
+    };
+
+    std::cout << std::setw(20) << "Flow" << std::setw(15) << "Copy" << std::setw(15) << "Move"
+              << std::setw(15) << "Emplace" << std::endl;
+    std::cout << std::string(65, '-') << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+
+    // Each container starts from the same warm state (keys for every artist
+    // and genre already present) so only the per-song cost is compared
+    {
+        double results[3];
+        for (int path = 0; path < 3; path++) {
+            Playlist playlist("Benchmark");
+            for (int i = 0; i < 200; i++) playlist.add_song(makeSong(i));
+            long long before = allocations();
+            for (int i = 0; i < songCount; i++) {
+                if (path == 0) {
+                    Song song = makeSong(i);
+                    playlist.add_song(song);
+                } else if (path == 1) {
+                    playlist.add_song(makeSong(i));
+                } else {
+                    playlist.emplace_song("bench-" + std::to_string(i), "Benchmark Title Number " + std::to_string(i),
+                                          "Benchmark Artist " + std::to_string(i % 50), 120 + i % 240, 1 + i % 5,
+                                          "Benchmark Album " + std::to_string(i % 200), "Progressive Rock");
+                }
+            }
+            results[path] = perSong(before);
+        }
+        std::cout << std::setw(20) << "Playlist::add_song" << std::setw(15) << results[0] << std::setw(15)
+                  << results[1] << std::setw(15) << results[2] << std::endl;
+    }
+
+    {
+        double results[2];
+        for (int path = 0; path < 2; path++) {
+            SongDatabase db;
+            db.insert_song(makeSong(-1));
+            long long before = allocations();
+            for (int i = 0; i < songCount; i++) {
+                if (path == 0) {
+                    Song song = makeSong(i);
+                    db.insert_song(song);
+                } else {
+                    db.insert_song(makeSong(i));
+                }
+            }
+            results[path] = perSong(before);
+        }
+        std::cout << std::setw(20) << "Database insert" << std::setw(15) << results[0] << std::setw(15)
+                  << results[1] << std::setw(15) << "-" << std::endl;
+    }
+
+    {
+        double results[2];
+        for (int path = 0; path < 2; path++) {
+            History history(songCount + 1);
+            long long before = allocations();
+            for (int i = 0; i < songCount; i++) {
+                if (path == 0) {
+                    Song song = makeSong(i);
+                    history.add_played_song(song);
+                } else {
+                    history.add_played_song(makeSong(i));
+                }
+            }
+            results[path] = perSong(before);
+        }
+        std::cout << std::setw(20) << "History push" << std::setw(15) << results[0] << std::setw(15)
+                  << results[1] << std::setw(15) << "-" << std::endl;
+    }
+
+    {
+        double results[2];
+        for (int path = 0; path < 2; path++) {
+            RatingTree tree;
+            long long before = allocations();
+            for (int i = 0; i < songCount; i++) {
+                Song song = makeSong(i);
+                int rating = song.getRating();
+                if (path == 0) {
+                    tree.insert_song(song, rating);
+                } else {
+                    tree.insert_song(std::move(song), rating);
+                }
+            }
+            results[path] = perSong(before);
+        }
+        std::cout << std::setw(20) << "Rating tree insert" << std::setw(15) << results[0] << std::setw(15)
+                  << results[1] << std::setw(15) << "-" << std::endl;
+    }
+
+    {
+        double results[2];
+        for (int path = 0; path < 2; path++) {
+            FavoriteSongsQueue favorites;
+            long long before = allocations();
+            for (int i = 0; i < songCount; i++) {
+                if (path == 0) {
+                    Song song = makeSong(i);
+                    favorites.addSong(song);
+                } else {
+                    favorites.addSong(makeSong(i));
+                }
+            }
+            results[path] = perSong(before);
+        }
+        std::cout << std::setw(20) << "Favorites add" << std::setw(15) << results[0] << std::setw(15)
+                  << results[1] << std::setw(15) << "-" << std::endl;
+    }
+
+    // Sorting: a comparator that copies its keys, as by-value getters did,
+    // against the library comparator reading through const references
+    {
+        std::vector<Song> songs;
+        songs.reserve(songCount);
+        for (int i = 0; i < songCount; i++) songs.push_back(makeSong((i * 7919) % songCount));
+        std::vector<Song> copy = songs;
+
+        long long before = allocations();
+        std::sort(copy.begin(), copy.end(), [](const Song& a, const Song& b) {
+            std::string left = a.getTitle();
+            std::string right = b.getTitle();
+            return left < right;
+        });
+        double copying = perSong(before);
+
+        before = allocations();
+        std::sort(songs.begin(), songs.end(), Sorting::getComparator(Sorting::SortCriteria::TITLE_ASC));
+        double referencing = perSong(before);
+
+        std::cout << std::setw(20) << "Sort by title" << std::setw(15) << copying << std::setw(15)
+                  << referencing << std::setw(15) << "-" << std::endl;
+    }
+    std::cout << "(Sort row: a key-copying comparator against Sorting::getComparator)" << std::endl;
+    std::cout << std::endl;
+}
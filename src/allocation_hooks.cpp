@@ -0,0 +1,51 @@
+// Replacement global allocation functions that feed AllocationCounter.
+// Compiled in only with PLAYWISE_COUNT_ALLOCATIONS, so regular builds keep
+// the default allocator; the test runner defines it and includes this file.
+#ifdef PLAYWISE_COUNT_ALLOCATIONS
+
+#include "../include/allocation_counter.h"
+#include <cstdlib>
+#include <new>
+
+static const bool countingEnabled = AllocationCounter::enableCounting();
+
+static void* countedAllocate(std::size_t size) {
+    AllocationCounter::record(size);
+    if (size == 0) size = 1;
+    while (true) {
+        void* memory = std::malloc(size);
+        if (memory != nullptr) return memory;
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) throw std::bad_alloc();
+        handler();
+    }
+}
+
+// Global allocation functions
+void* operator new(std::size_t size) { return countedAllocate(size); }
+void* operator new[](std::size_t size) { return countedAllocate(size); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return countedAllocate(size);
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return countedAllocate(size);
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { std::free(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { std::free(memory); }
+
+#endif // PLAYWISE_COUNT_ALLOCATIONS
@@ -0,0 +1,415 @@
+#include "../include/compressed_history.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+
+static const char FILE_MAGIC[4] = {'P', 'W', 'C', 'H'};
+static const std::uint32_t FILE_VERSION = 1;
+
+// LEB128: seven bits per byte, high bit set on all but the last byte
+static void putVarint(std::vector<std::uint8_t>& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+// Unrolled for the one- to three-byte values that make up nearly every block
+static inline const std::uint8_t* readVarint(const std::uint8_t* in, std::uint64_t& value) {
+    std::uint64_t byte = in[0];
+    if (byte < 0x80) {
+        value = byte;
+        return in + 1;
+    }
+    std::uint64_t result = (byte & 0x7F) | (static_cast<std::uint64_t>(in[1]) << 7);
+    if (in[1] < 0x80) {
+        value = result;
+        return in + 2;
+    }
+    result = (result & 0x3FFF) | (static_cast<std::uint64_t>(in[2]) << 14);
+    if (in[2] < 0x80) {
+        value = result;
+        return in + 3;
+    }
+    result &= 0x1FFFFF;
+    int shift = 21;
+    in += 3;
+    do {
+        byte = *in++;
+        result |= (byte & 0x7F) << shift;
+        shift += 7;
+    } while (byte >= 0x80 && shift < 64);
+    value = result;
+    return in;
+}
+
+static size_t varintLength(std::uint64_t value) {
+    size_t length = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        length++;
+    }
+    return length;
+}
+
+// Writes a column as varints or, if at most an eighth larger, at a fixed width
+static std::uint8_t putColumn(std::vector<std::uint8_t>& out, const std::vector<std::uint64_t>& values) {
+    size_t varintBytes = 0;
+    std::uint64_t largest = 0;
+    for (std::uint64_t value : values) {
+        varintBytes += varintLength(value);
+        largest = std::max(largest, value);
+    }
+    std::uint8_t width = 1;
+    while (width < 8 && (largest >> (8 * width)) != 0) width++;
+
+    if (values.size() * width * 8 > varintBytes * 9) {
+        for (std::uint64_t value : values) putVarint(out, value);
+        return 0;
+    }
+    for (std::uint64_t value : values) {
+        for (std::uint8_t byte = 0; byte < width; byte++) {
+            out.push_back(static_cast<std::uint8_t>(value >> (8 * byte)));
+        }
+    }
+    return width;
+}
+
+template <int Width, typename Store>
+static const std::uint8_t* readFixedColumn(const std::uint8_t* in, size_t count, Store store) {
+    for (size_t i = 0; i < count; i++, in += Width) {
+        std::uint64_t value = 0;
+        for (int byte = 0; byte < Width; byte++) {
+            value |= static_cast<std::uint64_t>(in[byte]) << (8 * byte);
+        }
+        store(i, value);
+    }
+    return in;
+}
+
+template <typename Store>
+static const std::uint8_t* readColumn(const std::uint8_t* in, size_t count, std::uint8_t width, Store store) {
+    switch (width) {
+        case 1: return readFixedColumn<1>(in, count, store);
+        case 2: return readFixedColumn<2>(in, count, store);
+        case 3: return readFixedColumn<3>(in, count, store);
+        case 4: return readFixedColumn<4>(in, count, store);
+        case 5: return readFixedColumn<5>(in, count, store);
+        case 6: return readFixedColumn<6>(in, count, store);
+        case 7: return readFixedColumn<7>(in, count, store);
+        case 8: return readFixedColumn<8>(in, count, store);
+    }
+    std::uint64_t value;
+    for (size_t i = 0; i < count; i++) {
+        in = readVarint(in, value);
+        store(i, value);
+    }
+    return in;
+}
+
+// Bytes a well-formed column occupies within [in, end), or 0 if it is malformed
+static size_t columnLength(const std::uint8_t* in, const std::uint8_t* end, size_t count, std::uint8_t width) {
+    if (width > 8) return 0;
+    if (width > 0) {
+        return count * width <= static_cast<size_t>(end - in) ? count * width : 0;
+    }
+    const std::uint8_t* at = in;
+    for (size_t value = 0; value < count; value++) {
+        size_t run = 0;
+        do {
+            if (at >= end || ++run > 10) return 0;
+        } while (*at++ >= 0x80);
+    }
+    return static_cast<size_t>(at - in);
+}
+
+// Constructor
+CompressedHistory::CompressedHistory() : lastMillis(std::numeric_limits<std::int64_t>::min()), eventCount(0) {
+    pending.reserve(BLOCK_EVENTS);
+}
+
+// Helper methods
+void CompressedHistory::sealBlock() {
+    if (pending.empty()) return;
+
+    BlockHeader header;
+    header.firstMillis = pending.front().playedAtMillis;
+    header.lastMillis = pending.back().playedAtMillis;
+    header.eventCount = static_cast<std::uint32_t>(pending.size());
+    header.byteOffset = static_cast<std::uint32_t>(bytes.size());
+    header.reserved = 0;
+
+    // Column by column: time deltas, song references, listened seconds
+    std::vector<std::uint64_t> column(pending.size());
+    std::int64_t previous = header.firstMillis;
+    for (size_t i = 0; i < pending.size(); i++) {
+        column[i] = static_cast<std::uint64_t>(pending[i].playedAtMillis - previous);
+        previous = pending[i].playedAtMillis;
+    }
+    header.columnWidths[0] = putColumn(bytes, column);
+    for (size_t i = 0; i < pending.size(); i++) column[i] = pending[i].songRef;
+    header.columnWidths[1] = putColumn(bytes, column);
+    for (size_t i = 0; i < pending.size(); i++) column[i] = pending[i].listenedSeconds;
+    header.columnWidths[2] = putColumn(bytes, column);
+
+    header.byteLength = static_cast<std::uint32_t>(bytes.size() - header.byteOffset);
+    blocks.push_back(header);
+    pending.clear();
+}
+
+size_t CompressedHistory::firstBlockEndingAtOrAfter(std::int64_t millis) const {
+    auto it = std::lower_bound(blocks.begin(), blocks.end(), millis,
+                               [](const BlockHeader& header, std::int64_t value) { return header.lastMillis < value; });
+    return static_cast<size_t>(it - blocks.begin());
+}
+
+// Building
+void CompressedHistory::append(std::int64_t playedAtMillis, std::uint32_t songRef, int listenedSeconds) {
+    lastMillis = std::max(lastMillis, playedAtMillis);
+    pending.push_back(Event{lastMillis, songRef, static_cast<std::uint32_t>(std::max(0, listenedSeconds))});
+    eventCount++;
+    if (pending.size() == static_cast<size_t>(BLOCK_EVENTS)) {
+        sealBlock();
+    }
+}
+
+void CompressedHistory::finish() {
+    sealBlock();
+}
+
+void CompressedHistory::clear() {
+    blocks.clear();
+    bytes.clear();
+    pending.clear();
+    lastMillis = std::numeric_limits<std::int64_t>::min();
+    eventCount = 0;
+}
+
+CompressedHistory CompressedHistory::fromLog(const HistoryLog& log) {
+    CompressedHistory compressed;
+    log.for_each_between(std::numeric_limits<std::int64_t>::min(), std::numeric_limits<std::int64_t>::max(),
+                         [&compressed](std::uint64_t, const HistoryLog::LogRecord& record) {
+                             compressed.append(record.playedAtMillis, record.songRef, record.listenedSeconds);
+                         });
+    compressed.finish();
+    return compressed;
+}
+
+// Size
+size_t CompressedHistory::get_event_count() const {
+    return eventCount;
+}
+
+size_t CompressedHistory::get_block_count() const {
+    return blocks.size();
+}
+
+size_t CompressedHistory::get_encoded_bytes() const {
+    return bytes.size() + blocks.size() * sizeof(BlockHeader);
+}
+
+const CompressedHistory::BlockHeader& CompressedHistory::get_block_header(size_t block) const {
+    return blocks[block];
+}
+
+// Decoding
+size_t CompressedHistory::decode_block(size_t block, Event* out) const {
+    if (block >= blocks.size()) return 0;
+
+    const BlockHeader& header = blocks[block];
+    const std::uint8_t* in = bytes.data() + header.byteOffset;
+    size_t count = header.eventCount;
+
+    std::int64_t millis = header.firstMillis;
+    in = readColumn(in, count, header.columnWidths[0], [out, &millis](size_t i, std::uint64_t value) {
+        millis += static_cast<std::int64_t>(value);
+        out[i].playedAtMillis = millis;
+    });
+    in = readColumn(in, count, header.columnWidths[1], [out](size_t i, std::uint64_t value) {
+        out[i].songRef = static_cast<std::uint32_t>(value);
+    });
+    readColumn(in, count, header.columnWidths[2], [out](size_t i, std::uint64_t value) {
+        out[i].listenedSeconds = static_cast<std::uint32_t>(value);
+    });
+    return count;
+}
+
+// Persistence
+bool CompressedHistory::save_to_file(const std::string& filename) {
+    finish();
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cout << "Error: Could not open file " << filename << " for writing." << std::endl;
+        return false;
+    }
+    std::uint64_t sizes[2] = {blocks.size(), bytes.size()};
+    file.write(FILE_MAGIC, 4);
+    file.write(reinterpret_cast<const char*>(&FILE_VERSION), sizeof(FILE_VERSION));
+    file.write(reinterpret_cast<const char*>(sizes), sizeof(sizes));
+    file.write(reinterpret_cast<const char*>(blocks.data()),
+               static_cast<std::streamsize>(blocks.size() * sizeof(BlockHeader)));
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    return file.good();
+}
+
+bool CompressedHistory::load_from_file(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cout << "Error: Could not open file " << filename << " for reading." << std::endl;
+        return false;
+    }
+    char magic[4];
+    std::uint32_t version = 0;
+    std::uint64_t sizes[2] = {0, 0};
+    if (!file.read(magic, 4) || !std::equal(magic, magic + 4, FILE_MAGIC) ||
+        !file.read(reinterpret_cast<char*>(&version), sizeof(version)) || version != FILE_VERSION ||
+        !file.read(reinterpret_cast<char*>(sizes), sizeof(sizes))) {
+        std::cout << "Error: " << filename << " is not a compressed PlayWise history." << std::endl;
+        return false;
+    }
+
+    std::vector<BlockHeader> loadedBlocks(sizes[0]);
+    std::vector<std::uint8_t> loadedBytes(sizes[1]);
+    file.read(reinterpret_cast<char*>(loadedBlocks.data()),
+              static_cast<std::streamsize>(loadedBlocks.size() * sizeof(BlockHeader)));
+    file.read(reinterpret_cast<char*>(loadedBytes.data()), static_cast<std::streamsize>(loadedBytes.size()));
+    if (!file) {
+        std::cout << "Error: " << filename << " is truncated." << std::endl;
+        return false;
+    }
+
+    // Headers must tile the data in time order
+    size_t events = 0;
+    std::uint64_t offset = 0;
+    for (size_t i = 0; i < loadedBlocks.size(); i++) {
+        const BlockHeader& header = loadedBlocks[i];
+        bool valid = header.byteOffset == offset && header.eventCount > 0 &&
+                     header.eventCount <= static_cast<std::uint32_t>(BLOCK_EVENTS) &&
+                     offset + header.byteLength <= loadedBytes.size() && header.firstMillis <= header.lastMillis &&
+                     (i == 0 || loadedBlocks[i - 1].lastMillis <= header.firstMillis);
+        if (valid) {
+            // The three columns must fill the block exactly
+            const std::uint8_t* in = loadedBytes.data() + offset;
+            const std::uint8_t* end = in + header.byteLength;
+            for (int column = 0; valid && column < 3; column++) {
+                size_t length = columnLength(in, end, header.eventCount, header.columnWidths[column]);
+                valid = length > 0;
+                in += length;
+            }
+            valid = valid && in == end;
+        }
+        if (!valid) {
+            std::cout << "Error: " << filename << " has a corrupt block " << i << "." << std::endl;
+            return false;
+        }
+        offset += header.byteLength;
+        events += header.eventCount;
+    }
+
+    blocks.swap(loadedBlocks);
+    bytes.swap(loadedBytes);
+    pending.clear();
+    eventCount = events;
+    lastMillis = blocks.empty() ? std::numeric_limits<std::int64_t>::min() : blocks.back().lastMillis;
+    return true;
+}
+
+// Performance analysis
+void CompressedHistory::benchmarkCompression(int events) {
+    std::cout << "\n=== Compressed History Benchmark ===" << std::endl;
+
+    // Synthetic listener trace: sessions of 5-40 plays a few hours apart,
+    // Zipf-like song popularity over a 20,000 song catalogue, one play in
+    // four skipped early, a few seconds between plays in a session
+    const int catalogSize = 20000;
+    std::mt19937 random(42);
+    std::vector<Song> catalog;
+    catalog.reserve(catalogSize);
+    for (int i = 0; i < catalogSize; i++) {
+        catalog.emplace_back("song-" + std::to_string(i), "Track Title Number " + std::to_string(i),
+                             "Recording Artist " + std::to_string(i % 1500), 150 + static_cast<int>(random() % 210),
+                             static_cast<int>(random() % 6), "Album Name " + std::to_string(i / 12),
+                             i % 3 == 0 ? "Alternative Rock" : "Pop");
+    }
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    CompressedHistory compressed;
+    std::int64_t millis = 1500000000000LL;
+    int sessionLeft = 0;
+    for (int i = 0; i < events; i++) {
+        if (sessionLeft == 0) {
+            sessionLeft = 5 + static_cast<int>(random() % 36);
+            millis += (2 + static_cast<std::int64_t>(random() % 12)) * 3600 * 1000;
+        }
+        sessionLeft--;
+        std::uint32_t songRef = static_cast<std::uint32_t>(catalogSize * std::pow(unit(random), 3.0));
+        int duration = catalog[songRef].getDuration();
+        int listened = unit(random) < 0.25 ? 5 + static_cast<int>(random() % duration) : duration;
+        compressed.append(millis, songRef, listened);
+        millis += listened * 1000LL + static_cast<std::int64_t>(random() % 5000);
+    }
+    compressed.finish();
+
+    // What a Song copy per play costs: the object plus its heap-allocated strings
+    double songBytes = 0;
+    for (const Song& song : catalog) {
+        songBytes += sizeof(Song);
+        const std::string* fields[] = {&song.getId(), &song.getTitle(), &song.getArtist(),
+                                       &song.getAlbum(), &song.getGenre(), &song.getAddedDate()};
+        for (const std::string* field : fields) {
+            if (field->capacity() > 15) songBytes += field->capacity() + 1;
+        }
+    }
+    songBytes /= catalogSize;
+    double logBytes = sizeof(HistoryLog::LogRecord);
+    double blockBytes = static_cast<double>(compressed.get_encoded_bytes()) / events;
+
+    std::cout << "Plays: " << events << " (" << compressed.get_block_count() << " blocks of "
+              << BLOCK_EVENTS << ")" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << std::setw(28) << "Encoding" << std::setw(14) << "Bytes/play" << std::setw(14) << "Total MB"
+              << std::setw(14) << "vs Song" << std::endl;
+    std::cout << std::string(70, '-') << std::endl;
+    struct Row {
+        const char* name;
+        double bytesPerPlay;
+    };
+    Row rows[] = {{"Song copy per play", songBytes}, {"HistoryLog record", logBytes}, {"Packed blocks", blockBytes}};
+    for (const Row& row : rows) {
+        std::cout << std::setw(28) << row.name << std::setw(14) << row.bytesPerPlay << std::setw(14)
+                  << row.bytesPerPlay * events / (1024.0 * 1024.0) << std::setw(13) << songBytes / row.bytesPerPlay
+                  << "x" << std::endl;
+    }
+
+    // Full decode, repeated to get a stable figure
+    std::vector<Event> decoded(BLOCK_EVENTS);
+    std::uint64_t checksum = 0;
+    int rounds = 5;
+    auto begin = std::chrono::high_resolution_clock::now();
+    for (int round = 0; round < rounds; round++) {
+        for (size_t block = 0; block < compressed.get_block_count(); block++) {
+            size_t count = compressed.decode_block(block, decoded.data());
+            checksum += decoded[count - 1].songRef + decoded[count / 2].listenedSeconds;
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double seconds = std::chrono::duration<double>(end - begin).count();
+    std::cout << "Decode: " << std::setprecision(0) << (static_cast<double>(events) * rounds) / seconds
+              << " plays/s on one core (checksum " << checksum << ")" << std::endl;
+
+    // A month-long window touches only the blocks whose headers overlap it
+    std::int64_t to = millis;
+    std::int64_t from = to - 30LL * 24 * 3600 * 1000;
+    long long inWindow = 0;
+    begin = std::chrono::high_resolution_clock::now();
+    compressed.for_each_between(from, to, [&inWindow](const Event&) { inWindow++; });
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "Last 30 days: " << inWindow << " plays in " << std::setprecision(3)
+              << std::chrono::duration<double, std::milli>(end - begin).count() << " ms" << std::endl;
+    std::cout << std::endl;
+}
@@ -0,0 +1,245 @@
+#include "../include/concurrent_playlist.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Constructors
+ConcurrentPlaylist::ConcurrentPlaylist()
+    : current(std::make_shared<const PersistentPlaylist>()), commits(0), retries(0) {}
+
+ConcurrentPlaylist::ConcurrentPlaylist(const PersistentPlaylist& initial)
+    : current(std::make_shared<const PersistentPlaylist>(initial)), commits(0), retries(0) {}
+
+// Helper methods
+bool ConcurrentPlaylist::publish(Snapshot& expected, const PersistentPlaylist& next) {
+    Snapshot replacement = std::make_shared<const PersistentPlaylist>(next);
+    // On failure expected is reloaded with the version that won
+    if (std::atomic_compare_exchange_strong(&current, &expected, replacement)) {
+        commits.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    retries.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+// Reading
+ConcurrentPlaylist::Snapshot ConcurrentPlaylist::snapshot() const {
+    return std::atomic_load(&current);
+}
+
+int ConcurrentPlaylist::getSize() const {
+    return snapshot()->getSize();
+}
+
+// Editing
+bool ConcurrentPlaylist::apply(const Edit& edit) {
+    Snapshot base = snapshot();
+    while (true) {
+        PersistentPlaylist next;
+        if (!edit(*base, next)) return false;
+        if (publish(base, next)) return true;
+        std::this_thread::yield();
+    }
+}
+
+bool ConcurrentPlaylist::commit_if_unchanged(const Snapshot& base, const PersistentPlaylist& next) {
+    Snapshot expected = base;
+    return publish(expected, next);
+}
+
+bool ConcurrentPlaylist::insert_song_at(int position, SongHandle song) {
+    return apply([position, song](const PersistentPlaylist& version, PersistentPlaylist& next) {
+        if (position < 0 || position > version.getSize()) return false;
+        next = version.insert_song_at(position, song);
+        return true;
+    });
+}
+
+bool ConcurrentPlaylist::add_song(SongHandle song) {
+    return apply([song](const PersistentPlaylist& version, PersistentPlaylist& next) {
+        next = version.add_song(song);
+        return true;
+    });
+}
+
+bool ConcurrentPlaylist::delete_song(int position) {
+    return apply([position](const PersistentPlaylist& version, PersistentPlaylist& next) {
+        if (position < 0 || position >= version.getSize()) return false;
+        next = version.delete_song(position);
+        return true;
+    });
+}
+
+bool ConcurrentPlaylist::move_song(int fromIndex, int toIndex) {
+    return apply([fromIndex, toIndex](const PersistentPlaylist& version, PersistentPlaylist& next) {
+        int size = version.getSize();
+        if (fromIndex < 0 || fromIndex >= size || toIndex < 0 || toIndex >= size) return false;
+        next = version.move_song(fromIndex, toIndex);
+        return true;
+    });
+}
+
+// Statistics
+long long ConcurrentPlaylist::get_commit_count() const {
+    return commits.load(std::memory_order_relaxed);
+}
+
+long long ConcurrentPlaylist::get_retry_count() const {
+    return retries.load(std::memory_order_relaxed);
+}
+
+// Performance analysis
+void ConcurrentPlaylist::benchmarkConcurrentEdits(int playlistSize, int editsPerThread) {
+    std::cout << "\n=== Concurrent Edit Benchmark ===" << std::endl;
+    std::cout << "Playlist size: " << playlistSize << ", edits per writer: " << editsPerThread
+              << " (40% insert, 30% delete, 30% move), one snapshot reader" << std::endl;
+
+    std::vector<SongHandle> handles(playlistSize);
+    for (int i = 0; i < playlistSize; i++) {
+        handles[i] = static_cast<SongHandle>(i);
+    }
+
+    std::cout << std::setw(20) << "Method" << std::setw(10) << "Writers" << std::setw(15) << "Edits/s"
+              << std::setw(15) << "Retries" << std::setw(15) << "Snapshots" << std::setw(12) << "Consistent" << std::endl;
+    std::cout << std::string(87, '-') << std::endl;
+
+    const int writerCounts[] = {1, 2, 4, 8};
+    for (int writers : writerCounts) {
+        // Optimistic: copy-on-write versions published by compare-and-swap
+        {
+            ConcurrentPlaylist playlist(PersistentPlaylist::from_handles(handles));
+            std::atomic<bool> done(false);
+            std::atomic<long long> netInserted(0);
+            long long snapshots = 0;
+            bool consistent = true;
+
+            // Every snapshot must be a complete version: each handle appears once
+            std::thread reader([&]() {
+                std::vector<char> seen;
+                while (!done.load()) {
+                    Snapshot version = playlist.snapshot();
+                    std::vector<SongHandle> songs = version->to_handles();
+                    seen.assign(playlistSize + static_cast<size_t>(writers) * editsPerThread, 0);
+                    consistent = consistent && static_cast<int>(songs.size()) == version->getSize();
+                    for (SongHandle song : songs) {
+                        consistent = consistent && !seen[song];
+                        seen[song] = 1;
+                    }
+                    snapshots++;
+                }
+            });
+
+            auto start = std::chrono::high_resolution_clock::now();
+            std::vector<std::thread> threads;
+            for (int w = 0; w < writers; w++) {
+                threads.emplace_back([&, w]() {
+                    std::mt19937 rng(1000 + w);
+                    std::uniform_real_distribution<double> fraction(0.0, 1.0);
+                    SongHandle nextHandle = static_cast<SongHandle>(playlistSize + w * editsPerThread);
+                    for (int i = 0; i < editsPerThread; i++) {
+                        int kind = static_cast<int>(rng() % 10);
+                        double a = fraction(rng);
+                        double b = fraction(rng);
+                        if (kind < 4) {
+                            SongHandle song = nextHandle++;
+                            playlist.apply([a, song](const PersistentPlaylist& version, PersistentPlaylist& next) {
+                                next = version.insert_song_at(static_cast<int>(a * (version.getSize() + 1)), song);
+                                return true;
+                            });
+                            netInserted++;
+                        } else if (kind < 7) {
+                            if (playlist.apply([a](const PersistentPlaylist& version, PersistentPlaylist& next) {
+                                    if (version.isEmpty()) return false;
+                                    next = version.delete_song(static_cast<int>(a * version.getSize()));
+                                    return true;
+                                })) {
+                                netInserted--;
+                            }
+                        } else {
+                            playlist.apply([a, b](const PersistentPlaylist& version, PersistentPlaylist& next) {
+                                if (version.isEmpty()) return false;
+                                next = version.move_song(static_cast<int>(a * version.getSize()),
+                                                         static_cast<int>(b * version.getSize()));
+                                return true;
+                            });
+                        }
+                    }
+                });
+            }
+            for (std::thread& thread : threads) thread.join();
+            auto end = std::chrono::high_resolution_clock::now();
+            done = true;
+            reader.join();
+
+            consistent = consistent && playlist.getSize() == playlistSize + netInserted.load();
+            double seconds = std::chrono::duration<double>(end - start).count();
+            std::cout << std::setw(20) << "Optimistic (CAS)" << std::setw(10) << writers << std::setw(15)
+                      << static_cast<long long>(writers * editsPerThread / seconds) << std::setw(15)
+                      << playlist.get_retry_count() << std::setw(15) << snapshots << std::setw(12)
+                      << (consistent ? "yes" : "no") << std::endl;
+        }
+
+        // Baseline: one mutex around a linked Playlist; readers copy under the lock
+        {
+            Playlist playlist("Baseline");
+            for (int i = 0; i < playlistSize; i++) {
+                playlist.add_song(Song(std::to_string(i), "Song " + std::to_string(i), "Artist", 180, 3));
+            }
+            std::mutex lock;
+            std::atomic<bool> done(false);
+            long long snapshots = 0;
+
+            std::thread reader([&]() {
+                std::vector<std::string> ids;
+                while (!done.load()) {
+                    std::lock_guard<std::mutex> guard(lock);
+                    ids.clear();
+                    for (PlaylistNode* node = playlist.getHead(); node != nullptr; node = node->next) {
+                        ids.push_back(node->song.getId());
+                    }
+                    snapshots++;
+                }
+            });
+
+            auto start = std::chrono::high_resolution_clock::now();
+            std::vector<std::thread> threads;
+            for (int w = 0; w < writers; w++) {
+                threads.emplace_back([&, w]() {
+                    std::mt19937 rng(1000 + w);
+                    std::uniform_real_distribution<double> fraction(0.0, 1.0);
+                    int nextId = playlistSize + w * editsPerThread;
+                    for (int i = 0; i < editsPerThread; i++) {
+                        int kind = static_cast<int>(rng() % 10);
+                        double a = fraction(rng);
+                        double b = fraction(rng);
+                        Song song(std::to_string(nextId), "Song", "Artist", 180, 3);
+                        std::lock_guard<std::mutex> guard(lock);
+                        int size = playlist.getSize();
+                        if (kind < 4) {
+                            playlist.add_song_at(song, static_cast<int>(a * (size + 1)));
+                            nextId++;
+                        } else if (kind < 7) {
+                            if (size > 0) playlist.delete_song(static_cast<int>(a * size));
+                        } else if (size > 0) {
+                            playlist.move_song(static_cast<int>(a * size), static_cast<int>(b * size));
+                        }
+                    }
+                });
+            }
+            for (std::thread& thread : threads) thread.join();
+            auto end = std::chrono::high_resolution_clock::now();
+            done = true;
+            reader.join();
+
+            double seconds = std::chrono::duration<double>(end - start).count();
+            std::cout << std::setw(20) << "Global mutex" << std::setw(10) << writers << std::setw(15)
+                      << static_cast<long long>(writers * editsPerThread / seconds) << std::setw(15) << 0
+                      << std::setw(15) << snapshots << std::setw(12) << "-" << std::endl;
+        }
+    }
+    std::cout << std::endl;
+}
@@ -1,4 +1,6 @@
 #include "../include/dashboard.h"
+#include "../include/heavy_hitters.h"
+#include "../include/distinct_counts.h"
 #include <algorithm>
 #include <fstream>
 #include <iomanip>
@@ -7,12 +9,14 @@
 
 // Constructor
 Dashboard::Dashboard() : currentPlaylist(nullptr), playbackHistory(nullptr), 
-                                    ratingTree(nullptr), songDatabase(nullptr) {
+                                    ratingTree(nullptr), songDatabase(nullptr), playlistManager(nullptr),
+                                    playTrends(nullptr), playDistincts(nullptr) {
     stats = {0, 0, 0, 0.0, "", "", 0, 0.0, 0};
 }
 
 Dashboard::Dashboard(Playlist* playlist, History* history, RatingTree* tree, SongDatabase* db)
-    : currentPlaylist(playlist), playbackHistory(history), ratingTree(tree), songDatabase(db) {
+    : currentPlaylist(playlist), playbackHistory(history), ratingTree(tree), songDatabase(db),
+      playlistManager(nullptr), playTrends(nullptr), playDistincts(nullptr) {
     stats = {0, 0, 0, 0.0, "", "", 0, 0.0, 0};
     updateSystemStats();
 }
@@ -31,8 +35,9 @@ void Dashboard::updateSystemStats() {
         stats.totalSongs = songDatabase->get_size();
     }
     
-    // Update total playlists (assuming 1 for now)
-    stats.totalPlaylists = 1;
+    // Update total playlists: the current playlist plus the saved library
+    stats.totalPlaylists = (currentPlaylist ? 1 : 0) +
+                           (playlistManager ? playlistManager->get_playlist_count() : 0);
     
     // Update total play time
     stats.totalPlayTime = calculateTotalPlayTime();
@@ -58,7 +63,8 @@ void Dashboard::updateSystemStats() {
     stats.memoryUsage = sizeof(Dashboard) + 
                        (songDatabase ? songDatabase->get_size() * sizeof(Song) : 0) +
                        (playbackHistory ? playbackHistory->get_size() * sizeof(Song) : 0) +
-                       (ratingTree ? ratingTree->get_total_songs() * sizeof(Song) : 0);
+                       (ratingTree ? ratingTree->get_total_songs() * sizeof(Song) : 0) +
+                       (playlistManager ? playlistManager->get_total_memory() : 0);
 }
 
 std::vector<Song> Dashboard::getTopLongestSongs(int count) const {
@@ -91,25 +97,20 @@ std::vector<Song> Dashboard::getMostRecentlyPlayed(int count) const {
 }
 
 std::map<int, int> Dashboard::getSongCountByRating() const {
-    std::map<int, int> ratingCounts;
-    
-    if (songDatabase) {
-        std::vector<Song> allSongs = songDatabase->get_all_songs();
-        for (const Song& song : allSongs) {
-            ratingCounts[song.getRating()]++;
-        }
-    }
-    
-    return ratingCounts;
+    if (!songDatabase) return std::map<int, int>();
+    return songDatabase->get_stats().getRatingCounts();
 }
 
 std::map<std::string, int> Dashboard::getArtistPlayCount() const {
     std::map<std::string, int> artistCounts;
     
-    if (songDatabase) {
-        std::vector<Song> allSongs = songDatabase->get_all_songs();
-        for (const Song& song : allSongs) {
-            artistCounts[song.getArtist()]++;
+    if (playbackHistory) {
+        // One entry per distinct song in the history, resolved to its latest play
+        for (const auto& entry : playbackHistory->get_most_played(playbackHistory->get_size())) {
+            const Song* song = playbackHistory->get_recent_song(playbackHistory->get_last_played_age(entry.first));
+            if (song) {
+                artistCounts[song->getArtist()] += entry.second;
+            }
         }
     }
     
@@ -117,58 +118,47 @@ std::map<std::string, int> Dashboard::getArtistPlayCount() const {
 }
 
 std::string Dashboard::getMostPlayedArtist() const {
-    auto artistCounts = getArtistPlayCount();
-    
-    if (artistCounts.empty()) return "None";
-    
-    auto maxElement = std::max_element(artistCounts.begin(), artistCounts.end(),
-                                      [](const auto& a, const auto& b) {
-                                          return a.second < b.second;
-                                      });
-    
-    return maxElement->first;
+    // Heavy hitters also count plays the bounded history has evicted
+    if (playTrends && playTrends->get_play_count(PlayTrends::ALL_TIME) > 0) {
+        return playTrends->top_artists(1, PlayTrends::ALL_TIME).front().key;
+    }
+    
+    std::map<std::string, int> artistCounts = getArtistPlayCount();
+    std::string topArtist = "None";
+    int topPlays = 0;
+    for (const auto& entry : artistCounts) {
+        if (entry.second > topPlays) {
+            topArtist = entry.first;
+            topPlays = entry.second;
+        }
+    }
+    return topArtist;
 }
 
 std::string Dashboard::getMostPlayedSong() const {
+    if (playTrends && playTrends->get_play_count(PlayTrends::ALL_TIME) > 0) {
+        std::string songId = playTrends->top_songs(1, PlayTrends::ALL_TIME).front().key;
+        const Song* song = songDatabase ? songDatabase->search_by_id(songId) : nullptr;
+        return song ? song->getTitle() : songId;
+    }
+    
     if (!playbackHistory || playbackHistory->is_empty()) {
         return "None";
     }
     
-    // Get the most recent song as a proxy for most played
-    Song lastSong = playbackHistory->get_last_played();
-    return lastSong.getTitle();
+    auto mostPlayed = playbackHistory->get_most_played(1);
+    const Song* song = playbackHistory->get_recent_song(playbackHistory->get_last_played_age(mostPlayed.front().first));
+    return song ? song->getTitle() : "None";
 }
 
 double Dashboard::calculateAverageRating() const {
     if (!songDatabase) return 0.0;
-    
-    std::vector<Song> allSongs = songDatabase->get_all_songs();
-    if (allSongs.empty()) return 0.0;
-    
-    double totalRating = 0.0;
-    int ratedSongs = 0;
-    
-    for (const Song& song : allSongs) {
-        if (song.getRating() > 0) {
-            totalRating += song.getRating();
-            ratedSongs++;
-        }
-    }
-    
-    return ratedSongs > 0 ? totalRating / ratedSongs : 0.0;
+    return songDatabase->get_stats().getAverageRating();
 }
 
 int Dashboard::calculateTotalPlayTime() const {
     if (!songDatabase) return 0;
-    
-    std::vector<Song> allSongs = songDatabase->get_all_songs();
-    int totalTime = 0;
-    
-    for (const Song& song : allSongs) {
-        totalTime += song.getDuration();
-    }
-    
-    return totalTime;
+    return static_cast<int>(songDatabase->get_stats().getTotalDuration());
 }
 
 // Core dashboard functions
@@ -233,14 +223,33 @@ void Dashboard::display_live_dashboard() const {
     std::cout << "+==============================================================+" << std::endl;
     std::cout << std::endl;
     
+    // Current playlist, from its running aggregates
+    if (currentPlaylist) {
+        const SongStats& playlistStats = currentPlaylist->get_stats();
+        std::cout << "CURRENT PLAYLIST (" << currentPlaylist->getName() << "):" << std::endl;
+        std::cout << "  Songs: " << playlistStats.getSongCount()
+                  << ", Play Time: " << playlistStats.getTotalDuration() / 60 << " min"
+                  << ", Average Rating: " << std::fixed << std::setprecision(2)
+                  << playlistStats.getAverageRating() << "/5" << std::endl;
+        auto playlistGenres = playlistStats.top_genres(3);
+        if (!playlistGenres.empty()) {
+            std::cout << "  Top Genres:";
+            for (const auto& genre : playlistGenres) {
+                std::cout << " " << (genre.first.empty() ? "(none)" : genre.first) << " (" << genre.second << ")";
+            }
+            std::cout << std::endl;
+        }
+        std::cout << std::endl;
+    }
+    
     // Top Artists
     std::cout << "TOP ARTISTS:" << std::endl;
-    auto artistCounts = getArtistPlayCount();
-    std::vector<std::pair<std::string, int>> artistList(artistCounts.begin(), artistCounts.end());
-    std::sort(artistList.begin(), artistList.end(),
-              [](const auto& a, const auto& b) { return a.second > b.second; });
+    std::vector<std::pair<std::string, int>> artistList;
+    if (songDatabase) {
+        artistList = songDatabase->get_stats().top_artists(5);
+    }
     
-    for (size_t i = 0; i < std::min(artistList.size(), size_t(5)); i++) {
+    for (size_t i = 0; i < artistList.size(); i++) {
         std::cout << "  " << (i + 1) << ". " << artistList[i].first 
                   << " (" << artistList[i].second << " songs)" << std::endl;
     }
@@ -283,6 +292,39 @@ void Dashboard::display_user_activity() const {
                       << " - " << recentSongs[i].getArtist() << " [" << recentSongs[i].getGenre() << "]" << std::endl;
         }
     }
+    
+    if (playDistincts) {
+        std::cout << "Distinct plays (estimated, +/- " << std::fixed << std::setprecision(1)
+                  << 100.0 * playDistincts->get_relative_error() << "%):" << std::endl;
+        for (PlayTrends::Window window : {PlayTrends::LAST_HOUR, PlayTrends::LAST_DAY, PlayTrends::LAST_WEEK,
+                                          PlayTrends::ALL_TIME}) {
+            std::cout << "  " << PlayTrends::windowName(window) << ": " << getDistinctSongs(window) << " songs, "
+                      << getDistinctArtists(window) << " artists, " << getDistinctListeners(window)
+                      << " listeners" << std::endl;
+        }
+    }
+    
+    if (playTrends) {
+        std::cout << "Trending (estimated plays +/- error bound):" << std::endl;
+        for (PlayTrends::Window window : {PlayTrends::LAST_HOUR, PlayTrends::LAST_DAY, PlayTrends::LAST_WEEK,
+                                          PlayTrends::ALL_TIME}) {
+            std::cout << "  " << PlayTrends::windowName(window) << " (" << playTrends->get_play_count(window)
+                      << " plays):" << std::endl;
+            for (const HeavyHitter& hitter : playTrends->top_songs(5, window)) {
+                const Song* song = songDatabase ? songDatabase->search_by_id(hitter.key) : nullptr;
+                std::cout << "    " << (song ? song->getTitle() : hitter.key) << ": " << hitter.count
+                          << " +/- " << hitter.errorBound << std::endl;
+            }
+            std::vector<HeavyHitter> artists = playTrends->top_artists(3, window);
+            if (!artists.empty()) {
+                std::cout << "    Artists:";
+                for (const HeavyHitter& hitter : artists) {
+                    std::cout << " " << hitter.key << " (" << hitter.count << " +/- " << hitter.errorBound << ")";
+                }
+                std::cout << std::endl;
+            }
+        }
+    }
     std::cout << std::endl;
 }
 
@@ -336,14 +378,11 @@ std::vector<Song> Dashboard::getTopSongs(int count, const std::string& criteria)
 }
 
 std::vector<std::string> Dashboard::getTopArtists(int count) const {
-    auto artistCounts = getArtistPlayCount();
-    std::vector<std::pair<std::string, int>> artistList(artistCounts.begin(), artistCounts.end());
-    std::sort(artistList.begin(), artistList.end(),
-              [](const auto& a, const auto& b) { return a.second > b.second; });
-    
     std::vector<std::string> topArtists;
-    for (size_t i = 0; i < std::min(artistList.size(), size_t(count)); i++) {
-        topArtists.push_back(artistList[i].first);
+    if (!songDatabase) return topArtists;
+    
+    for (const auto& artist : songDatabase->get_stats().top_artists(count)) {
+        topArtists.push_back(artist.first);
     }
     return topArtists;
 }
@@ -351,26 +390,28 @@ std::vector<std::string> Dashboard::getTopArtists(int count) const {
 std::vector<std::string> Dashboard::getTopGenres(int count) const {
     if (!songDatabase) return std::vector<std::string>();
     
-    std::map<std::string, int> genreCounts;
-    std::vector<Song> allSongs = songDatabase->get_all_songs();
-    
-    for (const Song& song : allSongs) {
-        if (!song.getGenre().empty()) {
-            genreCounts[song.getGenre()]++;
-        }
-    }
-    
-    std::vector<std::pair<std::string, int>> genreList(genreCounts.begin(), genreCounts.end());
-    std::sort(genreList.begin(), genreList.end(),
-              [](const auto& a, const auto& b) { return a.second > b.second; });
-    
+    // One extra in case songs without a genre rank among the top
     std::vector<std::string> topGenres;
-    for (size_t i = 0; i < std::min(genreList.size(), size_t(count)); i++) {
-        topGenres.push_back(genreList[i].first);
+    for (const auto& genre : songDatabase->get_stats().top_genres(count + 1)) {
+        if (!genre.first.empty() && static_cast<int>(topGenres.size()) < count) {
+            topGenres.push_back(genre.first);
+        }
     }
     return topGenres;
 }
 
+long long Dashboard::getDistinctSongs(PlayTrends::Window window) const {
+    return playDistincts ? playDistincts->distinct_songs(window) : 0;
+}
+
+long long Dashboard::getDistinctArtists(PlayTrends::Window window) const {
+    return playDistincts ? playDistincts->distinct_artists(window) : 0;
+}
+
+long long Dashboard::getDistinctListeners(PlayTrends::Window window) const {
+    return playDistincts ? playDistincts->distinct_listeners(window) : 0;
+}
+
 // Real-time monitoring
 void Dashboard::start_monitoring() {
     std::cout << "Starting real-time monitoring..." << std::endl;
@@ -479,6 +520,11 @@ void Dashboard::memory_usage_analysis() const {
         size_t historyMemory = playbackHistory->get_size() * sizeof(Song);
         std::cout << "  History Memory: " << historyMemory << " bytes" << std::endl;
     }
+    
+    if (playlistManager) {
+        std::cout << "  Playlist Library Memory: " << playlistManager->get_total_memory() 
+                  << " bytes (" << playlistManager->get_playlist_count() << " playlists)" << std::endl;
+    }
 }
 
 // Component setters
@@ -486,6 +532,9 @@ void Dashboard::setPlaylist(Playlist* playlist) { currentPlaylist = playlist; }
 void Dashboard::setHistory(History* history) { playbackHistory = history; }
 void Dashboard::setRatingTree(RatingTree* tree) { ratingTree = tree; }
 void Dashboard::setSongDatabase(SongDatabase* db) { songDatabase = db; }
+void Dashboard::setPlaylistManager(PlaylistManager* manager) { playlistManager = manager; }
+void Dashboard::setPlayTrends(PlayTrends* trends) { playTrends = trends; }
+void Dashboard::setPlayDistincts(PlayDistincts* distincts) { playDistincts = distincts; }
 
 // Utility functions
 void Dashboard::clear() {
@@ -493,6 +542,9 @@ void Dashboard::clear() {
     playbackHistory = nullptr;
     ratingTree = nullptr;
     songDatabase = nullptr;
+    playlistManager = nullptr;
+    playTrends = nullptr;
+    playDistincts = nullptr;
     stats = {0, 0, 0, 0.0, "", "", 0, 0.0, 0};
 }
 
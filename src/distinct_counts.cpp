@@ -0,0 +1,317 @@
+#include "../include/distinct_counts.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <unordered_set>
+
+static const PlayTrends::Window SLIDING_WINDOWS[3] = {PlayTrends::LAST_HOUR, PlayTrends::LAST_DAY,
+                                                      PlayTrends::LAST_WEEK};
+
+// Registers per vector block; every register count is a multiple of it
+static const size_t LANES = 16;
+
+static int leadingZeros(std::uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return value == 0 ? 64 : __builtin_clzll(value);
+#else
+    int zeros = 0;
+    for (std::uint64_t bit = 1ULL << 63; bit != 0 && !(value & bit); bit >>= 1) zeros++;
+    return zeros;
+#endif
+}
+
+// ===== HyperLogLog =====
+
+HyperLogLog::HyperLogLog(int precision)
+    : precision(std::max(MIN_PRECISION, std::min(MAX_PRECISION, precision))),
+      registers(static_cast<size_t>(1) << this->precision, 0) {}
+
+void HyperLogLog::add(std::uint64_t hash) {
+    size_t slot = static_cast<size_t>(hash >> (64 - precision));
+    std::uint64_t rest = hash << precision;
+    std::uint8_t rank = static_cast<std::uint8_t>(rest == 0 ? 64 - precision + 1 : leadingZeros(rest) + 1);
+    if (rank > registers[slot]) registers[slot] = rank;
+}
+
+void HyperLogLog::add(const std::string& key) {
+    add(CountMinSketch::hashKey(key));
+}
+
+bool HyperLogLog::merge(const HyperLogLog& other) {
+    if (other.precision != precision) {
+        std::cout << "Error: Cannot merge HyperLogLogs of precision " << precision << " and "
+                  << other.precision << std::endl;
+        return false;
+    }
+    // Fixed 16-byte blocks through a local buffer: the compiler needs no
+    // aliasing check to turn the max into one vector instruction per block
+    std::uint8_t* mine = registers.data();
+    const std::uint8_t* theirs = other.registers.data();
+    for (size_t i = 0; i < registers.size(); i += LANES) {
+        std::uint8_t block[LANES];
+        for (size_t j = 0; j < LANES; j++) {
+            block[j] = std::max(mine[i + j], theirs[i + j]);
+        }
+        std::memcpy(mine + i, block, LANES);
+    }
+    return true;
+}
+
+void HyperLogLog::clear() {
+    std::fill(registers.begin(), registers.end(), 0);
+}
+
+long long HyperLogLog::estimate() const {
+    // 2^-register is built directly as a float (exponent 127 - register), so
+    // each lane is a subtract, a shift and an add; lanes are flushed into a
+    // double every 256 registers to keep the float sums exact enough
+    const std::uint8_t* values = registers.data();
+    double sum = 0.0;
+    std::uint32_t zeros = 0;
+    for (size_t i = 0; i < registers.size(); i += 256) {
+        float lanes[LANES] = {0.0f};
+        size_t end = std::min(i + 256, registers.size());
+        for (size_t k = i; k < end; k += LANES) {
+            for (size_t j = 0; j < LANES; j++) {
+                std::uint32_t bits = static_cast<std::uint32_t>(127 - values[k + j]) << 23;
+                float term;
+                std::memcpy(&term, &bits, sizeof(term));
+                lanes[j] += term;
+                zeros += values[k + j] == 0;
+            }
+        }
+        for (float lane : lanes) sum += lane;
+    }
+
+    double m = static_cast<double>(registers.size());
+    double alpha = registers.size() == 16 ? 0.673
+                 : registers.size() == 32 ? 0.697
+                 : registers.size() == 64 ? 0.709
+                 : 0.7213 / (1.0 + 1.079 / m);
+    double raw = alpha * m * m / sum;
+    if (raw <= 2.5 * m && zeros > 0) {
+        // Small range: linear counting over the empty registers
+        raw = m * std::log(m / static_cast<double>(zeros));
+    }
+    return std::llround(raw);
+}
+
+bool HyperLogLog::is_empty() const {
+    return std::all_of(registers.begin(), registers.end(), [](std::uint8_t value) { return value == 0; });
+}
+
+int HyperLogLog::get_precision() const { return precision; }
+size_t HyperLogLog::get_register_count() const { return registers.size(); }
+
+double HyperLogLog::get_relative_error() const {
+    return 1.04 / std::sqrt(static_cast<double>(registers.size()));
+}
+
+// ===== PlayDistincts =====
+
+PlayDistincts::Sketches::Sketches(int precision) : songs(precision), artists(precision), listeners(precision) {}
+
+void PlayDistincts::Sketches::clear() {
+    songs.clear();
+    artists.clear();
+    listeners.clear();
+}
+
+PlayDistincts::PlayDistincts(int precision, int userPrecision)
+    : precision(HyperLogLog(precision).get_precision()), userPrecision(HyperLogLog(userPrecision).get_precision()),
+      nowMillis(TimeBucketRing<Sketches>::NO_BUCKET), allTime(precision) {
+    initWindows();
+}
+
+// Helper methods
+void PlayDistincts::initWindows() {
+    for (int w = 0; w < 3; w++) {
+        windows[w] = TimeBucketRing<Sketches>(PlayTrends::bucketMillisOf(SLIDING_WINDOWS[w]),
+                                              PlayTrends::bucketCountOf(SLIDING_WINDOWS[w]), Sketches(precision));
+    }
+}
+
+HyperLogLog PlayDistincts::mergedWindow(PlayTrends::Window window, HyperLogLog Sketches::*member) const {
+    if (window == PlayTrends::ALL_TIME) return allTime.*member;
+    HyperLogLog merged(precision);
+    windows[window].for_each_live([&merged, member](const Sketches& bucket) { merged.merge(bucket.*member); });
+    return merged;
+}
+
+// Recording
+void PlayDistincts::set_listener(const std::string& listener) {
+    this->listener = listener;
+}
+
+const std::string& PlayDistincts::get_listener() const {
+    return listener;
+}
+
+void PlayDistincts::record_play(const Song& song, std::int64_t playedAtMillis) {
+    record_play(song, listener, playedAtMillis);
+}
+
+void PlayDistincts::record_play(const Song& song, const std::string& listener, std::int64_t playedAtMillis) {
+    advance_to(playedAtMillis);
+    std::uint64_t songHash = CountMinSketch::hashKey(song.getId());
+    std::uint64_t artistHash = CountMinSketch::hashKey(song.getArtist());
+    std::uint64_t listenerHash = CountMinSketch::hashKey(listener);
+
+    allTime.songs.add(songHash);
+    allTime.artists.add(artistHash);
+    allTime.listeners.add(listenerHash);
+    for (TimeBucketRing<Sketches>& window : windows) {
+        Sketches* current = window.bucket_for(playedAtMillis);
+        if (!current) continue;
+        current->songs.add(songHash);
+        current->artists.add(artistHash);
+        current->listeners.add(listenerHash);
+    }
+
+    auto it = listenerSongs.find(listener);
+    if (it == listenerSongs.end()) {
+        it = listenerSongs.emplace(listener, HyperLogLog(userPrecision)).first;
+    }
+    it->second.add(songHash);
+}
+
+void PlayDistincts::advance_to(std::int64_t nowMillis) {
+    this->nowMillis = std::max(this->nowMillis, nowMillis);
+    for (TimeBucketRing<Sketches>& window : windows) {
+        window.advance(this->nowMillis, [](Sketches& reused) { reused.clear(); });
+    }
+}
+
+void PlayDistincts::clear() {
+    nowMillis = TimeBucketRing<Sketches>::NO_BUCKET;
+    allTime.clear();
+    listenerSongs.clear();
+    initWindows();
+}
+
+// HistoryListener
+void PlayDistincts::onPlayRecorded(const Song& song, int, std::int64_t playedAtMillis) {
+    record_play(song, playedAtMillis);
+}
+
+// Estimated distinct counts
+long long PlayDistincts::distinct_songs(PlayTrends::Window window) const {
+    return mergedWindow(window, &Sketches::songs).estimate();
+}
+
+long long PlayDistincts::distinct_artists(PlayTrends::Window window) const {
+    return mergedWindow(window, &Sketches::artists).estimate();
+}
+
+long long PlayDistincts::distinct_listeners(PlayTrends::Window window) const {
+    return mergedWindow(window, &Sketches::listeners).estimate();
+}
+
+long long PlayDistincts::listener_distinct_songs(const std::string& listener) const {
+    auto it = listenerSongs.find(listener);
+    return it == listenerSongs.end() ? 0 : it->second.estimate();
+}
+
+long long PlayDistincts::listeners_distinct_songs(const std::vector<std::string>& listeners) const {
+    HyperLogLog merged(userPrecision);
+    for (const std::string& name : listeners) {
+        auto it = listenerSongs.find(name);
+        if (it != listenerSongs.end()) merged.merge(it->second);
+    }
+    return merged.estimate();
+}
+
+HyperLogLog PlayDistincts::songs_sketch(PlayTrends::Window window) const {
+    return mergedWindow(window, &Sketches::songs);
+}
+
+double PlayDistincts::get_relative_error() const {
+    return allTime.songs.get_relative_error();
+}
+
+size_t PlayDistincts::get_memory_bytes() const {
+    size_t sketchBytes = static_cast<size_t>(1) << precision;
+    size_t buckets = 0;
+    for (const TimeBucketRing<Sketches>& window : windows) buckets += window.bucket_count();
+    return 3 * (buckets + 1) * sketchBytes + listenerSongs.size() * (static_cast<size_t>(1) << userPrecision);
+}
+
+// Performance analysis
+void PlayDistincts::benchmarkDistinctCounts(int events) {
+    std::cout << "\n=== Distinct Count Benchmark ===" << std::endl;
+    std::cout << "Events: " << events << " over a long-tailed catalog" << std::endl;
+
+    // Exact reference: a set of every song id seen
+    std::mt19937_64 random(42);
+    std::vector<std::uint64_t> hashes;
+    hashes.reserve(events);
+    std::unordered_set<std::uint64_t> exact;
+    for (int i = 0; i < events; i++) {
+        double u = std::uniform_real_distribution<double>(0.0, 1.0)(random);
+        std::uint64_t song = static_cast<std::uint64_t>(u * u * events);
+        hashes.push_back(CountMinSketch::hashKey("song-" + std::to_string(song)));
+        exact.insert(song);
+    }
+    size_t exactBytes = exact.size() * (sizeof(std::uint64_t) + 2 * sizeof(void*)) +
+                        exact.bucket_count() * sizeof(void*);
+    std::cout << "Exact distinct: " << exact.size() << " (hash set of about " << exactBytes / 1024 << " KB)"
+              << std::endl;
+
+    std::cout << std::setw(10) << "Precision" << std::setw(12) << "Bytes" << std::setw(12) << "Estimate"
+              << std::setw(10) << "Error%" << std::setw(10) << "Bound%" << std::setw(14) << "Merge ns"
+              << std::setw(14) << "Estimate ns" << std::endl;
+    std::cout << std::string(82, '-') << std::endl;
+
+    for (int precision : {10, 12, 14, 16}) {
+        HyperLogLog sketch(precision);
+        for (std::uint64_t hash : hashes) sketch.add(hash);
+        long long estimate = sketch.estimate();
+
+        HyperLogLog other(precision);
+        for (size_t i = 0; i < hashes.size(); i += 3) other.add(hashes[i] * 31);
+        const int rounds = 2000;
+        auto begin = std::chrono::high_resolution_clock::now();
+        HyperLogLog target(precision);
+        for (int i = 0; i < rounds; i++) target.merge(i % 2 ? sketch : other);
+        auto middle = std::chrono::high_resolution_clock::now();
+        volatile long long sink = 0;
+        for (int i = 0; i < rounds; i++) sink = sink + target.estimate();
+        auto end = std::chrono::high_resolution_clock::now();
+
+        double error = 100.0 * std::fabs(static_cast<double>(estimate) - exact.size()) / exact.size();
+        std::cout << std::setw(10) << precision << std::setw(12) << sketch.get_register_count() << std::setw(12)
+                  << estimate << std::setw(10) << std::fixed << std::setprecision(2) << error << std::setw(10)
+                  << 100.0 * sketch.get_relative_error() << std::setw(14) << std::setprecision(0)
+                  << std::chrono::duration<double, std::nano>(middle - begin).count() / rounds << std::setw(14)
+                  << std::chrono::duration<double, std::nano>(end - middle).count() / rounds << std::endl;
+    }
+
+    // Windowed recording over a simulated week of plays
+    PlayDistincts distincts;
+    std::vector<Song> catalog;
+    for (int i = 0; i < 5000; i++) {
+        catalog.emplace_back("distinct-" + std::to_string(i), "Distinct Song " + std::to_string(i),
+                             "Distinct Artist " + std::to_string(i % 400), 180, 3);
+    }
+    std::int64_t start = 1700000000000LL;
+    std::int64_t spacing = 7LL * 24 * 3600 * 1000 / std::max(1, events);
+    auto begin = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < events; i++) {
+        distincts.record_play(catalog[hashes[i] % catalog.size()], "listener-" + std::to_string(i % 50),
+                              start + i * spacing);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double seconds = std::chrono::duration<double>(end - begin).count();
+    std::cout << "\nWindowed recording: " << std::fixed << std::setprecision(0) << events / std::max(seconds, 1e-9)
+              << " plays/s in " << distincts.get_memory_bytes() / 1024 << " KB" << std::endl;
+    for (PlayTrends::Window window : {PlayTrends::LAST_HOUR, PlayTrends::LAST_DAY, PlayTrends::LAST_WEEK}) {
+        std::cout << "  " << PlayTrends::windowName(window) << ": " << distincts.distinct_songs(window)
+                  << " songs, " << distincts.distinct_artists(window) << " artists, "
+                  << distincts.distinct_listeners(window) << " listeners" << std::endl;
+    }
+    std::cout << std::endl;
+}
@@ -0,0 +1,332 @@
+#include "../include/edit_journal.h"
+#include <iostream>
+
+// Constructor
+EditJournal::EditJournal(Playlist* playlist, History* history, RatingTree* ratingTree, SongDatabase* database,
+                         FavoriteSongsQueue* favorites, size_t maxBytes)
+    : playlist(playlist), history(history), ratingTree(ratingTree), database(database), favorites(favorites),
+      maxBytes(maxBytes), usedBytes(0), undoSteps(0), redoSteps(0), groupDepth(0), groupStarted(false) {}
+
+// Helper methods
+size_t EditJournal::costOf(const JournalEntry& entry) {
+    const Song& song = entry.song;
+    return sizeof(JournalEntry) + song.getId().capacity() + song.getTitle().capacity() +
+           song.getArtist().capacity() + song.getAlbum().capacity() + song.getGenre().capacity() +
+           song.getAddedDate().capacity();
+}
+
+void EditJournal::record(JournalEntry&& entry) {
+    // A new edit makes the undone ones unreachable
+    for (const JournalEntry& undone : redoStack) usedBytes -= costOf(undone);
+    redoStack.clear();
+    redoSteps = 0;
+
+    entry.chained = groupDepth > 0 && groupStarted;
+    if (groupDepth > 0) groupStarted = true;
+    if (!entry.chained) undoSteps++;
+    usedBytes += costOf(entry);
+    undoStack.push_back(std::move(entry));
+    evictToCap();
+}
+
+void EditJournal::evictToCap() {
+    while (usedBytes > maxBytes && !undoStack.empty()) {
+        usedBytes -= costOf(undoStack.front());
+        if (!undoStack.front().chained) undoSteps--;
+        undoStack.pop_front();
+        // The rest of a partly dropped group becomes its own step
+        if (!undoStack.empty() && undoStack.front().chained) {
+            undoStack.front().chained = false;
+            undoSteps++;
+        }
+    }
+}
+
+bool EditJournal::applyRating(const std::string& songId, int rating) {
+    Song* song = database ? database->search_by_id(songId) : nullptr;
+    if (!song || rating < 0 || rating > Song::MAX_RATING) return false;
+
+    int oldRating = song->getRating();
+    if (oldRating > 0 && ratingTree) {
+        ratingTree->delete_song(songId, oldRating);
+    }
+    if (rating == 0) {
+        Song unrated = *song;
+        unrated.setRating(0);
+        database->update_song(unrated);
+    } else {
+        database->update_song_rating(songId, rating);
+        if (ratingTree) ratingTree->insert_song(*database->search_by_id(songId), rating);
+    }
+    return true;
+}
+
+bool EditJournal::playlistHolds(int position, const Song& song) const {
+    const Song* held = playlist ? playlist->get_song_at(position) : nullptr;
+    return held && held->getId() == song.getId();
+}
+
+bool EditJournal::applyForward(JournalEntry& entry) {
+    switch (entry.type) {
+        case JournalEntry::Type::PLAYLIST_INSERT:
+            if (!playlist || entry.position < 0 || entry.position > playlist->getSize()) return false;
+            playlist->add_song_at(entry.song, entry.position);
+            return true;
+        case JournalEntry::Type::PLAYLIST_DELETE:
+            return playlistHolds(entry.position, entry.song) && playlist->delete_song(entry.position);
+        case JournalEntry::Type::PLAYLIST_MOVE:
+            return playlistHolds(entry.position, entry.song) && playlist->move_song(entry.position, entry.toPosition);
+        case JournalEntry::Type::PLAYLIST_RATING:
+            return playlistHolds(entry.position, entry.song) &&
+                   playlist->set_song_rating(entry.position, entry.newValue);
+        case JournalEntry::Type::PLAYLIST_REVERSE:
+            if (!playlist || playlist->getSize() != entry.oldValue) return false;
+            playlist->reverse_playlist();
+            return true;
+        case JournalEntry::Type::SONG_RATING:
+            return applyRating(entry.song.getId(), entry.newValue);
+        case JournalEntry::Type::HISTORY_PLAY:
+            if (!history) return false;
+            history->record_play(entry.song, entry.playedAt, entry.newValue);
+            return true;
+        case JournalEntry::Type::FAVORITE_UPDATE:
+            if (!favorites) return false;
+            if (entry.newValue > 0 && entry.oldValue > 0) {
+                favorites->autoUpdateFromPlayback(entry.song, entry.newValue);
+            } else if (entry.newValue > 0) {
+                favorites->updateListeningTime(entry.song, entry.newValue);
+            } else if (entry.oldValue > 0) {
+                favorites->incrementPlayCount(entry.song);
+            } else {
+                favorites->addSong(entry.song);
+            }
+            return true;
+    }
+    return false;
+}
+
+bool EditJournal::applyInverse(const JournalEntry& entry) {
+    switch (entry.type) {
+        case JournalEntry::Type::PLAYLIST_INSERT:
+            return playlistHolds(entry.position, entry.song) && playlist->delete_song(entry.position);
+        case JournalEntry::Type::PLAYLIST_DELETE:
+            if (!playlist || entry.position > playlist->getSize()) return false;
+            playlist->add_song_at(entry.song, entry.position);
+            return true;
+        case JournalEntry::Type::PLAYLIST_MOVE:
+            return playlistHolds(entry.toPosition, entry.song) && playlist->move_song(entry.toPosition, entry.position);
+        case JournalEntry::Type::PLAYLIST_RATING:
+            return playlistHolds(entry.position, entry.song) &&
+                   playlist->set_song_rating(entry.position, entry.oldValue);
+        case JournalEntry::Type::PLAYLIST_REVERSE:
+            if (!playlist || playlist->getSize() != entry.oldValue) return false;
+            playlist->reverse_playlist();
+            return true;
+        case JournalEntry::Type::SONG_RATING:
+            return applyRating(entry.song.getId(), entry.oldValue);
+        case JournalEntry::Type::HISTORY_PLAY:
+            if (!history || history->is_empty() || history->get_last_played().getId() != entry.song.getId()) {
+                return false;
+            }
+            history->undo_last_play();
+            return true;
+        case JournalEntry::Type::FAVORITE_UPDATE:
+            if (!favorites) return false;
+            favorites->revertUpdate(entry.song, entry.newValue, entry.oldValue, entry.songWasNew);
+            return true;
+    }
+    return false;
+}
+
+// Journaled edits
+bool EditJournal::add_song(const Song& song) {
+    return playlist && add_song_at(song, playlist->getSize());
+}
+
+bool EditJournal::add_song_at(const Song& song, int position) {
+    JournalEntry entry{JournalEntry::Type::PLAYLIST_INSERT, position, 0, 0, 0, false, false, song, {}};
+    if (!applyForward(entry)) return false;
+    record(std::move(entry));
+    return true;
+}
+
+bool EditJournal::delete_song(int index) {
+    Song* song = playlist ? playlist->get_song_at(index) : nullptr;
+    if (!song) return false;
+    JournalEntry entry{JournalEntry::Type::PLAYLIST_DELETE, index, 0, 0, 0, false, false, *song, {}};
+    if (!applyForward(entry)) return false;
+    record(std::move(entry));
+    return true;
+}
+
+bool EditJournal::move_song(int fromIndex, int toIndex) {
+    Song* song = playlist ? playlist->get_song_at(fromIndex) : nullptr;
+    if (!song) return false;
+    if (fromIndex == toIndex) return playlist->move_song(fromIndex, toIndex);
+
+    // Only the id and title are needed to check and describe the move
+    Song moved;
+    moved.setId(song->getId());
+    moved.setTitle(song->getTitle());
+    JournalEntry entry{JournalEntry::Type::PLAYLIST_MOVE, fromIndex, toIndex, 0, 0, false, false,
+                       std::move(moved), {}};
+    if (!applyForward(entry)) return false;
+    record(std::move(entry));
+    return true;
+}
+
+bool EditJournal::set_song_rating(int index, int rating) {
+    Song* song = playlist ? playlist->get_song_at(index) : nullptr;
+    if (!song) return false;
+    Song rated;
+    rated.setId(song->getId());
+    rated.setTitle(song->getTitle());
+    JournalEntry entry{JournalEntry::Type::PLAYLIST_RATING, index, 0, song->getRating(), rating, false, false,
+                       std::move(rated), {}};
+    if (!applyForward(entry)) return false;
+    record(std::move(entry));
+    return true;
+}
+
+bool EditJournal::reverse_playlist() {
+    if (!playlist) return false;
+    JournalEntry entry{JournalEntry::Type::PLAYLIST_REVERSE, 0, 0, playlist->getSize(), 0, false, false, Song(), {}};
+    if (!applyForward(entry)) return false;
+    record(std::move(entry));
+    return true;
+}
+
+bool EditJournal::rate_song(const std::string& songId, int rating) {
+    Song* song = database ? database->search_by_id(songId) : nullptr;
+    if (!song) return false;
+    JournalEntry entry{JournalEntry::Type::SONG_RATING, 0, 0, song->getRating(), rating, false, false, *song, {}};
+    if (!applyForward(entry)) return false;
+    record(std::move(entry));
+    return true;
+}
+
+bool EditJournal::play_song(const Song& song, int listenedSeconds) {
+    if (!history) return false;
+    history->add_played_song(song, listenedSeconds);
+    JournalEntry entry{JournalEntry::Type::HISTORY_PLAY, 0, 0, 0, history->get_listened_seconds(0), false, false,
+                       song, history->get_play_time(0)};
+    record(std::move(entry));
+    return true;
+}
+
+bool EditJournal::update_favorite(const Song& song, int addedSeconds, bool countPlay) {
+    if (!favorites || addedSeconds < 0) return false;
+    JournalEntry entry{JournalEntry::Type::FAVORITE_UPDATE, 0, 0, countPlay ? 1 : 0, addedSeconds,
+                       !favorites->isInFavorites(song), false, song, {}};
+    if (!applyForward(entry)) return false;
+    record(std::move(entry));
+    return true;
+}
+
+// Grouping
+void EditJournal::begin_group() {
+    if (groupDepth++ == 0) groupStarted = false;
+}
+
+void EditJournal::end_group() {
+    if (groupDepth > 0) groupDepth--;
+}
+
+// Undo / redo
+bool EditJournal::undo() {
+    if (undoStack.empty()) return false;
+    bool more = true;
+    while (more && !undoStack.empty()) {
+        JournalEntry entry = std::move(undoStack.back());
+        undoStack.pop_back();
+        more = entry.chained;
+        if (!applyInverse(entry)) {
+            std::cout << "Error: Cannot undo '" << describe(entry)
+                      << "'; the data changed outside the journal. Journal cleared." << std::endl;
+            clear();
+            return false;
+        }
+        redoStack.push_back(std::move(entry));
+    }
+    undoSteps--;
+    redoSteps++;
+    return true;
+}
+
+bool EditJournal::redo() {
+    if (redoStack.empty()) return false;
+    do {
+        JournalEntry entry = std::move(redoStack.back());
+        redoStack.pop_back();
+        if (!applyForward(entry)) {
+            std::cout << "Error: Cannot redo '" << describe(entry)
+                      << "'; the data changed outside the journal. Journal cleared." << std::endl;
+            clear();
+            return false;
+        }
+        undoStack.push_back(std::move(entry));
+    } while (!redoStack.empty() && redoStack.back().chained);
+    redoSteps--;
+    undoSteps++;
+    return true;
+}
+
+bool EditJournal::can_undo() const { return !undoStack.empty(); }
+bool EditJournal::can_redo() const { return !redoStack.empty(); }
+int EditJournal::get_undo_count() const { return undoSteps; }
+int EditJournal::get_redo_count() const { return redoSteps; }
+
+std::string EditJournal::describe_undo() const {
+    return undoStack.empty() ? "" : describe(undoStack.back());
+}
+
+std::string EditJournal::describe_redo() const {
+    return redoStack.empty() ? "" : describe(redoStack.back());
+}
+
+// Memory
+void EditJournal::clear() {
+    undoStack.clear();
+    redoStack.clear();
+    usedBytes = 0;
+    undoSteps = 0;
+    redoSteps = 0;
+}
+
+size_t EditJournal::get_memory_bytes() const { return usedBytes; }
+size_t EditJournal::get_max_bytes() const { return maxBytes; }
+
+void EditJournal::set_max_bytes(size_t maxBytes) {
+    this->maxBytes = maxBytes;
+    // Undone edits go first: they are the least likely to be wanted
+    if (usedBytes > maxBytes) {
+        for (const JournalEntry& undone : redoStack) usedBytes -= costOf(undone);
+        redoStack.clear();
+        redoSteps = 0;
+    }
+    evictToCap();
+}
+
+std::string EditJournal::describe(const JournalEntry& entry) {
+    const std::string& title = entry.song.getTitle();
+    switch (entry.type) {
+        case JournalEntry::Type::PLAYLIST_INSERT:
+            return "add '" + title + "' at " + std::to_string(entry.position + 1);
+        case JournalEntry::Type::PLAYLIST_DELETE:
+            return "delete '" + title + "' from " + std::to_string(entry.position + 1);
+        case JournalEntry::Type::PLAYLIST_MOVE:
+            return "move '" + title + "' from " + std::to_string(entry.position + 1) + " to " +
+                   std::to_string(entry.toPosition + 1);
+        case JournalEntry::Type::PLAYLIST_RATING:
+        case JournalEntry::Type::SONG_RATING:
+            return "rate '" + title + "' " + std::to_string(entry.newValue) + " (was " +
+                   std::to_string(entry.oldValue) + ")";
+        case JournalEntry::Type::PLAYLIST_REVERSE:
+            return "reverse the playlist";
+        case JournalEntry::Type::HISTORY_PLAY:
+            return "play '" + title + "'";
+        case JournalEntry::Type::FAVORITE_UPDATE:
+            return "favorite update for '" + title + "'";
+    }
+    return "";
+}
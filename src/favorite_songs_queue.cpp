@@ -13,21 +13,34 @@ FavoriteSongsQueue::FavoriteSongsQueue() {
 
 // Helper function to generate song key
 std::string FavoriteSongsQueue::generateSongKey(const Song& song) const {
-    return song.getTitle() + "|||" + song.getArtist();
+    std::string key;
+    key.reserve(song.getTitle().size() + 3 + song.getArtist().size());
+    key.append(song.getTitle()).append("|||").append(song.getArtist());
+    return key;
+}
+
+// Starts tracking a song; false if it is already a favorite
+bool FavoriteSongsQueue::trackNewSong(const Song& song) {
+    std::string key = generateSongKey(song);
+    if (songListeningTime.find(key) != songListeningTime.end()) {
+        return false;
+    }
+    songListeningTime[key] = 0;
+    songPlayCount[std::move(key)] = 0;
+    return true;
 }
 
 // Add a song to favorites
 void FavoriteSongsQueue::addSong(const Song& song) {
-    std::string key = generateSongKey(song);
-    
-    // If song is not already in favorites, add it
-    if (songListeningTime.find(key) == songListeningTime.end()) {
-        songListeningTime[key] = 0;
-        songPlayCount[key] = 0;
-        
-        // Add to priority queue
-        SongWithDuration songWithDuration(song, 0, 0);
-        songQueue.push(songWithDuration);
+    // If song is not already in favorites, add it to the priority queue
+    if (trackNewSong(song)) {
+        songQueue.emplace(song, 0, 0);
+    }
+}
+
+void FavoriteSongsQueue::addSong(Song&& song) {
+    if (trackNewSong(song)) {
+        songQueue.emplace(std::move(song), 0, 0);
     }
 }
 
@@ -106,17 +119,16 @@ void FavoriteSongsQueue::rebuildQueue() {
     }
     
     // Rebuild queue with updated durations and counts
-    for (const SongWithDuration& songWithDuration : tempSongs) {
+    for (SongWithDuration& songWithDuration : tempSongs) {
         std::string key = generateSongKey(songWithDuration.song);
         
         int currentListeningTime = songListeningTime[key];
         int currentPlayCount = songPlayCount[key];
         
-        SongWithDuration updatedSong(songWithDuration.song, currentListeningTime, currentPlayCount);
-        newQueue.push(updatedSong);
+        newQueue.emplace(std::move(songWithDuration.song), currentListeningTime, currentPlayCount);
     }
     
-    songQueue = newQueue;
+    songQueue = std::move(newQueue);
 }
 
 // Get the top favorite song (most listened)
@@ -250,6 +262,33 @@ void FavoriteSongsQueue::autoUpdateFromPlayback(const Song& song, int playbackDu
     rebuildQueue();
 }
 
+void FavoriteSongsQueue::autoUpdateFromPlaybackBatch(const std::vector<std::pair<const Song*, int>>& plays) {
+    if (plays.empty()) return;
+    
+    for (const auto& play : plays) {
+        addSong(*play.first);
+        std::string key = generateSongKey(*play.first);
+        songListeningTime[key] += play.second;
+        songPlayCount[key]++;
+    }
+    
+    // One rebuild for the whole batch
+    rebuildQueue();
+}
+
+void FavoriteSongsQueue::revertUpdate(const Song& song, int seconds, int plays, bool untrack) {
+    if (untrack) {
+        removeSong(song);
+        return;
+    }
+    
+    std::string key = generateSongKey(song);
+    if (songListeningTime.find(key) == songListeningTime.end()) return;
+    songListeningTime[key] = std::max(0, songListeningTime[key] - seconds);
+    songPlayCount[key] = std::max(0, songPlayCount[key] - plays);
+    rebuildQueue();
+}
+
 // Sync with history - update favorites based on played songs
 void FavoriteSongsQueue::syncWithHistory(const std::vector<Song>& playedSongs) {
     // Count occurrences of each song in history
@@ -419,8 +458,7 @@ void FavoriteSongsQueue::importFavoritesFromFile(const std::string& filename) {
                 std::string artist = songInfo.substr(dashPos + 3);
                 
                 // Create a basic song object
-                Song newSong("", title, artist, 180, 3);
-                addSong(newSong);
+                addSong(Song("", std::move(title), std::move(artist), 180, 3));
             }
         }
     }
@@ -0,0 +1,385 @@
+#include "../include/heavy_hitters.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <unordered_set>
+
+// Window layout: bucket length and bucket count for the last hour, day and week
+static const std::int64_t MINUTE_MILLIS = 60LL * 1000;
+static const std::int64_t WINDOW_BUCKET_MILLIS[3] = {5 * MINUTE_MILLIS, 60 * MINUTE_MILLIS, 360 * MINUTE_MILLIS};
+static const int WINDOW_BUCKETS[3] = {12, 24, 28};
+
+// ===== SpaceSaving =====
+
+SpaceSaving::SpaceSaving(size_t capacity)
+    : capacity(std::max<size_t>(1, capacity)), total(0), minBucket(-1), maxBucket(-1) {}
+
+// Helper methods
+int SpaceSaving::newBucket(long long count, int prev, int next) {
+    int bucket;
+    if (!freeBuckets.empty()) {
+        bucket = freeBuckets.back();
+        freeBuckets.pop_back();
+    } else {
+        bucket = static_cast<int>(buckets.size());
+        buckets.emplace_back();
+    }
+    buckets[bucket] = Bucket{count, -1, prev, next};
+    if (prev != -1) buckets[prev].next = bucket; else minBucket = bucket;
+    if (next != -1) buckets[next].prev = bucket; else maxBucket = bucket;
+    return bucket;
+}
+
+void SpaceSaving::detach(int counter) {
+    Counter& entry = counters[counter];
+    Bucket& bucket = buckets[entry.bucket];
+    if (entry.prev != -1) counters[entry.prev].next = entry.next; else bucket.head = entry.next;
+    if (entry.next != -1) counters[entry.next].prev = entry.prev;
+
+    // Drop the bucket once its last counter leaves
+    if (bucket.head == -1) {
+        if (bucket.prev != -1) buckets[bucket.prev].next = bucket.next; else minBucket = bucket.next;
+        if (bucket.next != -1) buckets[bucket.next].prev = bucket.prev; else maxBucket = bucket.prev;
+        freeBuckets.push_back(entry.bucket);
+    }
+}
+
+void SpaceSaving::attach(int counter, int bucket) {
+    Counter& entry = counters[counter];
+    entry.bucket = bucket;
+    entry.prev = -1;
+    entry.next = buckets[bucket].head;
+    if (entry.next != -1) counters[entry.next].prev = counter;
+    buckets[bucket].head = counter;
+}
+
+void SpaceSaving::increment(int counter) {
+    int bucket = counters[counter].bucket;
+    long long target = counters[counter].count + 1;
+    int next = buckets[bucket].next;
+
+    if (next == -1 || buckets[next].count != target) {
+        if (buckets[bucket].head == counter && counters[counter].next == -1) {
+            // Alone in its bucket and no bucket at target: the bucket moves up
+            buckets[bucket].count = target;
+            counters[counter].count = target;
+            return;
+        }
+        next = newBucket(target, bucket, next);
+    }
+    detach(counter);
+    counters[counter].count = target;
+    attach(counter, next);
+}
+
+void SpaceSaving::add(const std::string& key) {
+    total++;
+    auto it = index.find(key);
+    if (it != index.end()) {
+        increment(it->second);
+        return;
+    }
+
+    if (counters.size() < capacity) {
+        int counter = static_cast<int>(counters.size());
+        counters.push_back(Counter{key, 1, 0, -1, -1, -1});
+        index.emplace(key, counter);
+        int bucket = (minBucket != -1 && buckets[minBucket].count == 1) ? minBucket : newBucket(1, -1, minBucket);
+        attach(counter, bucket);
+        return;
+    }
+
+    // Replace a counter with the smallest count; its count becomes the error
+    int victim = buckets[minBucket].head;
+    index.erase(counters[victim].key);
+    counters[victim].key = key;
+    counters[victim].error = counters[victim].count;
+    index.emplace(key, victim);
+    increment(victim);
+}
+
+void SpaceSaving::clear() {
+    total = 0;
+    counters.clear();
+    buckets.clear();
+    freeBuckets.clear();
+    index.clear();
+    minBucket = -1;
+    maxBucket = -1;
+}
+
+std::vector<HeavyHitter> SpaceSaving::top(int k) const {
+    std::vector<HeavyHitter> result;
+    if (k <= 0) return result;
+    result.reserve(std::min(static_cast<size_t>(k), counters.size()));
+    for (int bucket = maxBucket; bucket != -1; bucket = buckets[bucket].prev) {
+        for (int counter = buckets[bucket].head; counter != -1; counter = counters[counter].next) {
+            const Counter& entry = counters[counter];
+            result.push_back(HeavyHitter{entry.key, entry.count, entry.error});
+            if (static_cast<int>(result.size()) == k) return result;
+        }
+    }
+    return result;
+}
+
+HeavyHitter SpaceSaving::estimate(const std::string& key) const {
+    auto it = index.find(key);
+    if (it != index.end()) {
+        const Counter& entry = counters[it->second];
+        return HeavyHitter{key, entry.count, entry.error};
+    }
+    // Untracked: it was counted at most as often as the smallest counter
+    long long bound = (counters.size() == capacity && minBucket != -1) ? buckets[minBucket].count : 0;
+    return HeavyHitter{key, bound, bound};
+}
+
+std::vector<std::string> SpaceSaving::tracked_keys() const {
+    std::vector<std::string> keys;
+    keys.reserve(counters.size());
+    for (const Counter& entry : counters) keys.push_back(entry.key);
+    return keys;
+}
+
+long long SpaceSaving::get_total() const { return total; }
+size_t SpaceSaving::get_capacity() const { return capacity; }
+
+// ===== CountMinSketch =====
+
+CountMinSketch::CountMinSketch(int width, int depth)
+    : width(std::max(1, width)), depth(std::max(1, depth)), total(0),
+      cells(static_cast<size_t>(this->width) * this->depth, 0) {}
+
+size_t CountMinSketch::cellOf(int row, std::uint64_t hash) const {
+    // Double hashing: row i probes h1 + i * h2
+    std::uint64_t h1 = hash & 0xFFFFFFFFULL;
+    std::uint64_t h2 = (hash >> 32) | 1;
+    return static_cast<size_t>(row) * width + static_cast<size_t>((h1 + row * h2) % width);
+}
+
+void CountMinSketch::add(std::uint64_t hash) {
+    total++;
+    for (int row = 0; row < depth; row++) {
+        cells[cellOf(row, hash)]++;
+    }
+}
+
+long long CountMinSketch::estimate(std::uint64_t hash) const {
+    std::uint32_t smallest = std::numeric_limits<std::uint32_t>::max();
+    for (int row = 0; row < depth; row++) {
+        smallest = std::min(smallest, cells[cellOf(row, hash)]);
+    }
+    return smallest;
+}
+
+void CountMinSketch::subtract(const CountMinSketch& other) {
+    if (other.cells.size() != cells.size()) return;
+    for (size_t i = 0; i < cells.size(); i++) {
+        cells[i] -= other.cells[i];
+    }
+    total -= other.total;
+}
+
+void CountMinSketch::clear() {
+    std::fill(cells.begin(), cells.end(), 0);
+    total = 0;
+}
+
+long long CountMinSketch::get_total() const { return total; }
+double CountMinSketch::get_epsilon() const { return std::exp(1.0) / width; }
+double CountMinSketch::get_delta() const { return std::exp(-static_cast<double>(depth)); }
+
+long long CountMinSketch::error_bound() const {
+    return static_cast<long long>(std::ceil(get_epsilon() * total));
+}
+
+std::uint64_t CountMinSketch::hashKey(const std::string& key) {
+    // std::hash may be the identity on some platforms; mix it (splitmix64 finalizer)
+    std::uint64_t hash = std::hash<std::string>()(key);
+    hash ^= hash >> 30;
+    hash *= 0xBF58476D1CE4E5B9ULL;
+    hash ^= hash >> 27;
+    hash *= 0x94D049BB133111EBULL;
+    hash ^= hash >> 31;
+    return hash;
+}
+
+// ===== PlayTrends =====
+
+PlayTrends::TimeBucket::TimeBucket(int width, int depth, size_t counters)
+    : sketch(width, depth), candidates(counters) {}
+
+PlayTrends::PlayTrends(size_t counters, int sketchWidth, int sketchDepth, size_t rankedKeys)
+    : counters(std::max<size_t>(4, counters)), sketchWidth(std::max(16, sketchWidth)),
+      sketchDepth(std::max(1, sketchDepth)), rankedKeys(std::max<size_t>(1, rankedKeys)),
+      nowMillis(TimeBucketRing<TimeBucket>::NO_BUCKET) {
+    initTracker(songs);
+    initTracker(artists);
+}
+
+// Helper methods
+void PlayTrends::initTracker(Tracker& tracker) {
+    tracker.allTime = SpaceSaving(counters);
+    for (int w = 0; w < 3; w++) {
+        SlidingWindow& window = tracker.windows[w];
+        window.buckets = TimeBucketRing<TimeBucket>(WINDOW_BUCKET_MILLIS[w], WINDOW_BUCKETS[w],
+                                                    TimeBucket(sketchWidth, sketchDepth, counters / 4));
+        window.sketch = CountMinSketch(sketchWidth, sketchDepth);
+        window.ranked.clear();
+    }
+}
+
+void PlayTrends::advanceWindow(SlidingWindow& window, std::int64_t millis) {
+    bool expired = false;
+    window.buckets.advance(millis, [&window, &expired](TimeBucket& reused) {
+        if (reused.sketch.get_total() == 0) return;
+        window.sketch.subtract(reused.sketch);
+        reused.sketch.clear();
+        reused.candidates.clear();
+        expired = true;
+    });
+    if (expired) rerank(window);
+}
+
+void PlayTrends::rerank(SlidingWindow& window) {
+    std::unordered_set<std::string> keys;
+    window.buckets.for_each_live([&keys](const TimeBucket& bucket) {
+        if (bucket.sketch.get_total() == 0) return;
+        for (std::string& key : bucket.candidates.tracked_keys()) keys.insert(std::move(key));
+    });
+
+    window.ranked.clear();
+    for (const std::string& key : keys) {
+        window.ranked.push_back(HeavyHitter{key, window.sketch.estimate(CountMinSketch::hashKey(key)), 0});
+    }
+    auto byCount = [](const HeavyHitter& a, const HeavyHitter& b) {
+        return a.count != b.count ? a.count > b.count : a.key < b.key;
+    };
+    size_t keep = std::min(rankedKeys, window.ranked.size());
+    std::partial_sort(window.ranked.begin(), window.ranked.begin() + keep, window.ranked.end(), byCount);
+    window.ranked.resize(keep);
+}
+
+void PlayTrends::updateRanking(SlidingWindow& window, const std::string& key, long long estimate) {
+    std::vector<HeavyHitter>& ranked = window.ranked;
+    size_t position = 0;
+    while (position < ranked.size() && ranked[position].key != key) position++;
+
+    if (position == ranked.size()) {
+        if (ranked.size() < rankedKeys) {
+            ranked.push_back(HeavyHitter{key, estimate, 0});
+        } else if (estimate > ranked.back().count) {
+            position = ranked.size() - 1;
+            ranked[position] = HeavyHitter{key, estimate, 0};
+        } else {
+            return;
+        }
+    } else {
+        ranked[position].count = estimate;
+    }
+
+    // Counts only grow between expiries, so the key can only move up
+    while (position > 0 && ranked[position - 1].count < ranked[position].count) {
+        std::swap(ranked[position - 1], ranked[position]);
+        position--;
+    }
+}
+
+void PlayTrends::recordKey(Tracker& tracker, const std::string& key, std::int64_t playedAtMillis) {
+    tracker.allTime.add(key);
+    std::uint64_t hash = CountMinSketch::hashKey(key);
+    for (SlidingWindow& window : tracker.windows) {
+        TimeBucket* current = window.buckets.bucket_for(playedAtMillis);
+        if (!current) continue;
+
+        current->sketch.add(hash);
+        current->candidates.add(key);
+        window.sketch.add(hash);
+        updateRanking(window, key, window.sketch.estimate(hash));
+    }
+}
+
+std::vector<HeavyHitter> PlayTrends::top(const Tracker& tracker, int k, Window window) const {
+    if (window == ALL_TIME) return tracker.allTime.top(k);
+
+    const SlidingWindow& sliding = tracker.windows[window];
+    std::vector<HeavyHitter> result;
+    size_t count = std::min(static_cast<size_t>(std::max(0, k)), sliding.ranked.size());
+    result.reserve(count);
+    long long bound = sliding.sketch.error_bound();
+    for (size_t i = 0; i < count; i++) {
+        result.push_back(HeavyHitter{sliding.ranked[i].key, sliding.ranked[i].count, bound});
+    }
+    return result;
+}
+
+// Recording
+void PlayTrends::record_play(const Song& song, std::int64_t playedAtMillis) {
+    advance_to(playedAtMillis);
+    recordKey(songs, song.getId(), playedAtMillis);
+    recordKey(artists, song.getArtist(), playedAtMillis);
+}
+
+void PlayTrends::advance_to(std::int64_t nowMillis) {
+    this->nowMillis = std::max(this->nowMillis, nowMillis);
+    for (Tracker* tracker : {&songs, &artists}) {
+        for (SlidingWindow& window : tracker->windows) {
+            advanceWindow(window, this->nowMillis);
+        }
+    }
+}
+
+void PlayTrends::clear() {
+    nowMillis = TimeBucketRing<TimeBucket>::NO_BUCKET;
+    initTracker(songs);
+    initTracker(artists);
+}
+
+// HistoryListener
+void PlayTrends::onPlayRecorded(const Song& song, int, std::int64_t playedAtMillis) {
+    record_play(song, playedAtMillis);
+}
+
+// Queries
+std::vector<HeavyHitter> PlayTrends::top_songs(int k, Window window) const {
+    return top(songs, k, window);
+}
+
+std::vector<HeavyHitter> PlayTrends::top_artists(int k, Window window) const {
+    return top(artists, k, window);
+}
+
+long long PlayTrends::get_play_count(Window window) const {
+    if (window == ALL_TIME) return songs.allTime.get_total();
+    return songs.windows[window].sketch.get_total();
+}
+
+size_t PlayTrends::get_memory_bytes() const {
+    // Sketch cells dominate; counters are costed at a small string plus links
+    size_t sketchBytes = static_cast<size_t>(sketchWidth) * sketchDepth * sizeof(std::uint32_t);
+    size_t counterBytes = 96;
+    size_t perTracker = counters * counterBytes;
+    for (int w = 0; w < 3; w++) {
+        perTracker += (WINDOW_BUCKETS[w] + 1) * sketchBytes + WINDOW_BUCKETS[w] * (counters / 4) * counterBytes +
+                      rankedKeys * counterBytes;
+    }
+    return 2 * perTracker;
+}
+
+std::int64_t PlayTrends::bucketMillisOf(Window window) {
+    return window == ALL_TIME ? 0 : WINDOW_BUCKET_MILLIS[window];
+}
+
+int PlayTrends::bucketCountOf(Window window) {
+    return window == ALL_TIME ? 0 : WINDOW_BUCKETS[window];
+}
+
+const char* PlayTrends::windowName(Window window) {
+    switch (window) {
+        case LAST_HOUR: return "Last hour";
+        case LAST_DAY: return "Last day";
+        case LAST_WEEK: return "Last week";
+        case ALL_TIME: return "All time";
+    }
+    return "Unknown";
+}
@@ -1,78 +1,269 @@
 #include "../include/history.h"
+#include "../include/history_log.h"
 #include <fstream>
 #include <algorithm>
 #include <unordered_map>
+#include <unordered_set>
 
 // Constructor
-History::History() : maxSize(100) {}
+History::History() : start(0), held(0), maxSize(100), nextSequence(0), log(nullptr) {}
 
-History::History(int maxSize) : maxSize(maxSize) {
+History::History(int maxSize) : start(0), held(0), maxSize(maxSize), nextSequence(0), log(nullptr) {
     if (maxSize <= 0) {
         this->maxSize = 100;  // Default value
     }
 }
 
-// Core operations
-void History::add_played_song(const Song& song) {
-    // Check if we need to remove oldest songs to maintain max size
-    if (playbackHistory.size() >= static_cast<size_t>(maxSize)) {
-        // Remove oldest songs by creating a temporary stack
-        std::stack<Song> tempStack;
-        size_t songsToKeep = static_cast<size_t>(maxSize) - 1;
-        
-        // Pop songs from original stack and push to temp (except the oldest)
-        for (size_t i = 0; i < songsToKeep; i++) {
-            tempStack.push(playbackHistory.top());
-            playbackHistory.pop();
+// Copy constructor
+History::History(const History& other) : log(nullptr) {
+    copyPlays(other);
+}
+
+// Assignment operator
+History& History::operator=(const History& other) {
+    if (this != &other) {
+        copyPlays(other);
+    }
+    return *this;
+}
+
+// The log stores wall-clock time; plays are stamped with the steady clock
+static std::int64_t toLogMillis(History::Clock::time_point playedAt) {
+    return HistoryLog::now_millis() +
+           std::chrono::duration_cast<std::chrono::milliseconds>(playedAt - History::Clock::now()).count();
+}
+
+static History::Clock::time_point fromLogMillis(std::int64_t millis) {
+    return History::Clock::now() + std::chrono::milliseconds(millis - HistoryLog::now_millis());
+}
+
+// Helper methods
+size_t History::slotOf(size_t age) const {
+    return (start + held - 1 - age) % ring.size();
+}
+
+size_t History::nextSlot() {
+    size_t slots = ring.size();
+    if (held < slots) {
+        // A slot freed by undo or removal
+        held++;
+        return (start + held - 1) % slots;
+    }
+    if (slots < static_cast<size_t>(maxSize)) {
+        // Still growing: keep the plays in order so the new slot goes last
+        if (start != 0) {
+            std::rotate(ring.begin(), ring.begin() + start, ring.end());
+            std::rotate(slotInfo.begin(), slotInfo.begin() + start, slotInfo.end());
+            start = 0;
         }
-        
-        // Clear the original stack
-        while (!playbackHistory.empty()) {
-            playbackHistory.pop();
+        ring.emplace_back();
+        slotInfo.emplace_back();
+        held++;
+        return slots;
+    }
+    // Full: the oldest slot becomes the newest
+    size_t slot = start;
+    unindexOldest(slot);
+    start = (start + 1) % slots;
+    return slot;
+}
+
+size_t History::playsBefore(Clock::time_point moment) const {
+    // Plays are in time order from the oldest slot, so search the logical order
+    size_t low = 0;
+    size_t high = held;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (slotInfo[(start + middle) % ring.size()].playedAt < moment) {
+            low = middle + 1;
+        } else {
+            high = middle;
         }
-        
-        // Push back the songs we want to keep (in reverse order)
-        while (!tempStack.empty()) {
-            playbackHistory.push(tempStack.top());
-            tempStack.pop();
+    }
+    return low;
+}
+
+void History::indexPlay(size_t slot, Clock::time_point playedAt, int listenedSeconds) {
+    PlayInfo& info = slotInfo[slot];
+    // Keep time order: a play never lands before the one it follows
+    if (held > 1) {
+        playedAt = std::max(playedAt, slotInfo[slotOf(1)].playedAt);
+    }
+    info.playedAt = playedAt;
+    info.listenedSeconds = listenedSeconds < 0 ? ring[slot].getDuration() : listenedSeconds;
+    info.logIndex = log ? log->append(ring[slot].getId(), toLogMillis(playedAt), info.listenedSeconds)
+                        : HistoryLog::NO_RECORD;
+    if (!listeners.empty()) {
+        std::int64_t playedAtMillis = toLogMillis(playedAt);
+        for (HistoryListener* listener : listeners) {
+            listener->onPlayRecorded(ring[slot], info.listenedSeconds, playedAtMillis);
         }
     }
     
-    playbackHistory.push(song);
+    std::uint64_t sequence = nextSequence++;
+    const std::string& songId = ring[slot].getId();
+    auto it = playIndex.find(songId);
+    if (it == playIndex.end()) {
+        if (spareRecord.node.empty()) {
+            it = playIndex.emplace(songId, PlayRecord{0, sequence}).first;
+        } else {
+            // Recycle the node of a song that left the history, so a full
+            // buffer cycling through songs does not allocate
+            spareRecord.node.key() = songId;
+            spareRecord.node.mapped() = PlayRecord{0, sequence};
+            it = playIndex.insert(std::move(spareRecord.node)).position;
+        }
+    }
+    PlayRecord& record = it->second;
+    // Link to the song's previous play so undo can restore it
+    info.previousPlay = record.lastSequence;
+    record.lastSequence = sequence;
+    record.plays++;
+}
+
+void History::unindexNewest(size_t slot) {
+    nextSequence--;
+    auto it = playIndex.find(ring[slot].getId());
+    if (it == playIndex.end()) return;
+    if (--it->second.plays == 0) {
+        spareRecord.node = playIndex.extract(it);
+    } else {
+        // Older plays of a song are evicted first, so the linked one is still held
+        it->second.lastSequence = slotInfo[slot].previousPlay;
+    }
+}
+
+void History::unindexOldest(size_t slot) {
+    auto it = playIndex.find(ring[slot].getId());
+    if (it == playIndex.end()) return;
+    if (--it->second.plays == 0) {
+        spareRecord.node = playIndex.extract(it);
+    }
+}
+
+void History::copyPlays(const History& other) {
+    ring = other.ring;
+    start = other.start;
+    held = other.held;
+    maxSize = other.maxSize;
+    playIndex = other.playIndex;
+    spareRecord = SpareRecord();
+    slotInfo = other.slotInfo;
+    nextSequence = other.nextSequence;
+    // The records belong to the other history's log; undo must not retract them
+    for (PlayInfo& info : slotInfo) {
+        info.logIndex = HistoryLog::NO_RECORD;
+    }
+}
+
+// Core operations
+void History::add_played_song(const Song& song, int listenedSeconds) {
+    record_play(song, Clock::now(), listenedSeconds);
+}
+
+void History::add_played_song(Song&& song, int listenedSeconds) {
+    record_play(std::move(song), Clock::now(), listenedSeconds);
+}
+
+void History::record_play(const Song& song, Clock::time_point playedAt, int listenedSeconds) {
+    size_t slot = nextSlot();
+    ring[slot] = song;
+    indexPlay(slot, playedAt, listenedSeconds);
+}
+
+void History::record_play(Song&& song, Clock::time_point playedAt, int listenedSeconds) {
+    size_t slot = nextSlot();
+    ring[slot] = std::move(song);
+    indexPlay(slot, playedAt, listenedSeconds);
 }
 
 Song History::undo_last_play() {
-    if (playbackHistory.empty()) {
+    if (held == 0) {
         // Return an empty song if history is empty
         return Song();
     }
     
-    Song lastSong = playbackHistory.top();
-    playbackHistory.pop();
+    size_t slot = slotOf(0);
+    if (log) {
+        log->retract(slotInfo[slot].logIndex);
+    }
+    unindexNewest(slot);
+    Song lastSong = std::move(ring[slot]);
+    held--;
     
     return lastSong;
 }
 
 Song History::get_last_played() const {
-    if (playbackHistory.empty()) {
+    if (held == 0) {
         return Song();
     }
-    return playbackHistory.top();
+    return ring[slotOf(0)];
+}
+
+const Song* History::get_recent_song(int k) const {
+    if (k < 0 || static_cast<size_t>(k) >= held) return nullptr;
+    return &ring[slotOf(k)];
+}
+
+HistoryView History::recent_view(int count) const {
+    return HistoryView(this, std::max(0, std::min(count, get_size())));
+}
+
+History::Clock::time_point History::get_play_time(int k) const {
+    if (k < 0 || static_cast<size_t>(k) >= held) return Clock::time_point();
+    return slotInfo[slotOf(k)].playedAt;
+}
+
+int History::get_listened_seconds(int k) const {
+    if (k < 0 || static_cast<size_t>(k) >= held) return 0;
+    return slotInfo[slotOf(k)].listenedSeconds;
+}
+
+// Time windows
+int History::count_plays_between(Clock::time_point from, Clock::time_point to) const {
+    if (!(from < to)) return 0;
+    return static_cast<int>(playsBefore(to) - playsBefore(from));
+}
+
+HistoryView History::plays_between(Clock::time_point from, Clock::time_point to) const {
+    if (!(from < to)) return HistoryView(this, 0);
+    size_t first = playsBefore(from);
+    size_t last = playsBefore(to);
+    // The newest play in the window is at logical index last - 1
+    return HistoryView(this, static_cast<int>(held - last), static_cast<int>(last - first));
+}
+
+PlayWindowStats History::window_stats(Clock::time_point from, Clock::time_point to) const {
+    PlayWindowStats stats = {0, 0, 0};
+    HistoryView window = plays_between(from, to);
+    std::unordered_set<std::string> songIds;
+    songIds.reserve(window.size());
+    for (int i = 0; i < window.size(); i++) {
+        stats.listenedSeconds += get_listened_seconds(window.age(i));
+        songIds.insert(window[i].getId());
+    }
+    stats.plays = window.size();
+    stats.distinctSongs = static_cast<int>(songIds.size());
+    return stats;
 }
 
 // Utility operations
 void History::clear_history() {
-    while (!playbackHistory.empty()) {
-        playbackHistory.pop();
-    }
+    ring.clear();
+    slotInfo.clear();
+    playIndex.clear();
+    start = 0;
+    held = 0;
+    nextSequence = 0;
 }
 
 int History::get_size() const {
-    return playbackHistory.size();
+    return static_cast<int>(held);
 }
 
 bool History::is_empty() const {
-    return playbackHistory.empty();
+    return held == 0;
 }
 
 int History::get_max_size() const {
@@ -81,15 +272,75 @@ int History::get_max_size() const {
 
 void History::set_max_size(int maxSize) {
     if (maxSize > 0) {
-        this->maxSize = maxSize;
-        
-        // If current size exceeds new max size, remove oldest songs
-        if (playbackHistory.size() > static_cast<size_t>(maxSize)) {
-            remove_oldest_songs(static_cast<int>(playbackHistory.size() - static_cast<size_t>(maxSize)));
+        // Re-pack the newest plays oldest first; only plays beyond a smaller
+        // limit are dropped
+        size_t keep = std::min(held, static_cast<size_t>(maxSize));
+        for (size_t age = held; age > keep; age--) {
+            unindexOldest(slotOf(age - 1));
+        }
+        std::vector<Song> packed;
+        std::vector<PlayInfo> packedInfo;
+        packed.reserve(keep);
+        packedInfo.reserve(keep);
+        for (size_t age = keep; age > 0; age--) {
+            size_t slot = slotOf(age - 1);
+            packed.push_back(std::move(ring[slot]));
+            packedInfo.push_back(slotInfo[slot]);
         }
+        ring.swap(packed);
+        slotInfo.swap(packedInfo);
+        start = 0;
+        held = keep;
+        this->maxSize = maxSize;
     }
 }
 
+// On-disk log
+void History::attach_log(HistoryLog* log) {
+    this->log = log;
+}
+
+HistoryLog* History::get_log() const {
+    return log;
+}
+
+// Stream consumers
+void History::add_listener(HistoryListener* listener) {
+    if (listener == nullptr) return;
+    if (std::find(listeners.begin(), listeners.end(), listener) == listeners.end()) {
+        listeners.push_back(listener);
+    }
+}
+
+void History::remove_listener(HistoryListener* listener) {
+    listeners.erase(std::remove(listeners.begin(), listeners.end(), listener), listeners.end());
+}
+
+int History::restore_tail_from_log() {
+    if (!log) return 0;
+    
+    std::vector<HistoryLog::LoggedPlay> plays = log->recent_plays(maxSize);
+    // Detach while reloading so the plays are not appended or counted a second time
+    HistoryLog* attached = log;
+    std::vector<HistoryListener*> attachedListeners;
+    attachedListeners.swap(listeners);
+    log = nullptr;
+    clear_history();
+    int restored = 0;
+    for (const HistoryLog::LoggedPlay& play : plays) {
+        const Song* song = attached->find_song(play.songId);
+        if (!song) continue;
+        size_t slot = nextSlot();
+        ring[slot] = *song;
+        indexPlay(slot, fromLogMillis(play.playedAtMillis), play.listenedSeconds);
+        slotInfo[slot].logIndex = play.index;
+        restored++;
+    }
+    log = attached;
+    listeners.swap(attachedListeners);
+    return restored;
+}
+
 // Display operations
 void History::display_history() const {
     std::cout << "\n=== Playback History ===" << std::endl;
@@ -100,23 +351,14 @@ void History::display_history() const {
         return;
     }
     
-    // Create a copy of the stack to display (since we can't iterate over stack directly)
-    std::stack<Song> tempStack = playbackHistory;
-    std::vector<Song> songs;
-    
-    // Pop all songs from temp stack and store in vector
-    while (!tempStack.empty()) {
-        songs.push_back(tempStack.top());
-        tempStack.pop();
-    }
-    
     // Display songs in chronological order (oldest first)
-    for (int i = songs.size() - 1; i >= 0; i--) {
-        std::cout << songs.size() - i << ". ";
-        std::cout << songs[i].getTitle() << " - " << songs[i].getArtist();
-        std::cout << " [" << songs[i].getGenre() << "] (" << songs[i].getDurationString() << ")";
-        if (songs[i].getRating() > 0) {
-            std::cout << " [Rating: " << songs[i].getRating() << "/5]";
+    for (int age = get_size() - 1; age >= 0; age--) {
+        const Song& song = ring[slotOf(age)];
+        std::cout << get_size() - age << ". ";
+        std::cout << song.getTitle() << " - " << song.getArtist();
+        std::cout << " [" << song.getGenre() << "] (" << song.getDurationString() << ")";
+        if (song.getRating() > 0) {
+            std::cout << " [Rating: " << song.getRating() << "/5]";
         }
         std::cout << std::endl;
     }
@@ -133,26 +375,14 @@ void History::display_recent_songs(int count) const {
         return;
     }
     
-    // Create a copy of the stack
-    std::stack<Song> tempStack = playbackHistory;
-    std::vector<Song> recentSongs;
-    
-    // Get the most recent songs
-    int actualCount = std::min(count, get_size());
-    for (int i = 0; i < actualCount; i++) {
-        if (!tempStack.empty()) {
-            recentSongs.push_back(tempStack.top());
-            tempStack.pop();
-        }
-    }
-    
     // Display in reverse order (most recent first)
-    for (size_t i = 0; i < recentSongs.size(); i++) {
-        std::cout << i + 1 << ". ";
-        std::cout << recentSongs[i].getTitle() << " - " << recentSongs[i].getArtist();
-        std::cout << " [" << recentSongs[i].getGenre() << "] (" << recentSongs[i].getDurationString() << ")";
-        if (recentSongs[i].getRating() > 0) {
-            std::cout << " [Rating: " << recentSongs[i].getRating() << "/5]";
+    int index = 1;
+    for (const Song& song : recent_view(count)) {
+        std::cout << index++ << ". ";
+        std::cout << song.getTitle() << " - " << song.getArtist();
+        std::cout << " [" << song.getGenre() << "] (" << song.getDurationString() << ")";
+        if (song.getRating() > 0) {
+            std::cout << " [Rating: " << song.getRating() << "/5]";
         }
         std::cout << std::endl;
     }
@@ -163,69 +393,60 @@ void History::display_recent_songs(int count) const {
 void History::remove_oldest_songs(int count) {
     if (count <= 0 || is_empty()) return;
     
-    int songsToRemove = std::min(count, get_size());
-    
-    // Create a temporary stack
-    std::stack<Song> tempStack;
-    int songsToKeep = get_size() - songsToRemove;
+    size_t songsToRemove = static_cast<size_t>(std::min(count, get_size()));
     
-    // Pop songs from original stack and push to temp (except the oldest ones)
-    for (int i = 0; i < songsToKeep; i++) {
-        tempStack.push(playbackHistory.top());
-        playbackHistory.pop();
-    }
-    
-    // Clear the original stack
-    while (!playbackHistory.empty()) {
-        playbackHistory.pop();
-    }
-    
-    // Push back the songs we want to keep (in reverse order)
-    while (!tempStack.empty()) {
-        playbackHistory.push(tempStack.top());
-        tempStack.pop();
+    // Advance past the oldest slots, releasing their songs
+    for (size_t i = 0; i < songsToRemove; i++) {
+        unindexOldest(start);
+        ring[start] = Song();
+        start = (start + 1) % ring.size();
     }
+    held -= songsToRemove;
 }
 
 bool History::contains_song(const std::string& songId) const {
-    std::stack<Song> tempStack = playbackHistory;
-    
-    while (!tempStack.empty()) {
-        if (tempStack.top().getId() == songId) {
-            return true;
-        }
-        tempStack.pop();
-    }
-    return false;
+    return playIndex.find(songId) != playIndex.end();
 }
 
 int History::get_song_play_count(const std::string& songId) const {
-    std::stack<Song> tempStack = playbackHistory;
-    int count = 0;
+    auto it = playIndex.find(songId);
+    return it != playIndex.end() ? it->second.plays : 0;
+}
+
+int History::get_last_played_age(const std::string& songId) const {
+    auto it = playIndex.find(songId);
+    if (it == playIndex.end()) return -1;
+    return static_cast<int>(nextSequence - 1 - it->second.lastSequence);
+}
+
+std::vector<std::pair<std::string, int>> History::get_most_played(int count) const {
+    std::vector<std::pair<std::string, int>> ranked;
+    if (count <= 0) return ranked;
     
-    while (!tempStack.empty()) {
-        if (tempStack.top().getId() == songId) {
-            count++;
-        }
-        tempStack.pop();
+    typedef std::unordered_map<std::string, PlayRecord>::const_iterator RecordIterator;
+    std::vector<RecordIterator> records;
+    records.reserve(playIndex.size());
+    for (auto it = playIndex.begin(); it != playIndex.end(); ++it) {
+        records.push_back(it);
+    }
+    auto byPlays = [](const RecordIterator& a, const RecordIterator& b) {
+        if (a->second.plays != b->second.plays) return a->second.plays > b->second.plays;
+        return a->second.lastSequence > b->second.lastSequence;
+    };
+    size_t keep = std::min(records.size(), static_cast<size_t>(count));
+    std::partial_sort(records.begin(), records.begin() + keep, records.end(), byPlays);
+    
+    ranked.reserve(keep);
+    for (size_t i = 0; i < keep; i++) {
+        ranked.emplace_back(records[i]->first, records[i]->second.plays);
     }
-    return count;
+    return ranked;
 }
 
 // Advanced features
 std::vector<Song> History::get_recent_songs(int count) const {
-    std::vector<Song> recentSongs;
-    std::stack<Song> tempStack = playbackHistory;
-    
-    int actualCount = std::min(count, get_size());
-    for (int i = 0; i < actualCount; i++) {
-        if (!tempStack.empty()) {
-            recentSongs.push_back(tempStack.top());
-            tempStack.pop();
-        }
-    }
-    
-    return recentSongs;
+    HistoryView recent = recent_view(count);
+    return std::vector<Song>(recent.begin(), recent.end());
 }
 
 void History::export_history_to_file(const std::string& filename) const {
@@ -244,20 +465,13 @@ void History::export_history_to_file(const std::string& filename) const {
     if (is_empty()) {
         file << "No playback history available." << std::endl;
     } else {
-        std::stack<Song> tempStack = playbackHistory;
-        std::vector<Song> songs;
-        
-        while (!tempStack.empty()) {
-            songs.push_back(tempStack.top());
-            tempStack.pop();
-        }
-        
-        for (int i = songs.size() - 1; i >= 0; i--) {
-            file << songs.size() - i << ". ";
-            file << songs[i].getTitle() << " - " << songs[i].getArtist();
-            file << " [" << songs[i].getGenre() << "] (" << songs[i].getDurationString() << ")";
-            if (songs[i].getRating() > 0) {
-                file << " [Rating: " << songs[i].getRating() << "/5]";
+        for (int age = get_size() - 1; age >= 0; age--) {
+            const Song& song = ring[slotOf(age)];
+            file << get_size() - age << ". ";
+            file << song.getTitle() << " - " << song.getArtist();
+            file << " [" << song.getGenre() << "] (" << song.getDurationString() << ")";
+            if (song.getRating() > 0) {
+                file << " [Rating: " << song.getRating() << "/5]";
             }
             file << std::endl;
         }
@@ -0,0 +1,451 @@
+#include "../include/history_log.h"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <thread>
+#include <unordered_set>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static_assert(sizeof(HistoryLog::LogRecord) == 16, "log records must stay 16 bytes");
+
+// Segment header: magic, format version, record size, records per segment
+static const char SEGMENT_MAGIC[4] = {'P', 'W', 'H', 'L'};
+static const std::uint32_t SEGMENT_VERSION = 1;
+static const size_t HEADER_SIZE = 16;
+
+/**
+ * @brief Read-only view of one segment's records for the life of a scan
+ */
+class MappedSegment {
+private:
+#ifdef _WIN32
+    std::vector<char> bytes;
+#else
+    void* address;
+    size_t length;
+#endif
+    const HistoryLog::LogRecord* first;
+    size_t count;
+
+public:
+    explicit MappedSegment(const std::string& path) : first(nullptr), count(0) {
+#ifdef _WIN32
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) return;
+        bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        if (bytes.size() < HEADER_SIZE) return;
+        first = reinterpret_cast<const HistoryLog::LogRecord*>(bytes.data() + HEADER_SIZE);
+        count = (bytes.size() - HEADER_SIZE) / sizeof(HistoryLog::LogRecord);
+#else
+        address = nullptr;
+        length = 0;
+        int descriptor = ::open(path.c_str(), O_RDONLY);
+        if (descriptor < 0) return;
+        struct stat info;
+        if (::fstat(descriptor, &info) == 0 && static_cast<size_t>(info.st_size) > HEADER_SIZE) {
+            length = static_cast<size_t>(info.st_size);
+            address = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+            if (address == MAP_FAILED) {
+                address = nullptr;
+                length = 0;
+            } else {
+                ::madvise(address, length, MADV_SEQUENTIAL);
+                first = reinterpret_cast<const HistoryLog::LogRecord*>(static_cast<const char*>(address) + HEADER_SIZE);
+                count = (length - HEADER_SIZE) / sizeof(HistoryLog::LogRecord);
+            }
+        }
+        ::close(descriptor);
+#endif
+    }
+
+    ~MappedSegment() {
+#ifndef _WIN32
+        if (address != nullptr) ::munmap(address, length);
+#endif
+    }
+
+    MappedSegment(const MappedSegment&) = delete;
+    MappedSegment& operator=(const MappedSegment&) = delete;
+
+    const HistoryLog::LogRecord* begin() const { return first; }
+    const HistoryLog::LogRecord* end() const { return first + count; }
+    size_t size() const { return count; }
+};
+
+// Records of a time-sorted range with from <= playedAtMillis < to
+static std::pair<const HistoryLog::LogRecord*, const HistoryLog::LogRecord*>
+recordsBetween(const HistoryLog::LogRecord* begin, const HistoryLog::LogRecord* end,
+               std::int64_t fromMillis, std::int64_t toMillis) {
+    auto before = [](const HistoryLog::LogRecord& record, std::int64_t millis) {
+        return record.playedAtMillis < millis;
+    };
+    const HistoryLog::LogRecord* low = std::lower_bound(begin, end, fromMillis, before);
+    const HistoryLog::LogRecord* high = std::lower_bound(low, end, toMillis, before);
+    return std::make_pair(low, high);
+}
+
+// Constructor and destructor
+HistoryLog::HistoryLog(const std::string& directory, SongDatabase* database,
+                       int recordsPerSegment, size_t bufferCapacity)
+    : directory(directory), database(database), recordsPerSegment(std::max(1, recordsPerSegment)),
+      bufferCapacity(std::max<size_t>(1, bufferCapacity)), savedSongIds(0), savedRecords(0),
+      lastMillis(0), openSegment(NO_RECORD), healthy(true) {
+    buffer.reserve(this->bufferCapacity);
+    openExisting();
+}
+
+HistoryLog::~HistoryLog() {
+    flush();
+}
+
+// Helper methods
+std::string HistoryLog::segmentPath(std::uint64_t segment) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "segment-%06llu.log", static_cast<unsigned long long>(segment));
+    return (std::filesystem::path(directory) / name).string();
+}
+
+std::string HistoryLog::dictionaryPath() const {
+    return (std::filesystem::path(directory) / "songs.dict").string();
+}
+
+void HistoryLog::openExisting() {
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (!std::filesystem::is_directory(directory, error)) {
+        std::cout << "Error: Could not open history log directory " << directory << std::endl;
+        healthy = false;
+        return;
+    }
+
+    std::ifstream dictionary(dictionaryPath());
+    std::string songId;
+    while (std::getline(dictionary, songId)) {
+        songRefs.emplace(songId, static_cast<std::uint32_t>(songIds.size()));
+        songIds.push_back(songId);
+    }
+    savedSongIds = songIds.size();
+
+    // An existing log keeps the segment size it was written with
+    std::uint64_t segments = 0;
+    while (std::filesystem::exists(segmentPath(segments), error)) segments++;
+    if (segments == 0) return;
+    std::ifstream header(segmentPath(0), std::ios::binary);
+    char magic[4];
+    std::uint32_t fields[3];
+    if (header.read(magic, 4) && header.read(reinterpret_cast<char*>(fields), sizeof(fields)) &&
+        std::equal(magic, magic + 4, SEGMENT_MAGIC) && fields[0] == SEGMENT_VERSION &&
+        fields[1] == sizeof(LogRecord) && fields[2] > 0) {
+        recordsPerSegment = static_cast<int>(fields[2]);
+    } else {
+        std::cout << "Error: " << segmentPath(0) << " is not a PlayWise history segment" << std::endl;
+        healthy = false;
+        return;
+    }
+
+    // Drop a torn record left by an interrupted write
+    std::string lastPath = segmentPath(segments - 1);
+    std::uintmax_t bytes = std::filesystem::file_size(lastPath, error);
+    std::uintmax_t records = bytes > HEADER_SIZE ? (bytes - HEADER_SIZE) / sizeof(LogRecord) : 0;
+    if (bytes > HEADER_SIZE && HEADER_SIZE + records * sizeof(LogRecord) != bytes) {
+        std::filesystem::resize_file(lastPath, HEADER_SIZE + records * sizeof(LogRecord), error);
+    }
+    savedRecords = (segments - 1) * static_cast<std::uint64_t>(recordsPerSegment) + records;
+
+    for (std::uint64_t segment = segments; segment > 0 && lastMillis == 0; segment--) {
+        MappedSegment mapped(segmentPath(segment - 1));
+        if (mapped.size() > 0) lastMillis = (mapped.end() - 1)->playedAtMillis;
+    }
+}
+
+bool HistoryLog::openSegmentForAppend(std::uint64_t segment) {
+    segmentOut.close();
+    segmentOut.clear();
+    std::string path = segmentPath(segment);
+    std::error_code error;
+    bool fresh = !std::filesystem::exists(path, error) || std::filesystem::file_size(path, error) < HEADER_SIZE;
+    segmentOut.open(path, fresh ? std::ios::binary | std::ios::trunc | std::ios::out
+                                : std::ios::binary | std::ios::app);
+    if (fresh && segmentOut.is_open()) {
+        std::uint32_t fields[3] = {SEGMENT_VERSION, static_cast<std::uint32_t>(sizeof(LogRecord)),
+                                   static_cast<std::uint32_t>(recordsPerSegment)};
+        segmentOut.write(SEGMENT_MAGIC, 4);
+        segmentOut.write(reinterpret_cast<const char*>(fields), sizeof(fields));
+    }
+    openSegment = segmentOut.good() ? segment : NO_RECORD;
+    return segmentOut.good();
+}
+
+std::uint32_t HistoryLog::songRefFor(const std::string& songId) {
+    auto it = songRefs.find(songId);
+    if (it != songRefs.end()) return it->second;
+    std::uint32_t songRef = static_cast<std::uint32_t>(songIds.size());
+    songRefs.emplace(songId, songRef);
+    songIds.push_back(songId);
+    return songRef;
+}
+
+std::uint64_t HistoryLog::segmentCount() const {
+    return (savedRecords + recordsPerSegment - 1) / recordsPerSegment;
+}
+
+// Writing
+std::uint64_t HistoryLog::append(const std::string& songId, std::int64_t playedAtMillis, int listenedSeconds) {
+    if (!healthy) return NO_RECORD;
+
+    lastMillis = std::max(lastMillis, playedAtMillis);
+    LogRecord record;
+    record.playedAtMillis = lastMillis;
+    record.songRef = songRefFor(songId);
+    record.listenedSeconds = static_cast<std::uint16_t>(std::max(0, std::min(listenedSeconds, 65535)));
+    record.flags = 0;
+    buffer.push_back(record);
+
+    std::uint64_t index = savedRecords + buffer.size() - 1;
+    if (buffer.size() >= bufferCapacity) {
+        flush();
+    }
+    return index;
+}
+
+bool HistoryLog::retract(std::uint64_t index) {
+    if (!healthy || index >= get_record_count()) return false;
+
+    if (index >= savedRecords) {
+        buffer[index - savedRecords].flags |= RETRACTED;
+        return true;
+    }
+
+    // Already on disk: flip the flag in place, the only write that is not an append
+    segmentOut.flush();
+    std::fstream file(segmentPath(index / recordsPerSegment), std::ios::binary | std::ios::in | std::ios::out);
+    if (!file.is_open()) return false;
+    std::streamoff offset = static_cast<std::streamoff>(HEADER_SIZE + (index % recordsPerSegment) * sizeof(LogRecord) +
+                                                        offsetof(LogRecord, flags));
+    std::uint16_t flags = 0;
+    file.seekg(offset);
+    file.read(reinterpret_cast<char*>(&flags), sizeof(flags));
+    flags |= RETRACTED;
+    file.seekp(offset);
+    file.write(reinterpret_cast<const char*>(&flags), sizeof(flags));
+    return file.good();
+}
+
+bool HistoryLog::flush() {
+    if (!healthy) return false;
+
+    // Dictionary lines go first so every saved record can be resolved
+    if (savedSongIds < songIds.size()) {
+        std::ofstream dictionary(dictionaryPath(), std::ios::app);
+        for (size_t i = savedSongIds; i < songIds.size(); i++) {
+            dictionary << songIds[i] << '\n';
+        }
+        if (!dictionary.good()) return false;
+        savedSongIds = songIds.size();
+    }
+
+    size_t written = 0;
+    while (written < buffer.size()) {
+        std::uint64_t segment = savedRecords / recordsPerSegment;
+        if (segment != openSegment && !openSegmentForAppend(segment)) break;
+        size_t room = static_cast<size_t>(recordsPerSegment - savedRecords % recordsPerSegment);
+        size_t chunk = std::min(room, buffer.size() - written);
+        segmentOut.write(reinterpret_cast<const char*>(buffer.data() + written),
+                         static_cast<std::streamsize>(chunk * sizeof(LogRecord)));
+        if (!segmentOut.good()) break;
+        written += chunk;
+        savedRecords += chunk;
+    }
+    segmentOut.flush();
+    buffer.erase(buffer.begin(), buffer.begin() + written);
+    return buffer.empty() && segmentOut.good();
+}
+
+// Reading
+bool HistoryLog::is_open() const {
+    return healthy;
+}
+
+std::uint64_t HistoryLog::get_record_count() const {
+    return savedRecords + buffer.size();
+}
+
+std::uint64_t HistoryLog::get_segment_count() const {
+    return segmentCount();
+}
+
+const std::string& HistoryLog::get_song_id(std::uint32_t songRef) const {
+    static const std::string unknown;
+    return songRef < songIds.size() ? songIds[songRef] : unknown;
+}
+
+Song* HistoryLog::find_song(const std::string& songId) const {
+    return database ? database->search_by_id(songId) : nullptr;
+}
+
+PlayWindowStats HistoryLog::window_stats(std::int64_t fromMillis, std::int64_t toMillis, int threadCount) const {
+    struct Partial {
+        int plays = 0;
+        long long listenedSeconds = 0;
+        std::unordered_set<std::uint32_t> songs;
+    };
+    auto scan = [fromMillis, toMillis](const LogRecord* begin, const LogRecord* end, Partial& partial) {
+        auto range = recordsBetween(begin, end, fromMillis, toMillis);
+        for (const LogRecord* record = range.first; record != range.second; ++record) {
+            if (record->flags & RETRACTED) continue;
+            partial.plays++;
+            partial.listenedSeconds += record->listenedSeconds;
+            partial.songs.insert(record->songRef);
+        }
+    };
+
+    std::uint64_t segments = segmentCount();
+    size_t threads = threadCount > 0 ? static_cast<size_t>(threadCount)
+                                     : std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<size_t>(std::max<std::uint64_t>(1, std::min<std::uint64_t>(threads, segments)));
+
+    // Thread t scans segments t, t + threads, ...
+    std::vector<Partial> partials(threads + 1);
+    auto scanSegments = [this, segments, threads, &partials, &scan](size_t worker) {
+        for (std::uint64_t segment = worker; segment < segments; segment += threads) {
+            MappedSegment mapped(segmentPath(segment));
+            scan(mapped.begin(), mapped.end(), partials[worker]);
+        }
+    };
+    if (threads == 1) {
+        scanSegments(0);
+    } else {
+        std::vector<std::thread> workers;
+        for (size_t worker = 0; worker < threads; worker++) {
+            workers.emplace_back(scanSegments, worker);
+        }
+        for (std::thread& worker : workers) worker.join();
+    }
+    scan(buffer.data(), buffer.data() + buffer.size(), partials[threads]);
+
+    PlayWindowStats stats = {0, 0, 0};
+    Partial& merged = partials[0];
+    for (size_t i = 1; i < partials.size(); i++) {
+        merged.plays += partials[i].plays;
+        merged.listenedSeconds += partials[i].listenedSeconds;
+        merged.songs.insert(partials[i].songs.begin(), partials[i].songs.end());
+    }
+    stats.plays = merged.plays;
+    stats.listenedSeconds = merged.listenedSeconds;
+    stats.distinctSongs = static_cast<int>(merged.songs.size());
+    return stats;
+}
+
+void HistoryLog::for_each_between(std::int64_t fromMillis, std::int64_t toMillis,
+                                  const std::function<void(std::uint64_t, const LogRecord&)>& visit) const {
+    std::uint64_t segments = segmentCount();
+    for (std::uint64_t segment = 0; segment < segments; segment++) {
+        MappedSegment mapped(segmentPath(segment));
+        if (mapped.size() == 0 || (mapped.end() - 1)->playedAtMillis < fromMillis) continue;
+        if (mapped.begin()->playedAtMillis >= toMillis) return;
+        auto range = recordsBetween(mapped.begin(), mapped.end(), fromMillis, toMillis);
+        std::uint64_t base = segment * recordsPerSegment;
+        for (const LogRecord* record = range.first; record != range.second; ++record) {
+            if (!(record->flags & RETRACTED)) visit(base + (record - mapped.begin()), *record);
+        }
+    }
+    auto range = recordsBetween(buffer.data(), buffer.data() + buffer.size(), fromMillis, toMillis);
+    for (const LogRecord* record = range.first; record != range.second; ++record) {
+        if (!(record->flags & RETRACTED)) visit(savedRecords + (record - buffer.data()), *record);
+    }
+}
+
+std::vector<HistoryLog::LoggedPlay> HistoryLog::recent_plays(int count) const {
+    std::vector<LoggedPlay> plays;
+    if (count <= 0) return plays;
+
+    auto take = [this, &plays, count](std::uint64_t index, const LogRecord& record) {
+        if (record.flags & RETRACTED) return true;
+        plays.push_back(LoggedPlay{index, get_song_id(record.songRef), record.playedAtMillis, record.listenedSeconds});
+        return static_cast<int>(plays.size()) < count;
+    };
+
+    // Newest first: the buffer, then segments from the last one back
+    bool more = true;
+    for (size_t i = buffer.size(); more && i > 0; i--) {
+        more = take(savedRecords + i - 1, buffer[i - 1]);
+    }
+    for (std::uint64_t segment = segmentCount(); more && segment > 0; segment--) {
+        MappedSegment mapped(segmentPath(segment - 1));
+        std::uint64_t base = (segment - 1) * recordsPerSegment;
+        for (size_t i = mapped.size(); more && i > 0; i--) {
+            more = take(base + i - 1, mapped.begin()[i - 1]);
+        }
+    }
+    std::reverse(plays.begin(), plays.end());
+    return plays;
+}
+
+std::int64_t HistoryLog::now_millis() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// Performance analysis
+void HistoryLog::benchmarkHistoryLog(int plays) {
+    std::cout << "\n=== History Log Benchmark ===" << std::endl;
+    std::cout << "Plays: " << plays << " over 500 songs, 64K records per segment" << std::endl;
+
+    std::string directory = (std::filesystem::temp_directory_path() / "playwise_history_benchmark").string();
+    std::error_code error;
+    std::filesystem::remove_all(directory, error);
+
+    std::vector<std::string> songIds;
+    for (int i = 0; i < 500; i++) songIds.push_back("bench-song-" + std::to_string(i));
+    const std::int64_t start = 1600000000000LL;  // one play a minute from September 2020
+
+    std::cout << std::fixed << std::setprecision(2);
+    {
+        HistoryLog log(directory, nullptr, 1 << 16);
+        auto begin = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < plays; i++) {
+            log.append(songIds[(i * 7) % songIds.size()], start + i * 60000LL, 180);
+        }
+        log.flush();
+        auto end = std::chrono::high_resolution_clock::now();
+        double millis = std::chrono::duration<double, std::milli>(end - begin).count();
+        std::cout << "Append + flush: " << millis << " ms (" << (plays / std::max(millis, 0.001)) * 1000.0
+                  << " plays/s), " << log.get_segment_count() << " segments" << std::endl;
+    }
+
+    HistoryLog log(directory, nullptr);
+    std::int64_t lastMillis = start + (plays - 1) * 60000LL;
+    std::cout << std::setw(25) << "Query" << std::setw(12) << "Threads" << std::setw(15) << "Time (ms)"
+              << std::setw(12) << "Plays" << std::endl;
+    std::cout << std::string(64, '-') << std::endl;
+    struct Query {
+        const char* name;
+        std::int64_t from;
+    };
+    Query queries[] = {{"Whole log", start}, {"Last 30 days", lastMillis - 30LL * 24 * 3600 * 1000}};
+    unsigned int hardware = std::max(1u, std::thread::hardware_concurrency());
+    for (const Query& query : queries) {
+        for (int threads : {1, static_cast<int>(hardware)}) {
+            auto begin = std::chrono::high_resolution_clock::now();
+            PlayWindowStats stats = log.window_stats(query.from, lastMillis + 1, threads);
+            auto end = std::chrono::high_resolution_clock::now();
+            std::cout << std::setw(25) << query.name << std::setw(12) << threads << std::setw(15)
+                      << std::chrono::duration<double, std::milli>(end - begin).count() << std::setw(12)
+                      << stats.plays << std::endl;
+            if (hardware == 1) break;
+        }
+    }
+    std::cout << std::endl;
+    std::filesystem::remove_all(directory, error);
+}
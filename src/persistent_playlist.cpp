@@ -0,0 +1,286 @@
+#include "../include/persistent_playlist.h"
+#include <random>
+#include <unordered_set>
+
+// Node constructor
+PersistentPlaylist::Node::Node(SongHandle song, std::shared_ptr<const Node> left,
+                               std::shared_ptr<const Node> right)
+    : song(song), size(1), left(std::move(left)), right(std::move(right)) {
+    size += (this->left ? this->left->size : 0) + (this->right ? this->right->size : 0);
+}
+
+// Constructors
+PersistentPlaylist::PersistentPlaylist() : root(nullptr) {}
+
+PersistentPlaylist::PersistentPlaylist(NodePtr root) : root(std::move(root)) {}
+
+PersistentPlaylist PersistentPlaylist::from_handles(const std::vector<SongHandle>& songs) {
+    return PersistentPlaylist(buildBalanced(songs, 0, static_cast<int>(songs.size())));
+}
+
+PersistentPlaylist PersistentPlaylist::from_playlist(const Playlist& playlist, const SongDatabase& db) {
+    std::vector<SongHandle> songs;
+    songs.reserve(playlist.getSize());
+    for (PlaylistNode* node = playlist.getHead(); node != nullptr; node = node->next) {
+        SongHandle handle = db.get_handle(node->song.getId());
+        if (handle != INVALID_SONG_HANDLE) {
+            songs.push_back(handle);
+        }
+    }
+    return from_handles(songs);
+}
+
+// Path-copying treap primitives
+int PersistentPlaylist::sizeOf(const NodePtr& node) {
+    return node ? node->size : 0;
+}
+
+PersistentPlaylist::NodePtr PersistentPlaylist::withChildren(const NodePtr& node, NodePtr left, NodePtr right) {
+    return std::make_shared<const Node>(node->song, std::move(left), std::move(right));
+}
+
+bool PersistentPlaylist::chooseLeftRoot(int leftSize, int rightSize) {
+    thread_local std::mt19937 rng(std::random_device{}());
+    return static_cast<int>(rng() % static_cast<unsigned int>(leftSize + rightSize)) < leftSize;
+}
+
+void PersistentPlaylist::split(const NodePtr& node, int count, NodePtr& left, NodePtr& right) {
+    if (!node) {
+        left = right = nullptr;
+        return;
+    }
+
+    int leftSize = sizeOf(node->left);
+    if (count <= leftSize) {
+        NodePtr innerRight;
+        split(node->left, count, left, innerRight);
+        right = withChildren(node, innerRight, node->right);
+    } else {
+        NodePtr innerLeft;
+        split(node->right, count - leftSize - 1, innerLeft, right);
+        left = withChildren(node, node->left, innerLeft);
+    }
+}
+
+PersistentPlaylist::NodePtr PersistentPlaylist::merge(const NodePtr& left, const NodePtr& right) {
+    if (!left) return right;
+    if (!right) return left;
+
+    if (chooseLeftRoot(left->size, right->size)) {
+        return withChildren(left, left->left, merge(left->right, right));
+    }
+    return withChildren(right, merge(left, right->left), right->right);
+}
+
+PersistentPlaylist::NodePtr PersistentPlaylist::buildBalanced(const std::vector<SongHandle>& songs, int low, int high) {
+    if (low >= high) return nullptr;
+
+    int mid = low + (high - low) / 2;
+    NodePtr left = buildBalanced(songs, low, mid);
+    NodePtr right = buildBalanced(songs, mid + 1, high);
+    return std::make_shared<const Node>(songs[mid], std::move(left), std::move(right));
+}
+
+// Edits
+PersistentPlaylist PersistentPlaylist::insert_song_at(int position, SongHandle song) const {
+    if (position < 0 || position > getSize()) return *this;
+
+    NodePtr left, right;
+    split(root, position, left, right);
+    NodePtr single = std::make_shared<const Node>(song, nullptr, nullptr);
+    return PersistentPlaylist(merge(merge(left, single), right));
+}
+
+PersistentPlaylist PersistentPlaylist::add_song(SongHandle song) const {
+    return insert_song_at(getSize(), song);
+}
+
+PersistentPlaylist PersistentPlaylist::delete_song(int position) const {
+    if (position < 0 || position >= getSize()) return *this;
+
+    NodePtr left, rest, removed, right;
+    split(root, position, left, rest);
+    split(rest, 1, removed, right);
+    return PersistentPlaylist(merge(left, right));
+}
+
+PersistentPlaylist PersistentPlaylist::move_song(int fromIndex, int toIndex) const {
+    int size = getSize();
+    if (fromIndex < 0 || fromIndex >= size || toIndex < 0 || toIndex >= size) return *this;
+    if (fromIndex == toIndex) return *this;
+
+    SongHandle song = get_song_at(fromIndex);
+    return delete_song(fromIndex).insert_song_at(toIndex, song);
+}
+
+PersistentPlaylist PersistentPlaylist::set_song_at(int position, SongHandle song) const {
+    if (position < 0 || position >= getSize()) return *this;
+
+    NodePtr left, rest, replaced, right;
+    split(root, position, left, rest);
+    split(rest, 1, replaced, right);
+    NodePtr single = std::make_shared<const Node>(song, nullptr, nullptr);
+    return PersistentPlaylist(merge(merge(left, single), right));
+}
+
+// Queries
+SongHandle PersistentPlaylist::get_song_at(int position) const {
+    if (position < 0 || position >= getSize()) return INVALID_SONG_HANDLE;
+
+    const Node* current = root.get();
+    while (current != nullptr) {
+        int leftSize = sizeOf(current->left);
+        if (position < leftSize) {
+            current = current->left.get();
+        } else if (position == leftSize) {
+            return current->song;
+        } else {
+            position -= leftSize + 1;
+            current = current->right.get();
+        }
+    }
+    return INVALID_SONG_HANDLE;
+}
+
+int PersistentPlaylist::getSize() const { return sizeOf(root); }
+bool PersistentPlaylist::isEmpty() const { return !root; }
+
+void PersistentPlaylist::for_each(const std::function<void(SongHandle)>& visit) const {
+    // Iterative in-order walk so deep trees cannot overflow the stack
+    std::vector<const Node*> stack;
+    const Node* current = root.get();
+    while (current != nullptr || !stack.empty()) {
+        while (current != nullptr) {
+            stack.push_back(current);
+            current = current->left.get();
+        }
+        current = stack.back();
+        stack.pop_back();
+        visit(current->song);
+        current = current->right.get();
+    }
+}
+
+std::vector<SongHandle> PersistentPlaylist::to_handles() const {
+    std::vector<SongHandle> songs;
+    songs.reserve(getSize());
+    for_each([&songs](SongHandle song) { songs.push_back(song); });
+    return songs;
+}
+
+Playlist PersistentPlaylist::to_playlist(const SongDatabase& db, const std::string& name) const {
+    Playlist playlist(name);
+    for_each([&playlist, &db](SongHandle handle) {
+        const Song* song = db.resolve_handle(handle);
+        if (song != nullptr) {
+            playlist.add_song(*song);
+        }
+    });
+    return playlist;
+}
+
+// Structural sharing helpers
+const PersistentPlaylist::Node* PersistentPlaylist::getRoot() const { return root.get(); }
+
+bool PersistentPlaylist::shares_root_with(const PersistentPlaylist& other) const {
+    return root == other.root;
+}
+
+// PlaylistVersionHistory implementation
+PlaylistVersionHistory::PlaylistVersionHistory() : currentVersion(0) {
+    versions.push_back(PersistentPlaylist());
+    labels.push_back("initial");
+}
+
+PlaylistVersionHistory::PlaylistVersionHistory(const PersistentPlaylist& initial) : currentVersion(0) {
+    versions.push_back(initial);
+    labels.push_back("initial");
+}
+
+int PlaylistVersionHistory::commit(const PersistentPlaylist& version, const std::string& label) {
+    versions.push_back(version);
+    labels.push_back(label);
+    currentVersion = static_cast<int>(versions.size()) - 1;
+    return currentVersion;
+}
+
+bool PlaylistVersionHistory::commitEdit(const PersistentPlaylist& next, bool valid, const std::string& label) {
+    if (!valid) return false;
+    commit(next, label);
+    return true;
+}
+
+bool PlaylistVersionHistory::insert_song_at(int position, SongHandle song) {
+    const PersistentPlaylist& current = get_current();
+    bool valid = position >= 0 && position <= current.getSize();
+    return commitEdit(current.insert_song_at(position, song), valid, "insert");
+}
+
+bool PlaylistVersionHistory::delete_song(int position) {
+    const PersistentPlaylist& current = get_current();
+    bool valid = position >= 0 && position < current.getSize();
+    return commitEdit(current.delete_song(position), valid, "delete");
+}
+
+bool PlaylistVersionHistory::move_song(int fromIndex, int toIndex) {
+    const PersistentPlaylist& current = get_current();
+    int size = current.getSize();
+    bool valid = fromIndex >= 0 && fromIndex < size && toIndex >= 0 && toIndex < size;
+    return commitEdit(current.move_song(fromIndex, toIndex), valid, "move");
+}
+
+// Version selection
+bool PlaylistVersionHistory::rollback(int version) {
+    if (version < 0 || version >= get_version_count()) return false;
+    currentVersion = version;
+    return true;
+}
+
+const PersistentPlaylist& PlaylistVersionHistory::get_current() const {
+    return versions[currentVersion];
+}
+
+const PersistentPlaylist& PlaylistVersionHistory::get_version(int version) const {
+    if (version < 0 || version >= get_version_count()) return versions[currentVersion];
+    return versions[version];
+}
+
+std::string PlaylistVersionHistory::get_label(int version) const {
+    if (version < 0 || version >= get_version_count()) return "";
+    return labels[version];
+}
+
+int PlaylistVersionHistory::get_current_version() const { return currentVersion; }
+int PlaylistVersionHistory::get_version_count() const { return static_cast<int>(versions.size()); }
+
+// Memory analysis
+size_t PlaylistVersionHistory::count_unique_nodes() const {
+    std::unordered_set<const PersistentPlaylist::Node*> visited;
+    std::vector<const PersistentPlaylist::Node*> stack;
+
+    for (const PersistentPlaylist& version : versions) {
+        if (version.getRoot() != nullptr) {
+            stack.push_back(version.getRoot());
+        }
+        while (!stack.empty()) {
+            const PersistentPlaylist::Node* node = stack.back();
+            stack.pop_back();
+            // Shared subtrees are only walked the first time they are seen
+            if (!visited.insert(node).second) continue;
+            if (node->left) stack.push_back(node->left.get());
+            if (node->right) stack.push_back(node->right.get());
+        }
+    }
+    return visited.size();
+}
+
+size_t PlaylistVersionHistory::estimate_memory() const {
+    // make_shared keeps the control block next to each node
+    const size_t bytesPerNode = sizeof(PersistentPlaylist::Node) + 2 * sizeof(long);
+    size_t bytes = sizeof(PlaylistVersionHistory) + count_unique_nodes() * bytesPerNode;
+    bytes += versions.capacity() * sizeof(PersistentPlaylist);
+    for (const std::string& label : labels) {
+        bytes += sizeof(std::string) + (label.capacity() > 15 ? label.capacity() + 1 : 0);
+    }
+    return bytes;
+}
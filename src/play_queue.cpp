@@ -0,0 +1,263 @@
+#include "../include/play_queue.h"
+#include <algorithm>
+
+// Constructor
+PlayQueue::PlayQueue(Playlist* playlist, History* history, FavoriteSongsQueue* favorites)
+    : playlist(playlist), cursor(nullptr), cursorPending(false), repeatMode(RepeatMode::OFF),
+      shuffleEnabled(false), shuffleSeed(0), shuffleDealt(false), shuffleStep(0), history(history), favorites(favorites) {
+    if (playlist != nullptr) {
+        playlist->add_listener(this);
+    }
+}
+
+// Destructor
+PlayQueue::~PlayQueue() {
+    if (playlist != nullptr) {
+        playlist->remove_listener(this);
+    }
+}
+
+// Helper methods
+const Song* PlayQueue::arrive(PlaylistNode* node) {
+    cursor = node;
+    cursorPending = false;
+    if (node == nullptr) return nullptr;
+    if (shuffleEnabled) {
+        dropShuffled(node);
+    }
+
+    if (history != nullptr) {
+        history->add_played_song(node->song);
+    }
+    if (favorites != nullptr) {
+        favorites->autoUpdateFromPlayback(node->song, node->song.getDuration());
+    }
+    return &(node->song);
+}
+
+PlaylistNode* PlayQueue::nextShuffled() {
+    if (!upNext.empty()) {
+        PlaylistNode* node = upNext.front();
+        upNext.pop_front();
+        return node;
+    }
+
+    // The first cycle skips the song already playing when shuffle was turned on
+    if (!shuffleDealt) {
+        dealShuffle(cursorPending ? nullptr : cursor);
+    }
+    for (int pass = 0; pass < 2; pass++) {
+        size_t remaining = shuffleOrder.size() - shuffleStep;
+        if (remaining > 0) {
+            // One Fisher-Yates step, as in Playlist::shuffle
+            if (remaining > 1) {
+                size_t j = shuffleStep + ShuffleIterator::boundedRandom(shuffleRng, static_cast<int>(remaining));
+                std::swap(shuffleOrder[shuffleStep], shuffleOrder[j]);
+                shuffleSlots[shuffleOrder[j]] = j;
+            }
+            PlaylistNode* node = shuffleOrder[shuffleStep];
+            shuffleOrder[shuffleStep++] = nullptr;
+            shuffleSlots.erase(node);
+            return node;
+        }
+        if (repeatMode != RepeatMode::ALL || playlist->isEmpty()) break;
+        shuffleSeed++;
+        dealShuffle(nullptr);
+    }
+    return nullptr;
+}
+
+void PlayQueue::dealShuffle(PlaylistNode* skip) {
+    discardShuffle();
+    shuffleDealt = true;
+    shuffleRng.seed(shuffleSeed);
+    for (PlaylistNode* node = playlist->getHead(); node != nullptr; node = node->next) {
+        if (node == skip) continue;
+        shuffleSlots[node] = shuffleOrder.size();
+        shuffleOrder.push_back(node);
+    }
+}
+
+void PlayQueue::dropShuffled(PlaylistNode* node) {
+    auto slot = shuffleSlots.find(node);
+    if (slot == shuffleSlots.end()) return;
+
+    // Undrawn slots are unordered, so the last one can fill the gap
+    size_t index = slot->second;
+    shuffleSlots.erase(slot);
+    PlaylistNode* last = shuffleOrder.back();
+    shuffleOrder.pop_back();
+    if (last != node) {
+        shuffleOrder[index] = last;
+        shuffleSlots[last] = index;
+    }
+}
+
+void PlayQueue::discardShuffle() {
+    shuffleDealt = false;
+    shuffleOrder.clear();
+    shuffleSlots.clear();
+    shuffleStep = 0;
+}
+
+void PlayQueue::pushShuffleBack(PlaylistNode* node) {
+    shuffleBack.push_back(node);
+    if (shuffleBack.size() > SHUFFLE_BACK_LIMIT) {
+        shuffleBack.pop_front();
+    }
+}
+
+// Playback control
+const Song* PlayQueue::start() {
+    if (playlist == nullptr) return nullptr;
+
+    shuffleBack.clear();
+    if (shuffleEnabled) {
+        cursor = nullptr;
+        cursorPending = false;
+        discardShuffle();
+        return arrive(nextShuffled());
+    }
+    return arrive(playlist->getHead());
+}
+
+const Song* PlayQueue::next() {
+    if (playlist == nullptr) return nullptr;
+
+    // The current song was deleted: the song that replaced it has not played yet
+    if (cursorPending) {
+        if (cursor == nullptr && repeatMode == RepeatMode::ALL) {
+            return arrive(playlist->getHead());
+        }
+        return arrive(cursor);
+    }
+    if (cursor == nullptr) return nullptr;
+
+    if (repeatMode == RepeatMode::ONE) {
+        return arrive(cursor);
+    }
+    if (shuffleEnabled) {
+        pushShuffleBack(cursor);
+        return arrive(nextShuffled());
+    }
+
+    PlaylistNode* following = cursor->next;
+    if (following == nullptr && repeatMode == RepeatMode::ALL) {
+        following = playlist->getHead();
+    }
+    return arrive(following);
+}
+
+const Song* PlayQueue::previous() {
+    if (playlist == nullptr || (cursor == nullptr && !cursorPending)) return nullptr;
+
+    PlaylistNode* preceding = nullptr;
+    if (shuffleEnabled) {
+        if (!shuffleBack.empty()) {
+            preceding = shuffleBack.back();
+            shuffleBack.pop_back();
+        }
+    } else {
+        // A deleted last song leaves a pending null cursor; step back to the tail
+        preceding = (cursor != nullptr) ? cursor->prev : playlist->getTail();
+        if (preceding == nullptr && repeatMode == RepeatMode::ALL) {
+            preceding = playlist->getTail();
+        }
+    }
+
+    // With nothing before it, "previous" restarts the current song
+    return arrive(preceding != nullptr ? preceding : cursor);
+}
+
+const Song* PlayQueue::jump_to(int index) {
+    if (playlist == nullptr) return nullptr;
+
+    PlaylistNode* node = playlist->getNodeAt(index);
+    if (node == nullptr) return nullptr;
+    if (shuffleEnabled && cursor != nullptr && !cursorPending) {
+        pushShuffleBack(cursor);
+    }
+    return arrive(node);
+}
+
+void PlayQueue::stop() {
+    cursor = nullptr;
+    cursorPending = false;
+    shuffleBack.clear();
+    upNext.clear();
+}
+
+// Queue editing
+bool PlayQueue::play_next(const Song& song) {
+    if (playlist == nullptr) return false;
+
+    PlaylistNode* node = new PlaylistNode(song);
+    if (cursorPending) {
+        // The pending song has not started, so the new one goes in front of it
+        PlaylistNode* before = (cursor != nullptr) ? cursor->prev : playlist->getTail();
+        playlist->insertNode(node, before);
+        cursor = node;
+        return true;
+    }
+
+    playlist->insertNode(node, cursor);
+    if (shuffleEnabled) {
+        upNext.push_front(node);
+    }
+    return true;
+}
+
+// Modes
+void PlayQueue::setRepeatMode(RepeatMode mode) { repeatMode = mode; }
+PlayQueue::RepeatMode PlayQueue::getRepeatMode() const { return repeatMode; }
+
+void PlayQueue::setShuffle(bool enabled, unsigned int seed) {
+    shuffleEnabled = enabled;
+    shuffleSeed = seed;
+    shuffleBack.clear();
+    upNext.clear();
+    discardShuffle();
+}
+
+bool PlayQueue::isShuffleEnabled() const { return shuffleEnabled; }
+
+std::string PlayQueue::getRepeatModeName(RepeatMode mode) {
+    switch (mode) {
+        case RepeatMode::OFF: return "Off";
+        case RepeatMode::ONE: return "Repeat one";
+        case RepeatMode::ALL: return "Repeat all";
+        default: return "Unknown";
+    }
+}
+
+// State
+const Song* PlayQueue::current() const {
+    return (cursor != nullptr && !cursorPending) ? &(cursor->song) : nullptr;
+}
+
+bool PlayQueue::isPlaying() const { return current() != nullptr; }
+Playlist* PlayQueue::getPlaylist() const { return playlist; }
+
+// PlaylistListener
+void PlayQueue::onNodeRemoving(PlaylistNode* node, PlaylistNode* successor) {
+    if (cursor == node) {
+        cursor = successor;
+        cursorPending = true;
+    }
+    dropShuffled(node);
+    // Both are short: shuffleBack is capped and upNext holds play_next requests
+    shuffleBack.erase(std::remove(shuffleBack.begin(), shuffleBack.end(), node), shuffleBack.end());
+    if (!upNext.empty()) {
+        upNext.erase(std::remove(upNext.begin(), upNext.end(), node), upNext.end());
+    }
+}
+
+void PlayQueue::onPlaylistCleared() {
+    stop();
+    discardShuffle();
+}
+
+void PlayQueue::onPlaylistDestroyed() {
+    onPlaylistCleared();
+    playlist = nullptr;
+}
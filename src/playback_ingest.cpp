@@ -0,0 +1,197 @@
+#include "../include/playback_ingest.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+// Constructor and destructor
+PlaybackIngest::PlaybackIngest(SongDatabase* database, History* history, FavoriteSongsQueue* favorites,
+                               size_t capacity, BackpressurePolicy policy, int sampleRate, size_t batchSize)
+    : ring(capacity), policy(policy), sampleRate(std::max(1, sampleRate)),
+      batchSize(std::max<size_t>(1, batchSize)), database(database), history(history), favorites(favorites),
+      published(0), dropped(0), applied(0), unresolved(0), pressured(0), running(false) {
+    batch.reserve(this->batchSize);
+    favoriteBatch.reserve(this->batchSize);
+}
+
+PlaybackIngest::~PlaybackIngest() {
+    stop();
+}
+
+// Helper methods
+void PlaybackIngest::applyBatch() {
+    favoriteBatch.clear();
+    for (const PlaybackEvent& event : batch) {
+        const Song* song = database ? database->search_by_id(event.songId) : nullptr;
+        if (!song) {
+            unresolved.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        // A negative listenedSeconds means the whole song, as in History
+        int listenedSeconds = event.listenedSeconds < 0 ? song->getDuration() : event.listenedSeconds;
+        if (history) {
+            history->record_play(*song, event.playedAt, listenedSeconds);
+        }
+        favoriteBatch.emplace_back(song, listenedSeconds);
+    }
+    if (favorites) {
+        favorites->autoUpdateFromPlaybackBatch(favoriteBatch);
+    }
+    applied.fetch_add(static_cast<long long>(favoriteBatch.size()), std::memory_order_relaxed);
+    batch.clear();
+}
+
+void PlaybackIngest::consumeLoop() {
+    // Keep going after stop() until the ring is empty
+    while (true) {
+        if (drain(static_cast<int>(batchSize)) == 0) {
+            if (!running.load(std::memory_order_acquire)) break;
+            std::this_thread::yield();
+        }
+    }
+}
+
+// Producer side
+bool PlaybackIngest::publish(const std::string& songId, int listenedSeconds) {
+    return publish(PlaybackEvent{songId, listenedSeconds, History::Clock::now()});
+}
+
+bool PlaybackIngest::publish(PlaybackEvent&& event) {
+    switch (policy) {
+        case BackpressurePolicy::BLOCK:
+            while (!ring.try_push(std::move(event))) {
+                if (!running.load(std::memory_order_acquire)) {
+                    dropped.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                std::this_thread::yield();
+            }
+            break;
+        case BackpressurePolicy::DROP_OLDEST:
+            while (!ring.try_push(std::move(event))) {
+                PlaybackEvent oldest;
+                if (ring.try_pop(oldest)) {
+                    dropped.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            break;
+        case BackpressurePolicy::SAMPLE: {
+            if (ring.size_approx() > ring.capacity() / 2 &&
+                pressured.fetch_add(1, std::memory_order_relaxed) % sampleRate != 0) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            if (!ring.try_push(std::move(event))) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            break;
+        }
+    }
+    published.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+// Consumer side
+int PlaybackIngest::drain(int maxEvents) {
+    int consumed = 0;
+    PlaybackEvent event;
+    while (consumed < maxEvents) {
+        while (batch.size() < batchSize && consumed < maxEvents && ring.try_pop(event)) {
+            batch.push_back(std::move(event));
+            consumed++;
+        }
+        if (batch.empty()) break;
+        bool ringEmpty = batch.size() < batchSize && consumed < maxEvents;
+        applyBatch();
+        if (ringEmpty) break;
+    }
+    return consumed;
+}
+
+void PlaybackIngest::start() {
+    if (running.exchange(true)) return;
+    consumer = std::thread(&PlaybackIngest::consumeLoop, this);
+}
+
+void PlaybackIngest::stop() {
+    if (!running.exchange(false)) return;
+    if (consumer.joinable()) consumer.join();
+}
+
+bool PlaybackIngest::is_running() const {
+    return running.load(std::memory_order_acquire);
+}
+
+// Statistics
+long long PlaybackIngest::get_published_count() const { return published.load(std::memory_order_relaxed); }
+long long PlaybackIngest::get_dropped_count() const { return dropped.load(std::memory_order_relaxed); }
+long long PlaybackIngest::get_applied_count() const { return applied.load(std::memory_order_relaxed); }
+long long PlaybackIngest::get_unresolved_count() const { return unresolved.load(std::memory_order_relaxed); }
+size_t PlaybackIngest::get_capacity() const { return ring.capacity(); }
+BackpressurePolicy PlaybackIngest::get_policy() const { return policy; }
+
+const char* PlaybackIngest::policyName(BackpressurePolicy policy) {
+    switch (policy) {
+        case BackpressurePolicy::BLOCK: return "block";
+        case BackpressurePolicy::DROP_OLDEST: return "drop-oldest";
+        case BackpressurePolicy::SAMPLE: return "sample";
+    }
+    return "unknown";
+}
+
+// Performance analysis
+void PlaybackIngest::benchmarkIngestion(int eventsPerRun) {
+    std::cout << "\n=== Playback Ingestion Benchmark ===" << std::endl;
+    std::cout << "Events per run: " << eventsPerRun << " over 500 songs, ring of 4096, batches of 256" << std::endl;
+    std::cout << "Hardware threads: " << std::max(1u, std::thread::hardware_concurrency()) << std::endl;
+
+    SongDatabase database;
+    std::vector<std::string> songIds;
+    for (int i = 0; i < 500; i++) {
+        songIds.push_back("ingest-" + std::to_string(i));
+        database.insert_song(Song(songIds.back(), "Ingest Song " + std::to_string(i),
+                                  "Ingest Artist " + std::to_string(i % 40), 120 + i % 240, 1 + i % 5));
+    }
+
+    std::cout << std::setw(10) << "Producers" << std::setw(14) << "Policy" << std::setw(16) << "Applied/s"
+              << std::setw(12) << "Applied" << std::setw(12) << "Dropped" << std::setw(10) << "Drop %" << std::endl;
+    std::cout << std::string(74, '-') << std::endl;
+
+    BackpressurePolicy policies[] = {BackpressurePolicy::BLOCK, BackpressurePolicy::DROP_OLDEST,
+                                     BackpressurePolicy::SAMPLE};
+    for (int producers : {1, 4, 16, 64}) {
+        for (BackpressurePolicy policy : policies) {
+            History history(1000);
+            FavoriteSongsQueue favorites;
+            PlaybackIngest ingest(&database, &history, &favorites, 4096, policy);
+            int perProducer = eventsPerRun / producers;
+
+            auto begin = std::chrono::high_resolution_clock::now();
+            ingest.start();
+            std::vector<std::thread> threads;
+            for (int p = 0; p < producers; p++) {
+                threads.emplace_back([&ingest, &songIds, perProducer, p]() {
+                    for (int i = 0; i < perProducer; i++) {
+                        ingest.publish(songIds[(p * 31 + i) % songIds.size()], 90 + i % 120);
+                    }
+                });
+            }
+            for (std::thread& thread : threads) thread.join();
+            ingest.stop();
+            auto end = std::chrono::high_resolution_clock::now();
+
+            double seconds = std::chrono::duration<double>(end - begin).count();
+            long long offered = static_cast<long long>(perProducer) * producers;
+            long long applied = ingest.get_applied_count();
+            long long dropped = ingest.get_dropped_count();
+            std::cout << std::setw(10) << producers << std::setw(14) << policyName(policy) << std::setw(16)
+                      << std::fixed << std::setprecision(0) << applied / std::max(seconds, 1e-9) << std::setw(12)
+                      << applied << std::setw(12) << dropped << std::setw(10) << std::setprecision(1)
+                      << 100.0 * dropped / std::max(offered, 1LL) << std::endl;
+        }
+    }
+    std::cout << "(Applied/s is the sustained rate into History and favorites; dropped events are not counted)"
+              << std::endl;
+    std::cout << std::endl;
+}
@@ -2,6 +2,10 @@
 #include <algorithm>
 #include <random>
 #include <chrono>
+#include <iomanip>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
 
 // Constructor
 Playlist::Playlist() : head(nullptr), tail(nullptr), name("Untitled Playlist"), size(0) {}
@@ -11,6 +15,11 @@ Playlist::Playlist(const std::string& name) : head(nullptr), tail(nullptr), name
 // Destructor
 Playlist::~Playlist() {
     clear();
+    std::vector<PlaylistListener*> detached;
+    detached.swap(listeners);
+    for (PlaylistListener* listener : detached) {
+        listener->onPlaylistDestroyed();
+    }
 }
 
 // Copy constructor
@@ -39,12 +48,7 @@ Playlist& Playlist::operator=(const Playlist& other) {
 // Helper methods
 PlaylistNode* Playlist::getNodeAt(int index) const {
     if (index < 0 || index >= size) return nullptr;
-    
-    PlaylistNode* current = head;
-    for (int i = 0; i < index; i++) {
-        current = current->next;
-    }
-    return current;
+    return durationIndex.nodeAt(index);
 }
 
 void Playlist::insertNode(PlaylistNode* newNode, PlaylistNode* afterNode) {
@@ -72,11 +76,33 @@ void Playlist::insertNode(PlaylistNode* newNode, PlaylistNode* afterNode) {
         }
     }
     size++;
+    durationIndex.insertAfter(newNode, afterNode);
+    stats.add(newNode->song);
 }
 
-void Playlist::removeNode(PlaylistNode* node) {
-    if (node == nullptr) return;
-    
+void Playlist::unlinkNode(PlaylistNode* node) {
+    durationIndex.erase(node);
+    stats.remove(node->song);
+    spliceOut(node);
+    size--;
+}
+
+void Playlist::spliceBefore(PlaylistNode* node, PlaylistNode* successor) {
+    node->next = successor;
+    node->prev = successor != nullptr ? successor->prev : tail;
+    if (node->prev != nullptr) {
+        node->prev->next = node;
+    } else {
+        head = node;
+    }
+    if (successor != nullptr) {
+        successor->prev = node;
+    } else {
+        tail = node;
+    }
+}
+
+void Playlist::spliceOut(PlaylistNode* node) {
     if (node->prev != nullptr) {
         node->prev->next = node->next;
     } else {
@@ -89,16 +115,39 @@ void Playlist::removeNode(PlaylistNode* node) {
         tail = node->prev;
     }
     
+    node->prev = node->next = nullptr;
+}
+
+void Playlist::notifyRemoving(PlaylistNode* node, PlaylistNode* successor) {
+    for (PlaylistListener* listener : listeners) {
+        listener->onNodeRemoving(node, successor);
+    }
+}
+
+void Playlist::removeNode(PlaylistNode* node) {
+    if (node == nullptr) return;
+    
+    notifyRemoving(node, node->next);
+    unlinkNode(node);
     delete node;
-    size--;
+}
+
+void Playlist::relinkNodes(const std::vector<PlaylistNode*>& nodes) {
+    int count = static_cast<int>(nodes.size());
+    for (int i = 0; i < count; i++) {
+        nodes[i]->prev = (i > 0) ? nodes[i - 1] : nullptr;
+        nodes[i]->next = (i + 1 < count) ? nodes[i + 1] : nullptr;
+    }
+    head = count > 0 ? nodes.front() : nullptr;
+    tail = count > 0 ? nodes.back() : nullptr;
+    size = count;
+    durationIndex.rebuild(head);
 }
 
 // Core playlist operations
 void Playlist::add_song(const std::string& title, const std::string& artist, int duration) {
     // Generate a unique ID based on current timestamp and size
-    std::string id = std::to_string(size + 1);
-    Song song(id, title, artist, duration);
-    add_song(song);
+    emplace_song(std::to_string(size + 1), title, artist, duration);
 }
 
 void Playlist::add_song(const Song& song) {
@@ -106,16 +155,23 @@ void Playlist::add_song(const Song& song) {
     insertNode(newNode, tail);
 }
 
+void Playlist::add_song(Song&& song) {
+    PlaylistNode* newNode = new PlaylistNode(std::move(song));
+    insertNode(newNode, tail);
+}
+
 void Playlist::add_song_at(const Song& song, int position) {
     if (position < 0 || position > size) return;
     
     PlaylistNode* newNode = new PlaylistNode(song);
-    if (position == 0) {
-        insertNode(newNode, nullptr);
-    } else {
-        PlaylistNode* afterNode = getNodeAt(position - 1);
-        insertNode(newNode, afterNode);
-    }
+    insertNode(newNode, position == 0 ? nullptr : getNodeAt(position - 1));
+}
+
+void Playlist::add_song_at(Song&& song, int position) {
+    if (position < 0 || position > size) return;
+    
+    PlaylistNode* newNode = new PlaylistNode(std::move(song));
+    insertNode(newNode, position == 0 ? nullptr : getNodeAt(position - 1));
 }
 
 bool Playlist::delete_song(int index) {
@@ -149,24 +205,87 @@ bool Playlist::move_song(int from_index, int to_index) {
         return false;
     }
     
-    // Store the song data before removing the node
-    Song songToMove = fromNode->song;
+    // Relink the existing node instead of copying its song
+    unlinkNode(fromNode);
     
-    // Remove the node from its current position
-    removeNode(fromNode);
-    
-    // Create a new node with the song data and insert at new position
-    PlaylistNode* newNode = new PlaylistNode(songToMove);
     if (to_index == 0) {
-        insertNode(newNode, nullptr);
+        insertNode(fromNode, nullptr);
     } else {
         PlaylistNode* afterNode = getNodeAt(to_index - 1);
-        insertNode(newNode, afterNode);
+        insertNode(fromNode, afterNode);
     }
     
     return true;
 }
 
+PlaylistEditResult Playlist::apply_edits(const std::vector<PlaylistEdit>& edits, bool countMoves) {
+    // Validation only needs the running size; the move count needs a replay
+    PlaylistEditResult result = countMoves ? PlaylistEditor::planEdits(size, edits)
+                                           : PlaylistEditor::checkEdits(size, edits);
+    if (!result.success) {
+        return result;
+    }
+    
+    // Every edit is now known to apply. Removed nodes are kept until the end
+    // so their successors can be followed past nodes the batch also removed
+    std::unordered_set<PlaylistNode*> created;
+    std::vector<PlaylistNode*> removed;
+    std::vector<PlaylistNode*> followers;  // next node when each removed node left
+    std::unordered_map<PlaylistNode*, size_t> removedAt;
+    for (const PlaylistEdit& edit : edits) {
+        PlaylistNode* node;
+        switch (edit.type) {
+            case PlaylistEdit::Type::INSERT:
+                node = new PlaylistNode(edit.song);
+                created.insert(node);
+                durationIndex.insertAt(node, edit.position);
+                spliceBefore(node, durationIndex.successorOf(node));
+                stats.add(node->song);
+                size++;
+                break;
+            case PlaylistEdit::Type::DELETE:
+                node = durationIndex.eraseAt(edit.position);
+                removedAt[node] = removed.size();
+                removed.push_back(node);
+                followers.push_back(node->next);
+                spliceOut(node);
+                stats.remove(node->song);
+                size--;
+                break;
+            case PlaylistEdit::Type::MOVE:
+                if (edit.position != edit.toPosition) {
+                    node = durationIndex.eraseAt(edit.position);
+                    spliceOut(node);
+                    durationIndex.insertAt(node, edit.toPosition);
+                    spliceBefore(node, durationIndex.successorOf(node));
+                }
+                break;
+        }
+    }
+    
+    // A follower removed later was resolved first, walking back
+    for (size_t i = removed.size(); i-- > 0;) {
+        auto later = followers[i] != nullptr ? removedAt.find(followers[i]) : removedAt.end();
+        if (later != removedAt.end()) followers[i] = followers[later->second];
+    }
+    
+    // Songs the batch both added and removed were never visible, so only the
+    // original songs are reported, each with the song that now follows it
+    result.inserted = static_cast<int>(created.size());
+    result.deleted = 0;
+    for (size_t i = 0; i < removed.size(); i++) {
+        if (created.count(removed[i]) > 0) {
+            result.inserted--;
+        } else {
+            result.deleted++;
+            notifyRemoving(removed[i], followers[i]);
+        }
+        delete removed[i];
+    }
+    
+    return result;
+}
+
 void Playlist::reverse_playlist() {
     if (size <= 1) return;
     
@@ -185,12 +304,22 @@ void Playlist::reverse_playlist() {
     temp = head;
     head = tail;
     tail = temp;
+    durationIndex.rebuild(head);
 }
 
 // Utility operations
+void Playlist::displaySummary() const {
+    long long total = stats.getTotalDuration();
+    std::cout << "Size: " << size << " songs | Total: " << total / 60 << "m " << total % 60 << "s";
+    if (stats.getRatedCount() > 0) {
+        std::cout << " | Avg rating: " << std::fixed << std::setprecision(2) << stats.getAverageRating() << "/5";
+    }
+    std::cout << "\n" << std::endl;
+}
+
 void Playlist::display() const {
     std::cout << "\n=== Playlist: " << name << " ===" << std::endl;
-    std::cout << "Size: " << size << " songs\n" << std::endl;
+    displaySummary();
     
     if (isEmpty()) {
         std::cout << "Playlist is empty!" << std::endl;
@@ -215,7 +344,7 @@ void Playlist::display() const {
 
 void Playlist::display_reverse() const {
     std::cout << "\n=== Playlist: " << name << " (Reverse Order) ===" << std::endl;
-    std::cout << "Size: " << size << " songs\n" << std::endl;
+    displaySummary();
     
     if (isEmpty()) {
         std::cout << "Playlist is empty!" << std::endl;
@@ -281,6 +410,9 @@ int Playlist::find_song_index(const std::string& songId) {
 
 // Playlist management
 void Playlist::clear() {
+    for (PlaylistListener* listener : listeners) {
+        listener->onPlaylistCleared();
+    }
     while (head != nullptr) {
         PlaylistNode* temp = head;
         head = head->next;
@@ -288,28 +420,96 @@ void Playlist::clear() {
     }
     head = tail = nullptr;
     size = 0;
+    durationIndex.clear();
+    stats.clear();
 }
 
 void Playlist::shuffle() {
+    unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
+    shuffle(seed);
+}
+
+void Playlist::shuffle(unsigned int seed) {
     if (size <= 1) return;
     
-    // Convert to vector for shuffling
-    std::vector<Song> songs;
+    // Permute node pointers instead of copying songs
+    std::vector<PlaylistNode*> nodes;
+    nodes.reserve(size);
     PlaylistNode* current = head;
     while (current != nullptr) {
-        songs.push_back(current->song);
+        nodes.push_back(current);
         current = current->next;
     }
     
-    // Shuffle the vector
-    unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-    std::shuffle(songs.begin(), songs.end(), std::default_random_engine(seed));
+    // Fisher-Yates with the same draws as ShuffleIterator
+    std::mt19937 rng(seed);
+    for (int i = 0; i < size - 1; i++) {
+        int j = i + ShuffleIterator::boundedRandom(rng, size - i);
+        std::swap(nodes[i], nodes[j]);
+    }
     
-    // Rebuild the playlist
-    clear();
-    for (const Song& song : songs) {
-        add_song(song);
+    relinkNodes(nodes);
+}
+
+PlaylistNode* Playlist::mergeRuns(PlaylistNode* left, PlaylistNode* right,
+                                 const std::function<bool(const Song&, const Song&)>& compare) {
+    // Merge two null-terminated runs through next pointers only; ties take
+    // from the left run so the sort stays stable
+    PlaylistNode* merged = nullptr;
+    PlaylistNode** tail = &merged;
+    while (left != nullptr && right != nullptr) {
+        if (compare(right->song, left->song)) {
+            *tail = right;
+            right = right->next;
+        } else {
+            *tail = left;
+            left = left->next;
+        }
+        tail = &(*tail)->next;
     }
+    *tail = (left != nullptr) ? left : right;
+    return merged;
+}
+
+void Playlist::sort(Sorting::SortCriteria criteria) {
+    if (size <= 1) return;
+    
+    auto compare = Sorting::getComparator(criteria);
+    
+    // Bottom-up merge sort: runs[i] holds a sorted run of 2^i nodes (or none),
+    // and every run in runs[] precedes the nodes that have not been read yet
+    PlaylistNode* runs[64] = {};
+    PlaylistNode* current = head;
+    while (current != nullptr) {
+        PlaylistNode* next = current->next;
+        current->next = nullptr;
+        PlaylistNode* carry = current;
+        int level = 0;
+        while (runs[level] != nullptr) {
+            carry = mergeRuns(runs[level], carry, compare);
+            runs[level] = nullptr;
+            level++;
+        }
+        runs[level] = carry;
+        current = next;
+    }
+    
+    PlaylistNode* sorted = nullptr;
+    for (PlaylistNode* run : runs) {
+        if (run != nullptr) {
+            sorted = (sorted == nullptr) ? run : mergeRuns(run, sorted, compare);
+        }
+    }
+    
+    // Restore prev pointers and tail in one pass
+    head = sorted;
+    PlaylistNode* previous = nullptr;
+    for (current = head; current != nullptr; current = current->next) {
+        current->prev = previous;
+        previous = current;
+    }
+    tail = previous;
+    durationIndex.rebuild(head);
 }
 
 Song* Playlist::get_song_at(int index) {
@@ -317,6 +517,121 @@ Song* Playlist::get_song_at(int index) {
     return node ? &(node->song) : nullptr;
 }
 
+// Time-offset queries
+long long Playlist::get_total_duration() const {
+    return durationIndex.totalDuration();
+}
+
+int Playlist::find_index_at_offset(long long seconds) const {
+    PlaylistNode* node = durationIndex.nodeAtOffset(seconds);
+    return node ? durationIndex.rankOf(node) : -1;
+}
+
+long long Playlist::get_offset_of(int index) const {
+    PlaylistNode* node = getNodeAt(index);
+    return node ? durationIndex.offsetOf(node) : -1;
+}
+
+int Playlist::count_songs_within(long long seconds) const {
+    return durationIndex.countWithin(seconds);
+}
+
+bool Playlist::set_song_duration(int index, int duration) {
+    PlaylistNode* node = getNodeAt(index);
+    if (node == nullptr || duration < 0) return false;
+    
+    stats.remove(node->song);
+    node->song.setDuration(duration);
+    stats.add(node->song);
+    durationIndex.refresh(node);
+    return true;
+}
+
+// Running aggregates
+const SongStats& Playlist::get_stats() const { return stats; }
+
+bool Playlist::set_song_rating(int index, int rating) {
+    PlaylistNode* node = getNodeAt(index);
+    if (node == nullptr || rating < 0 || rating > Song::MAX_RATING) return false;
+    
+    stats.remove(node->song);
+    node->song.setRating(rating);
+    stats.add(node->song);
+    return true;
+}
+
 // Iterator-like functionality
 PlaylistNode* Playlist::getHead() const { return head; }
-PlaylistNode* Playlist::getTail() const { return tail; } 
\ No newline at end of file
+PlaylistNode* Playlist::getTail() const { return tail; }
+
+// Cursor support
+void Playlist::add_listener(PlaylistListener* listener) {
+    if (listener == nullptr) return;
+    if (std::find(listeners.begin(), listeners.end(), listener) == listeners.end()) {
+        listeners.push_back(listener);
+    }
+}
+
+void Playlist::remove_listener(PlaylistListener* listener) {
+    listeners.erase(std::remove(listeners.begin(), listeners.end(), listener), listeners.end());
+}
+
+// ShuffleIterator implementation
+ShuffleIterator::ShuffleIterator(const Playlist& playlist, unsigned int seed)
+    : playlist(&playlist), total(playlist.getSize()), step(0), seed(seed), rng(seed) {}
+
+int ShuffleIterator::boundedRandom(std::mt19937& rng, int bound) {
+    // Rejection sampling keeps the draw unbiased and independent of the
+    // standard library's distribution implementation
+    const unsigned long range = static_cast<unsigned long>(bound);
+    const unsigned long limit = 0xFFFFFFFFUL - (0xFFFFFFFFUL % range + 1) % range;
+    unsigned long value;
+    do {
+        value = static_cast<unsigned long>(rng()) & 0xFFFFFFFFUL;
+    } while (value > limit);
+    return static_cast<int>(value % range);
+}
+
+int ShuffleIterator::valueAt(int position) const {
+    auto it = displaced.find(position);
+    return it != displaced.end() ? it->second : position;
+}
+
+bool ShuffleIterator::hasNext() const {
+    return step < total;
+}
+
+int ShuffleIterator::nextIndex() {
+    if (step >= total) return -1;
+    
+    // One Fisher-Yates step: swap position `step` with a random later one
+    int j = step;
+    if (step < total - 1) {
+        j = step + boundedRandom(rng, total - step);
+    }
+    int chosen = valueAt(j);
+    if (j != step) {
+        displaced[j] = valueAt(step);
+    }
+    displaced.erase(step);
+    step++;
+    return chosen;
+}
+
+const Song* ShuffleIterator::nextSong() {
+    int index = nextIndex();
+    if (index < 0) return nullptr;
+    
+    PlaylistNode* node = playlist->getNodeAt(index);
+    return node ? &(node->song) : nullptr;
+}
+
+int ShuffleIterator::getStep() const { return step; }
+unsigned int ShuffleIterator::getSeed() const { return seed; }
+
+void ShuffleIterator::reset() {
+    total = playlist->getSize();
+    step = 0;
+    rng.seed(seed);
+    displaced.clear();
+}
\ No newline at end of file
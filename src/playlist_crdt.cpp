@@ -0,0 +1,392 @@
+#include "../include/playlist_crdt.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <unordered_set>
+
+// CrdtElementId implementation
+bool CrdtElementId::operator==(const CrdtElementId& other) const {
+    return counter == other.counter && replica == other.replica;
+}
+
+bool CrdtElementId::operator!=(const CrdtElementId& other) const {
+    return !(*this == other);
+}
+
+bool CrdtElementId::operator<(const CrdtElementId& other) const {
+    if (counter != other.counter) return counter < other.counter;
+    return replica < other.replica;
+}
+
+size_t CrdtElementIdHash::operator()(const CrdtElementId& id) const {
+    return std::hash<std::uint64_t>()(id.counter * 0x9E3779B97F4A7C15ULL ^ id.replica);
+}
+
+// Element constructor
+PlaylistCRDT::Element::Element(const CrdtOperation& insert)
+    : id(insert.id), parent(insert.parent), song(insert.song), removed(false), insertSeq(insert.seq),
+      removeOrigin(0), removeSeq(0), prev(nullptr), next(nullptr) {}
+
+// Constructor
+PlaylistCRDT::PlaylistCRDT(CrdtReplicaId replicaId)
+    : replicaId(replicaId), clock(0), seq(0), root(CrdtOperation()),
+      visibleCount(0), tombstoneCount(0) {}
+
+// Destructor
+PlaylistCRDT::~PlaylistCRDT() {
+    for (auto& pair : elements) {
+        delete pair.second;
+    }
+}
+
+// Helper methods
+PlaylistCRDT::Element* PlaylistCRDT::find(const CrdtElementId& id) const {
+    if (id == CRDT_ROOT_ID) return const_cast<Element*>(&root);
+    auto it = elements.find(id);
+    return it != elements.end() ? it->second : nullptr;
+}
+
+PlaylistCRDT::Element* PlaylistCRDT::visibleAt(int position) const {
+    if (position < 0 || position >= visibleCount) return nullptr;
+    for (Element* element = root.next; element != nullptr; element = element->next) {
+        if (!element->removed && position-- == 0) return element;
+    }
+    return nullptr;
+}
+
+bool PlaylistCRDT::hasSeen(const CrdtVersionVector& seen, CrdtReplicaId origin, std::uint64_t opSeq) const {
+    auto it = seen.find(origin);
+    return it != seen.end() && it->second >= opSeq;
+}
+
+CrdtOperation PlaylistCRDT::makeOperation(CrdtOperation::Type type) {
+    CrdtOperation op;
+    op.type = type;
+    op.origin = replicaId;
+    op.seq = ++seq;
+    return op;
+}
+
+bool PlaylistCRDT::integrate(const CrdtOperation& op) {
+    // Operations from one origin arrive in order; anything else was already
+    // applied or would skip one of its causal predecessors
+    auto applied = version.find(op.origin);
+    std::uint64_t expected = (applied == version.end()) ? 1 : applied->second + 1;
+    if (op.seq != expected) return false;
+
+    // An insert whose parent has not arrived stays unseen, so it is sent again
+    Element* parent = nullptr;
+    if (op.type == CrdtOperation::INSERT) {
+        parent = find(op.parent);
+        if (parent == nullptr) return false;
+    }
+
+    version[op.origin] = op.seq;
+    log.push_back(op);
+
+    if (op.type == CrdtOperation::INSERT) {
+        clock = std::max(clock, op.id.counter);
+        if (elements.count(op.id) > 0) return true;
+
+        // Concurrent inserts after the same parent (and everything inserted
+        // after them) carry larger ids and stay in front of this one
+        Element* after = parent;
+        while (after->next != nullptr && op.id < after->next->id) {
+            after = after->next;
+        }
+
+        Element* element = new Element(op);
+        element->prev = after;
+        element->next = after->next;
+        if (after->next != nullptr) after->next->prev = element;
+        after->next = element;
+        elements[op.id] = element;
+        visibleCount++;
+    } else {
+        // Removing an element that is already gone (or purged) changes nothing
+        Element* target = find(op.id);
+        if (target != nullptr && target != &root && !target->removed) {
+            target->removed = true;
+            target->removeOrigin = op.origin;
+            target->removeSeq = op.seq;
+            visibleCount--;
+            tombstoneCount++;
+        }
+    }
+    return true;
+}
+
+bool PlaylistCRDT::stableVersion(const std::vector<CrdtReplicaId>& replicas, CrdtVersionVector& stable) const {
+    // stable: what every replica has seen (the element-wise minimum)
+    stable = version;
+    bool caughtUp = true;
+    for (CrdtReplicaId replica : replicas) {
+        if (replica == replicaId) continue;
+        auto known = peerVersions.find(replica);
+        if (known == peerVersions.end()) {
+            stable.clear();
+            return false;
+        }
+        const CrdtVersionVector& seen = known->second;
+        for (auto& entry : stable) {
+            auto other = seen.find(entry.first);
+            entry.second = (other == seen.end()) ? 0 : std::min(entry.second, other->second);
+        }
+
+        // Operations the replica made before reporting may still be in flight
+        auto own = seen.find(replica);
+        if (own != seen.end() && !hasSeen(version, replica, own->second)) caughtUp = false;
+    }
+    return caughtUp;
+}
+
+void PlaylistCRDT::absorbVersions(CrdtReplicaId peer, const CrdtVersionVector& seen) {
+    if (peer == replicaId) return;
+    CrdtVersionVector& known = peerVersions[peer];
+    for (const auto& entry : seen) {
+        std::uint64_t& value = known[entry.first];
+        value = std::max(value, entry.second);
+    }
+}
+
+// Local edits by element
+CrdtElementId PlaylistCRDT::insert_after(const CrdtElementId& anchor, SongHandle song) {
+    Element* parent = find(anchor);
+    if (parent == nullptr || parent->removed) return CRDT_ROOT_ID;
+
+    CrdtOperation op = makeOperation(CrdtOperation::INSERT);
+    op.id = CrdtElementId(++clock, replicaId);
+    op.parent = anchor;
+    op.song = song;
+    integrate(op);
+    return op.id;
+}
+
+bool PlaylistCRDT::remove(const CrdtElementId& id) {
+    Element* target = find(id);
+    if (target == nullptr || target == &root || target->removed) return false;
+
+    CrdtOperation op = makeOperation(CrdtOperation::REMOVE);
+    op.id = id;
+    return integrate(op);
+}
+
+// Local edits by visible position
+CrdtElementId PlaylistCRDT::insert_at(int position, SongHandle song) {
+    if (position < 0 || position > visibleCount) return CRDT_ROOT_ID;
+    CrdtElementId anchor = (position == 0) ? CRDT_ROOT_ID : visibleAt(position - 1)->id;
+    return insert_after(anchor, song);
+}
+
+bool PlaylistCRDT::remove_at(int position) {
+    Element* target = visibleAt(position);
+    return target != nullptr && remove(target->id);
+}
+
+bool PlaylistCRDT::move(int fromIndex, int toIndex) {
+    if (toIndex < 0 || toIndex >= visibleCount) return false;
+    Element* target = visibleAt(fromIndex);
+    if (target == nullptr) return false;
+    if (fromIndex == toIndex) return true;
+
+    SongHandle song = target->song;
+    remove(target->id);
+    return insert_at(toIndex, song) != CRDT_ROOT_ID;
+}
+
+// Synchronization
+std::vector<CrdtOperation> PlaylistCRDT::operations_since(const CrdtVersionVector& seen) const {
+    std::vector<CrdtOperation> missing;
+    for (const CrdtOperation& op : log) {
+        if (!hasSeen(seen, op.origin, op.seq)) {
+            missing.push_back(op);
+        }
+    }
+    return missing;
+}
+
+int PlaylistCRDT::apply_operations(const std::vector<CrdtOperation>& operations) {
+    // Retry what had to wait for a parent until a pass makes no progress
+    int applied = 0;
+    std::vector<CrdtOperation> pending = operations;
+    std::vector<CrdtOperation> waiting;
+    while (!pending.empty()) {
+        int before = applied;
+        for (const CrdtOperation& op : pending) {
+            if (integrate(op)) {
+                applied++;
+            } else if (!hasSeen(version, op.origin, op.seq)) {
+                waiting.push_back(op);
+            }
+        }
+        if (applied == before) break;
+        pending.swap(waiting);
+        waiting.clear();
+    }
+    return applied;
+}
+
+int PlaylistCRDT::merge(const PlaylistCRDT& other) {
+    int applied = apply_operations(other.operations_since(version));
+
+    // Remember what the other replica (and the replicas it heard from) had seen
+    absorbVersions(other.replicaId, other.version);
+    for (const auto& entry : other.peerVersions) {
+        absorbVersions(entry.first, entry.second);
+    }
+    return applied;
+}
+
+size_t PlaylistCRDT::collect_garbage(const std::vector<CrdtReplicaId>& replicas) {
+    CrdtVersionVector stable;
+    bool caughtUp = stableVersion(replicas, stable);
+
+    size_t collected = 0;
+    if (caughtUp && tombstoneCount > 0) {
+        // A tombstone stays while anything placed after it is not yet stable
+        std::unordered_set<CrdtElementId, CrdtElementIdHash> pinned;
+        for (Element* element = root.next; element != nullptr; element = element->next) {
+            if (!hasSeen(stable, element->id.replica, element->insertSeq)) {
+                pinned.insert(element->parent);
+            }
+        }
+
+        Element* element = root.next;
+        while (element != nullptr) {
+            Element* following = element->next;
+            if (element->removed && pinned.count(element->id) == 0 &&
+                hasSeen(stable, element->removeOrigin, element->removeSeq)) {
+                element->prev->next = following;
+                if (following != nullptr) following->prev = element->prev;
+                elements.erase(element->id);
+                delete element;
+                tombstoneCount--;
+                collected++;
+            }
+            element = following;
+        }
+    }
+
+    // Operations every replica has seen never need to be sent again
+    log.erase(std::remove_if(log.begin(), log.end(), [this, &stable](const CrdtOperation& op) {
+        return hasSeen(stable, op.origin, op.seq);
+    }), log.end());
+
+    return collected;
+}
+
+// Queries
+CrdtElementId PlaylistCRDT::element_at(int position) const {
+    Element* element = visibleAt(position);
+    return element != nullptr ? element->id : CRDT_ROOT_ID;
+}
+
+SongHandle PlaylistCRDT::get_song(const CrdtElementId& id) const {
+    Element* element = find(id);
+    return (element != nullptr && !element->removed) ? element->song : INVALID_SONG_HANDLE;
+}
+
+int PlaylistCRDT::getSize() const { return visibleCount; }
+bool PlaylistCRDT::isEmpty() const { return visibleCount == 0; }
+size_t PlaylistCRDT::get_tombstone_count() const { return tombstoneCount; }
+size_t PlaylistCRDT::get_log_size() const { return log.size(); }
+CrdtReplicaId PlaylistCRDT::get_replica_id() const { return replicaId; }
+const CrdtVersionVector& PlaylistCRDT::get_version() const { return version; }
+
+// Conversion
+std::vector<SongHandle> PlaylistCRDT::to_handles() const {
+    std::vector<SongHandle> handles;
+    handles.reserve(visibleCount);
+    for (Element* element = root.next; element != nullptr; element = element->next) {
+        if (!element->removed) handles.push_back(element->song);
+    }
+    return handles;
+}
+
+Playlist PlaylistCRDT::to_playlist(const SongDatabase& db, const std::string& name) const {
+    Playlist playlist(name);
+    for (Element* element = root.next; element != nullptr; element = element->next) {
+        if (element->removed) continue;
+        const Song* song = db.resolve_handle(element->song);
+        if (song != nullptr) {
+            playlist.add_song(*song);
+        }
+    }
+    return playlist;
+}
+
+// Performance analysis
+void PlaylistCRDT::benchmarkMerge(int initialSize, int operationsPerReplica) {
+    std::cout << "\n=== Offline Merge Benchmark (RGA) ===" << std::endl;
+    std::cout << "Shared playlist: " << initialSize << " songs, offline edits per replica: "
+              << operationsPerReplica << " (60% insert, 40% remove)" << std::endl;
+
+    PlaylistCRDT first(1);
+    PlaylistCRDT second(2);
+    std::vector<CrdtElementId> shared;
+    CrdtElementId last = CRDT_ROOT_ID;
+    for (int i = 0; i < initialSize; i++) {
+        last = first.insert_after(last, static_cast<SongHandle>(i));
+        shared.push_back(last);
+    }
+    second.merge(first);
+
+    // Both replicas edit the same base without seeing each other
+    PlaylistCRDT* replicas[] = {&first, &second};
+    for (int r = 0; r < 2; r++) {
+        std::mt19937 rng(77 + r);
+        std::vector<CrdtElementId> known = shared;
+        SongHandle nextSong = static_cast<SongHandle>(initialSize + r * operationsPerReplica);
+        for (int i = 0; i < operationsPerReplica; i++) {
+            CrdtElementId target = known[rng() % known.size()];
+            if (rng() % 10 < 6) {
+                // Removed songs cannot anchor new ones; draw again
+                while (replicas[r]->get_song(target) == INVALID_SONG_HANDLE) {
+                    target = known[rng() % known.size()];
+                }
+                known.push_back(replicas[r]->insert_after(target, nextSong++));
+            } else {
+                replicas[r]->remove(target);
+            }
+        }
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    int appliedFirst = first.merge(second);
+    auto end = std::chrono::high_resolution_clock::now();
+    auto firstTime = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+
+    start = std::chrono::high_resolution_clock::now();
+    int appliedSecond = second.merge(first);
+    end = std::chrono::high_resolution_clock::now();
+    auto secondTime = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+
+    // One more exchange tells each side what the other has seen
+    first.merge(second);
+    size_t tombstonesBefore = first.get_tombstone_count();
+    size_t logBefore = first.get_log_size();
+    std::vector<CrdtReplicaId> members = {1, 2};
+    start = std::chrono::high_resolution_clock::now();
+    size_t collected = first.collect_garbage(members);
+    end = std::chrono::high_resolution_clock::now();
+    auto gcTime = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+    second.collect_garbage(members);
+
+    start = std::chrono::high_resolution_clock::now();
+    std::vector<SongHandle> merged = first.to_handles();
+    end = std::chrono::high_resolution_clock::now();
+    auto convertTime = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+
+    std::cout << std::setw(20) << "Step" << std::setw(15) << "Time (μs)" << std::setw(15) << "Operations" << std::endl;
+    std::cout << std::string(50, '-') << std::endl;
+    std::cout << std::setw(20) << "Merge 2 into 1" << std::setw(15) << firstTime.count() << std::setw(15) << appliedFirst << std::endl;
+    std::cout << std::setw(20) << "Merge 1 into 2" << std::setw(15) << secondTime.count() << std::setw(15) << appliedSecond << std::endl;
+    std::cout << std::setw(20) << "Garbage collect" << std::setw(15) << gcTime.count() << std::setw(15) << collected << std::endl;
+    std::cout << std::setw(20) << "To handles" << std::setw(15) << convertTime.count() << std::setw(15) << merged.size() << std::endl;
+    std::cout << "Tombstones: " << tombstonesBefore << " -> " << first.get_tombstone_count()
+              << ", log entries: " << logBefore << " -> " << first.get_log_size() << std::endl;
+    std::cout << "Replicas converged: " << (merged == second.to_handles() ? "yes" : "no") << std::endl;
+    std::cout << std::endl;
+}
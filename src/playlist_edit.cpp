@@ -0,0 +1,684 @@
+#include "../include/playlist_edit.h"
+#include "../include/playlist.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <unordered_map>
+
+// PlaylistEdit factories
+PlaylistEdit PlaylistEdit::insert(const Song& song, int position) {
+    PlaylistEdit edit;
+    edit.type = Type::INSERT;
+    edit.position = position;
+    edit.toPosition = position;
+    edit.song = song;
+    return edit;
+}
+
+PlaylistEdit PlaylistEdit::remove(int position) {
+    PlaylistEdit edit;
+    edit.type = Type::DELETE;
+    edit.position = position;
+    edit.toPosition = position;
+    return edit;
+}
+
+PlaylistEdit PlaylistEdit::move(int fromIndex, int toIndex) {
+    PlaylistEdit edit;
+    edit.type = Type::MOVE;
+    edit.position = fromIndex;
+    edit.toPosition = toIndex;
+    return edit;
+}
+
+// Baseline: one Playlist call per edit, stopping at the first invalid one
+PlaylistEditResult PlaylistEditor::applySequential(Playlist& playlist, const std::vector<PlaylistEdit>& edits) {
+    PlaylistEditResult result;
+
+    for (size_t i = 0; i < edits.size(); i++) {
+        const PlaylistEdit& edit = edits[i];
+        bool applied = false;
+
+        switch (edit.type) {
+            case PlaylistEdit::Type::INSERT:
+                if (edit.position >= 0 && edit.position <= playlist.getSize()) {
+                    playlist.add_song_at(edit.song, edit.position);
+                    applied = true;
+                }
+                break;
+            case PlaylistEdit::Type::DELETE:
+                applied = playlist.delete_song(edit.position);
+                break;
+            case PlaylistEdit::Type::MOVE:
+                applied = playlist.move_song(edit.position, edit.toPosition);
+                break;
+        }
+
+        if (!applied) {
+            // Earlier edits stay applied; this is what batching avoids
+            result.failedEdit = static_cast<int>(i);
+            result.error = "edit out of range";
+            return result;
+        }
+    }
+
+    result.success = true;
+    return result;
+}
+
+std::vector<PlaylistEdit> PlaylistEditor::generateRandomEdits(int playlistSize, int editCount, unsigned int seed) {
+    std::vector<PlaylistEdit> edits;
+    edits.reserve(editCount);
+    std::mt19937 rng(seed);
+    int size = playlistSize;
+
+    for (int i = 0; i < editCount; i++) {
+        int kind = static_cast<int>(rng() % 3);
+        if (size == 0 || kind == 0) {
+            int position = static_cast<int>(rng() % static_cast<unsigned int>(size + 1));
+            std::string id = "batch-" + std::to_string(i);
+            edits.push_back(PlaylistEdit::insert(Song(id, "Inserted " + std::to_string(i), "Batch Artist", 200, 3), position));
+            size++;
+        } else if (kind == 1) {
+            edits.push_back(PlaylistEdit::remove(static_cast<int>(rng() % static_cast<unsigned int>(size))));
+            size--;
+        } else {
+            int from = static_cast<int>(rng() % static_cast<unsigned int>(size));
+            int to = static_cast<int>(rng() % static_cast<unsigned int>(size));
+            edits.push_back(PlaylistEdit::move(from, to));
+        }
+    }
+    return edits;
+}
+
+int PlaylistEditor::countMoved(const std::vector<int>& originalIndices) {
+    // Patience sorting: tails[k] is the smallest tail of an increasing run of length k + 1
+    std::vector<int> tails;
+    for (int index : originalIndices) {
+        auto it = std::lower_bound(tails.begin(), tails.end(), index);
+        if (it == tails.end()) {
+            tails.push_back(index);
+        } else {
+            *it = index;
+        }
+    }
+    return static_cast<int>(originalIndices.size() - tails.size());
+}
+
+// Batch planning: a run of original songs [start, start + length) in their
+// original order, or one inserted song (start -1), as a node of an implicit
+// treap stored in a pool and linked by index
+struct EditSegment {
+    int start;
+    int length;
+    unsigned int priority;
+    int total;  // songs in the subtree
+    int left;
+    int right;
+};
+
+static int segmentTotal(const std::vector<EditSegment>& pool, int node) {
+    return node < 0 ? 0 : pool[node].total;
+}
+
+static void pullSegment(std::vector<EditSegment>& pool, int node) {
+    pool[node].total = pool[node].length + segmentTotal(pool, pool[node].left) + segmentTotal(pool, pool[node].right);
+}
+
+static int newSegment(std::vector<EditSegment>& pool, int start, int length, unsigned int priority) {
+    pool.push_back(EditSegment{start, length, priority, length, -1, -1});
+    return static_cast<int>(pool.size()) - 1;
+}
+
+// Splits off the first count songs, cutting a run in two if the split falls inside it
+static void splitSegments(std::vector<EditSegment>& pool, int node, int count, int& left, int& right) {
+    if (node < 0) {
+        left = right = -1;
+        return;
+    }
+
+    int leftTotal = segmentTotal(pool, pool[node].left);
+    if (count <= leftTotal) {
+        int rest;
+        splitSegments(pool, pool[node].left, count, left, rest);
+        pool[node].left = rest;
+        right = node;
+    } else if (count >= leftTotal + pool[node].length) {
+        int rest;
+        splitSegments(pool, pool[node].right, count - leftTotal - pool[node].length, rest, right);
+        pool[node].right = rest;
+        left = node;
+    } else {
+        // The tail keeps the run's priority, so it can adopt the right subtree
+        int offset = count - leftTotal;
+        int tail = newSegment(pool, pool[node].start + offset, pool[node].length - offset, pool[node].priority);
+        pool[tail].right = pool[node].right;
+        pullSegment(pool, tail);
+        pool[node].length = offset;
+        pool[node].right = -1;
+        left = node;
+        right = tail;
+    }
+    pullSegment(pool, node);
+}
+
+static int mergeSegments(std::vector<EditSegment>& pool, int left, int right) {
+    if (left < 0) return right;
+    if (right < 0) return left;
+
+    if (pool[left].priority > pool[right].priority) {
+        int merged = mergeSegments(pool, pool[left].right, right);
+        pool[left].right = merged;
+        pullSegment(pool, left);
+        return left;
+    }
+    int merged = mergeSegments(pool, left, pool[right].left);
+    pool[right].left = merged;
+    pullSegment(pool, right);
+    return right;
+}
+
+static void collectSegments(const std::vector<EditSegment>& pool, int node, std::vector<int>& order) {
+    if (node < 0) return;
+    collectSegments(pool, pool[node].left, order);
+    order.push_back(node);
+    collectSegments(pool, pool[node].right, order);
+}
+
+PlaylistEditResult PlaylistEditor::checkEdits(int size, const std::vector<PlaylistEdit>& edits) {
+    PlaylistEditResult result;
+    int count = size;
+
+    for (size_t i = 0; i < edits.size(); i++) {
+        const PlaylistEdit& edit = edits[i];
+        std::string error;
+
+        switch (edit.type) {
+            case PlaylistEdit::Type::INSERT:
+                if (edit.position < 0 || edit.position > count) {
+                    error = "insert position out of range";
+                } else {
+                    count++;
+                }
+                break;
+            case PlaylistEdit::Type::DELETE:
+                if (edit.position < 0 || edit.position >= count) {
+                    error = "delete position out of range";
+                } else {
+                    count--;
+                }
+                break;
+            case PlaylistEdit::Type::MOVE:
+                if (edit.position < 0 || edit.position >= count ||
+                    edit.toPosition < 0 || edit.toPosition >= count) {
+                    error = "move position out of range";
+                }
+                break;
+        }
+
+        if (!error.empty()) {
+            result.failedEdit = static_cast<int>(i);
+            result.error = error;
+            return result;
+        }
+    }
+
+    result.success = true;
+    return result;
+}
+
+PlaylistEditResult PlaylistEditor::planEdits(int size, const std::vector<PlaylistEdit>& edits) {
+    PlaylistEditResult result = checkEdits(size, edits);
+    if (!result.success) {
+        return result;
+    }
+
+    // Each edit adds at most three segments
+    std::vector<EditSegment> pool;
+    pool.reserve(1 + 3 * edits.size());
+    std::mt19937 rng(static_cast<unsigned int>(edits.size()));
+    int root = size > 0 ? newSegment(pool, 0, size, static_cast<unsigned int>(rng())) : -1;
+
+    for (const PlaylistEdit& edit : edits) {
+        int left, rest, single, right;
+
+        switch (edit.type) {
+            case PlaylistEdit::Type::INSERT:
+                splitSegments(pool, root, edit.position, left, right);
+                single = newSegment(pool, -1, 1, static_cast<unsigned int>(rng()));
+                root = mergeSegments(pool, mergeSegments(pool, left, single), right);
+                break;
+            case PlaylistEdit::Type::DELETE:
+                splitSegments(pool, root, edit.position, left, rest);
+                splitSegments(pool, rest, 1, single, right);
+                root = mergeSegments(pool, left, right);
+                break;
+            case PlaylistEdit::Type::MOVE:
+                if (edit.position != edit.toPosition) {
+                    splitSegments(pool, root, edit.position, left, rest);
+                    splitSegments(pool, rest, 1, single, right);
+                    root = mergeSegments(pool, left, right);
+                    splitSegments(pool, root, edit.toPosition, left, right);
+                    root = mergeSegments(pool, mergeSegments(pool, left, single), right);
+                }
+                break;
+        }
+    }
+
+    // Surviving runs of original songs, in final order
+    std::vector<int> order;
+    collectSegments(pool, root, order);
+    std::vector<int> runStarts;
+    std::vector<int> runLengths;
+    int survivors = 0;
+    for (int node : order) {
+        if (pool[node].start < 0) {
+            result.inserted++;
+        } else {
+            runStarts.push_back(pool[node].start);
+            runLengths.push_back(pool[node].length);
+            survivors += pool[node].length;
+        }
+    }
+    result.deleted = size - survivors;
+
+    // Runs never overlap, so a longest increasing subsequence takes whole runs:
+    // weighted by length over the runs in final order, with a Fenwick tree of
+    // prefix maxima over their ranks by start
+    std::vector<int> starts(runStarts);
+    std::sort(starts.begin(), starts.end());
+    std::vector<int> best(starts.size() + 1, 0);
+    int longest = 0;
+    for (size_t i = 0; i < runStarts.size(); i++) {
+        int rank = static_cast<int>(std::lower_bound(starts.begin(), starts.end(), runStarts[i]) - starts.begin()) + 1;
+        int before = 0;
+        for (int j = rank - 1; j > 0; j -= j & -j) before = std::max(before, best[j]);
+        int length = before + runLengths[i];
+        longest = std::max(longest, length);
+        for (int j = rank; j < static_cast<int>(best.size()); j += j & -j) best[j] = std::max(best[j], length);
+    }
+    result.moved = survivors - longest;
+
+    result.success = true;
+    return result;
+}
+
+void PlaylistEditor::benchmarkBatchEdits(int playlistSize, int editCount) {
+    std::cout << "\n=== Batch Edit Benchmark ===" << std::endl;
+    std::cout << "Playlist size: " << playlistSize << ", edits: " << editCount << std::endl;
+
+    Playlist sequential("Sequential");
+    for (int i = 0; i < playlistSize; i++) {
+        sequential.add_song(Song(std::to_string(i), "Song " + std::to_string(i), "Artist", 180, 3));
+    }
+    Playlist batched(sequential);
+    std::vector<PlaylistEdit> edits = generateRandomEdits(playlistSize, editCount, 2024);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    applySequential(sequential, edits);
+    auto end = std::chrono::high_resolution_clock::now();
+    auto sequentialTime = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+
+    start = std::chrono::high_resolution_clock::now();
+    PlaylistEditResult result = batched.apply_edits(edits);
+    end = std::chrono::high_resolution_clock::now();
+    auto batchTime = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+
+    // The move count is optional: it replays the batch on its own treap
+    start = std::chrono::high_resolution_clock::now();
+    PlaylistEditResult planned = planEdits(playlistSize, edits);
+    end = std::chrono::high_resolution_clock::now();
+    auto planTime = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+
+    // Both paths must agree on the final order
+    bool identical = sequential.getSize() == batched.getSize();
+    PlaylistNode* a = sequential.getHead();
+    PlaylistNode* b = batched.getHead();
+    while (identical && a != nullptr && b != nullptr) {
+        identical = a->song.getId() == b->song.getId();
+        a = a->next;
+        b = b->next;
+    }
+
+    std::cout << std::setw(24) << "Method" << std::setw(15) << "Time (μs)" << std::endl;
+    std::cout << std::string(39, '-') << std::endl;
+    std::cout << std::setw(24) << "One by one" << std::setw(15) << sequentialTime.count() << std::endl;
+    std::cout << std::setw(24) << "Batch" << std::setw(15) << batchTime.count() << std::endl;
+    std::cout << std::setw(24) << "Move count (optional)" << std::setw(15) << planTime.count() << std::endl;
+    std::cout << "Net diff: +" << result.inserted << " -" << result.deleted
+              << " moved " << planned.moved << std::endl;
+    std::cout << "Both paths pay one index update per edit; the batch skips node lookups and, for moves," << std::endl;
+    std::cout << "the song aggregates, and validates everything before changing anything." << std::endl;
+    std::cout << "Results identical: " << (identical ? "yes" : "no") << std::endl;
+    std::cout << std::endl;
+}
+
+// Synchronization helpers
+std::vector<const Song*> PlaylistEditor::collectSongs(const Playlist& playlist) {
+    std::vector<const Song*> songs;
+    songs.reserve(playlist.getSize());
+    for (PlaylistNode* node = playlist.getHead(); node != nullptr; node = node->next) {
+        songs.push_back(&(node->song));
+    }
+    return songs;
+}
+
+std::vector<int> PlaylistEditor::toSymbols(const std::vector<const Song*>& songs,
+                                           std::unordered_map<std::string, int>& table) {
+    std::vector<int> symbols;
+    symbols.reserve(songs.size());
+    for (const Song* song : songs) {
+        auto inserted = table.emplace(song->getId(), static_cast<int>(table.size()));
+        symbols.push_back(inserted.first->second);
+    }
+    return symbols;
+}
+
+void PlaylistEditor::matchSongs(const std::vector<int>& fromSymbols, const std::vector<int>& toSymbols,
+                                int symbolCount, std::vector<int>& matchFrom, std::vector<int>& matchTo) {
+    // Chain equal ids on the "from" side so the k-th copy matches the k-th copy
+    std::vector<int> cursor(symbolCount, -1);
+    std::vector<int> nextSame(fromSymbols.size(), -1);
+    for (int p = static_cast<int>(fromSymbols.size()) - 1; p >= 0; p--) {
+        nextSame[p] = cursor[fromSymbols[p]];
+        cursor[fromSymbols[p]] = p;
+    }
+
+    matchFrom.assign(fromSymbols.size(), -1);
+    matchTo.assign(toSymbols.size(), -1);
+    for (size_t j = 0; j < toSymbols.size(); j++) {
+        int p = cursor[toSymbols[j]];
+        if (p >= 0) {
+            matchFrom[p] = static_cast<int>(j);
+            matchTo[j] = p;
+            cursor[toSymbols[j]] = nextSame[p];
+        }
+    }
+}
+
+std::vector<char> PlaylistEditor::keptInOrder(const std::vector<int>& matchFrom) {
+    // Longest increasing subsequence of target positions, with back-links
+    std::vector<int> tailPositions;
+    std::vector<int> previous(matchFrom.size(), -1);
+    for (int p = 0; p < static_cast<int>(matchFrom.size()); p++) {
+        int value = matchFrom[p];
+        if (value < 0) continue;
+
+        int low = 0;
+        int high = static_cast<int>(tailPositions.size());
+        while (low < high) {
+            int mid = (low + high) / 2;
+            if (matchFrom[tailPositions[mid]] < value) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        previous[p] = low > 0 ? tailPositions[low - 1] : -1;
+        if (low == static_cast<int>(tailPositions.size())) {
+            tailPositions.push_back(p);
+        } else {
+            tailPositions[low] = p;
+        }
+    }
+
+    std::vector<char> kept(matchFrom.size(), 0);
+    int p = tailPositions.empty() ? -1 : tailPositions.back();
+    while (p >= 0) {
+        kept[p] = 1;
+        p = previous[p];
+    }
+    return kept;
+}
+
+std::vector<PlaylistEdit> PlaylistEditor::diffSongs(const std::vector<const Song*>& from,
+                                                    const std::vector<const Song*>& to) {
+    std::unordered_map<std::string, int> table;
+    table.reserve(from.size() + to.size());
+    std::vector<int> fromSymbols = toSymbols(from, table);
+    std::vector<int> toSymbolsList = toSymbols(to, table);
+
+    std::vector<int> matchFrom, matchTo;
+    matchSongs(fromSymbols, toSymbolsList, static_cast<int>(table.size()), matchFrom, matchTo);
+    std::vector<char> kept = keptInOrder(matchFrom);
+
+    std::vector<PlaylistEdit> edits;
+    int n = static_cast<int>(from.size());
+    int m = static_cast<int>(to.size());
+
+    // Deletes from the back so earlier positions stay valid
+    for (int p = n - 1; p >= 0; p--) {
+        if (matchFrom[p] < 0) {
+            edits.push_back(PlaylistEdit::remove(p));
+        }
+    }
+
+    // Order keys: a kept song at source position p has key (p, 0); the songs
+    // that must follow it in the target get (p, 1), (p, 2), ... so the final
+    // relative order of every key is known before any edit is emitted
+    const long long stride = static_cast<long long>(m) + 2;
+    auto keyOf = [stride](int anchor, int sub) {
+        return static_cast<long long>(anchor + 1) * stride + sub;
+    };
+
+    std::vector<long long> targetKeys(m);
+    int anchor = -1;
+    int sub = 0;
+    for (int j = 0; j < m; j++) {
+        int p = matchTo[j];
+        if (p >= 0 && kept[p]) {
+            anchor = p;
+            sub = 0;
+            targetKeys[j] = keyOf(p, 0);
+        } else {
+            sub++;
+            targetKeys[j] = keyOf(anchor, sub);
+        }
+    }
+
+    std::vector<long long> allKeys(targetKeys);
+    for (int p = 0; p < n; p++) {
+        if (matchFrom[p] >= 0) {
+            allKeys.push_back(keyOf(p, 0));
+        }
+    }
+    std::sort(allKeys.begin(), allKeys.end());
+    allKeys.erase(std::unique(allKeys.begin(), allKeys.end()), allKeys.end());
+    auto slotOf = [&allKeys](long long key) {
+        return static_cast<int>(std::lower_bound(allKeys.begin(), allKeys.end(), key) - allKeys.begin());
+    };
+
+    // Fenwick tree over key slots: prefix(slot) is the current list position
+    std::vector<int> tree(allKeys.size() + 1, 0);
+    auto update = [&tree](int slot, int delta) {
+        for (int i = slot + 1; i < static_cast<int>(tree.size()); i += i & -i) tree[i] += delta;
+    };
+    auto prefix = [&tree](int slot) {
+        int total = 0;
+        for (int i = slot; i > 0; i -= i & -i) total += tree[i];
+        return total;
+    };
+
+    for (int p = 0; p < n; p++) {
+        if (matchFrom[p] >= 0) {
+            update(slotOf(keyOf(p, 0)), 1);
+        }
+    }
+
+    for (int j = 0; j < m; j++) {
+        int p = matchTo[j];
+        if (p >= 0 && kept[p]) continue;
+
+        int target = slotOf(targetKeys[j]);
+        if (p >= 0) {
+            int source = slotOf(keyOf(p, 0));
+            int fromIndex = prefix(source);
+            update(source, -1);
+            int toIndex = prefix(target);
+            update(target, 1);
+            if (fromIndex != toIndex) {
+                edits.push_back(PlaylistEdit::move(fromIndex, toIndex));
+            }
+        } else {
+            int position = prefix(target);
+            update(target, 1);
+            edits.push_back(PlaylistEdit::insert(*to[j], position));
+        }
+    }
+
+    return edits;
+}
+
+std::vector<PlaylistEdit> PlaylistEditor::diff(const Playlist& from, const Playlist& to) {
+    return diffSongs(collectSongs(from), collectSongs(to));
+}
+
+PlaylistMergeResult PlaylistEditor::merge(const Playlist& base, const Playlist& ours, const Playlist& theirs) {
+    PlaylistMergeResult result;
+    std::vector<const Song*> baseSongs = collectSongs(base);
+    std::vector<const Song*> ourSongs = collectSongs(ours);
+    std::vector<const Song*> theirSongs = collectSongs(theirs);
+
+    std::unordered_map<std::string, int> table;
+    table.reserve(baseSongs.size() + ourSongs.size() + theirSongs.size());
+    std::vector<int> baseSymbols = toSymbols(baseSongs, table);
+    std::vector<int> ourSymbols = toSymbols(ourSongs, table);
+    std::vector<int> theirSymbols = toSymbols(theirSongs, table);
+    int symbolCount = static_cast<int>(table.size());
+
+    std::vector<int> baseToOurs, oursToBase, baseToTheirs, theirsToBase;
+    matchSongs(baseSymbols, ourSymbols, symbolCount, baseToOurs, oursToBase);
+    matchSongs(baseSymbols, theirSymbols, symbolCount, baseToTheirs, theirsToBase);
+    std::vector<char> keptByOurs = keptInOrder(baseToOurs);
+    std::vector<char> keptByTheirs = keptInOrder(baseToTheirs);
+
+    // Songs both sides added are matched so they are not inserted twice
+    std::vector<int> ourNew, theirNew;
+    std::vector<int> ourNewSymbols, theirNewSymbols;
+    for (size_t i = 0; i < ourSongs.size(); i++) {
+        if (oursToBase[i] < 0) {
+            ourNew.push_back(static_cast<int>(i));
+            ourNewSymbols.push_back(ourSymbols[i]);
+        }
+    }
+    for (size_t j = 0; j < theirSongs.size(); j++) {
+        if (theirsToBase[j] < 0) {
+            theirNew.push_back(static_cast<int>(j));
+            theirNewSymbols.push_back(theirSymbols[j]);
+        }
+    }
+    std::vector<int> ourNewMatch, theirNewMatch;
+    matchSongs(ourNewSymbols, theirNewSymbols, symbolCount, ourNewMatch, theirNewMatch);
+    std::vector<int> theirNewToOurs(theirSongs.size(), -1);
+    for (size_t k = 0; k < theirNew.size(); k++) {
+        if (theirNewMatch[k] >= 0) {
+            theirNewToOurs[theirNew[k]] = ourNew[theirNewMatch[k]];
+        }
+    }
+
+    // Merged order as an index-linked list: items [0, o) are our songs,
+    // items [o, o + t) are songs only they added
+    int o = static_cast<int>(ourSongs.size());
+    int total = o + static_cast<int>(theirSongs.size());
+    std::vector<int> prev(total, -1), next(total, -1);
+    int head = o > 0 ? 0 : -1;
+    for (int i = 0; i < o; i++) {
+        prev[i] = i - 1;
+        next[i] = (i + 1 < o) ? i + 1 : -1;
+    }
+    auto unlink = [&](int item) {
+        if (prev[item] >= 0) next[prev[item]] = next[item]; else head = next[item];
+        if (next[item] >= 0) prev[next[item]] = prev[item];
+        prev[item] = next[item] = -1;
+    };
+    auto linkAfter = [&](int item, int anchor) {
+        int following = anchor >= 0 ? next[anchor] : head;
+        prev[item] = anchor;
+        next[item] = following;
+        if (following >= 0) prev[following] = item;
+        if (anchor >= 0) next[anchor] = item; else head = item;
+    };
+
+    // Their deletions
+    for (size_t b = 0; b < baseSongs.size(); b++) {
+        if (baseToTheirs[b] < 0 && baseToOurs[b] >= 0) {
+            unlink(baseToOurs[b]);
+        }
+    }
+
+    // Their insertions and moves, anchored after their predecessor
+    int anchor = -1;
+    for (int j = 0; j < static_cast<int>(theirSongs.size()); j++) {
+        int item;
+        int b = theirsToBase[j];
+        if (b >= 0) {
+            if (baseToOurs[b] < 0) continue;  // we deleted it
+            item = baseToOurs[b];
+            if (!keptByTheirs[b]) {
+                if (!keptByOurs[b]) {
+                    result.conflicts++;
+                } else {
+                    unlink(item);
+                    linkAfter(item, anchor);
+                }
+            }
+        } else if (theirNewToOurs[j] >= 0) {
+            item = theirNewToOurs[j];
+        } else {
+            item = o + j;
+            linkAfter(item, anchor);
+        }
+        anchor = item;
+    }
+
+    std::vector<const Song*> merged;
+    merged.reserve(total);
+    for (int item = head; item >= 0; item = next[item]) {
+        merged.push_back(item < o ? ourSongs[item] : theirSongs[item - o]);
+    }
+
+    result.mergedSize = static_cast<int>(merged.size());
+    result.edits = diffSongs(ourSongs, merged);
+    return result;
+}
+
+void PlaylistEditor::benchmarkDiff(int playlistSize, int editCount) {
+    std::cout << "\n=== Playlist Diff Benchmark ===" << std::endl;
+    std::cout << "Playlist size: " << playlistSize << ", edits: " << editCount << std::endl;
+
+    Playlist server("Server");
+    for (int i = 0; i < playlistSize; i++) {
+        server.add_song(Song(std::to_string(i), "Song " + std::to_string(i), "Artist", 180, 3));
+    }
+    Playlist client(server);
+    client.apply_edits(generateRandomEdits(playlistSize, editCount, 7));
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<PlaylistEdit> script = diff(server, client);
+    auto end = std::chrono::high_resolution_clock::now();
+    auto diffTime = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+
+    start = std::chrono::high_resolution_clock::now();
+    PlaylistEditResult applied = server.apply_edits(script);
+    end = std::chrono::high_resolution_clock::now();
+    auto applyTime = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+
+    bool identical = applied.success && server.getSize() == client.getSize();
+    PlaylistNode* a = server.getHead();
+    PlaylistNode* b = client.getHead();
+    while (identical && a != nullptr) {
+        identical = a->song.getId() == b->song.getId();
+        a = a->next;
+        b = b->next;
+    }
+
+    std::cout << std::setw(20) << "Step" << std::setw(15) << "Time (μs)" << std::endl;
+    std::cout << std::string(35, '-') << std::endl;
+    std::cout << std::setw(20) << "Diff" << std::setw(15) << diffTime.count() << std::endl;
+    std::cout << std::setw(20) << "Apply script" << std::setw(15) << applyTime.count() << std::endl;
+    std::cout << "Script length: " << script.size() << " edits" << std::endl;
+    std::cout << "Results identical: " << (identical ? "yes" : "no") << std::endl;
+    std::cout << std::endl;
+}
@@ -0,0 +1,206 @@
+#include "../include/playlist_generator.h"
+#include <algorithm>
+#include <cctype>
+#include <random>
+#include <unordered_map>
+
+// Helper methods
+std::string PlaylistGenerator::artistKey(const std::string& artist) {
+    std::string key = artist;
+    std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+    return key;
+}
+
+long long PlaylistGenerator::collectCandidates(SongDatabase& db, const SmartPlaylistRule& rule, std::time_t now,
+                                               int limit, std::vector<std::vector<const Song*>>& byDuration) {
+    byDuration.assign(limit + 1, std::vector<const Song*>());
+    long long count = 0;
+    auto consider = [&](const Song* song) {
+        if (song == nullptr || !rule.matches(*song, now)) return;
+        count++;
+        // Songs longer than the whole window can never be used
+        int duration = song->getDuration();
+        if (duration > 0 && duration <= limit) {
+            byDuration[duration].push_back(song);
+        }
+    };
+
+    if (!rule.genre.empty()) {
+        for (SongHandle handle : db.get_handles_by_genre(rule.genre)) {
+            consider(db.resolve_handle(handle));
+        }
+    } else {
+        SongHandle handleCount = static_cast<SongHandle>(db.get_handle_count());
+        for (SongHandle handle = 0; handle < handleCount; handle++) {
+            consider(db.resolve_handle(handle));
+        }
+    }
+    return count;
+}
+
+int PlaylistGenerator::solveDurations(const std::vector<std::vector<const Song*>>& byDuration, int target,
+                                      int tolerance, unsigned int seed, std::vector<int>& counts) {
+    int limit = target + tolerance;
+    int lowest = std::max(1, target - tolerance);
+
+    // Each distinct duration is one item type; the bucket order decides
+    // which of several equally good combinations is found first
+    std::vector<int> durations;
+    for (int d = 1; d <= limit; d++) {
+        if (!byDuration[d].empty()) durations.push_back(d);
+    }
+    std::mt19937 rng(seed);
+    std::shuffle(durations.begin(), durations.end(), rng);
+
+    // via[s]: duration of the last song on the path to sum s (0 = unreachable)
+    // used[s]: copies of that duration on the path; stamp[s]: bucket that reached s
+    std::vector<int> via(limit + 1, 0);
+    std::vector<int> used(limit + 1, 0);
+    std::vector<int> stamp(limit + 1, -1);
+    via[0] = -1;
+
+    for (size_t g = 0; g < durations.size() && via[target] == 0; g++) {
+        int d = durations[g];
+        int available = static_cast<int>(byDuration[d].size());
+        for (int s = d; s <= limit; s++) {
+            if (via[s] != 0 || via[s - d] == 0) continue;
+            int copies = (stamp[s - d] == static_cast<int>(g)) ? used[s - d] + 1 : 1;
+            if (copies > available) continue;
+            via[s] = d;
+            used[s] = copies;
+            stamp[s] = static_cast<int>(g);
+        }
+    }
+
+    // Closest reachable total to the target within the tolerance
+    int best = -1;
+    for (int delta = 0; delta <= tolerance && best < 0; delta++) {
+        if (target - delta >= lowest && via[target - delta] != 0) {
+            best = target - delta;
+        } else if (target + delta <= limit && via[target + delta] != 0) {
+            best = target + delta;
+        }
+    }
+    if (best < 0) return -1;
+
+    counts.assign(limit + 1, 0);
+    for (int s = best; s > 0; s -= via[s]) {
+        counts[via[s]]++;
+    }
+    return best;
+}
+
+void PlaylistGenerator::drawSongs(std::vector<std::vector<const Song*>>& byDuration, const std::vector<int>& counts,
+                                  unsigned int seed, std::vector<const Song*>& picked) {
+    // Bounds the search for an unused artist in very large buckets
+    const size_t scanLimit = 256;
+
+    std::mt19937 rng(seed);
+    std::unordered_map<std::string, int> artistUses;
+    picked.clear();
+
+    for (size_t d = 1; d < counts.size(); d++) {
+        std::vector<const Song*>& bucket = byDuration[d];
+        for (int i = 0; i < counts[d]; i++) {
+            // Chosen songs are swapped to the front of the bucket
+            size_t remaining = bucket.size() - i;
+            size_t start = rng() % remaining;
+            size_t best = i;
+            int bestUses = -1;
+            for (size_t t = 0; t < remaining && t < scanLimit; t++) {
+                size_t position = i + (start + t) % remaining;
+                auto it = artistUses.find(artistKey(bucket[position]->getArtist()));
+                int uses = (it == artistUses.end()) ? 0 : it->second;
+                if (bestUses < 0 || uses < bestUses) {
+                    best = position;
+                    bestUses = uses;
+                    if (uses == 0) break;
+                }
+            }
+            std::swap(bucket[i], bucket[best]);
+            artistUses[artistKey(bucket[i]->getArtist())]++;
+            picked.push_back(bucket[i]);
+        }
+    }
+}
+
+bool PlaylistGenerator::arrange(std::vector<const Song*>& songs, int spacing) {
+    if (spacing <= 1) return true;
+
+    std::unordered_map<std::string, size_t> artistIndex;
+    std::vector<std::vector<const Song*>> byArtist;
+    for (const Song* song : songs) {
+        auto inserted = artistIndex.emplace(artistKey(song->getArtist()), byArtist.size());
+        if (inserted.second) byArtist.emplace_back();
+        byArtist[inserted.first->second].push_back(song);
+    }
+
+    // Place the artist with the most songs left among those outside the window
+    std::vector<int> lastPosition(byArtist.size(), -spacing);
+    std::vector<const Song*> ordered;
+    ordered.reserve(songs.size());
+    for (int position = 0; position < static_cast<int>(songs.size()); position++) {
+        int best = -1;
+        for (size_t a = 0; a < byArtist.size(); a++) {
+            if (byArtist[a].empty() || position - lastPosition[a] < spacing) continue;
+            if (best < 0 || byArtist[a].size() > byArtist[best].size()) {
+                best = static_cast<int>(a);
+            }
+        }
+        if (best < 0) return false;
+
+        ordered.push_back(byArtist[best].back());
+        byArtist[best].pop_back();
+        lastPosition[best] = position;
+    }
+
+    songs.swap(ordered);
+    return true;
+}
+
+// Generation
+PlaylistGeneratorResult PlaylistGenerator::generate(SongDatabase& db, const PlaylistGeneratorRequest& request,
+                                                    Playlist& out, std::time_t now) {
+    PlaylistGeneratorResult result;
+    int target = request.targetSeconds;
+    int tolerance = request.toleranceSeconds;
+    if (target <= 0 || tolerance < 0 || target + tolerance > MAX_TARGET_SECONDS) {
+        result.error = "Target duration must be between 1 second and 24 hours";
+        return result;
+    }
+
+    std::vector<std::vector<const Song*>> byDuration;
+    result.candidates = collectCandidates(db, request.rule, now, target + tolerance, byDuration);
+    if (result.candidates == 0) {
+        result.error = "No songs match " + request.rule.describe();
+        return result;
+    }
+
+    std::vector<int> counts;
+    std::vector<const Song*> picked;
+    for (int attempt = 0; attempt < MAX_ATTEMPTS; attempt++) {
+        unsigned int seed = request.seed + static_cast<unsigned int>(attempt);
+        int total = solveDurations(byDuration, target, tolerance, seed, counts);
+        if (total < 0) {
+            // The set of reachable totals does not depend on the bucket order
+            result.error = "No combination of matching songs fits within the tolerance";
+            return result;
+        }
+
+        drawSongs(byDuration, counts, seed, picked);
+        if (!arrange(picked, request.artistSpacing)) continue;
+
+        out.clear();
+        for (const Song* song : picked) {
+            out.add_song(*song);
+        }
+        result.success = true;
+        result.totalDuration = total;
+        result.songCount = static_cast<int>(picked.size());
+        return result;
+    }
+
+    result.error = "Not enough distinct artists to keep repeats " + std::to_string(request.artistSpacing) +
+                   " tracks apart";
+    return result;
+}
@@ -0,0 +1,233 @@
+#include "../include/playlist_index.h"
+#include "../include/playlist.h"
+#include <vector>
+
+// Constructor
+PlaylistIndex::PlaylistIndex() : root(nullptr), rng(std::random_device{}()) {}
+
+// Treap primitives
+int PlaylistIndex::countOf(const PlaylistNode* node) {
+    return node ? node->links.count : 0;
+}
+
+long long PlaylistIndex::durationOf(const PlaylistNode* node) {
+    return node ? node->links.duration : 0;
+}
+
+void PlaylistIndex::pull(PlaylistNode* node) {
+    PlaylistIndexLinks& links = node->links;
+    links.count = 1 + countOf(links.left) + countOf(links.right);
+    links.duration = node->song.getDuration() + durationOf(links.left) + durationOf(links.right);
+}
+
+void PlaylistIndex::split(PlaylistNode* node, int count, PlaylistNode*& left, PlaylistNode*& right) {
+    if (node == nullptr) {
+        left = right = nullptr;
+        return;
+    }
+
+    PlaylistIndexLinks& links = node->links;
+    if (countOf(links.left) < count) {
+        split(links.right, count - countOf(links.left) - 1, links.right, right);
+        if (links.right != nullptr) links.right->links.parent = node;
+        left = node;
+    } else {
+        split(links.left, count, left, links.left);
+        if (links.left != nullptr) links.left->links.parent = node;
+        right = node;
+    }
+    links.parent = nullptr;
+    pull(node);
+}
+
+PlaylistNode* PlaylistIndex::merge(PlaylistNode* left, PlaylistNode* right) {
+    if (left == nullptr) return right;
+    if (right == nullptr) return left;
+
+    if (left->links.priority > right->links.priority) {
+        left->links.right = merge(left->links.right, right);
+        left->links.right->links.parent = left;
+        pull(left);
+        return left;
+    }
+    right->links.left = merge(left, right->links.left);
+    right->links.left->links.parent = right;
+    pull(right);
+    return right;
+}
+
+void PlaylistIndex::resetLinks(PlaylistNode* node) {
+    PlaylistIndexLinks& links = node->links;
+    links.parent = links.left = links.right = nullptr;
+    links.priority = static_cast<unsigned int>(rng());
+    pull(node);
+}
+
+// Structure maintenance
+void PlaylistIndex::clear() {
+    root = nullptr;
+}
+
+void PlaylistIndex::rebuild(PlaylistNode* head) {
+    // Build the treap over the list order in one pass: the stack holds the
+    // right spine, and each node adopts the lower-priority nodes it pops
+    std::vector<PlaylistNode*> spine;
+    for (PlaylistNode* node = head; node != nullptr; node = node->next) {
+        resetLinks(node);
+        PlaylistNode* last = nullptr;
+        while (!spine.empty() && spine.back()->links.priority < node->links.priority) {
+            last = spine.back();
+            spine.pop_back();
+            pull(last);
+        }
+        node->links.left = last;
+        if (last != nullptr) last->links.parent = node;
+        if (!spine.empty()) {
+            spine.back()->links.right = node;
+            node->links.parent = spine.back();
+        }
+        spine.push_back(node);
+    }
+
+    while (spine.size() > 1) {
+        pull(spine.back());
+        spine.pop_back();
+    }
+    root = spine.empty() ? nullptr : spine.front();
+    if (root != nullptr) pull(root);
+}
+
+void PlaylistIndex::insertAfter(PlaylistNode* node, PlaylistNode* afterNode) {
+    insertAt(node, (afterNode == nullptr) ? 0 : rankOf(afterNode) + 1);
+}
+
+void PlaylistIndex::insertAt(PlaylistNode* node, int index) {
+    resetLinks(node);
+
+    PlaylistNode* left;
+    PlaylistNode* right;
+    split(root, index, left, right);
+    root = merge(merge(left, node), right);
+    root->links.parent = nullptr;
+}
+
+void PlaylistIndex::erase(PlaylistNode* node) {
+    eraseAt(rankOf(node));
+}
+
+PlaylistNode* PlaylistIndex::eraseAt(int index) {
+    PlaylistNode* left;
+    PlaylistNode* rest;
+    PlaylistNode* removed;
+    PlaylistNode* right;
+    split(root, index, left, rest);
+    split(rest, 1, removed, right);
+    root = merge(left, right);
+    if (root != nullptr) root->links.parent = nullptr;
+    if (removed != nullptr) {
+        removed->links.parent = removed->links.left = removed->links.right = nullptr;
+    }
+    return removed;
+}
+
+void PlaylistIndex::refresh(PlaylistNode* node) {
+    // Re-sum every subtree on the path to the root after a duration change
+    for (PlaylistNode* current = node; current != nullptr; current = current->links.parent) {
+        pull(current);
+    }
+}
+
+// Queries
+int PlaylistIndex::rankOf(const PlaylistNode* node) const {
+    int rank = countOf(node->links.left);
+    for (const PlaylistNode* current = node; current->links.parent != nullptr; current = current->links.parent) {
+        const PlaylistNode* parent = current->links.parent;
+        if (parent->links.right == current) {
+            rank += countOf(parent->links.left) + 1;
+        }
+    }
+    return rank;
+}
+
+PlaylistNode* PlaylistIndex::nodeAt(int index) const {
+    if (index < 0 || index >= countOf(root)) return nullptr;
+
+    PlaylistNode* current = root;
+    while (current != nullptr) {
+        int leftCount = countOf(current->links.left);
+        if (index < leftCount) {
+            current = current->links.left;
+        } else if (index == leftCount) {
+            return current;
+        } else {
+            index -= leftCount + 1;
+            current = current->links.right;
+        }
+    }
+    return nullptr;
+}
+
+PlaylistNode* PlaylistIndex::successorOf(const PlaylistNode* node) const {
+    // Leftmost node of the right subtree, else the first ancestor reached from the left
+    if (node->links.right != nullptr) {
+        PlaylistNode* current = node->links.right;
+        while (current->links.left != nullptr) current = current->links.left;
+        return current;
+    }
+    while (node->links.parent != nullptr && node->links.parent->links.right == node) {
+        node = node->links.parent;
+    }
+    return node->links.parent;
+}
+
+long long PlaylistIndex::offsetOf(const PlaylistNode* node) const {
+    long long offset = durationOf(node->links.left);
+    for (const PlaylistNode* current = node; current->links.parent != nullptr; current = current->links.parent) {
+        const PlaylistNode* parent = current->links.parent;
+        if (parent->links.right == current) {
+            offset += durationOf(parent->links.left) + parent->song.getDuration();
+        }
+    }
+    return offset;
+}
+
+PlaylistNode* PlaylistIndex::nodeAtOffset(long long seconds) const {
+    if (seconds < 0 || seconds >= totalDuration()) return nullptr;
+
+    PlaylistNode* current = root;
+    while (current != nullptr) {
+        long long leftDuration = durationOf(current->links.left);
+        if (seconds < leftDuration) {
+            current = current->links.left;
+            continue;
+        }
+        seconds -= leftDuration;
+        if (seconds < current->song.getDuration()) {
+            return current;
+        }
+        seconds -= current->song.getDuration();
+        current = current->links.right;
+    }
+    return nullptr;
+}
+
+int PlaylistIndex::countWithin(long long seconds) const {
+    // Longest prefix whose total duration does not exceed the limit
+    int count = 0;
+    PlaylistNode* current = root;
+    while (current != nullptr) {
+        long long throughCurrent = durationOf(current->links.left) + current->song.getDuration();
+        if (throughCurrent <= seconds) {
+            seconds -= throughCurrent;
+            count += countOf(current->links.left) + 1;
+            current = current->links.right;
+        } else {
+            current = current->links.left;
+        }
+    }
+    return count;
+}
+
+long long PlaylistIndex::totalDuration() const {
+    return durationOf(root);
+}
@@ -0,0 +1,388 @@
+#include "../include/playlist_io.h"
+#include <charconv>
+#include <fstream>
+
+// BufferedWriter implementation
+PlaylistIO::BufferedWriter::BufferedWriter(const std::string& filename)
+    : file(std::fopen(filename.c_str(), "wb")), buffer(WRITE_BUFFER_SIZE), used(0), failed(false) {
+    if (file == nullptr) failed = true;
+}
+
+PlaylistIO::BufferedWriter::~BufferedWriter() {
+    close();
+}
+
+bool PlaylistIO::BufferedWriter::isOpen() const {
+    return file != nullptr;
+}
+
+void PlaylistIO::BufferedWriter::write(const char* data, size_t length) {
+    if (used + length > buffer.size()) {
+        flush();
+        if (length > buffer.size()) {
+            // Larger than the whole buffer: write it straight through
+            if (file == nullptr || std::fwrite(data, 1, length, file) != length) failed = true;
+            return;
+        }
+    }
+    std::copy(data, data + length, buffer.begin() + used);
+    used += length;
+}
+
+void PlaylistIO::BufferedWriter::write(const std::string& text) {
+    write(text.data(), text.size());
+}
+
+void PlaylistIO::BufferedWriter::write(char c) {
+    if (used == buffer.size()) flush();
+    buffer[used++] = c;
+}
+
+void PlaylistIO::BufferedWriter::writeInt(long long value) {
+    char digits[24];
+    auto converted = std::to_chars(digits, digits + sizeof(digits), value);
+    write(digits, static_cast<size_t>(converted.ptr - digits));
+}
+
+bool PlaylistIO::BufferedWriter::flush() {
+    if (used > 0) {
+        if (file == nullptr || std::fwrite(buffer.data(), 1, used, file) != used) failed = true;
+        used = 0;
+    }
+    return !failed;
+}
+
+bool PlaylistIO::BufferedWriter::close() {
+    if (file == nullptr) return false;
+    flush();
+    if (std::fclose(file) != 0) failed = true;
+    file = nullptr;
+    return !failed;
+}
+
+// Helper methods
+void PlaylistIO::resolveBatch(std::vector<PendingEntry>& batch, size_t count, Playlist& playlist,
+                              SongDatabase& db, PlaylistIOResult& result) {
+    for (size_t i = 0; i < count; i++) {
+        const PendingEntry& entry = batch[i];
+        Song* song = entry.id.empty() ? nullptr : db.search_by_id(entry.id);
+        if (song == nullptr && !entry.title.empty()) {
+            song = db.search_by_title_artist(entry.title, entry.artist);
+        }
+
+        if (song != nullptr) {
+            playlist.add_song(*song);
+            result.imported++;
+        } else {
+            result.unresolved++;
+        }
+    }
+}
+
+void PlaylistIO::writeJsonString(BufferedWriter& writer, const std::string& text) {
+    static const char hex[] = "0123456789abcdef";
+    writer.write('"');
+    for (char c : text) {
+        unsigned char u = static_cast<unsigned char>(c);
+        switch (c) {
+            case '"': writer.write("\\\"", 2); break;
+            case '\\': writer.write("\\\\", 2); break;
+            case '\n': writer.write("\\n", 2); break;
+            case '\r': writer.write("\\r", 2); break;
+            case '\t': writer.write("\\t", 2); break;
+            default:
+                if (u < 0x20) {
+                    char escaped[6] = {'\\', 'u', '0', '0', hex[u >> 4], hex[u & 0xF]};
+                    writer.write(escaped, 6);
+                } else {
+                    writer.write(c);
+                }
+        }
+    }
+    writer.write('"');
+}
+
+void PlaylistIO::writeM3uText(BufferedWriter& writer, const std::string& text) {
+    // M3U is line based, so line breaks inside metadata become spaces
+    for (char c : text) {
+        writer.write((c == '\n' || c == '\r') ? ' ' : c);
+    }
+}
+
+bool PlaylistIO::parseJsonString(const std::string& line, size_t& pos, std::string& out) {
+    if (pos >= line.size() || line[pos] != '"') return false;
+    pos++;
+    out.clear();
+
+    while (pos < line.size()) {
+        // Copy the unescaped run in one append
+        size_t special = line.find_first_of("\"\\", pos);
+        if (special == std::string::npos) return false;
+        out.append(line, pos, special - pos);
+        pos = special + 1;
+        if (line[special] == '"') return true;
+        if (pos >= line.size()) return false;
+
+        char escape = line[pos++];
+        switch (escape) {
+            case '"': out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '/': out += '/'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u': {
+                if (pos + 4 > line.size()) return false;
+                unsigned int code = 0;
+                auto parsed = std::from_chars(line.data() + pos, line.data() + pos + 4, code, 16);
+                if (parsed.ptr != line.data() + pos + 4) return false;
+                pos += 4;
+                // Encode the code unit as UTF-8 (surrogate pairs are kept as-is)
+                if (code < 0x80) {
+                    out += static_cast<char>(code);
+                } else if (code < 0x800) {
+                    out += static_cast<char>(0xC0 | (code >> 6));
+                    out += static_cast<char>(0x80 | (code & 0x3F));
+                } else {
+                    out += static_cast<char>(0xE0 | (code >> 12));
+                    out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                    out += static_cast<char>(0x80 | (code & 0x3F));
+                }
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    return false;
+}
+
+bool PlaylistIO::skipJsonValue(const std::string& line, size_t& pos) {
+    // Entries are flat, so only strings and bare scalars need skipping
+    if (pos < line.size() && line[pos] == '"') {
+        for (pos++; pos < line.size(); pos++) {
+            if (line[pos] == '\\') {
+                pos++;
+            } else if (line[pos] == '"') {
+                pos++;
+                return true;
+            }
+        }
+        return false;
+    }
+    size_t start = pos;
+    while (pos < line.size() && line[pos] != ',' && line[pos] != '}' && line[pos] != ' ') {
+        pos++;
+    }
+    return pos > start;
+}
+
+bool PlaylistIO::parseJsonEntry(const std::string& line, PendingEntry& entry) {
+    entry.id.clear();
+    entry.title.clear();
+    entry.artist.clear();
+
+    size_t pos = line.find_first_not_of(" \t\r");
+    if (pos == std::string::npos || line[pos] != '{') return false;
+    pos++;
+
+    std::string key;
+    while (true) {
+        pos = line.find_first_not_of(" \t\r", pos);
+        if (pos == std::string::npos) return false;
+        if (line[pos] == '}') break;
+        if (!parseJsonString(line, pos, key)) return false;
+
+        pos = line.find_first_not_of(" \t\r", pos);
+        if (pos == std::string::npos || line[pos] != ':') return false;
+        pos = line.find_first_not_of(" \t\r", pos + 1);
+        if (pos == std::string::npos) return false;
+
+        bool parsed;
+        if (key == "id") {
+            parsed = parseJsonString(line, pos, entry.id);
+        } else if (key == "title") {
+            parsed = parseJsonString(line, pos, entry.title);
+        } else if (key == "artist") {
+            parsed = parseJsonString(line, pos, entry.artist);
+        } else {
+            parsed = skipJsonValue(line, pos);
+        }
+        if (!parsed) return false;
+
+        pos = line.find_first_not_of(" \t\r", pos);
+        if (pos == std::string::npos) return false;
+        if (line[pos] == ',') {
+            pos++;
+        } else if (line[pos] != '}') {
+            return false;
+        }
+    }
+    return !entry.id.empty() || !entry.title.empty();
+}
+
+bool PlaylistIO::parseExtinf(const std::string& line, PendingEntry& entry) {
+    // #EXTINF:<seconds>,<artist> - <title>
+    size_t comma = line.find(',');
+    if (comma == std::string::npos) return false;
+
+    std::string display = line.substr(comma + 1);
+    if (!display.empty() && display.back() == '\r') display.pop_back();
+    size_t separator = display.find(" - ");
+    if (separator == std::string::npos) {
+        entry.artist.clear();
+        entry.title = display;
+    } else {
+        entry.artist = display.substr(0, separator);
+        entry.title = display.substr(separator + 3);
+    }
+    return true;
+}
+
+// Export
+PlaylistIOResult PlaylistIO::export_m3u(const Playlist& playlist, const std::string& filename) {
+    PlaylistIOResult result;
+    BufferedWriter writer(filename);
+    if (!writer.isOpen()) {
+        result.error = "could not open " + filename + " for writing";
+        return result;
+    }
+
+    writer.write("#EXTM3U\n");
+    writer.write("#PLAYLIST:");
+    writeM3uText(writer, playlist.getName());
+    writer.write('\n');
+    for (PlaylistNode* node = playlist.getHead(); node != nullptr; node = node->next) {
+        const Song& song = node->song;
+        writer.write("#EXTINF:");
+        writer.writeInt(song.getDuration());
+        writer.write(',');
+        writeM3uText(writer, song.getArtist());
+        writer.write(" - ", 3);
+        writeM3uText(writer, song.getTitle());
+        writer.write('\n');
+        writeM3uText(writer, song.getId());
+        writer.write('\n');
+        result.entries++;
+    }
+
+    result.success = writer.close();
+    if (!result.success) result.error = "write to " + filename + " failed";
+    return result;
+}
+
+PlaylistIOResult PlaylistIO::export_jsonl(const Playlist& playlist, const std::string& filename) {
+    PlaylistIOResult result;
+    BufferedWriter writer(filename);
+    if (!writer.isOpen()) {
+        result.error = "could not open " + filename + " for writing";
+        return result;
+    }
+
+    for (PlaylistNode* node = playlist.getHead(); node != nullptr; node = node->next) {
+        const Song& song = node->song;
+        writer.write("{\"id\":", 6);
+        writeJsonString(writer, song.getId());
+        writer.write(",\"title\":", 9);
+        writeJsonString(writer, song.getTitle());
+        writer.write(",\"artist\":", 10);
+        writeJsonString(writer, song.getArtist());
+        writer.write(",\"album\":", 9);
+        writeJsonString(writer, song.getAlbum());
+        writer.write(",\"genre\":", 9);
+        writeJsonString(writer, song.getGenre());
+        writer.write(",\"duration\":", 12);
+        writer.writeInt(song.getDuration());
+        writer.write(",\"rating\":", 10);
+        writer.writeInt(song.getRating());
+        writer.write(",\"added\":", 9);
+        writeJsonString(writer, song.getAddedDate());
+        writer.write("}\n", 2);
+        result.entries++;
+    }
+
+    result.success = writer.close();
+    if (!result.success) result.error = "write to " + filename + " failed";
+    return result;
+}
+
+// Import
+PlaylistIOResult PlaylistIO::import_m3u(Playlist& playlist, SongDatabase& db, const std::string& filename) {
+    PlaylistIOResult result;
+    std::vector<char> readBuffer(WRITE_BUFFER_SIZE);
+    std::ifstream file;
+    file.rdbuf()->pubsetbuf(readBuffer.data(), static_cast<std::streamsize>(readBuffer.size()));
+    file.open(filename, std::ios::binary);
+    if (!file.is_open()) {
+        result.error = "could not open " + filename + " for reading";
+        return result;
+    }
+
+    std::vector<PendingEntry> batch(RESOLVE_BATCH_SIZE);
+    size_t count = 0;
+    bool haveInfo = false;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) continue;
+
+        PendingEntry& entry = batch[count];
+        if (line.compare(0, 8, "#EXTINF:") == 0) {
+            haveInfo = parseExtinf(line, entry);
+            continue;
+        }
+        if (line[0] == '#') continue;
+
+        // A location line completes the entry
+        if (!haveInfo) {
+            entry.title.clear();
+            entry.artist.clear();
+        }
+        entry.id = line;
+        haveInfo = false;
+        result.entries++;
+        if (++count == batch.size()) {
+            resolveBatch(batch, count, playlist, db, result);
+            count = 0;
+        }
+    }
+    resolveBatch(batch, count, playlist, db, result);
+
+    result.success = true;
+    return result;
+}
+
+PlaylistIOResult PlaylistIO::import_jsonl(Playlist& playlist, SongDatabase& db, const std::string& filename) {
+    PlaylistIOResult result;
+    std::vector<char> readBuffer(WRITE_BUFFER_SIZE);
+    std::ifstream file;
+    file.rdbuf()->pubsetbuf(readBuffer.data(), static_cast<std::streamsize>(readBuffer.size()));
+    file.open(filename, std::ios::binary);
+    if (!file.is_open()) {
+        result.error = "could not open " + filename + " for reading";
+        return result;
+    }
+
+    std::vector<PendingEntry> batch(RESOLVE_BATCH_SIZE);
+    size_t count = 0;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+
+        result.entries++;
+        if (!parseJsonEntry(line, batch[count])) {
+            result.malformed++;
+            continue;
+        }
+        if (++count == batch.size()) {
+            resolveBatch(batch, count, playlist, db, result);
+            count = 0;
+        }
+    }
+    resolveBatch(batch, count, playlist, db, result);
+
+    result.success = true;
+    return result;
+}
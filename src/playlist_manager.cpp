@@ -0,0 +1,207 @@
+#include "../include/playlist_manager.h"
+
+// Constructors
+PlaylistManager::PlaylistManager() : songDatabase(nullptr), nextId(1) {}
+
+PlaylistManager::PlaylistManager(SongDatabase* db) : songDatabase(db), nextId(1) {}
+
+// Helper methods
+PlaylistManager::PlaylistEntry* PlaylistManager::findEntry(PlaylistId id) {
+    auto it = playlists.find(id);
+    return it != playlists.end() ? &(it->second) : nullptr;
+}
+
+const PlaylistManager::PlaylistEntry* PlaylistManager::findEntry(PlaylistId id) const {
+    auto it = playlists.find(id);
+    return it != playlists.end() ? &(it->second) : nullptr;
+}
+
+// Playlist lifecycle
+PlaylistId PlaylistManager::create_playlist(const std::string& name) {
+    if (name.empty() || playlistsByName.find(name) != playlistsByName.end()) {
+        return INVALID_PLAYLIST_ID;
+    }
+
+    PlaylistId id = nextId++;
+    PlaylistEntry& entry = playlists[id];
+    entry.id = id;
+    entry.name = name;
+    playlistsByName[name] = id;
+    return id;
+}
+
+bool PlaylistManager::delete_playlist(PlaylistId id) {
+    auto it = playlists.find(id);
+    if (it == playlists.end()) return false;
+
+    playlistsByName.erase(it->second.name);
+    playlists.erase(it);
+    return true;
+}
+
+bool PlaylistManager::rename_playlist(PlaylistId id, const std::string& newName) {
+    PlaylistEntry* entry = findEntry(id);
+    if (entry == nullptr || newName.empty()) return false;
+    if (entry->name == newName) return true;
+    if (playlistsByName.find(newName) != playlistsByName.end()) return false;
+
+    playlistsByName.erase(entry->name);
+    entry->name = newName;
+    playlistsByName[newName] = id;
+    return true;
+}
+
+PlaylistId PlaylistManager::find_playlist(const std::string& name) const {
+    auto it = playlistsByName.find(name);
+    return it != playlistsByName.end() ? it->second : INVALID_PLAYLIST_ID;
+}
+
+std::vector<std::pair<PlaylistId, std::string>> PlaylistManager::list_playlists() const {
+    std::vector<std::pair<PlaylistId, std::string>> result;
+    result.reserve(playlistsByName.size());
+    for (const auto& pair : playlistsByName) {
+        result.push_back(std::make_pair(pair.second, pair.first));
+    }
+    return result;
+}
+
+bool PlaylistManager::contains_playlist(PlaylistId id) const {
+    return findEntry(id) != nullptr;
+}
+
+// Entry operations
+bool PlaylistManager::add_song(PlaylistId id, const std::string& songId) {
+    PlaylistEntry* entry = findEntry(id);
+    if (entry == nullptr) return false;
+    return insert_song_at(id, songId, static_cast<int>(entry->songs.size()));
+}
+
+bool PlaylistManager::insert_song_at(PlaylistId id, const std::string& songId, int position) {
+    PlaylistEntry* entry = findEntry(id);
+    if (entry == nullptr || songDatabase == nullptr) return false;
+    if (position < 0 || position > static_cast<int>(entry->songs.size())) return false;
+
+    SongHandle handle = songDatabase->get_handle(songId);
+    if (handle == INVALID_SONG_HANDLE) return false;
+
+    entry->songs.insert(entry->songs.begin() + position, handle);
+    return true;
+}
+
+bool PlaylistManager::remove_song_at(PlaylistId id, int position) {
+    PlaylistEntry* entry = findEntry(id);
+    if (entry == nullptr) return false;
+    if (position < 0 || position >= static_cast<int>(entry->songs.size())) return false;
+
+    entry->songs.erase(entry->songs.begin() + position);
+    return true;
+}
+
+int PlaylistManager::get_playlist_size(PlaylistId id) const {
+    const PlaylistEntry* entry = findEntry(id);
+    return entry ? static_cast<int>(entry->songs.size()) : 0;
+}
+
+std::string PlaylistManager::get_playlist_name(PlaylistId id) const {
+    const PlaylistEntry* entry = findEntry(id);
+    return entry ? entry->name : "";
+}
+
+std::vector<const Song*> PlaylistManager::get_songs(PlaylistId id) const {
+    std::vector<const Song*> result;
+    const PlaylistEntry* entry = findEntry(id);
+    if (entry == nullptr || songDatabase == nullptr) return result;
+
+    result.reserve(entry->songs.size());
+    for (SongHandle handle : entry->songs) {
+        // Songs deleted from the database are skipped until re-inserted
+        const Song* song = songDatabase->resolve_handle(handle);
+        if (song != nullptr) {
+            result.push_back(song);
+        }
+    }
+    return result;
+}
+
+// Conversion to and from full playlists
+PlaylistId PlaylistManager::import_playlist(const Playlist& playlist, const std::string& name) {
+    if (songDatabase == nullptr) return INVALID_PLAYLIST_ID;
+
+    PlaylistId id = create_playlist(name.empty() ? playlist.getName() : name);
+    if (id == INVALID_PLAYLIST_ID) return id;
+
+    PlaylistEntry* entry = findEntry(id);
+    entry->songs.reserve(playlist.getSize());
+    for (PlaylistNode* node = playlist.getHead(); node != nullptr; node = node->next) {
+        SongHandle handle = songDatabase->get_handle(node->song.getId());
+        if (handle != INVALID_SONG_HANDLE) {
+            entry->songs.push_back(handle);
+        }
+    }
+    return id;
+}
+
+Playlist PlaylistManager::to_playlist(PlaylistId id) const {
+    Playlist playlist(get_playlist_name(id));
+    for (const Song* song : get_songs(id)) {
+        playlist.add_song(*song);
+    }
+    return playlist;
+}
+
+// Memory reporting
+size_t PlaylistManager::get_playlist_memory(PlaylistId id) const {
+    const PlaylistEntry* entry = findEntry(id);
+    if (entry == nullptr) return 0;
+
+    // Entry payload plus the hash node and the name-index node that own it
+    size_t bytes = sizeof(PlaylistEntry) + sizeof(PlaylistId) + 2 * sizeof(void*);
+    bytes += sizeof(std::string) + sizeof(PlaylistId) + 4 * sizeof(void*);
+    if (entry->name.capacity() > 15) {
+        bytes += 2 * (entry->name.capacity() + 1);
+    }
+    bytes += entry->songs.capacity() * sizeof(SongHandle);
+    return bytes;
+}
+
+size_t PlaylistManager::get_total_memory() const {
+    size_t bytes = sizeof(PlaylistManager) + playlists.bucket_count() * sizeof(void*);
+    for (const auto& pair : playlists) {
+        bytes += get_playlist_memory(pair.first);
+    }
+    return bytes;
+}
+
+int PlaylistManager::get_playlist_count() const {
+    return static_cast<int>(playlists.size());
+}
+
+void PlaylistManager::display_playlists() const {
+    std::cout << "\n=== Playlist Library ===" << std::endl;
+    std::cout << "Total playlists: " << get_playlist_count() << std::endl;
+    std::cout << "Total memory: " << get_total_memory() << " bytes\n" << std::endl;
+
+    if (playlists.empty()) {
+        std::cout << "No saved playlists!" << std::endl;
+        return;
+    }
+
+    int index = 1;
+    for (const auto& pair : playlistsByName) {
+        std::cout << index << ". " << pair.first
+                  << " (" << get_playlist_size(pair.second) << " songs, "
+                  << get_playlist_memory(pair.second) << " bytes)" << std::endl;
+        index++;
+    }
+    std::cout << std::endl;
+}
+
+// Management
+void PlaylistManager::clear() {
+    playlists.clear();
+    playlistsByName.clear();
+}
+
+void PlaylistManager::setSongDatabase(SongDatabase* db) {
+    songDatabase = db;
+}
@@ -1,14 +1,19 @@
 #include "../include/playwise_app.h"
 #include <iostream>
+#include <iomanip>
 #include <string>
 #include <vector>
 #include <limits>
 #include <unordered_set>
+#include <ctime>
 
 // Constructor
 PlayWiseApp::PlayWiseApp() : currentPlaylist(nullptr), playbackHistory(nullptr),
                              ratingTree(nullptr), songDatabase(nullptr), dashboard(nullptr),
-                                 songCleaner(nullptr), favoriteSongsQueue(nullptr),
+                                 songCleaner(nullptr), favoriteSongsQueue(nullptr), playlistManager(nullptr),
+                                 playQueue(nullptr), historyLog(nullptr), playTrends(nullptr),
+                                 playDistincts(nullptr), sessionTotals(nullptr), sessionizer(nullptr),
+                                 editJournal(nullptr),
     isRunning(false), currentUser("User") {
     initializeSystem();
 }
@@ -25,11 +30,26 @@ void PlayWiseApp::initializeSystem() {
     // Create system components
     currentPlaylist = new Playlist("My Playlist");
     playbackHistory = new History(50);
+    playTrends = new PlayTrends();
+    playbackHistory->add_listener(playTrends);
+    playDistincts = new PlayDistincts();
+    playDistincts->set_listener(currentUser);
+    playbackHistory->add_listener(playDistincts);
+    sessionTotals = new SessionAggregator();
+    sessionizer = new Sessionizer(sessionTotals->as_sink());
+    sessionizer->set_listener(currentUser);
+    playbackHistory->add_listener(sessionizer);
     ratingTree = new RatingTree();
     songDatabase = new SongDatabase();
     dashboard = new Dashboard(currentPlaylist, playbackHistory, ratingTree, songDatabase);
     songCleaner = new SongCleaner();
     favoriteSongsQueue = new FavoriteSongsQueue();
+    playlistManager = new PlaylistManager(songDatabase);
+    dashboard->setPlaylistManager(playlistManager);
+    dashboard->setPlayTrends(playTrends);
+    dashboard->setPlayDistincts(playDistincts);
+    playQueue = new PlayQueue(currentPlaylist, playbackHistory, favoriteSongsQueue);
+    editJournal = new EditJournal(currentPlaylist, playbackHistory, ratingTree, songDatabase, favoriteSongsQueue);
 
     
     // Load sample data
@@ -59,6 +79,8 @@ void PlayWiseApp::displayMainMenu() {
     std::cout << "|  8. Favorite Songs Queue                                   |" << std::endl;
 std::cout << "|  9. Simulate Playback                                      |" << std::endl;
 std::cout << "|  10. System Operations                                     |" << std::endl;
+    std::cout << "|  11. Undo Last Change                                      |" << std::endl;
+    std::cout << "|  12. Redo                                                  |" << std::endl;
     std::cout << "|  0. Exit                                                   |" << std::endl;
     std::cout << "+==============================================================+" << std::endl;
     std::cout << "Enter your choice: ";
@@ -75,10 +97,15 @@ void PlayWiseApp::handlePlaylistOperations() {
         std::cout << "5. Reverse playlist" << std::endl;
         std::cout << "6. Shuffle playlist" << std::endl;
         std::cout << "7. Search song in playlist" << std::endl;
+        std::cout << "8. Save playlist to library" << std::endl;
+        std::cout << "9. Show playlist library" << std::endl;
+        std::cout << "10. Export playlist to file (M3U/JSONL)" << std::endl;
+        std::cout << "11. Import playlist from file (M3U/JSONL)" << std::endl;
+        std::cout << "12. Generate playlist by duration" << std::endl;
         std::cout << "0. Back to main menu" << std::endl;
         std::cout << "Enter your choice: ";
         
-        int choice = getValidChoice(0, 7);
+        int choice = getValidChoice(0, 12);
         
         switch (choice) {
             case 0:
@@ -94,7 +121,7 @@ void PlayWiseApp::handlePlaylistOperations() {
                     pauseScreen();
                     break;
                 }
-                currentPlaylist->add_song(*selectedSong);
+                editJournal->add_song(*selectedSong);
                 dashboard->updateStats();
                 std::cout << "Song added to playlist!" << std::endl;
                 pauseScreen();
@@ -103,7 +130,7 @@ void PlayWiseApp::handlePlaylistOperations() {
             case 3: {
                 currentPlaylist->display();
                 int index = getValidInt("Enter song index to delete: ", 1, currentPlaylist->getSize());
-                if (currentPlaylist->delete_song(index - 1)) {
+                if (editJournal->delete_song(index - 1)) {
                     dashboard->updateStats();
                     std::cout << "Song deleted successfully!" << std::endl;
                 } else {
@@ -116,7 +143,7 @@ void PlayWiseApp::handlePlaylistOperations() {
                 currentPlaylist->display();
                 int fromIndex = getValidInt("Enter source index: ", 1, currentPlaylist->getSize());
                 int toIndex = getValidInt("Enter destination index: ", 1, currentPlaylist->getSize());
-                if (currentPlaylist->move_song(fromIndex - 1, toIndex - 1)) {
+                if (editJournal->move_song(fromIndex - 1, toIndex - 1)) {
                     std::cout << "Song moved successfully!" << std::endl;
                 } else {
                     std::cout << "Failed to move song!" << std::endl;
@@ -125,12 +152,13 @@ void PlayWiseApp::handlePlaylistOperations() {
                 break;
             }
             case 5:
-                currentPlaylist->reverse_playlist();
+                editJournal->reverse_playlist();
                 std::cout << "Playlist reversed successfully!" << std::endl;
                 pauseScreen();
                 break;
             case 6:
                 currentPlaylist->shuffle();
+                editJournal->clear();
                 std::cout << "Playlist shuffled successfully!" << std::endl;
                 pauseScreen();
                 break;
@@ -144,6 +172,70 @@ void PlayWiseApp::handlePlaylistOperations() {
                 pauseScreen();
                 break;
             }
+            case 8: {
+                std::string name = getValidString("Enter a name for the saved playlist: ");
+                if (playlistManager->import_playlist(*currentPlaylist, name) != INVALID_PLAYLIST_ID) {
+                    dashboard->updateStats();
+                    std::cout << "Playlist saved to library!" << std::endl;
+                } else {
+                    std::cout << "A playlist with that name already exists!" << std::endl;
+                }
+                pauseScreen();
+                break;
+            }
+            case 9:
+                playlistManager->display_playlists();
+                pauseScreen();
+                break;
+            case 10: {
+                std::string filename = getValidString("Enter file name (.m3u or .jsonl): ");
+                bool jsonl = filename.size() >= 6 && filename.compare(filename.size() - 6, 6, ".jsonl") == 0;
+                PlaylistIOResult result = jsonl ? PlaylistIO::export_jsonl(*currentPlaylist, filename)
+                                                : PlaylistIO::export_m3u(*currentPlaylist, filename);
+                if (result.success) {
+                    std::cout << "Exported " << result.entries << " songs to " << filename << std::endl;
+                } else {
+                    std::cout << "Export failed: " << result.error << std::endl;
+                }
+                pauseScreen();
+                break;
+            }
+            case 11: {
+                std::string filename = getValidString("Enter file name (.m3u or .jsonl): ");
+                bool jsonl = filename.size() >= 6 && filename.compare(filename.size() - 6, 6, ".jsonl") == 0;
+                PlaylistIOResult result = jsonl ? PlaylistIO::import_jsonl(*currentPlaylist, *songDatabase, filename)
+                                                : PlaylistIO::import_m3u(*currentPlaylist, *songDatabase, filename);
+                if (result.success) {
+                    dashboard->updateStats();
+                    std::cout << "Imported " << result.imported << " of " << result.entries << " entries ("
+                              << result.unresolved << " unresolved, " << result.malformed << " malformed)" << std::endl;
+                } else {
+                    std::cout << "Import failed: " << result.error << std::endl;
+                }
+                pauseScreen();
+                break;
+            }
+            case 12: {
+                PlaylistGeneratorRequest request;
+                request.rule.genre = getValidString("Enter genre (empty for any): ");
+                request.rule.minRating = getValidInt("Enter minimum rating (1-5): ", 1, 5);
+                request.targetSeconds = getValidInt("Enter target length in minutes (1-1440): ", 1, 1440) * 60;
+                request.toleranceSeconds = getValidInt("Enter tolerance in seconds (0-600): ", 0, 600);
+                request.artistSpacing = getValidInt("Keep each artist apart by how many tracks (0-10): ", 0, 10);
+                request.seed = static_cast<unsigned int>(std::time(nullptr));
+                
+                PlaylistGeneratorResult result = PlaylistGenerator::generate(*songDatabase, request, *currentPlaylist);
+                if (result.success) {
+                    editJournal->clear();
+                    dashboard->updateStats();
+                    std::cout << "Generated " << result.songCount << " songs, " << result.totalDuration / 60 << "m "
+                              << result.totalDuration % 60 << "s, from " << result.candidates << " candidates" << std::endl;
+                } else {
+                    std::cout << "Generation failed: " << result.error << std::endl;
+                }
+                pauseScreen();
+                break;
+            }
         }
     }
 }
@@ -157,10 +249,12 @@ void PlayWiseApp::handleHistoryOperations() {
         std::cout << "3. Undo last played song" << std::endl;
         std::cout << "4. Clear history" << std::endl;
         std::cout << "5. Export history to file" << std::endl;
+        std::cout << "6. Plays in a recent time window" << std::endl;
+        std::cout << "7. Listening sessions" << std::endl;
         std::cout << "0. Back to main menu" << std::endl;
         std::cout << "Enter your choice: ";
         
-        int choice = getValidChoice(0, 5);
+        int choice = getValidChoice(0, 7);
         
         switch (choice) {
             case 0:
@@ -178,6 +272,7 @@ void PlayWiseApp::handleHistoryOperations() {
             case 3: {
                 if (!playbackHistory->is_empty()) {
                     Song undoneSong = playbackHistory->undo_last_play();
+                    editJournal->clear();
                     std::cout << "Undone: " << undoneSong.getTitle() << " - " << undoneSong.getArtist() << std::endl;
                     // Add back to playlist
                                     currentPlaylist->add_song(undoneSong);
@@ -191,6 +286,7 @@ void PlayWiseApp::handleHistoryOperations() {
             }
             case 4:
                 playbackHistory->clear_history();
+                editJournal->clear();
                 dashboard->updateStats();
                 std::cout << "History cleared successfully!" << std::endl;
                 pauseScreen();
@@ -199,6 +295,46 @@ void PlayWiseApp::handleHistoryOperations() {
                 playbackHistory->export_history_to_file("playback_history.txt");
                 pauseScreen();
                 break;
+            case 6: {
+                int minutes = getValidInt("Enter window length in minutes: ", 1, 10080);
+                History::Clock::time_point now = History::Clock::now();
+                History::Clock::time_point from = now - std::chrono::minutes(minutes);
+                // Include plays stamped at this very instant
+                History::Clock::time_point to = now + std::chrono::nanoseconds(1);
+                PlayWindowStats window = playbackHistory->window_stats(from, to);
+                std::cout << "\nLast " << minutes << " minute(s):" << std::endl;
+                std::cout << "  Plays: " << window.plays << std::endl;
+                std::cout << "  Listening time: " << window.listenedSeconds / 60 << "m "
+                          << window.listenedSeconds % 60 << "s" << std::endl;
+                std::cout << "  Distinct songs: " << window.distinctSongs << std::endl;
+                int index = 1;
+                for (const Song& song : playbackHistory->plays_between(from, to)) {
+                    std::cout << "  " << index++ << ". " << song.getTitle() << " - " << song.getArtist() << std::endl;
+                }
+                pauseScreen();
+                break;
+            }
+            case 7: {
+                std::int64_t now = HistoryLog::now_millis();
+                sessionizer->flush_idle(now);
+                std::cout << "\nCompleted sessions (" << sessionizer->get_gap_millis() / 60000
+                          << " minute gap):" << std::endl;
+                sessionTotals->display_summary();
+                const ListeningSession* open = sessionizer->get_open_session(currentUser);
+                if (open) {
+                    std::cout << "Current session: " << open->plays << " plays over "
+                              << open->length_millis() / 60000 << " min, skip rate " << std::fixed
+                              << std::setprecision(1) << 100.0 * open->skip_rate() << "%" << std::endl;
+                }
+                if (historyLog) {
+                    SessionAggregator archived;
+                    Sessionizer::backfill(*historyLog, 0, now + 1, currentUser, archived.as_sink());
+                    std::cout << "\nFrom the on-disk history log:" << std::endl;
+                    archived.display_summary();
+                }
+                pauseScreen();
+                break;
+            }
         }
     }
 }
@@ -261,16 +397,8 @@ void PlayWiseApp::handleRatingOperations() {
                 
                 int rating = getValidInt("Enter rating (1-5): ", 1, 5);
                 
-                // Check if song already has a rating
-                int oldRating = selectedSong->getRating();
-                if (oldRating > 0) {
-                    ratingTree->delete_song(selectedSong->getId(), oldRating);
-                }
-                
-                // Add new rating
-                selectedSong->setRating(rating);
-                ratingTree->insert_song(*selectedSong, rating);
-                songDatabase->update_song_rating(selectedSong->getId(), rating);
+                // Replaces any old rating; the database keeps its aggregates in step
+                editJournal->rate_song(selectedSong->getId(), rating);
                 
                 dashboard->updateStats();
                 std::cout << "Song added to rating tree successfully! " << selectedSong->getTitle() 
@@ -298,21 +426,10 @@ void PlayWiseApp::handleRatingOperations() {
                 int songChoice = getValidInt("Select song number: ", 1, allSongs.size());
                 int newRating = getValidInt("Enter new rating (1-5): ", 1, 5);
                 
-                Song selectedSong = allSongs[songChoice - 1];
-                std::string songId = selectedSong.getId();
-                
-                // Remove old rating if exists
-                int oldRating = selectedSong.getRating();
-                if (oldRating > 0) {
-                    ratingTree->delete_song(songId, oldRating);
-                }
-                
-                // Add new rating
-                selectedSong.setRating(newRating);
-                ratingTree->insert_song(selectedSong, newRating);
+                const Song& selectedSong = allSongs[songChoice - 1];
                 
-                // Update song in database
-                songDatabase->update_song_rating(songId, newRating);
+                // Moves the song in the rating tree and updates the database
+                editJournal->rate_song(selectedSong.getId(), newRating);
                 
                 dashboard->updateStats();
                 std::cout << "Song rated successfully! " << selectedSong.getTitle() 
@@ -335,9 +452,7 @@ void PlayWiseApp::handleRatingOperations() {
                     break;
                 }
                 
-                if (ratingTree->delete_song(selectedSong->getId(), rating)) {
-                    selectedSong->setRating(0);
-                    songDatabase->update_song_rating(selectedSong->getId(), 0);
+                if (editJournal->rate_song(selectedSong->getId(), 0)) {
                     dashboard->updateStats();
                     std::cout << "Song deleted from rating tree successfully!" << std::endl;
                 } else {
@@ -442,7 +557,7 @@ void PlayWiseApp::handleDatabaseOperations() {
                 }
                 
                 Song song(id, title, artist, duration, rating, album, genre);
-                if (songDatabase->insert_song(song)) {
+                if (songDatabase->insert_song(std::move(song))) {
                     dashboard->updateStats();
                     std::cout << "Song added to database successfully!" << std::endl;
                 } else {
@@ -488,28 +603,38 @@ void PlayWiseApp::handleSortingOperations() {
         std::cout << "5. Sort playlist by rating (highest first)" << std::endl;
         std::cout << "6. Sort playlist by artist (A-Z)" << std::endl;
         std::cout << "7. Benchmark sorting algorithms" << std::endl;
+        std::cout << "8. Benchmark in-place playlist sort (10k/100k/1M songs)" << std::endl;
         std::cout << "0. Back to main menu" << std::endl;
         std::cout << "Enter your choice: ";
         
-        int choice = getValidChoice(0, 7);
+        int choice = getValidChoice(0, 8);
         
         if (choice == 0) return;
-        
-        // Get songs from current playlist
-        std::vector<Song> songs;
-        PlaylistNode* current = currentPlaylist->getHead();
-        while (current != nullptr) {
-            songs.push_back(current->song);
-            current = current->next;
+        if (choice == 8) {
+            Sorting::benchmarkPlaylistSort(10000);
+            Sorting::benchmarkPlaylistSort(100000);
+            Sorting::benchmarkPlaylistSort(1000000);
+            pauseScreen();
+            continue;
         }
         
-        if (songs.empty()) {
+        if (currentPlaylist->isEmpty()) {
             std::cout << "No songs in playlist to sort!" << std::endl;
             pauseScreen();
             continue;
         }
         
-        Sorting::SortCriteria criteria;
+        // Copies the songs out; only the vector sorts need them
+        auto copySongs = [this]() {
+            std::vector<Song> songs;
+            songs.reserve(currentPlaylist->getSize());
+            for (PlaylistNode* current = currentPlaylist->getHead(); current != nullptr; current = current->next) {
+                songs.push_back(current->song);
+            }
+            return songs;
+        };
+        
+        Sorting::SortCriteria criteria = Sorting::SortCriteria::TITLE_ASC;
         
         switch (choice) {
             case 1:
@@ -530,15 +655,17 @@ void PlayWiseApp::handleSortingOperations() {
             case 6:
                 criteria = Sorting::SortCriteria::ARTIST_ASC;
                 break;
-            case 7:
+            case 7: {
+                std::vector<Song> songs = copySongs();
                 Sorting::benchmarkSorting(songs);
                 pauseScreen();
                 continue;
+            }
         }
         
         // Let user choose sorting algorithm
         std::cout << "\n=== Choose Sorting Algorithm ===" << std::endl;
-        std::cout << "1. Merge Sort (stable, O(n log n))" << std::endl;
+        std::cout << "1. Merge Sort (stable, in place, O(n log n))" << std::endl;
         std::cout << "2. Quick Sort (fast average, O(n log n))" << std::endl;
         std::cout << "Enter algorithm choice (1-2): ";
         
@@ -555,14 +682,21 @@ void PlayWiseApp::handleSortingOperations() {
         }
         
         std::cout << "\nSorting with " << algorithm << " sort..." << std::endl;
-        Sorting::sortPlaylist(songs, criteria, algorithm);
-        
-        // Update playlist with sorted songs
-        currentPlaylist->clear();
-        for (const Song& song : songs) {
-            currentPlaylist->add_song(song);
+        if (algorithm == "merge") {
+            // Relinks the existing nodes without copying songs
+            currentPlaylist->sort(criteria);
+        } else {
+            std::vector<Song> songs = copySongs();
+            Sorting::sortPlaylist(songs, criteria, algorithm);
+            
+            // Update playlist with sorted songs
+            currentPlaylist->clear();
+            for (Song& song : songs) {
+                currentPlaylist->add_song(std::move(song));
+            }
         }
         
+        editJournal->clear();
         std::cout << "Playlist sorted successfully!" << std::endl;
         pauseScreen();
     }
@@ -633,10 +767,20 @@ void PlayWiseApp::handleSystemOperations() {
         std::cout << "3. Import system data" << std::endl;
         std::cout << "4. Display system information" << std::endl;
         std::cout << "5. Memory usage analysis" << std::endl;
+        std::cout << "6. Benchmark batch edits and diff" << std::endl;
+        std::cout << "7. Benchmark concurrent playlist edits" << std::endl;
+        std::cout << "8. Benchmark offline merge (CRDT)" << std::endl;
+        std::cout << "9. Benchmark song ingestion allocations" << std::endl;
+        std::cout << "10. Open on-disk history log" << std::endl;
+        std::cout << "11. Benchmark history log" << std::endl;
+        std::cout << "12. Benchmark multi-producer playback ingestion" << std::endl;
+        std::cout << "13. Compress history log / benchmark compression" << std::endl;
+        std::cout << "14. Benchmark distinct counts (HyperLogLog)" << std::endl;
+        std::cout << "15. Benchmark session backfill" << std::endl;
         std::cout << "0. Back to main menu" << std::endl;
         std::cout << "Enter your choice: ";
         
-        int choice = getValidChoice(0, 5);
+        int choice = getValidChoice(0, 15);
         
         switch (choice) {
             case 0:
@@ -661,6 +805,80 @@ void PlayWiseApp::handleSystemOperations() {
                 dashboard->memory_usage_analysis();
                 pauseScreen();
                 break;
+            case 6:
+                PlaylistEditor::benchmarkBatchEdits(10000, 1000);
+                PlaylistEditor::benchmarkBatchEdits(100000, 1000);
+                PlaylistEditor::benchmarkDiff(100000, 1000);
+                pauseScreen();
+                break;
+            case 7:
+                ConcurrentPlaylist::benchmarkConcurrentEdits(100000, 20000);
+                pauseScreen();
+                break;
+            case 8:
+                PlaylistCRDT::benchmarkMerge(10000, 10000);
+                PlaylistCRDT::benchmarkMerge(100000, 100000);
+                pauseScreen();
+                break;
+            case 9:
+                AllocationCounter::benchmarkSongIngestion(100000);
+                pauseScreen();
+                break;
+            case 10: {
+                if (!historyLog) {
+                    historyLog = new HistoryLog("playwise_history", songDatabase);
+                    if (!historyLog->is_open()) {
+                        delete historyLog;
+                        historyLog = nullptr;
+                        pauseScreen();
+                        break;
+                    }
+                    playbackHistory->attach_log(historyLog);
+                    // Plays already in memory stay if the log has nothing to restore
+                    if (historyLog->get_record_count() > 0) {
+                        int restored = playbackHistory->restore_tail_from_log();
+                        editJournal->clear();
+                        std::cout << "Restored " << restored << " recent plays from the log." << std::endl;
+                    }
+                    dashboard->updateStats();
+                }
+                std::int64_t now = HistoryLog::now_millis();
+                PlayWindowStats month = historyLog->window_stats(now - 30LL * 24 * 3600 * 1000, now + 1);
+                std::cout << "History log: " << historyLog->get_record_count() << " plays in "
+                          << historyLog->get_segment_count() << " segment(s)" << std::endl;
+                std::cout << "Last 30 days: " << month.plays << " plays, " << month.listenedSeconds / 60
+                          << " minutes, " << month.distinctSongs << " distinct songs" << std::endl;
+                pauseScreen();
+                break;
+            }
+            case 11:
+                HistoryLog::benchmarkHistoryLog(1000000);
+                pauseScreen();
+                break;
+            case 12:
+                PlaybackIngest::benchmarkIngestion(200000);
+                pauseScreen();
+                break;
+            case 13:
+                if (historyLog) {
+                    CompressedHistory compressed = CompressedHistory::fromLog(*historyLog);
+                    if (compressed.save_to_file("playwise_history/compressed.bin")) {
+                        std::cout << "Compressed " << compressed.get_event_count() << " plays into "
+                                  << compressed.get_encoded_bytes() << " bytes (playwise_history/compressed.bin)"
+                                  << std::endl;
+                    }
+                }
+                CompressedHistory::benchmarkCompression(2000000);
+                pauseScreen();
+                break;
+            case 14:
+                PlayDistincts::benchmarkDistinctCounts(1000000);
+                pauseScreen();
+                break;
+            case 15:
+                Sessionizer::benchmarkBackfill(2000000);
+                pauseScreen();
+                break;
         }
     }
 }
@@ -873,7 +1091,7 @@ void PlayWiseApp::run() {
     
     while (isRunning) {
         displayMainMenu();
-        int choice = getValidChoice(0, 10);
+        int choice = getValidChoice(0, 12);
         
         switch (choice) {
             case 0:
@@ -910,6 +1128,12 @@ void PlayWiseApp::run() {
             case 10:
                 handleSystemOperations();
                 break;
+            case 11:
+                handleUndoRedo(true);
+                break;
+            case 12:
+                handleUndoRedo(false);
+                break;
         }
     }
 }
@@ -921,14 +1145,22 @@ void PlayWiseApp::shutdown() {
     std::cout << "Shutting down PlayWise..." << std::endl;
     isRunning = false;
     
-    // Clean up resources
+    // Clean up resources; the log flushes its buffered plays
+    delete historyLog;
+    delete playQueue;
     delete dashboard;
     delete songDatabase;
     delete ratingTree;
     delete playbackHistory;
+    delete playTrends;
+    delete playDistincts;
+    delete sessionizer;
+    delete sessionTotals;
+    delete editJournal;
     delete currentPlaylist;
     delete songCleaner;
     delete favoriteSongsQueue;
+    delete playlistManager;
 
     
     dashboard = nullptr;
@@ -938,6 +1170,14 @@ void PlayWiseApp::shutdown() {
     currentPlaylist = nullptr;
     songCleaner = nullptr;
     favoriteSongsQueue = nullptr;
+    playlistManager = nullptr;
+    playQueue = nullptr;
+    historyLog = nullptr;
+    playTrends = nullptr;
+    playDistincts = nullptr;
+    sessionizer = nullptr;
+    sessionTotals = nullptr;
+    editJournal = nullptr;
 
     
     std::cout << "Goodbye!" << std::endl;
@@ -952,10 +1192,16 @@ void PlayWiseApp::resetSystem() {
         // Clear all data
         currentPlaylist->clear();
         playbackHistory->clear_history();
+        playTrends->clear();
+        playDistincts->clear();
+        sessionizer->clear();
+        sessionTotals->clear();
+        editJournal->clear();
         ratingTree->clear();
         songDatabase->clear();
         songCleaner->clear();
         favoriteSongsQueue->clear();
+        playlistManager->clear();
 
         
         // Reload sample data
@@ -995,7 +1241,8 @@ void PlayWiseApp::importSystemData() {
 bool PlayWiseApp::isInitialized() const {
     return currentPlaylist != nullptr && playbackHistory != nullptr && 
            ratingTree != nullptr && songDatabase != nullptr && dashboard != nullptr &&
-           songCleaner != nullptr && favoriteSongsQueue != nullptr;
+           songCleaner != nullptr && favoriteSongsQueue != nullptr && playlistManager != nullptr &&
+           playQueue != nullptr;
 }
 
 std::string PlayWiseApp::getVersion() const {
@@ -1056,9 +1303,10 @@ void PlayWiseApp::handleSongCleanerOperations() {
                 if (duplicates > 0) {
                     // Clear current playlist and add cleaned songs
                     currentPlaylist->clear();
-                    for (const Song& song : cleanedSongs) {
-                        currentPlaylist->add_song(song);
+                    for (Song& song : cleanedSongs) {
+                        currentPlaylist->add_song(std::move(song));
                     }
+                    editJournal->clear();  // positions recorded so far no longer hold
                     dashboard->updateStats();
                     std::cout << "Removed " << duplicates << " duplicate(s) from playlist." << std::endl;
                 } else {
@@ -1154,10 +1402,11 @@ void PlayWiseApp::handleFavoriteSongsOperations() {
                     break;
                 }
                 
-                favoriteSongsQueue->addSong(*selectedSong);
-                
-                // Update playback history when adding to favorites
-                playbackHistory->add_played_song(*selectedSong);
+                // Update playback history when adding to favorites; undone together
+                editJournal->begin_group();
+                editJournal->update_favorite(*selectedSong, 0, false);
+                editJournal->play_song(*selectedSong);
+                editJournal->end_group();
                 
                 std::cout << "Song added to favorites!" << std::endl;
                 std::cout << "Song added to playback history." << std::endl;
@@ -1258,10 +1507,15 @@ void PlayWiseApp::handleSimulatePlaybackOperations() {
         std::cout << "1. Simulate song playback (add to history & favorites)" << std::endl;
         std::cout << "2. Update listening time for a song" << std::endl;
         std::cout << "3. Increment play count for a song" << std::endl;
+        std::cout << "4. Play next song in current playlist" << std::endl;
+        std::cout << "5. Play previous song in current playlist" << std::endl;
+        std::cout << "6. Queue a song to play next" << std::endl;
+        std::cout << "7. Cycle repeat mode (" << PlayQueue::getRepeatModeName(playQueue->getRepeatMode()) << ")" << std::endl;
+        std::cout << "8. Toggle shuffle (" << (playQueue->isShuffleEnabled() ? "On" : "Off") << ")" << std::endl;
         std::cout << "0. Back to main menu" << std::endl;
         std::cout << "Enter your choice: ";
         
-        int choice = getValidChoice(0, 3);
+        int choice = getValidChoice(0, 8);
         
         switch (choice) {
             case 0:
@@ -1277,10 +1531,11 @@ void PlayWiseApp::handleSimulatePlaybackOperations() {
                 }
                 
                 int playbackTime = getValidInt("Enter playback time (in seconds): ", 1, selectedSong->getDuration());
-                favoriteSongsQueue->autoUpdateFromPlayback(*selectedSong, playbackTime);
-                
-                // Update playback history when simulating playback
-                playbackHistory->add_played_song(*selectedSong);
+                // Update playback history when simulating playback; undone together
+                editJournal->begin_group();
+                editJournal->update_favorite(*selectedSong, playbackTime, true);
+                editJournal->play_song(*selectedSong, playbackTime);
+                editJournal->end_group();
                 
                 std::cout << "Song automatically added/updated in favorites!" << std::endl;
                 std::cout << "Queue automatically re-sorted by listening time." << std::endl;
@@ -1297,10 +1552,11 @@ void PlayWiseApp::handleSimulatePlaybackOperations() {
                 }
                 
                 int additionalTime = getValidInt("Enter additional listening time (in seconds): ", 1, 3600);
-                favoriteSongsQueue->updateListeningTime(*selectedSong, additionalTime);
-                
-                // Update playback history when listening time is updated
-                playbackHistory->add_played_song(*selectedSong);
+                // Update playback history when listening time is updated; undone together
+                editJournal->begin_group();
+                editJournal->update_favorite(*selectedSong, additionalTime, false);
+                editJournal->play_song(*selectedSong, additionalTime);
+                editJournal->end_group();
                 
                 std::cout << "Listening time updated! Queue automatically re-sorted." << std::endl;
                 std::cout << "Song added to playback history." << std::endl;
@@ -1315,16 +1571,80 @@ void PlayWiseApp::handleSimulatePlaybackOperations() {
                     break;
                 }
                 
-                favoriteSongsQueue->incrementPlayCount(*selectedSong);
-                
-                // Update playback history when play count is incremented
-                playbackHistory->add_played_song(*selectedSong);
+                // Update playback history when play count is incremented; undone together
+                editJournal->begin_group();
+                editJournal->update_favorite(*selectedSong, 0, true);
+                editJournal->play_song(*selectedSong);
+                editJournal->end_group();
                 
                 std::cout << "Play count incremented! Queue automatically re-sorted." << std::endl;
                 std::cout << "Song added to playback history." << std::endl;
                 pauseScreen();
                 break;
             }
+            case 4:
+            case 5: {
+                // The queue records every song it lands on in history and favorites
+                const Song* song;
+                if (choice == 4) {
+                    song = playQueue->isPlaying() ? playQueue->next() : playQueue->start();
+                } else {
+                    song = playQueue->previous();
+                }
+                if (song != nullptr) {
+                    std::cout << "Now playing: " << song->getTitle() << " - " << song->getArtist() << std::endl;
+                } else {
+                    std::cout << "Playback stopped (end of playlist)." << std::endl;
+                }
+                pauseScreen();
+                break;
+            }
+            case 6: {
+                Song* selectedSong = selectSongFromDatabase("Select song to play next");
+                if (selectedSong && playQueue->play_next(*selectedSong)) {
+                    std::cout << "\"" << selectedSong->getTitle() << "\" will play next." << std::endl;
+                } else {
+                    std::cout << "No song selected." << std::endl;
+                }
+                pauseScreen();
+                break;
+            }
+            case 7: {
+                PlayQueue::RepeatMode mode = playQueue->getRepeatMode();
+                if (mode == PlayQueue::RepeatMode::OFF) {
+                    mode = PlayQueue::RepeatMode::ALL;
+                } else if (mode == PlayQueue::RepeatMode::ALL) {
+                    mode = PlayQueue::RepeatMode::ONE;
+                } else {
+                    mode = PlayQueue::RepeatMode::OFF;
+                }
+                playQueue->setRepeatMode(mode);
+                std::cout << "Repeat mode: " << PlayQueue::getRepeatModeName(mode) << std::endl;
+                pauseScreen();
+                break;
+            }
+            case 8:
+                playQueue->setShuffle(!playQueue->isShuffleEnabled(),
+                                      static_cast<unsigned int>(std::time(nullptr)));
+                std::cout << "Shuffle " << (playQueue->isShuffleEnabled() ? "enabled" : "disabled") << std::endl;
+                pauseScreen();
+                break;
         }
     }
-} 
\ No newline at end of file
+} 
+void PlayWiseApp::handleUndoRedo(bool undo) {
+    std::string change = undo ? editJournal->describe_undo() : editJournal->describe_redo();
+    if (change.empty()) {
+        std::cout << (undo ? "Nothing to undo." : "Nothing to redo.") << std::endl;
+        pauseScreen();
+        return;
+    }
+    
+    if (undo ? editJournal->undo() : editJournal->redo()) {
+        dashboard->updateStats();
+        std::cout << (undo ? "Undone: " : "Redone: ") << change << std::endl;
+        std::cout << editJournal->get_undo_count() << " change(s) to undo, "
+                  << editJournal->get_redo_count() << " to redo." << std::endl;
+    }
+    pauseScreen();
+}
@@ -139,19 +139,28 @@ int RatingTree::getBalance(RatingNode* node) const {
 }
 
 // Core operations
-void RatingTree::insert_song(const Song& song, int rating) {
-    if (rating < 1 || rating > 5) return;  // Validate rating range
-    
-    // Find or create the rating node
+RatingNode* RatingTree::findOrCreateNode(int rating) {
     RatingNode* ratingNode = findNode(root, rating);
     if (ratingNode == nullptr) {
         // Create new rating node
         root = insertNode(root, rating);
         ratingNode = findNode(root, rating);
     }
+    return ratingNode;
+}
+
+void RatingTree::insert_song(const Song& song, int rating) {
+    if (rating < 1 || rating > Song::MAX_RATING) return;  // Validate rating range
     
     // Add song to the rating bucket
-    ratingNode->songs.push_back(song);
+    findOrCreateNode(rating)->songs.push_back(song);
+    totalSongs++;
+}
+
+void RatingTree::insert_song(Song&& song, int rating) {
+    if (rating < 1 || rating > Song::MAX_RATING) return;  // Validate rating range
+    
+    findOrCreateNode(rating)->songs.push_back(std::move(song));
     totalSongs++;
 }
 
@@ -267,8 +276,9 @@ void RatingTree::balance_tree() {
     // Simple balancing - rebuild the tree
     std::vector<Song> allSongs = get_all_songs();
     clear();
-    for (const Song& song : allSongs) {
-        insert_song(song, song.getRating());
+    for (Song& song : allSongs) {
+        int rating = song.getRating();
+        insert_song(std::move(song), rating);
     }
 }
 
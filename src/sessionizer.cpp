@@ -0,0 +1,383 @@
+#include "../include/sessionizer.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+
+// ===== ListeningSession =====
+
+long long ListeningSession::length_millis() const {
+    return endMillis - startMillis;
+}
+
+double ListeningSession::skip_rate() const {
+    return plays > 0 ? static_cast<double>(skips) / plays : 0.0;
+}
+
+void ListeningSession::absorb(const ListeningSession& later) {
+    startMillis = std::min(startMillis, later.startMillis);
+    endMillis = std::max(endMillis, later.endMillis);
+    if (later.lastPlayMillis >= lastPlayMillis) {
+        lastPlayMillis = later.lastPlayMillis;
+        lastPlayEndMillis = later.lastPlayEndMillis;
+    }
+    plays += later.plays;
+    skips += later.skips;
+    listenedSeconds += later.listenedSeconds;
+    for (const auto& genre : later.genreMix) {
+        genreMix[genre.first] += genre.second;
+    }
+}
+
+// ===== SessionAggregator =====
+
+SessionAggregator::SessionAggregator()
+    : sessions(0), plays(0), skips(0), listenedSeconds(0), lengthMillis(0), longestMillis(0) {}
+
+void SessionAggregator::add(const ListeningSession& session) {
+    sessions++;
+    plays += session.plays;
+    skips += session.skips;
+    listenedSeconds += session.listenedSeconds;
+    lengthMillis += session.length_millis();
+    longestMillis = std::max(longestMillis, session.length_millis());
+    for (const auto& genre : session.genreMix) {
+        genrePlays[genre.first] += genre.second;
+    }
+}
+
+void SessionAggregator::merge(const SessionAggregator& other) {
+    sessions += other.sessions;
+    plays += other.plays;
+    skips += other.skips;
+    listenedSeconds += other.listenedSeconds;
+    lengthMillis += other.lengthMillis;
+    longestMillis = std::max(longestMillis, other.longestMillis);
+    for (const auto& genre : other.genrePlays) {
+        genrePlays[genre.first] += genre.second;
+    }
+}
+
+void SessionAggregator::clear() {
+    *this = SessionAggregator();
+}
+
+std::function<void(const ListeningSession&)> SessionAggregator::as_sink() {
+    return [this](const ListeningSession& session) { add(session); };
+}
+
+long long SessionAggregator::get_session_count() const { return sessions; }
+long long SessionAggregator::get_play_count() const { return plays; }
+long long SessionAggregator::get_listened_seconds() const { return listenedSeconds; }
+
+double SessionAggregator::get_average_length_minutes() const {
+    return sessions > 0 ? lengthMillis / 60000.0 / sessions : 0.0;
+}
+
+double SessionAggregator::get_longest_length_minutes() const {
+    return longestMillis / 60000.0;
+}
+
+double SessionAggregator::get_skip_rate() const {
+    return plays > 0 ? static_cast<double>(skips) / plays : 0.0;
+}
+
+std::vector<std::pair<std::string, long long>> SessionAggregator::top_genres(int count) const {
+    std::vector<std::pair<std::string, long long>> genres(genrePlays.begin(), genrePlays.end());
+    size_t keep = std::min(genres.size(), static_cast<size_t>(std::max(0, count)));
+    std::partial_sort(genres.begin(), genres.begin() + keep, genres.end(),
+                      [](const std::pair<std::string, long long>& a, const std::pair<std::string, long long>& b) {
+                          return a.second != b.second ? a.second > b.second : a.first < b.first;
+                      });
+    genres.resize(keep);
+    return genres;
+}
+
+void SessionAggregator::display_summary() const {
+    std::cout << "Sessions: " << sessions << " (" << plays << " plays)" << std::endl;
+    if (sessions == 0) return;
+    std::cout << "Average length: " << std::fixed << std::setprecision(1) << get_average_length_minutes()
+              << " min, longest " << get_longest_length_minutes() << " min" << std::endl;
+    std::cout << "Skip rate: " << 100.0 * get_skip_rate() << "%" << std::endl;
+    std::cout << "Genre mix:";
+    for (const auto& genre : top_genres(5)) {
+        std::cout << " " << (genre.first.empty() ? "(none)" : genre.first) << " "
+                  << 100.0 * genre.second / plays << "%";
+    }
+    std::cout << std::endl;
+}
+
+// ===== Sessionizer =====
+
+Sessionizer::Sessionizer(Sink sink, std::int64_t gapMillis)
+    : sink(std::move(sink)), gapMillis(std::max<std::int64_t>(0, gapMillis)), emitted(0) {}
+
+// Helper methods
+void Sessionizer::emit(const ListeningSession& session) {
+    emitted++;
+    if (sink) sink(session);
+}
+
+Sessionizer::ChunkSessions Sessionizer::sessionizeChunk(const std::function<void(Sessionizer&)>& feed,
+                                                        std::int64_t gapMillis) {
+    ChunkSessions chunk;
+    // Closed sessions: the first per listener may continue an earlier chunk
+    Sessionizer sessionizer([&chunk](const ListeningSession& session) {
+        if (chunk.heads.count(session.listener) == 0) {
+            chunk.heads.emplace(session.listener, session);
+        } else {
+            chunk.middles.push_back(session);
+        }
+    }, gapMillis);
+    feed(sessionizer);
+
+    // Still open: may continue into the next chunk
+    for (auto& entry : sessionizer.openSessions) {
+        if (chunk.heads.count(entry.first) == 0) {
+            chunk.heads.emplace(entry.first, std::move(entry.second));
+        } else {
+            chunk.tails.emplace(entry.first, std::move(entry.second));
+        }
+    }
+    return chunk;
+}
+
+void Sessionizer::stitch(std::vector<ChunkSessions>& chunks, const Sink& sink, std::int64_t gapMillis) {
+    // Per listener, the session that may still continue into the next chunk
+    std::unordered_map<std::string, ListeningSession> carry;
+    for (ChunkSessions& chunk : chunks) {
+        for (auto& entry : chunk.heads) {
+            auto it = carry.find(entry.first);
+            if (it == carry.end()) {
+                it = carry.emplace(entry.first, std::move(entry.second)).first;
+            } else if (entry.second.startMillis - it->second.lastPlayEndMillis <= gapMillis) {
+                it->second.absorb(entry.second);
+            } else {
+                sink(it->second);
+                it->second = std::move(entry.second);
+            }
+
+            auto tail = chunk.tails.find(entry.first);
+            if (tail != chunk.tails.end()) {
+                sink(it->second);
+                it->second = std::move(tail->second);
+            }
+        }
+        for (const ListeningSession& session : chunk.middles) {
+            sink(session);
+        }
+    }
+    for (const auto& entry : carry) {
+        sink(entry.second);
+    }
+}
+
+void Sessionizer::backfillRanges(size_t count, int threadCount,
+                                 const std::function<void(Sessionizer&, size_t, size_t)>& feed,
+                                 const Sink& sink, std::int64_t gapMillis) {
+    if (!sink) return;
+    size_t threads = threadCount > 0 ? static_cast<size_t>(threadCount)
+                                     : std::max(1u, std::thread::hardware_concurrency());
+    threads = std::max<size_t>(1, std::min(threads, count));
+    size_t perChunk = (count + threads - 1) / std::max<size_t>(1, threads);
+
+    std::vector<ChunkSessions> chunks(threads);
+    auto run = [&](size_t chunk) {
+        size_t begin = std::min(count, chunk * perChunk);
+        size_t end = std::min(count, begin + perChunk);
+        chunks[chunk] = sessionizeChunk([&](Sessionizer& sessionizer) { feed(sessionizer, begin, end); }, gapMillis);
+    };
+    if (threads == 1) {
+        run(0);
+    } else {
+        std::vector<std::thread> workers;
+        for (size_t chunk = 0; chunk < threads; chunk++) {
+            workers.emplace_back(run, chunk);
+        }
+        for (std::thread& worker : workers) worker.join();
+    }
+    stitch(chunks, sink, gapMillis);
+}
+
+// Streaming
+void Sessionizer::set_listener(const std::string& listener) {
+    this->listener = listener;
+}
+
+void Sessionizer::record_play(const Song& song, int listenedSeconds, std::int64_t playedAtMillis) {
+    record_play(SessionPlay{listener, &song, listenedSeconds, playedAtMillis});
+}
+
+void Sessionizer::record_play(const SessionPlay& play) {
+    if (!play.song) return;
+
+    int heard = play.listenedSeconds < 0 ? play.song->getDuration() : play.listenedSeconds;
+    std::int64_t endMillis = play.playedAtMillis + static_cast<std::int64_t>(heard) * 1000;
+    auto it = openSessions.find(play.listener);
+    if (it == openSessions.end()) {
+        it = openSessions.emplace(play.listener, ListeningSession{play.listener, play.playedAtMillis, endMillis,
+                                                                  play.playedAtMillis, endMillis, 0, 0, 0, {}}).first;
+    } else if (play.playedAtMillis - it->second.lastPlayEndMillis > gapMillis) {
+        // Too long a pause: close the session and reuse its entry for the next
+        emit(it->second);
+        ListeningSession& session = it->second;
+        session.startMillis = play.playedAtMillis;
+        session.endMillis = endMillis;
+        session.lastPlayMillis = play.playedAtMillis;
+        session.lastPlayEndMillis = endMillis;
+        session.plays = 0;
+        session.skips = 0;
+        session.listenedSeconds = 0;
+        session.genreMix.clear();
+    }
+
+    ListeningSession& session = it->second;
+    session.startMillis = std::min(session.startMillis, play.playedAtMillis);
+    session.endMillis = std::max(session.endMillis, endMillis);
+    if (play.playedAtMillis >= session.lastPlayMillis) {
+        session.lastPlayMillis = play.playedAtMillis;
+        session.lastPlayEndMillis = endMillis;
+    }
+    session.plays++;
+    session.skips += isSkip(*play.song, play.listenedSeconds) ? 1 : 0;
+    session.listenedSeconds += heard;
+    session.genreMix[play.song->getGenre()]++;
+}
+
+int Sessionizer::flush_idle(std::int64_t nowMillis) {
+    int flushed = 0;
+    for (auto it = openSessions.begin(); it != openSessions.end();) {
+        if (nowMillis - it->second.lastPlayEndMillis > gapMillis) {
+            emit(it->second);
+            it = openSessions.erase(it);
+            flushed++;
+        } else {
+            ++it;
+        }
+    }
+    return flushed;
+}
+
+int Sessionizer::flush_all() {
+    int flushed = static_cast<int>(openSessions.size());
+    for (const auto& entry : openSessions) {
+        emit(entry.second);
+    }
+    openSessions.clear();
+    return flushed;
+}
+
+void Sessionizer::clear() {
+    openSessions.clear();
+    emitted = 0;
+}
+
+// HistoryListener
+void Sessionizer::onPlayRecorded(const Song& song, int listenedSeconds, std::int64_t playedAtMillis) {
+    record_play(song, listenedSeconds, playedAtMillis);
+}
+
+size_t Sessionizer::get_open_count() const { return openSessions.size(); }
+
+const ListeningSession* Sessionizer::get_open_session(const std::string& listener) const {
+    auto it = openSessions.find(listener);
+    return it == openSessions.end() ? nullptr : &it->second;
+}
+
+long long Sessionizer::get_emitted_count() const { return emitted; }
+std::int64_t Sessionizer::get_gap_millis() const { return gapMillis; }
+
+bool Sessionizer::isSkip(const Song& song, int listenedSeconds) {
+    return listenedSeconds >= 0 && listenedSeconds < SKIP_SECONDS && listenedSeconds * 2 < song.getDuration();
+}
+
+// Bulk backfill
+void Sessionizer::backfill(const std::vector<SessionPlay>& plays, const Sink& sink, std::int64_t gapMillis,
+                           int threadCount) {
+    backfillRanges(plays.size(), threadCount, [&plays](Sessionizer& sessionizer, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            sessionizer.record_play(plays[i]);
+        }
+    }, sink, gapMillis);
+}
+
+void Sessionizer::backfill(const HistoryLog& log, std::int64_t fromMillis, std::int64_t toMillis,
+                           const std::string& listener, const Sink& sink, std::int64_t gapMillis,
+                           int threadCount) {
+    // Copying the fixed-size records is a sequential scan of the mapped
+    // segments; resolving songs and sessionizing is what runs in parallel
+    std::vector<HistoryLog::LogRecord> records;
+    log.for_each_between(fromMillis, toMillis, [&records](std::uint64_t, const HistoryLog::LogRecord& record) {
+        records.push_back(record);
+    });
+
+    backfillRanges(records.size(), threadCount,
+                   [&records, &log, &listener](Sessionizer& sessionizer, size_t begin, size_t end) {
+        sessionizer.set_listener(listener);
+        for (size_t i = begin; i < end; i++) {
+            const Song* song = log.find_song(log.get_song_id(records[i].songRef));
+            if (song) {
+                sessionizer.record_play(*song, records[i].listenedSeconds, records[i].playedAtMillis);
+            }
+        }
+    }, sink, gapMillis);
+}
+
+// Performance analysis
+void Sessionizer::benchmarkBackfill(int plays) {
+    std::cout << "\n=== Session Backfill Benchmark ===" << std::endl;
+    std::cout << "Plays: " << plays << " by 2000 listeners, 30 minute gap" << std::endl;
+
+    std::vector<Song> catalog;
+    const char* genres[] = {"Pop", "Rock", "Jazz", "Electronic", "Classical"};
+    for (int i = 0; i < 1000; i++) {
+        catalog.emplace_back("session-" + std::to_string(i), "Session Song " + std::to_string(i),
+                             "Session Artist " + std::to_string(i % 80), 150 + i % 150, 1 + i % 5, "", genres[i % 5]);
+    }
+    std::vector<std::string> listeners;
+    for (int i = 0; i < 2000; i++) listeners.push_back("listener-" + std::to_string(i));
+
+    // Listeners take turns; every so often one pauses for hours
+    std::mt19937 random(5);
+    std::vector<SessionPlay> stream;
+    stream.reserve(plays);
+    std::int64_t millis = 1700000000000LL;
+    for (int i = 0; i < plays; i++) {
+        millis += random() % 400;
+        const std::string& listener = listeners[random() % listeners.size()];
+        int listened = random() % 4 == 0 ? static_cast<int>(random() % 20) : -1;
+        stream.push_back(SessionPlay{listener, &catalog[random() % catalog.size()], listened, millis});
+        if (random() % 50000 == 0) millis += 3LL * 3600 * 1000;
+    }
+
+    std::cout << std::setw(12) << "Mode" << std::setw(10) << "Threads" << std::setw(12) << "Sessions"
+              << std::setw(14) << "Skip rate" << std::setw(16) << "Plays/s" << std::endl;
+    std::cout << std::string(64, '-') << std::endl;
+
+    auto report = [plays](const char* mode, int threads, const SessionAggregator& totals, double seconds) {
+        std::cout << std::setw(12) << mode << std::setw(10) << threads << std::setw(12)
+                  << totals.get_session_count() << std::setw(13) << std::fixed << std::setprecision(1)
+                  << 100.0 * totals.get_skip_rate() << "%" << std::setw(16) << std::setprecision(0)
+                  << plays / std::max(seconds, 1e-9) << std::endl;
+    };
+
+    SessionAggregator streamed;
+    auto begin = std::chrono::high_resolution_clock::now();
+    Sessionizer sessionizer(streamed.as_sink());
+    for (const SessionPlay& play : stream) sessionizer.record_play(play);
+    sessionizer.flush_all();
+    auto end = std::chrono::high_resolution_clock::now();
+    report("streaming", 1, streamed, std::chrono::duration<double>(end - begin).count());
+
+    for (int threads : {1, 2, 4, 8}) {
+        SessionAggregator totals;
+        begin = std::chrono::high_resolution_clock::now();
+        backfill(stream, totals.as_sink(), DEFAULT_GAP_MILLIS, threads);
+        end = std::chrono::high_resolution_clock::now();
+        report("backfill", threads, totals, std::chrono::duration<double>(end - begin).count());
+    }
+    std::cout << "(Backfill stitches chunk boundaries, so every run finds the same sessions)" << std::endl;
+    std::cout << std::endl;
+}
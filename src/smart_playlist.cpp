@@ -0,0 +1,174 @@
+#include "../include/smart_playlist.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <iterator>
+
+// SmartPlaylistRule implementation
+bool SmartPlaylistRule::equalsIgnoreCase(const std::string& a, const std::string& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SmartPlaylistRule::matches(const Song& song, std::time_t now) const {
+    if (!genre.empty() && !equalsIgnoreCase(song.getGenre(), genre)) return false;
+    if (!artist.empty() && !equalsIgnoreCase(song.getArtist(), artist)) return false;
+    if (song.getRating() < minRating || song.getRating() > maxRating) return false;
+    if (addedWithinDays > 0) {
+        long long added = std::atoll(song.getAddedDate().c_str());
+        long long cutoff = static_cast<long long>(now) - static_cast<long long>(addedWithinDays) * 86400;
+        if (added < cutoff) return false;
+    }
+    return true;
+}
+
+std::string SmartPlaylistRule::describe() const {
+    std::string description;
+    if (!genre.empty()) description += "genre " + genre + ", ";
+    if (!artist.empty()) description += "artist " + artist + ", ";
+    description += "rating " + std::to_string(minRating) + "-" + std::to_string(maxRating);
+    if (addedWithinDays > 0) {
+        description += ", added in the last " + std::to_string(addedWithinDays) + " days";
+    }
+    return description;
+}
+
+// Ordering: configured criteria first, song id as a tie-breaker
+bool SmartPlaylist::OrderCompare::operator()(const PlaylistNode* a, const PlaylistNode* b) const {
+    if (compare(a->song, b->song)) return true;
+    if (compare(b->song, a->song)) return false;
+    return a->song.getId() < b->song.getId();
+}
+
+// Constructor
+SmartPlaylist::SmartPlaylist(const std::string& name, const SmartPlaylistRule& rule,
+                             Sorting::SortCriteria criteria)
+    : playlist(name), rule(rule), criteria(criteria), songDatabase(nullptr),
+      ordered(OrderCompare{Sorting::getComparator(criteria)}) {}
+
+// Destructor
+SmartPlaylist::~SmartPlaylist() {
+    detach();
+}
+
+// Helper methods
+long long SmartPlaylist::addedTimeOf(const Song& song) {
+    return std::atoll(song.getAddedDate().c_str());
+}
+
+void SmartPlaylist::insertMember(const Song& song) {
+    PlaylistNode* node = new PlaylistNode(song);
+    auto it = ordered.insert(node).first;
+    PlaylistNode* previous = (it == ordered.begin()) ? nullptr : *std::prev(it);
+    playlist.insertNode(node, previous);
+    byAddedTime.insert(std::make_pair(addedTimeOf(song), node));
+    members[song.getId()] = node;
+}
+
+void SmartPlaylist::removeMember(PlaylistNode* node) {
+    // Indexes are keyed by the song the node currently holds
+    ordered.erase(node);
+    byAddedTime.erase(std::make_pair(addedTimeOf(node->song), node));
+    members.erase(node->song.getId());
+    playlist.removeNode(node);
+}
+
+void SmartPlaylist::clearMembers() {
+    ordered.clear();
+    byAddedTime.clear();
+    members.clear();
+    playlist.clear();
+}
+
+// Database binding
+void SmartPlaylist::attach(SongDatabase* db) {
+    detach();
+    if (db == nullptr) return;
+
+    // One full evaluation; every later change is incremental
+    songDatabase = db;
+    std::time_t now = std::time(nullptr);
+    for (const Song& song : db->get_all_songs()) {
+        if (rule.matches(song, now)) {
+            insertMember(song);
+        }
+    }
+    db->add_listener(this);
+}
+
+void SmartPlaylist::detach() {
+    if (songDatabase != nullptr) {
+        songDatabase->remove_listener(this);
+        songDatabase = nullptr;
+    }
+    clearMembers();
+}
+
+bool SmartPlaylist::isAttached() const {
+    return songDatabase != nullptr;
+}
+
+// SongDatabaseListener
+void SmartPlaylist::onSongInserted(const Song& song) {
+    if (members.find(song.getId()) != members.end()) return;
+    if (rule.matches(song, std::time(nullptr))) {
+        insertMember(song);
+    }
+}
+
+void SmartPlaylist::onSongUpdated(const Song& song) {
+    bool matches = rule.matches(song, std::time(nullptr));
+    auto it = members.find(song.getId());
+    if (it == members.end()) {
+        if (matches) insertMember(song);
+        return;
+    }
+
+    // Re-key the existing node so its position follows the new metadata
+    removeMember(it->second);
+    if (matches) {
+        insertMember(song);
+    }
+}
+
+void SmartPlaylist::onSongDeleted(const std::string& songId) {
+    auto it = members.find(songId);
+    if (it != members.end()) {
+        removeMember(it->second);
+    }
+}
+
+// Time-based maintenance
+int SmartPlaylist::expire(std::time_t now) {
+    if (rule.addedWithinDays <= 0) return 0;
+
+    long long cutoff = static_cast<long long>(now) - static_cast<long long>(rule.addedWithinDays) * 86400;
+    int removed = 0;
+    while (!byAddedTime.empty() && byAddedTime.begin()->first < cutoff) {
+        removeMember(byAddedTime.begin()->second);
+        removed++;
+    }
+    return removed;
+}
+
+// Queries
+const Playlist& SmartPlaylist::getPlaylist() const { return playlist; }
+const SmartPlaylistRule& SmartPlaylist::getRule() const { return rule; }
+Sorting::SortCriteria SmartPlaylist::getCriteria() const { return criteria; }
+int SmartPlaylist::getSize() const { return playlist.getSize(); }
+
+bool SmartPlaylist::contains(const std::string& songId) const {
+    return members.find(songId) != members.end();
+}
+
+void SmartPlaylist::display() const {
+    std::cout << "Smart playlist: " << playlist.getName() << std::endl;
+    std::cout << "Rule: " << rule.describe() << std::endl;
+    std::cout << "Sorted by: " << Sorting::getCriteriaName(criteria) << std::endl;
+    playlist.display();
+}
@@ -2,6 +2,7 @@
 #include <iomanip>
 #include <sstream>
 #include <ctime>
+#include <utility>
 
 // Default constructor
 Song::Song() : id(""), title(""), artist(""), duration(0), rating(0) {
@@ -10,45 +11,45 @@ Song::Song() : id(""), title(""), artist(""), duration(0), rating(0) {
 }
 
 // Parameterized constructor
-Song::Song(const std::string& id, const std::string& title, const std::string& artist, 
+Song::Song(std::string id, std::string title, std::string artist, 
            int duration, int rating) 
-    : id(id), title(title), artist(artist), duration(duration), rating(rating) {
+    : id(std::move(id)), title(std::move(title)), artist(std::move(artist)), duration(duration), rating(rating) {
     std::time_t now = std::time(nullptr);
     addedDate = std::to_string(now);
 }
 
 // Full parameterized constructor
-Song::Song(const std::string& id, const std::string& title, const std::string& artist, 
-           int duration, int rating, const std::string& album, const std::string& genre)
-    : id(id), title(title), artist(artist), duration(duration), rating(rating), 
-      album(album), genre(genre) {
+Song::Song(std::string id, std::string title, std::string artist, 
+           int duration, int rating, std::string album, std::string genre)
+    : id(std::move(id)), title(std::move(title)), artist(std::move(artist)), duration(duration), rating(rating), 
+      album(std::move(album)), genre(std::move(genre)) {
     std::time_t now = std::time(nullptr);
     addedDate = std::to_string(now);
 }
 
 // Getters
-std::string Song::getId() const { return id; }
-std::string Song::getTitle() const { return title; }
-std::string Song::getArtist() const { return artist; }
+const std::string& Song::getId() const { return id; }
+const std::string& Song::getTitle() const { return title; }
+const std::string& Song::getArtist() const { return artist; }
 int Song::getDuration() const { return duration; }
 int Song::getRating() const { return rating; }
-std::string Song::getAlbum() const { return album; }
-std::string Song::getGenre() const { return genre; }
-std::string Song::getAddedDate() const { return addedDate; }
+const std::string& Song::getAlbum() const { return album; }
+const std::string& Song::getGenre() const { return genre; }
+const std::string& Song::getAddedDate() const { return addedDate; }
 
 // Setters
-void Song::setId(const std::string& id) { this->id = id; }
-void Song::setTitle(const std::string& title) { this->title = title; }
-void Song::setArtist(const std::string& artist) { this->artist = artist; }
+void Song::setId(std::string id) { this->id = std::move(id); }
+void Song::setTitle(std::string title) { this->title = std::move(title); }
+void Song::setArtist(std::string artist) { this->artist = std::move(artist); }
 void Song::setDuration(int duration) { this->duration = duration; }
 void Song::setRating(int rating) { 
-    if (rating >= 0 && rating <= 6) {
+    if (rating >= 0 && rating <= MAX_RATING) {
         this->rating = rating; 
     }
 }
-void Song::setAlbum(const std::string& album) { this->album = album; }
-void Song::setGenre(const std::string& genre) { this->genre = genre; }
-void Song::setAddedDate(const std::string& date) { this->addedDate = date; }
+void Song::setAlbum(std::string album) { this->album = std::move(album); }
+void Song::setGenre(std::string genre) { this->genre = std::move(genre); }
+void Song::setAddedDate(std::string date) { this->addedDate = std::move(date); }
 
 // Utility methods
 std::string Song::getDurationString() const {
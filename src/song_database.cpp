@@ -10,6 +10,7 @@ SongDatabase::SongDatabase() {}
 
 // Destructor
 SongDatabase::~SongDatabase() {
+    listeners.clear();
     clear();
 }
 
@@ -17,6 +18,12 @@ SongDatabase::~SongDatabase() {
 SongDatabase::SongDatabase(const SongDatabase& other) {
     songsById = other.songsById;
     titleArtistKeys = other.titleArtistKeys;
+    handlesById = other.handlesById;
+    handleIds = other.handleIds;
+    handlesByGenre = other.handlesByGenre;
+    genrePositions = other.genrePositions;
+    stats = other.stats;
+    rebuildHandleTable();
 }
 
 // Assignment operator
@@ -24,6 +31,12 @@ SongDatabase& SongDatabase::operator=(const SongDatabase& other) {
     if (this != &other) {
         songsById = other.songsById;
         titleArtistKeys = other.titleArtistKeys;
+        handlesById = other.handlesById;
+        handleIds = other.handleIds;
+        handlesByGenre = other.handlesByGenre;
+        genrePositions = other.genrePositions;
+        stats = other.stats;
+        rebuildHandleTable();
     }
     return *this;
 }
@@ -35,39 +48,143 @@ std::string SongDatabase::normalizeString(const std::string& str) const {
     return normalized;
 }
 
+bool SongDatabase::equalsIgnoreCase(const std::string& a, const std::string& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (::tolower(static_cast<unsigned char>(a[i])) != ::tolower(static_cast<unsigned char>(b[i]))) return false;
+    }
+    return true;
+}
+
+bool SongDatabase::containsIgnoreCase(const std::string& text, const std::string& lowerNeedle) {
+    auto found = std::search(text.begin(), text.end(), lowerNeedle.begin(), lowerNeedle.end(),
+                             [](char a, char b) { return ::tolower(static_cast<unsigned char>(a)) == b; });
+    return found != text.end() || lowerNeedle.empty();
+}
+
 bool SongDatabase::isValidSongId(const std::string& songId) const {
     return !songId.empty() && songId.length() > 0;
 }
 
+SongHandle SongDatabase::internSongId(const std::string& songId) {
+    auto it = handlesById.find(songId);
+    if (it != handlesById.end()) {
+        return it->second;
+    }
+    
+    SongHandle handle = static_cast<SongHandle>(handleIds.size());
+    handlesById[songId] = handle;
+    handleIds.push_back(songId);
+    handleTable.push_back(nullptr);
+    return handle;
+}
+
+void SongDatabase::rebuildHandleTable() {
+    // Song addresses differ between copies, so re-point every handle
+    handleTable.assign(handleIds.size(), nullptr);
+    for (auto& pair : songsById) {
+        auto it = handlesById.find(pair.first);
+        if (it != handlesById.end()) {
+            handleTable[it->second] = &pair.second;
+        }
+    }
+}
+
+void SongDatabase::indexGenre(SongHandle handle, const std::string& genre) {
+    std::vector<SongHandle>& handles = handlesByGenre[normalizeString(genre)];
+    if (genrePositions.size() <= handle) {
+        genrePositions.resize(handle + 1);
+    }
+    genrePositions[handle] = handles.size();
+    handles.push_back(handle);
+}
+
+void SongDatabase::unindexGenre(SongHandle handle, const std::string& genre) {
+    auto it = handlesByGenre.find(normalizeString(genre));
+    if (it == handlesByGenre.end()) return;
+    
+    // Swap-remove: the last handle takes over the vacated slot
+    std::vector<SongHandle>& handles = it->second;
+    size_t position = genrePositions[handle];
+    handles[position] = handles.back();
+    genrePositions[handles[position]] = position;
+    handles.pop_back();
+    if (handles.empty()) {
+        handlesByGenre.erase(it);
+    }
+}
+
+void SongDatabase::notifyInserted(const Song& song) {
+    for (SongDatabaseListener* listener : listeners) {
+        listener->onSongInserted(song);
+    }
+}
+
+void SongDatabase::notifyUpdated(const Song& song) {
+    for (SongDatabaseListener* listener : listeners) {
+        listener->onSongUpdated(song);
+    }
+}
+
+void SongDatabase::notifyDeleted(const std::string& songId) {
+    for (SongDatabaseListener* listener : listeners) {
+        listener->onSongDeleted(songId);
+    }
+}
+
 // Core operations
 std::string SongDatabase::generateCompositeKey(const std::string& title, const std::string& artist) const {
-    return normalizeString(title) + "|||" + normalizeString(artist);
+    // Built in one buffer: normalized title, separator, normalized artist
+    std::string key;
+    key.reserve(title.size() + 3 + artist.size());
+    for (char c : title) key.push_back(static_cast<char>(::tolower(static_cast<unsigned char>(c))));
+    key.append("|||");
+    for (char c : artist) key.push_back(static_cast<char>(::tolower(static_cast<unsigned char>(c))));
+    return key;
 }
 
-bool SongDatabase::insert_song(const Song& song) {
+bool SongDatabase::acceptsNewSong(const Song& song, std::string& compositeKey) const {
     if (!song.isValid()) return false;
-    
-    std::string songId = song.getId();
-    std::string title = song.getTitle();
-    std::string artist = song.getArtist();
-    
-    if (!isValidSongId(songId)) return false;
+    if (!isValidSongId(song.getId())) return false;
     
     // Check if song already exists
-    if (songsById.find(songId) != songsById.end()) {
+    if (songsById.find(song.getId()) != songsById.end()) {
         return false;  // Song already exists
     }
     
     // Check for duplicate title+artist (normalized)
-    std::string compositeKey = generateCompositeKey(title, artist);
+    compositeKey = generateCompositeKey(song.getTitle(), song.getArtist());
     if (titleArtistKeys.find(compositeKey) != titleArtistKeys.end()) {
         return false; // Duplicate title+artist
     }
+    return true;
+}
+
+void SongDatabase::storeSong(Song&& song, std::string&& compositeKey) {
+    // The interned id outlives the song, so the maps can copy it from there
+    SongHandle handle = internSongId(song.getId());
+    const std::string& songId = handleIds[handle];
+    Song& stored = songsById.emplace(songId, std::move(song)).first->second;
+    titleArtistKeys.emplace(std::move(compositeKey), songId);
+    handleTable[handle] = &stored;
+    indexGenre(handle, stored.getGenre());
+    stats.add(stored);
+    notifyInserted(stored);
+}
+
+bool SongDatabase::insert_song(const Song& song) {
+    std::string compositeKey;
+    if (!acceptsNewSong(song, compositeKey)) return false;
     
-    // Insert the song
-    songsById[songId] = song;
-    titleArtistKeys.insert(compositeKey);
+    storeSong(Song(song), std::move(compositeKey));
+    return true;
+}
+
+bool SongDatabase::insert_song(Song&& song) {
+    std::string compositeKey;
+    if (!acceptsNewSong(song, compositeKey)) return false;
     
+    storeSong(std::move(song), std::move(compositeKey));
     return true;
 }
 
@@ -78,12 +195,15 @@ bool SongDatabase::delete_song(const std::string& songId) {
     }
     
     // Remove from composite key set
-    std::string title = it->second.getTitle();
-    std::string artist = it->second.getArtist();
-    titleArtistKeys.erase(generateCompositeKey(title, artist));
+    titleArtistKeys.erase(generateCompositeKey(it->second.getTitle(), it->second.getArtist()));
+    SongHandle handle = handlesById[songId];
+    handleTable[handle] = nullptr;
+    unindexGenre(handle, it->second.getGenre());
+    stats.remove(it->second);
     
     // Remove from songs mapping
     songsById.erase(it);
+    notifyDeleted(songId);
     
     return true;
 }
@@ -91,17 +211,17 @@ bool SongDatabase::delete_song(const std::string& songId) {
 bool SongDatabase::update_song(const Song& song) {
     if (!song.isValid()) return false;
     
-    std::string songId = song.getId();
+    const std::string& songId = song.getId();
     auto it = songsById.find(songId);
     if (it == songsById.end()) {
         return false;  // Song not found
     }
     
     // Update the song
-    std::string oldTitle = it->second.getTitle();
-    std::string oldArtist = it->second.getArtist();
-    std::string newTitle = song.getTitle();
-    std::string newArtist = song.getArtist();
+    const std::string& oldTitle = it->second.getTitle();
+    const std::string& oldArtist = it->second.getArtist();
+    const std::string& newTitle = song.getTitle();
+    const std::string& newArtist = song.getArtist();
     
     // Update composite key if title or artist changed
     if (oldTitle != newTitle || oldArtist != newArtist) {
@@ -112,10 +232,18 @@ bool SongDatabase::update_song(const Song& song) {
         if (existing != titleArtistKeys.end()) {
             return false;
         }
-        titleArtistKeys.insert(newKey);
+        titleArtistKeys[newKey] = songId;
     }
     
+    if (normalizeString(it->second.getGenre()) != normalizeString(song.getGenre())) {
+        SongHandle handle = handlesById[songId];
+        unindexGenre(handle, it->second.getGenre());
+        indexGenre(handle, song.getGenre());
+    }
+    
+    stats.update(it->second, song);
     it->second = song;
+    notifyUpdated(it->second);
     return true;
 }
 
@@ -126,12 +254,15 @@ bool SongDatabase::update_song_rating(const std::string& songId, int newRating)
     }
     
     // Validate rating
-    if (newRating < 1 || newRating > 5) {
+    if (newRating < 1 || newRating > Song::MAX_RATING) {
         return false;  // Invalid rating
     }
     
     // Update the song's rating
+    stats.remove(it->second);
     it->second.setRating(newRating);
+    stats.add(it->second);
+    notifyUpdated(it->second);
     return true;
 }
 
@@ -154,12 +285,16 @@ Song* SongDatabase::search_by_title(const std::string& title) {
     return nullptr;
 }
 
+Song* SongDatabase::search_by_title_artist(const std::string& title, const std::string& artist) {
+    auto it = titleArtistKeys.find(generateCompositeKey(title, artist));
+    return it != titleArtistKeys.end() ? search_by_id(it->second) : nullptr;
+}
+
 std::vector<Song> SongDatabase::search_by_artist(const std::string& artist) const {
     std::vector<Song> result;
-    std::string normalizedArtist = normalizeString(artist);
     
     for (const auto& pair : songsById) {
-        if (normalizeString(pair.second.getArtist()) == normalizedArtist) {
+        if (equalsIgnoreCase(pair.second.getArtist(), artist)) {
             result.push_back(pair.second);
         }
     }
@@ -169,10 +304,9 @@ std::vector<Song> SongDatabase::search_by_artist(const std::string& artist) cons
 
 std::vector<Song> SongDatabase::search_by_album(const std::string& album) const {
     std::vector<Song> result;
-    std::string normalizedAlbum = normalizeString(album);
     
     for (const auto& pair : songsById) {
-        if (normalizeString(pair.second.getAlbum()) == normalizedAlbum) {
+        if (equalsIgnoreCase(pair.second.getAlbum(), album)) {
             result.push_back(pair.second);
         }
     }
@@ -182,12 +316,12 @@ std::vector<Song> SongDatabase::search_by_album(const std::string& album) const
 
 std::vector<Song> SongDatabase::search_by_genre(const std::string& genre) const {
     std::vector<Song> result;
-    std::string normalizedGenre = normalizeString(genre);
+    auto it = handlesByGenre.find(normalizeString(genre));
+    if (it == handlesByGenre.end()) return result;
     
-    for (const auto& pair : songsById) {
-        if (normalizeString(pair.second.getGenre()) == normalizedGenre) {
-            result.push_back(pair.second);
-        }
+    result.reserve(it->second.size());
+    for (SongHandle handle : it->second) {
+        result.push_back(*handleTable[handle]);
     }
     
     return result;
@@ -243,11 +377,67 @@ void SongDatabase::display_stats() const {
 }
 
 int SongDatabase::get_size() const { return songsById.size(); }
+const SongStats& SongDatabase::get_stats() const { return stats; }
 bool SongDatabase::is_empty() const { return songsById.empty(); }
 
 void SongDatabase::clear() {
+    if (!listeners.empty()) {
+        for (const auto& pair : songsById) {
+            notifyDeleted(pair.first);
+        }
+    }
     songsById.clear();
     titleArtistKeys.clear();
+    handlesByGenre.clear();
+    genrePositions.clear();
+    stats.clear();
+    // Interned ids keep their handles; they just stop resolving
+    std::fill(handleTable.begin(), handleTable.end(), nullptr);
+}
+
+// Change notification
+void SongDatabase::add_listener(SongDatabaseListener* listener) {
+    if (listener == nullptr) return;
+    if (std::find(listeners.begin(), listeners.end(), listener) == listeners.end()) {
+        listeners.push_back(listener);
+    }
+}
+
+void SongDatabase::remove_listener(SongDatabaseListener* listener) {
+    listeners.erase(std::remove(listeners.begin(), listeners.end(), listener), listeners.end());
+}
+
+// Handle operations
+SongHandle SongDatabase::get_handle(const std::string& songId) const {
+    auto it = handlesById.find(songId);
+    if (it == handlesById.end() || handleTable[it->second] == nullptr) {
+        return INVALID_SONG_HANDLE;
+    }
+    return it->second;
+}
+
+Song* SongDatabase::resolve_handle(SongHandle handle) {
+    if (handle >= handleTable.size()) return nullptr;
+    return handleTable[handle];
+}
+
+const Song* SongDatabase::resolve_handle(SongHandle handle) const {
+    if (handle >= handleTable.size()) return nullptr;
+    return handleTable[handle];
+}
+
+std::string SongDatabase::get_handle_id(SongHandle handle) const {
+    if (handle >= handleIds.size()) return "";
+    return handleIds[handle];
+}
+
+size_t SongDatabase::get_handle_count() const {
+    return handleIds.size();
+}
+
+std::vector<SongHandle> SongDatabase::get_handles_by_genre(const std::string& genre) const {
+    auto it = handlesByGenre.find(normalizeString(genre));
+    return it != handlesByGenre.end() ? it->second : std::vector<SongHandle>();
 }
 
 // Batch operations
@@ -261,6 +451,17 @@ bool SongDatabase::insert_songs(const std::vector<Song>& songs) {
     return allInserted;
 }
 
+bool SongDatabase::insert_songs(std::vector<Song>&& songs) {
+    bool allInserted = true;
+    for (Song& song : songs) {
+        if (!insert_song(std::move(song))) {
+            allInserted = false;
+        }
+    }
+    songs.clear();
+    return allInserted;
+}
+
 std::vector<Song> SongDatabase::get_all_songs() const {
     std::vector<Song> result;
     result.reserve(songsById.size());
@@ -273,7 +474,7 @@ std::vector<Song> SongDatabase::get_all_songs() const {
 std::vector<std::string> SongDatabase::get_all_artists() const {
     std::vector<std::string> artists;
     for (const auto& pair : songsById) {
-        std::string artist = pair.second.getArtist();
+        const std::string& artist = pair.second.getArtist();
         if (std::find(artists.begin(), artists.end(), artist) == artists.end()) {
             artists.push_back(artist);
         }
@@ -284,7 +485,7 @@ std::vector<std::string> SongDatabase::get_all_artists() const {
 std::vector<std::string> SongDatabase::get_all_albums() const {
     std::vector<std::string> albums;
     for (const auto& pair : songsById) {
-        std::string album = pair.second.getAlbum();
+        const std::string& album = pair.second.getAlbum();
         if (!album.empty() && std::find(albums.begin(), albums.end(), album) == albums.end()) {
             albums.push_back(album);
         }
@@ -295,7 +496,7 @@ std::vector<std::string> SongDatabase::get_all_albums() const {
 std::vector<std::string> SongDatabase::get_all_genres() const {
     std::vector<std::string> genres;
     for (const auto& pair : songsById) {
-        std::string genre = pair.second.getGenre();
+        const std::string& genre = pair.second.getGenre();
         if (!genre.empty() && std::find(genres.begin(), genres.end(), genre) == genres.end()) {
             genres.push_back(genre);
         }
@@ -332,15 +533,10 @@ std::vector<Song> SongDatabase::search_by_keyword(const std::string& keyword) co
     
     for (const auto& pair : songsById) {
         const Song& song = pair.second;
-        std::string title = normalizeString(song.getTitle());
-        std::string artist = normalizeString(song.getArtist());
-        std::string album = normalizeString(song.getAlbum());
-        std::string genre = normalizeString(song.getGenre());
-        
-        if (title.find(normalizedKeyword) != std::string::npos ||
-            artist.find(normalizedKeyword) != std::string::npos ||
-            album.find(normalizedKeyword) != std::string::npos ||
-            genre.find(normalizedKeyword) != std::string::npos) {
+        if (containsIgnoreCase(song.getTitle(), normalizedKeyword) ||
+            containsIgnoreCase(song.getArtist(), normalizedKeyword) ||
+            containsIgnoreCase(song.getAlbum(), normalizedKeyword) ||
+            containsIgnoreCase(song.getGenre(), normalizedKeyword)) {
             result.push_back(song);
         }
     }
@@ -412,7 +608,7 @@ bool SongDatabase::import_from_file(const std::string& filename) {
                 // Create and insert the previous song
                 Song song(id, title, artist, duration, rating, album, genre);
                 song.setAddedDate(addedDate);
-                if (insert_song(song)) {
+                if (insert_song(std::move(song))) {
                     songsImported++;
                 }
             }
@@ -447,7 +643,7 @@ bool SongDatabase::import_from_file(const std::string& filename) {
     if (readingSong) {
         Song song(id, title, artist, duration, rating, album, genre);
         song.setAddedDate(addedDate);
-        if (insert_song(song)) {
+        if (insert_song(std::move(song))) {
             songsImported++;
         }
     }
@@ -0,0 +1,134 @@
+#include "../include/song_stats.h"
+#include <algorithm>
+
+// Constructor
+SongStats::SongStats() : songCount(0), totalDuration(0), ratingSum(0), ratedCount(0) {
+    std::fill(ratingCounts, ratingCounts + Song::MAX_RATING + 1, 0);
+}
+
+// Helper methods
+void SongStats::countRating(int rating, int delta) {
+    if (rating >= 0 && rating <= Song::MAX_RATING) {
+        ratingCounts[rating] += delta;
+    } else if ((otherRatingCounts[rating] += delta) == 0) {
+        otherRatingCounts.erase(rating);
+    }
+    if (rating > 0) {
+        ratingSum += static_cast<long long>(rating) * delta;
+        ratedCount += delta;
+    }
+}
+
+void SongStats::countKey(std::unordered_map<std::string, int>& counts, const std::string& key, int delta) {
+    if (delta > 0) {
+        counts[key] += delta;
+        return;
+    }
+    auto it = counts.find(key);
+    if (it == counts.end()) return;
+    it->second += delta;
+    if (it->second <= 0) {
+        counts.erase(it);
+    }
+}
+
+std::vector<std::pair<std::string, int>> SongStats::topKeys(const std::unordered_map<std::string, int>& counts,
+                                                            int count) {
+    std::vector<std::pair<std::string, int>> ranked(counts.begin(), counts.end());
+    auto byCount = [](const std::pair<std::string, int>& a, const std::pair<std::string, int>& b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    };
+    size_t keep = std::min(ranked.size(), static_cast<size_t>(std::max(0, count)));
+    std::partial_sort(ranked.begin(), ranked.begin() + keep, ranked.end(), byCount);
+    ranked.resize(keep);
+    return ranked;
+}
+
+// Maintenance
+void SongStats::add(const Song& song) {
+    songCount++;
+    totalDuration += song.getDuration();
+    countRating(song.getRating(), 1);
+    countKey(genreCounts, song.getGenre(), 1);
+    countKey(artistCounts, song.getArtist(), 1);
+}
+
+void SongStats::remove(const Song& song) {
+    songCount--;
+    totalDuration -= song.getDuration();
+    countRating(song.getRating(), -1);
+    countKey(genreCounts, song.getGenre(), -1);
+    countKey(artistCounts, song.getArtist(), -1);
+}
+
+void SongStats::update(const Song& before, const Song& after) {
+    // Only the fields that changed touch the maps
+    totalDuration += after.getDuration() - before.getDuration();
+    if (before.getRating() != after.getRating()) {
+        countRating(before.getRating(), -1);
+        countRating(after.getRating(), 1);
+    }
+    if (before.getGenre() != after.getGenre()) {
+        countKey(genreCounts, before.getGenre(), -1);
+        countKey(genreCounts, after.getGenre(), 1);
+    }
+    if (before.getArtist() != after.getArtist()) {
+        countKey(artistCounts, before.getArtist(), -1);
+        countKey(artistCounts, after.getArtist(), 1);
+    }
+}
+
+void SongStats::clear() {
+    songCount = 0;
+    totalDuration = 0;
+    ratingSum = 0;
+    ratedCount = 0;
+    std::fill(ratingCounts, ratingCounts + Song::MAX_RATING + 1, 0);
+    otherRatingCounts.clear();
+    genreCounts.clear();
+    artistCounts.clear();
+}
+
+// Queries
+int SongStats::getSongCount() const { return songCount; }
+long long SongStats::getTotalDuration() const { return totalDuration; }
+int SongStats::getRatedCount() const { return ratedCount; }
+
+double SongStats::getAverageRating() const {
+    return ratedCount > 0 ? static_cast<double>(ratingSum) / ratedCount : 0.0;
+}
+
+int SongStats::getRatingCount(int rating) const {
+    if (rating >= 0 && rating <= Song::MAX_RATING) return ratingCounts[rating];
+    auto it = otherRatingCounts.find(rating);
+    return it != otherRatingCounts.end() ? it->second : 0;
+}
+
+std::map<int, int> SongStats::getRatingCounts() const {
+    std::map<int, int> counts(otherRatingCounts.begin(), otherRatingCounts.end());
+    for (int rating = 0; rating <= Song::MAX_RATING; rating++) {
+        if (ratingCounts[rating] > 0) counts[rating] = ratingCounts[rating];
+    }
+    return counts;
+}
+
+int SongStats::getGenreCount(const std::string& genre) const {
+    auto it = genreCounts.find(genre);
+    return it != genreCounts.end() ? it->second : 0;
+}
+
+int SongStats::getArtistCount(const std::string& artist) const {
+    auto it = artistCounts.find(artist);
+    return it != artistCounts.end() ? it->second : 0;
+}
+
+const std::unordered_map<std::string, int>& SongStats::getGenreCounts() const { return genreCounts; }
+const std::unordered_map<std::string, int>& SongStats::getArtistCounts() const { return artistCounts; }
+
+std::vector<std::pair<std::string, int>> SongStats::top_genres(int count) const {
+    return topKeys(genreCounts, count);
+}
+
+std::vector<std::pair<std::string, int>> SongStats::top_artists(int count) const {
+    return topKeys(artistCounts, count);
+}
@@ -1,8 +1,11 @@
 #include "../include/sorting.h"
+#include "../include/playlist.h"
 #include <algorithm>
 #include <chrono>
 #include <iostream>
 #include <iomanip>
+#include <iterator>
+#include <random>
 
 // Comparison functions
 bool Sorting::compareByTitle(const Song& a, const Song& b, bool ascending) {
@@ -90,9 +93,10 @@ std::string Sorting::getCriteriaName(SortCriteria criteria) {
 }
 
 void Sorting::swap(Song& a, Song& b) {
-    Song temp = a;
-    a = b;
-    b = temp;
+    // Moves only exchange string buffers
+    Song temp = std::move(a);
+    a = std::move(b);
+    b = std::move(temp);
 }
 
 // Merge Sort Implementation
@@ -104,7 +108,7 @@ void Sorting::mergeSort(std::vector<Song>& songs, SortCriteria criteria) {
 }
 
 void Sorting::mergeSortHelper(std::vector<Song>& songs, int left, int right, 
-                             std::function<bool(const Song&, const Song&)> compare) {
+                             const std::function<bool(const Song&, const Song&)>& compare) {
     if (left < right) {
         int mid = left + (right - left) / 2;
         mergeSortHelper(songs, left, mid, compare);
@@ -114,41 +118,37 @@ void Sorting::mergeSortHelper(std::vector<Song>& songs, int left, int right,
 }
 
 void Sorting::merge(std::vector<Song>& songs, int left, int mid, int right,
-                   std::function<bool(const Song&, const Song&)> compare) {
+                   const std::function<bool(const Song&, const Song&)>& compare) {
     int n1 = mid - left + 1;
     int n2 = right - mid;
     
-    std::vector<Song> leftArray(n1);
-    std::vector<Song> rightArray(n2);
-    
-    for (int i = 0; i < n1; i++) {
-        leftArray[i] = songs[left + i];
-    }
-    for (int j = 0; j < n2; j++) {
-        rightArray[j] = songs[mid + 1 + j];
-    }
+    // Halves are moved out and back, so no strings are copied
+    std::vector<Song> leftArray(std::make_move_iterator(songs.begin() + left),
+                                std::make_move_iterator(songs.begin() + mid + 1));
+    std::vector<Song> rightArray(std::make_move_iterator(songs.begin() + mid + 1),
+                                 std::make_move_iterator(songs.begin() + right + 1));
     
     int i = 0, j = 0, k = left;
     
     while (i < n1 && j < n2) {
         if (compare(leftArray[i], rightArray[j])) {
-            songs[k] = leftArray[i];
+            songs[k] = std::move(leftArray[i]);
             i++;
         } else {
-            songs[k] = rightArray[j];
+            songs[k] = std::move(rightArray[j]);
             j++;
         }
         k++;
     }
     
     while (i < n1) {
-        songs[k] = leftArray[i];
+        songs[k] = std::move(leftArray[i]);
         i++;
         k++;
     }
     
     while (j < n2) {
-        songs[k] = rightArray[j];
+        songs[k] = std::move(rightArray[j]);
         j++;
         k++;
     }
@@ -163,7 +163,7 @@ void Sorting::quickSort(std::vector<Song>& songs, SortCriteria criteria) {
 }
 
 void Sorting::quickSortHelper(std::vector<Song>& songs, int low, int high,
-                             std::function<bool(const Song&, const Song&)> compare) {
+                             const std::function<bool(const Song&, const Song&)>& compare) {
     if (low < high) {
         int pi = partition(songs, low, high, compare);
         quickSortHelper(songs, low, pi - 1, compare);
@@ -172,8 +172,9 @@ void Sorting::quickSortHelper(std::vector<Song>& songs, int low, int high,
 }
 
 int Sorting::partition(std::vector<Song>& songs, int low, int high,
-                      std::function<bool(const Song&, const Song&)> compare) {
-    Song pivot = songs[high];
+                      const std::function<bool(const Song&, const Song&)>& compare) {
+    // songs[high] stays put until the final swap
+    const Song& pivot = songs[high];
     int i = low - 1;
     
     for (int j = low; j < high; j++) {
@@ -252,4 +253,56 @@ void Sorting::benchmarkSorting(std::vector<Song>& songs) {
         std::cout << std::setw(20) << "Quick Sort" << std::setw(15) << quickTime.count() << std::endl;
         std::cout << std::endl;
     }
-} 
\ No newline at end of file
+}
+
+void Sorting::benchmarkPlaylistSort(int playlistSize) {
+    std::cout << "\n=== Playlist Sort Benchmark ===" << std::endl;
+    std::cout << "Testing with " << playlistSize << " songs" << std::endl;
+    
+    std::mt19937 rng(42);
+    Playlist original("Benchmark");
+    for (int i = 0; i < playlistSize; i++) {
+        original.add_song(Song(std::to_string(i), "Title " + std::to_string(rng() % 1000000),
+                               "Artist " + std::to_string(rng() % 5000), 60 + static_cast<int>(rng() % 600),
+                               1 + static_cast<int>(rng() % 5)));
+    }
+    
+    std::cout << std::setw(20) << "Method" << std::setw(15) << "Time (μs)" << std::endl;
+    std::cout << std::string(35, '-') << std::endl;
+    
+    std::vector<SortCriteria> criteria = {
+        SortCriteria::TITLE_ASC,
+        SortCriteria::DURATION_ASC,
+        SortCriteria::RATING_DESC
+    };
+    
+    for (auto criterion : criteria) {
+        // Copy every song out, sort the vector, rebuild the playlist
+        Playlist rebuilt(original);
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<Song> songs;
+        songs.reserve(rebuilt.getSize());
+        for (PlaylistNode* node = rebuilt.getHead(); node != nullptr; node = node->next) {
+            songs.push_back(node->song);
+        }
+        mergeSort(songs, criterion);
+        rebuilt.clear();
+        for (Song& song : songs) {
+            rebuilt.add_song(std::move(song));
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        auto copyTime = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+        
+        // Relink the existing nodes
+        Playlist relinked(original);
+        start = std::chrono::high_resolution_clock::now();
+        relinked.sort(criterion);
+        end = std::chrono::high_resolution_clock::now();
+        auto relinkTime = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+        
+        std::cout << "Criterion: " << getCriteriaName(criterion) << std::endl;
+        std::cout << std::setw(20) << "Copy + rebuild" << std::setw(15) << copyTime.count() << std::endl;
+        std::cout << std::setw(20) << "In-place relink" << std::setw(15) << relinkTime.count() << std::endl;
+        std::cout << std::endl;
+    }
+}
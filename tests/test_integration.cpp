@@ -5,8 +5,17 @@
 #include "../include/song_database.h"
 #include "../include/favorite_songs_queue.h"
 #include "../include/sorting.h"
+#include "../include/playlist_manager.h"
+#include "../include/smart_playlist.h"
+#include "../include/play_queue.h"
+#include "../include/playlist_io.h"
+#include "../include/playlist_generator.h"
+#include <chrono>
+#include <cstdio>
+#include <ctime>
 #include <iostream>
 #include <string>
+#include <unordered_set>
 
 // Global test framework instance
 // TestFramework instance is defined in test_runner.cpp
@@ -382,6 +391,453 @@ bool testDataConsistencyIntegration() {
     return true;
 }
 
+bool testPlaylistManagerSharedStorageIntegration() {
+    SongDatabase database;
+    PlaylistManager manager(&database);
+    
+    database.insert_song(Song("1", "Song 1", "Artist 1", 180, 4));
+    database.insert_song(Song("2", "Song 2", "Artist 2", 200, 5));
+    
+    PlaylistId rock = manager.create_playlist("Rock");
+    PlaylistId chill = manager.create_playlist("Chill");
+    ASSERT_NOT_EQUAL(INVALID_PLAYLIST_ID, rock);
+    ASSERT_EQUAL(INVALID_PLAYLIST_ID, manager.create_playlist("Rock"));
+    
+    ASSERT_TRUE(manager.add_song(rock, "1"));
+    ASSERT_TRUE(manager.add_song(rock, "2"));
+    ASSERT_TRUE(manager.insert_song_at(chill, "2", 0));
+    ASSERT_FALSE(manager.add_song(chill, "missing"));
+    
+    // Entries point at the database copy rather than holding their own
+    std::vector<const Song*> songs = manager.get_songs(rock);
+    ASSERT_EQUAL(2, static_cast<int>(songs.size()));
+    ASSERT_TRUE(songs[1] == database.search_by_id("2"));
+    database.update_song_rating("2", 3);
+    ASSERT_EQUAL(3, manager.get_songs(chill)[0]->getRating());
+    
+    // Deleted songs stop resolving and come back when re-inserted
+    database.delete_song("1");
+    ASSERT_EQUAL(1, static_cast<int>(manager.get_songs(rock).size()));
+    database.insert_song(Song("1", "Song 1", "Artist 1", 180, 4));
+    ASSERT_EQUAL(2, static_cast<int>(manager.get_songs(rock).size()));
+    
+    ASSERT_TRUE(manager.rename_playlist(chill, "Ambient"));
+    ASSERT_EQUAL(chill, manager.find_playlist("Ambient"));
+    ASSERT_EQUAL(INVALID_PLAYLIST_ID, manager.find_playlist("Chill"));
+    ASSERT_FALSE(manager.rename_playlist(chill, "Rock"));
+    
+    ASSERT_TRUE(manager.get_playlist_memory(rock) > 0);
+    ASSERT_EQUAL(2, manager.to_playlist(rock).getSize());
+    
+    ASSERT_TRUE(manager.delete_playlist(rock));
+    ASSERT_EQUAL(1, manager.get_playlist_count());
+    ASSERT_EQUAL("Ambient", manager.list_playlists()[0].second);
+    
+    return true;
+}
+
+bool testPlaylistManagerManyPlaylistsIntegration() {
+    SongDatabase database;
+    PlaylistManager manager(&database);
+    
+    for (int i = 0; i < 100; i++) {
+        database.insert_song(Song(std::to_string(i), "Song " + std::to_string(i), "Artist", 180, 3));
+    }
+    
+    for (int i = 0; i < 20000; i++) {
+        PlaylistId id = manager.create_playlist("Playlist " + std::to_string(i));
+        for (int j = 0; j < 10; j++) {
+            manager.add_song(id, std::to_string((i + j) % 100));
+        }
+    }
+    ASSERT_EQUAL(20000, manager.get_playlist_count());
+    
+    for (int i = 0; i < 20000; i += 2) {
+        ASSERT_TRUE(manager.delete_playlist(manager.find_playlist("Playlist " + std::to_string(i))));
+    }
+    ASSERT_EQUAL(10000, manager.get_playlist_count());
+    ASSERT_EQUAL(10, manager.get_playlist_size(manager.find_playlist("Playlist 1")));
+    
+    return true;
+}
+
+bool testSmartPlaylistIncrementalIntegration() {
+    SongDatabase database;
+    database.insert_song(Song("1", "Delta", "Artist A", 180, 5, "Album", "Rock"));
+    database.insert_song(Song("2", "Alpha", "Artist B", 200, 4, "Album", "Rock"));
+    database.insert_song(Song("3", "Charlie", "Artist C", 210, 2, "Album", "Rock"));
+    database.insert_song(Song("4", "Bravo", "Artist D", 190, 5, "Album", "Jazz"));
+    
+    SmartPlaylistRule rule;
+    rule.genre = "rock";
+    rule.minRating = 4;
+    SmartPlaylist smart("Top Rock", rule, Sorting::SortCriteria::TITLE_ASC);
+    smart.attach(&database);
+    ASSERT_EQUAL(2, smart.getSize());
+    ASSERT_EQUAL("Alpha", smart.getPlaylist().getHead()->song.getTitle());
+    
+    // Inserts land at their sorted position
+    database.insert_song(Song("5", "Bravo Two", "Artist E", 220, 4, "Album", "Rock"));
+    ASSERT_EQUAL(3, smart.getSize());
+    ASSERT_EQUAL("Bravo Two", smart.getPlaylist().getHead()->next->song.getTitle());
+    
+    // Updates move songs in and out
+    database.update_song_rating("3", 5);
+    ASSERT_TRUE(smart.contains("3"));
+    database.update_song_rating("2", 1);
+    ASSERT_FALSE(smart.contains("2"));
+    
+    Song renamed = *database.search_by_id("1");
+    renamed.setTitle("Aardvark");
+    database.update_song(renamed);
+    ASSERT_EQUAL("Aardvark", smart.getPlaylist().getHead()->song.getTitle());
+    
+    database.delete_song("5");
+    ASSERT_EQUAL(2, smart.getSize());
+    
+    // Order and links stay consistent with a full re-evaluation
+    const char* expected[] = {"Aardvark", "Charlie"};
+    PlaylistNode* node = smart.getPlaylist().getHead();
+    for (const char* title : expected) {
+        ASSERT_EQUAL(std::string(title), node->song.getTitle());
+        ASSERT_TRUE(node->next == nullptr || node->next->prev == node);
+        node = node->next;
+    }
+    ASSERT_TRUE(smart.getPlaylist().getTail()->song.getTitle() == "Charlie");
+    
+    smart.detach();
+    database.insert_song(Song("6", "Echo", "Artist F", 200, 5, "Album", "Rock"));
+    ASSERT_EQUAL(0, smart.getSize());
+    
+    return true;
+}
+
+bool testSmartPlaylistExpiryIntegration() {
+    SongDatabase database;
+    std::time_t now = std::time(nullptr);
+    
+    Song old("1", "Old", "Artist", 180, 4, "Album", "Pop");
+    old.setAddedDate(std::to_string(static_cast<long long>(now) - 40 * 86400));
+    Song aging("2", "Aging", "Artist", 180, 4, "Album", "Pop");
+    aging.setAddedDate(std::to_string(static_cast<long long>(now) - 20 * 86400));
+    Song fresh("3", "Fresh", "Artist", 180, 4, "Album", "Pop");
+    database.insert_song(old);
+    database.insert_song(aging);
+    database.insert_song(fresh);
+    
+    SmartPlaylistRule rule;
+    rule.addedWithinDays = 30;
+    SmartPlaylist recent("Recently Added", rule, Sorting::SortCriteria::DATE_ADDED_DESC);
+    recent.attach(&database);
+    ASSERT_EQUAL(2, recent.getSize());
+    ASSERT_EQUAL("Fresh", recent.getPlaylist().getHead()->song.getTitle());
+    
+    // Fifteen days later only the fresh song is still recent
+    ASSERT_EQUAL(1, recent.expire(now + 15 * 86400));
+    ASSERT_EQUAL(1, recent.getSize());
+    ASSERT_TRUE(recent.contains("3"));
+    
+    return true;
+}
+
+bool testPlayQueueCursorIntegration() {
+    Playlist playlist("Queue");
+    History history(50);
+    FavoriteSongsQueue favorites;
+    for (int i = 1; i <= 5; i++) {
+        playlist.add_song(Song(std::to_string(i), "Song " + std::to_string(i), "Artist", 100 + i, 3));
+    }
+    
+    PlayQueue queue(&playlist, &history, &favorites);
+    ASSERT_EQUAL("1", queue.start()->getId());
+    ASSERT_EQUAL("2", queue.next()->getId());
+    ASSERT_EQUAL("3", queue.next()->getId());
+    ASSERT_EQUAL(3, history.get_size());
+    ASSERT_EQUAL("3", history.get_last_played().getId());
+    ASSERT_EQUAL(1, favorites.getPlayCount(*playlist.get_song_at(0)));
+    
+    // Edits before the cursor do not move it
+    playlist.add_song_at(Song("0", "Song 0", "Artist", 100, 3), 0);
+    ASSERT_EQUAL("3", queue.current()->getId());
+    
+    // Deleting the current song makes its successor the next song played
+    playlist.delete_song(3);
+    ASSERT_TRUE(queue.current() == nullptr);
+    ASSERT_EQUAL("4", queue.next()->getId());
+    ASSERT_EQUAL("2", queue.previous()->getId());
+    
+    ASSERT_TRUE(queue.play_next(Song("x", "Inserted", "Artist", 90, 3)));
+    ASSERT_EQUAL("x", queue.next()->getId());
+    ASSERT_EQUAL("4", queue.next()->getId());
+    ASSERT_EQUAL("5", queue.next()->getId());
+    ASSERT_TRUE(queue.next() == nullptr);
+    
+    queue.setRepeatMode(PlayQueue::RepeatMode::ALL);
+    queue.jump_to(playlist.getSize() - 1);
+    ASSERT_EQUAL("0", queue.next()->getId());
+    queue.setRepeatMode(PlayQueue::RepeatMode::ONE);
+    ASSERT_EQUAL("0", queue.next()->getId());
+    
+    playlist.clear();
+    ASSERT_TRUE(queue.next() == nullptr);
+    
+    return true;
+}
+
+bool testPlayQueueShuffleIntegration() {
+    Playlist playlist("Shuffle");
+    for (int i = 0; i < 20; i++) {
+        playlist.add_song(Song(std::to_string(i), "Song " + std::to_string(i), "Artist", 120, 3));
+    }
+    
+    PlayQueue queue(&playlist);
+    queue.setShuffle(true, 11);
+    std::vector<std::string> played;
+    for (const Song* song = queue.start(); song != nullptr; song = queue.next()) {
+        played.push_back(song->getId());
+    }
+    
+    // Every song once, in the same order Playlist::shuffle would produce
+    ASSERT_EQUAL(20, static_cast<int>(played.size()));
+    Playlist expected(playlist);
+    expected.shuffle(11);
+    PlaylistNode* node = expected.getHead();
+    for (const std::string& id : played) {
+        ASSERT_EQUAL(node->song.getId(), id);
+        node = node->next;
+    }
+    
+    // previous walks back through what was actually played
+    queue.setRepeatMode(PlayQueue::RepeatMode::ALL);
+    queue.start();
+    std::string first = queue.current()->getId();
+    queue.next();
+    ASSERT_EQUAL(first, queue.previous()->getId());
+
+    // Edits mid-cycle shift positions but never repeat or skip a song
+    PlayQueue edited(&playlist);
+    edited.setShuffle(true, 5);
+    std::unordered_set<std::string> seen;
+    const Song* song = edited.start();
+    for (int i = 0; i < 5; i++) {
+        ASSERT_TRUE(seen.insert(song->getId()).second);
+        song = edited.next();
+    }
+    std::string deletedFirst = playlist.getHead()->song.getId();
+    std::string deletedLast = playlist.getTail()->song.getId();
+    ASSERT_TRUE(playlist.delete_song(0));
+    ASSERT_TRUE(playlist.delete_song(playlist.getSize() - 1));
+    ASSERT_TRUE(playlist.move_song(2, 10));
+    playlist.add_song_at(Song("new", "Added", "Artist", 120, 3), 0);
+    if (edited.isPlaying()) {
+        song = edited.current();
+    } else {
+        song = edited.next();
+    }
+    for (; song != nullptr; song = edited.next()) {
+        ASSERT_TRUE(seen.insert(song->getId()).second);
+        ASSERT_TRUE(song->getId() != deletedFirst && song->getId() != deletedLast);
+    }
+    ASSERT_TRUE(seen.count("new") == 0);
+    for (PlaylistNode* node = playlist.getHead(); node != nullptr; node = node->next) {
+        ASSERT_TRUE(node->song.getId() == "new" || seen.count(node->song.getId()) == 1);
+    }
+
+    return true;
+}
+
+bool testPlaylistIORoundTripIntegration() {
+    SongDatabase database;
+    database.insert_song(Song("1", "Plain", "Artist A", 180, 4, "Album", "Rock"));
+    database.insert_song(Song("2", "Quote \"and\" back\\slash", "Artist, B", 200, 5, "Album", "Jazz"));
+    database.insert_song(Song("3", "Tab\tand - dash", "Artist C", 210, 3, "Album", "Pop"));
+    
+    Playlist original("Round Trip");
+    original.add_song(*database.search_by_id("2"));
+    original.add_song(*database.search_by_id("1"));
+    original.add_song(Song("missing", "Not In Database", "Nobody", 100, 1));
+    original.add_song(*database.search_by_id("3"));
+    
+    PlaylistIOResult written = PlaylistIO::export_jsonl(original, "test_roundtrip.jsonl");
+    ASSERT_TRUE(written.success);
+    ASSERT_EQUAL(4LL, written.entries);
+    PlaylistIOResult m3uWritten = PlaylistIO::export_m3u(original, "test_roundtrip.m3u");
+    ASSERT_TRUE(m3uWritten.success);
+    
+    Playlist fromJson("JSON");
+    PlaylistIOResult readJson = PlaylistIO::import_jsonl(fromJson, database, "test_roundtrip.jsonl");
+    Playlist fromM3u("M3U");
+    PlaylistIOResult readM3u = PlaylistIO::import_m3u(fromM3u, database, "test_roundtrip.m3u");
+    std::remove("test_roundtrip.jsonl");
+    std::remove("test_roundtrip.m3u");
+    
+    ASSERT_TRUE(readJson.success);
+    ASSERT_EQUAL(3LL, readJson.imported);
+    ASSERT_EQUAL(1LL, readJson.unresolved);
+    ASSERT_TRUE(readM3u.success);
+    ASSERT_EQUAL(3LL, readM3u.imported);
+    
+    const char* expected[] = {"2", "1", "3"};
+    PlaylistNode* a = fromJson.getHead();
+    PlaylistNode* b = fromM3u.getHead();
+    for (const char* id : expected) {
+        ASSERT_EQUAL(std::string(id), a->song.getId());
+        ASSERT_EQUAL(std::string(id), b->song.getId());
+        a = a->next;
+        b = b->next;
+    }
+    ASSERT_EQUAL("Quote \"and\" back\\slash", fromJson.getHead()->song.getTitle());
+    
+    // Entries without a known id fall back to title and artist
+    Song renamed = *database.search_by_id("1");
+    database.delete_song("1");
+    renamed.setId("1b");
+    database.insert_song(renamed);
+    Playlist single("Single");
+    single.add_song(Song("1", "Plain", "Artist A", 180, 4));
+    PlaylistIO::export_m3u(single, "test_fallback.m3u");
+    Playlist resolved("Resolved");
+    PlaylistIOResult readFallback = PlaylistIO::import_m3u(resolved, database, "test_fallback.m3u");
+    std::remove("test_fallback.m3u");
+    ASSERT_EQUAL(1LL, readFallback.imported);
+    ASSERT_EQUAL("1b", resolved.getHead()->song.getId());
+    
+    return true;
+}
+
+bool testPlaylistIOThroughputIntegration() {
+    const int entryCount = 1000000;
+    SongDatabase database;
+    Playlist playlist("Large");
+    for (int i = 0; i < entryCount; i++) {
+        Song song(std::to_string(i), "Title " + std::to_string(i), "Artist " + std::to_string(i % 1000), 180, 3);
+        database.insert_song(song);
+        playlist.add_song(song);
+    }
+    
+    const char* formats[] = {"jsonl", "m3u"};
+    for (const char* format : formats) {
+        std::string filename = std::string("test_throughput.") + format;
+        bool json = std::string(format) == "jsonl";
+        
+        auto start = std::chrono::high_resolution_clock::now();
+        PlaylistIOResult written = json ? PlaylistIO::export_jsonl(playlist, filename)
+                                        : PlaylistIO::export_m3u(playlist, filename);
+        auto end = std::chrono::high_resolution_clock::now();
+        auto writeTime = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+        
+        Playlist imported("Imported");
+        start = std::chrono::high_resolution_clock::now();
+        PlaylistIOResult read = json ? PlaylistIO::import_jsonl(imported, database, filename)
+                                     : PlaylistIO::import_m3u(imported, database, filename);
+        end = std::chrono::high_resolution_clock::now();
+        auto readTime = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+        std::remove(filename.c_str());
+        
+        ASSERT_TRUE(written.success);
+        ASSERT_TRUE(read.success);
+        ASSERT_EQUAL(static_cast<long long>(entryCount), read.imported);
+        ASSERT_EQUAL(playlist.getTail()->song.getId(), imported.getTail()->song.getId());
+        
+        std::cout << "    " << format << ": export " << writeTime.count() << " ms, import "
+                  << readTime.count() << " ms for " << entryCount << " entries" << std::endl;
+    }
+    
+    return true;
+}
+
+bool testPlaylistGeneratorIntegration() {
+    SongDatabase database;
+    for (int i = 0; i < 400; i++) {
+        Song song("gen" + std::to_string(i), "Track " + std::to_string(i), "Artist " + std::to_string(i % 7),
+                  150 + (i * 37) % 200, (i % 5) + 1, "Album", (i % 2 == 0) ? "Rock" : "Jazz");
+        database.insert_song(song);
+    }
+    
+    PlaylistGeneratorRequest request;
+    request.rule.genre = "rock";
+    request.rule.minRating = 4;
+    request.targetSeconds = 3600;
+    request.toleranceSeconds = 30;
+    request.artistSpacing = 3;
+    
+    Playlist generated("Rock Hour");
+    PlaylistGeneratorResult result = PlaylistGenerator::generate(database, request, generated);
+    ASSERT_TRUE(result.success);
+    ASSERT_EQUAL(result.songCount, generated.getSize());
+    ASSERT_EQUAL(static_cast<long long>(result.totalDuration), generated.get_total_duration());
+    ASSERT_TRUE(result.totalDuration >= 3570 && result.totalDuration <= 3630);
+    
+    // Every song matches, appears once, and no artist repeats within 3 tracks
+    std::vector<Song> songs;
+    for (PlaylistNode* node = generated.getHead(); node != nullptr; node = node->next) {
+        songs.push_back(node->song);
+    }
+    std::unordered_set<std::string> ids;
+    for (size_t i = 0; i < songs.size(); i++) {
+        ASSERT_EQUAL(std::string("Rock"), songs[i].getGenre());
+        ASSERT_TRUE(songs[i].getRating() >= 4);
+        ASSERT_TRUE(ids.insert(songs[i].getId()).second);
+        for (size_t j = i + 1; j < songs.size() && j < i + 3; j++) {
+            ASSERT_TRUE(songs[i].getArtist() != songs[j].getArtist());
+        }
+    }
+    
+    // A single artist cannot be spaced; the output playlist is left untouched
+    request.rule.artist = "Artist 0";
+    request.targetSeconds = 600;
+    request.toleranceSeconds = 100;
+    PlaylistGeneratorResult spaced = PlaylistGenerator::generate(database, request, generated);
+    ASSERT_FALSE(spaced.success);
+    ASSERT_FALSE(spaced.error.empty());
+    ASSERT_EQUAL(result.songCount, generated.getSize());
+    
+    // Without the spacing rule the same request succeeds
+    request.artistSpacing = 0;
+    ASSERT_TRUE(PlaylistGenerator::generate(database, request, generated).success);
+    
+    // No song is short enough for a 10-second target
+    request.rule = SmartPlaylistRule();
+    request.targetSeconds = 10;
+    request.toleranceSeconds = 0;
+    ASSERT_FALSE(PlaylistGenerator::generate(database, request, generated).success);
+    
+    return true;
+}
+
+bool testPlaylistGeneratorLargeCatalogIntegration() {
+    const int catalogSize = 1000000;
+    SongDatabase database;
+    for (int i = 0; i < catalogSize; i++) {
+        Song song(std::to_string(i), "Title " + std::to_string(i), "Artist " + std::to_string(i % 5000),
+                  120 + static_cast<int>((i * 7919LL) % 241), (i % 5) + 1, "Album", "Genre " + std::to_string(i % 10));
+        database.insert_song(song);
+    }
+    
+    PlaylistGeneratorRequest request;
+    request.rule.genre = "Genre 3";
+    request.rule.minRating = 4;
+    request.targetSeconds = 3600;
+    request.toleranceSeconds = 0;
+    request.artistSpacing = 3;
+    
+    Playlist generated("Generated");
+    auto start = std::chrono::high_resolution_clock::now();
+    PlaylistGeneratorResult result = PlaylistGenerator::generate(database, request, generated);
+    auto end = std::chrono::high_resolution_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+    
+    ASSERT_TRUE(result.success);
+    ASSERT_EQUAL(3600, result.totalDuration);
+    ASSERT_EQUAL(3600LL, generated.get_total_duration());
+    
+    std::cout << "    generated " << result.songCount << " songs from " << result.candidates << " candidates in "
+              << elapsed.count() / 1000.0 << " ms (" << catalogSize << "-song catalog)" << std::endl;
+    ASSERT_TRUE(elapsed.count() < 100000);
+    
+    return true;
+}
+
 // Register all integration tests
 void registerIntegrationTests() {
     testFramework.addTest("Playlist to History Integration", "Test integration between playlist and history", testPlaylistToHistoryIntegration, true);
@@ -394,4 +850,14 @@ void registerIntegrationTests() {
     testFramework.addTest("Error Handling Integration", "Test error handling across components", testErrorHandlingIntegration, true);
     testFramework.addTest("Performance Integration", "Test performance with larger datasets", testPerformanceIntegration, true);
     testFramework.addTest("Data Consistency Integration", "Test data consistency across components", testDataConsistencyIntegration, true);
+    testFramework.addTest("Playlist Manager Shared Storage Integration", "Test managed playlists resolve handles into the database", testPlaylistManagerSharedStorageIntegration, true);
+    testFramework.addTest("Playlist Manager Many Playlists Integration", "Test creating and deleting thousands of playlists", testPlaylistManagerManyPlaylistsIntegration, true);
+    testFramework.addTest("Smart Playlist Incremental Integration", "Test smart playlists follow database inserts, updates and deletes", testSmartPlaylistIncrementalIntegration, true);
+    testFramework.addTest("Smart Playlist Expiry Integration", "Test songs age out of an added-within rule", testSmartPlaylistExpiryIntegration, true);
+    testFramework.addTest("Play Queue Cursor Integration", "Test the queue cursor survives edits and records plays", testPlayQueueCursorIntegration, true);
+    testFramework.addTest("Play Queue Shuffle Integration", "Test shuffle mode plays every song once and steps back", testPlayQueueShuffleIntegration, true);
+    testFramework.addTest("Playlist IO Round Trip Integration", "Test M3U and JSONL export and import resolve against the database", testPlaylistIORoundTripIntegration, true);
+    testFramework.addTest("Playlist IO Throughput Integration", "Test streaming export and import of 1M-entry files", testPlaylistIOThroughputIntegration, true);
+    testFramework.addTest("Playlist Generator Integration", "Test generated playlists meet the duration, rule and spacing constraints", testPlaylistGeneratorIntegration, true);
+    testFramework.addTest("Playlist Generator Large Catalog Integration", "Test generation against a 1M-song catalog", testPlaylistGeneratorLargeCatalogIntegration, true);
 } 
\ No newline at end of file
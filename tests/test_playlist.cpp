@@ -2,8 +2,29 @@
 #include "../include/playlist.h"
 #include "../include/song.h"
 #include "../include/song_database.h"
+#include "../include/persistent_playlist.h"
+#include "../include/concurrent_playlist.h"
+#include "../include/playlist_crdt.h"
+#include "../include/allocation_counter.h"
+#include "../include/history.h"
+#include "../include/history_log.h"
+#include "../include/playback_ingest.h"
+#include "../include/compressed_history.h"
+#include "../include/heavy_hitters.h"
+#include "../include/distinct_counts.h"
+#include "../include/sessionizer.h"
+#include "../include/dashboard.h"
+#include "../include/rating_tree.h"
+#include "../include/favorite_songs_queue.h"
+#include "../include/edit_journal.h"
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <random>
 #include <iostream>
 #include <string>
+#include <thread>
 
 // Global test framework instance
 // TestFramework instance is defined in test_runner.cpp
@@ -235,6 +256,73 @@ bool testPlaylistShuffleSingle() {
     return true;
 }
 
+bool testPlaylistShuffleSeeded() {
+    Playlist first("First");
+    Playlist second("Second");
+    
+    for (int i = 0; i < 50; i++) {
+        first.add_song("Song " + std::to_string(i), "Artist", 180);
+        second.add_song("Song " + std::to_string(i), "Artist", 180);
+    }
+    
+    // Shuffling must relink the existing nodes rather than copy songs
+    Song* songBefore = first.find_song_by_id("25");
+    first.shuffle(42);
+    second.shuffle(42);
+    ASSERT_TRUE(songBefore == first.find_song_by_id("25"));
+    
+    ASSERT_EQUAL(50, first.getSize());
+    PlaylistNode* a = first.getHead();
+    PlaylistNode* b = second.getHead();
+    int walked = 0;
+    while (a != nullptr && b != nullptr) {
+        ASSERT_EQUAL(a->song.getId(), b->song.getId());
+        if (a->next != nullptr) {
+            ASSERT_TRUE(a->next->prev == a);
+        }
+        a = a->next;
+        b = b->next;
+        walked++;
+    }
+    ASSERT_EQUAL(50, walked);
+    ASSERT_TRUE(first.getTail()->next == nullptr);
+    
+    return true;
+}
+
+bool testShuffleIteratorMatchesShuffle() {
+    Playlist playlist("Test");
+    for (int i = 0; i < 100; i++) {
+        playlist.add_song("Song " + std::to_string(i), "Artist", 180);
+    }
+    
+    ShuffleIterator iterator(playlist, 7);
+    std::vector<std::string> lazyOrder;
+    std::vector<bool> seen(100, false);
+    while (iterator.hasNext()) {
+        int index = iterator.nextIndex();
+        ASSERT_TRUE(index >= 0 && index < 100);
+        ASSERT_FALSE(seen[index]);
+        seen[index] = true;
+        lazyOrder.push_back(playlist.get_song_at(index)->getId());
+    }
+    ASSERT_EQUAL(-1, iterator.nextIndex());
+    ASSERT_EQUAL(100, static_cast<int>(lazyOrder.size()));
+    
+    // The lazy order is the same permutation an eager shuffle applies
+    playlist.shuffle(7);
+    PlaylistNode* current = playlist.getHead();
+    for (const std::string& id : lazyOrder) {
+        ASSERT_EQUAL(id, current->song.getId());
+        current = current->next;
+    }
+    
+    iterator.reset();
+    ASSERT_EQUAL(0, iterator.getStep());
+    
+    return true;
+}
+
 bool testPlaylistClear() {
     Playlist playlist("Test");
     SongDatabase database;
@@ -495,7 +583,1727 @@ bool testPlaylistDeleteBySongIdNotFound() {
     return true;
 }
 
+bool testPersistentPlaylistEdits() {
+    std::vector<SongHandle> handles = {10, 11, 12, 13};
+    PersistentPlaylist original = PersistentPlaylist::from_handles(handles);
+    
+    PersistentPlaylist inserted = original.insert_song_at(1, 99);
+    PersistentPlaylist deleted = inserted.delete_song(0);
+    PersistentPlaylist moved = deleted.move_song(0, 3);
+    
+    // Earlier versions are never modified by later edits
+    ASSERT_EQUAL(4, original.getSize());
+    ASSERT_EQUAL(11u, original.get_song_at(1));
+    ASSERT_EQUAL(99u, inserted.get_song_at(1));
+    ASSERT_EQUAL(5, inserted.getSize());
+    ASSERT_EQUAL(4, deleted.getSize());
+    
+    std::vector<SongHandle> expected = {11, 12, 13, 99};
+    ASSERT_TRUE(moved.to_handles() == expected);
+    
+    // Invalid edits leave the version unchanged
+    ASSERT_TRUE(moved.delete_song(10).shares_root_with(moved));
+    ASSERT_EQUAL(INVALID_SONG_HANDLE, moved.get_song_at(4));
+    
+    return true;
+}
+
+bool testPlaylistVersionHistorySharing() {
+    SongDatabase database;
+    Playlist playlist("Editorial");
+    for (int i = 0; i < 10000; i++) {
+        Song song(std::to_string(i), "Song " + std::to_string(i), "Artist", 180, 3);
+        database.insert_song(song);
+        playlist.add_song(song);
+    }
+    
+    PlaylistVersionHistory history(PersistentPlaylist::from_playlist(playlist, database));
+    ASSERT_EQUAL(10000, history.get_current().getSize());
+    
+    for (int i = 0; i < 300; i++) {
+        ASSERT_TRUE(history.move_song((i * 37) % 10000, (i * 91) % 10000));
+    }
+    ASSERT_EQUAL(301, history.get_version_count());
+    
+    // 300 full copies would need three million nodes
+    size_t nodes = history.count_unique_nodes();
+    ASSERT_TRUE(nodes < 10000 + 300 * 200);
+    
+    // Rolling back only selects a version; new edits branch from it
+    ASSERT_TRUE(history.rollback(0));
+    ASSERT_EQUAL(0, history.get_current_version());
+    ASSERT_EQUAL(database.get_handle("0"), history.get_current().get_song_at(0));
+    ASSERT_TRUE(history.delete_song(0));
+    ASSERT_EQUAL(302, history.get_version_count());
+    ASSERT_EQUAL(9999, history.get_current().getSize());
+    ASSERT_FALSE(history.rollback(500));
+    
+    Playlist restored = history.get_version(0).to_playlist(database, "Restored");
+    ASSERT_EQUAL(10000, restored.getSize());
+    ASSERT_EQUAL("9999", restored.getTail()->song.getId());
+    
+    return true;
+}
+
+bool testPlaylistApplyEdits() {
+    Playlist playlist("Batch");
+    for (int i = 0; i < 5; i++) {
+        playlist.add_song(Song(std::to_string(i), "Song " + std::to_string(i), "Artist", 180, 3));
+    }
+    Song* untouched = playlist.find_song_by_id("4");
+    
+    std::vector<PlaylistEdit> edits;
+    edits.push_back(PlaylistEdit::insert(Song("new", "New Song", "Artist", 200, 4), 2));
+    edits.push_back(PlaylistEdit::remove(0));
+    edits.push_back(PlaylistEdit::move(0, 4));
+    
+    PlaylistEditResult result = playlist.apply_edits(edits, true);
+    ASSERT_TRUE(result.success);
+    ASSERT_EQUAL(1, result.inserted);
+    ASSERT_EQUAL(1, result.deleted);
+    ASSERT_EQUAL(1, result.moved);
+    
+    // Same outcome as the one-by-one calls: new, 2, 3, 4, 1
+    std::string expected[] = {"new", "2", "3", "4", "1"};
+    PlaylistNode* current = playlist.getHead();
+    for (const std::string& id : expected) {
+        ASSERT_EQUAL(id, current->song.getId());
+        current = current->next;
+    }
+    ASSERT_TRUE(current == nullptr);
+    ASSERT_EQUAL("1", playlist.getTail()->song.getId());
+    ASSERT_TRUE(untouched == playlist.find_song_by_id("4"));
+    
+    return true;
+}
+
+bool testPlaylistApplyEditsAllOrNothing() {
+    Playlist playlist("Batch");
+    for (int i = 0; i < 3; i++) {
+        playlist.add_song(Song(std::to_string(i), "Song " + std::to_string(i), "Artist", 180, 3));
+    }
+    
+    std::vector<PlaylistEdit> edits;
+    edits.push_back(PlaylistEdit::remove(0));
+    edits.push_back(PlaylistEdit::insert(Song("x", "X", "Artist", 200, 4), 0));
+    edits.push_back(PlaylistEdit::move(0, 3));  // only indices 0-2 exist
+    
+    PlaylistEditResult result = playlist.apply_edits(edits);
+    ASSERT_FALSE(result.success);
+    ASSERT_EQUAL(2, result.failedEdit);
+    ASSERT_EQUAL(3, playlist.getSize());
+    ASSERT_EQUAL("0", playlist.getHead()->song.getId());
+    ASSERT_TRUE(playlist.find_song_by_id("x") == nullptr);
+    
+    return true;
+}
+
+bool testPlaylistApplyEditsMatchesSequential() {
+    Playlist sequential("Sequential");
+    for (int i = 0; i < 300; i++) {
+        sequential.add_song(Song(std::to_string(i), "Song " + std::to_string(i), "Artist", 180, 3));
+    }
+    Playlist batched(sequential);
+    std::vector<PlaylistEdit> edits = PlaylistEditor::generateRandomEdits(300, 500, 99);
+    
+    ASSERT_TRUE(PlaylistEditor::applySequential(sequential, edits).success);
+    PlaylistEditResult result = batched.apply_edits(edits);
+    ASSERT_TRUE(result.success);
+    ASSERT_EQUAL(sequential.getSize(), batched.getSize());
+    ASSERT_EQUAL(300 + result.inserted - result.deleted, batched.getSize());
+    ASSERT_EQUAL(sequential.get_total_duration(), batched.get_total_duration());
+    PlaylistEditResult planned = PlaylistEditor::planEdits(300, edits);
+    ASSERT_EQUAL(planned.inserted, result.inserted);
+    ASSERT_EQUAL(planned.deleted, result.deleted);
+    
+    // List links and the index agree
+    PlaylistNode* a = sequential.getHead();
+    PlaylistNode* b = batched.getHead();
+    int index = 0;
+    while (a != nullptr) {
+        ASSERT_EQUAL(a->song.getId(), b->song.getId());
+        ASSERT_TRUE(b->next == nullptr || b->next->prev == b);
+        ASSERT_TRUE(batched.get_song_at(index++) == &b->song);
+        a = a->next;
+        b = b->next;
+    }
+    ASSERT_TRUE(batched.getTail()->song.getId() == sequential.getTail()->song.getId());
+    
+    return true;
+}
+
+bool testPlaylistApplyEditsNotifiesOriginals() {
+    class RemovalRecorder : public PlaylistListener {
+    public:
+        std::vector<std::string> removals;  // "id>successor id"
+        void onNodeRemoving(PlaylistNode* node, PlaylistNode* successor) override {
+            removals.push_back(node->song.getId() + ">" + (successor ? successor->song.getId() : "end"));
+        }
+        void onPlaylistCleared() override {}
+        void onPlaylistDestroyed() override {}
+    };
+    
+    Playlist playlist("Batch");
+    for (int i = 0; i < 5; i++) {
+        playlist.add_song(Song(std::to_string(i), "Song " + std::to_string(i), "Artist", 180, 3));
+    }
+    RemovalRecorder recorder;
+    playlist.add_listener(&recorder);
+    
+    std::vector<PlaylistEdit> edits;
+    edits.push_back(PlaylistEdit::insert(Song("tmp", "Temporary", "Artist", 200, 4), 1));
+    edits.push_back(PlaylistEdit::remove(1));  // the song inserted above
+    edits.push_back(PlaylistEdit::remove(1));  // "1"
+    edits.push_back(PlaylistEdit::move(0, 2));  // 2, 3, 0, 4
+    edits.push_back(PlaylistEdit::remove(3));  // "4"
+    
+    PlaylistEditResult result = playlist.apply_edits(edits, true);
+    ASSERT_TRUE(result.success);
+    ASSERT_EQUAL(0, result.inserted);
+    ASSERT_EQUAL(2, result.deleted);
+    ASSERT_EQUAL(1, result.moved);
+    ASSERT_EQUAL(3, playlist.getSize());
+    ASSERT_EQUAL("0", playlist.getTail()->song.getId());
+    
+    // Only original songs are reported, each with the song that follows it
+    ASSERT_EQUAL(2, static_cast<int>(recorder.removals.size()));
+    ASSERT_EQUAL("1>2", recorder.removals[0]);
+    ASSERT_EQUAL("4>end", recorder.removals[1]);
+    playlist.remove_listener(&recorder);
+    
+    return true;
+}
+
+bool testPlaylistDiffReproducesTarget() {
+    Playlist server("Server");
+    for (int i = 0; i < 400; i++) {
+        server.add_song(Song(std::to_string(i), "Song " + std::to_string(i), "Artist", 180, 3));
+    }
+    Playlist client(server);
+    ASSERT_TRUE(client.apply_edits(PlaylistEditor::generateRandomEdits(400, 300, 5)).success);
+    
+    std::vector<PlaylistEdit> script = PlaylistEditor::diff(server, client);
+    PlaylistEditResult result = server.apply_edits(script, true);
+    ASSERT_TRUE(result.success);
+    ASSERT_EQUAL(client.getSize(), server.getSize());
+    
+    PlaylistNode* a = server.getHead();
+    PlaylistNode* b = client.getHead();
+    while (a != nullptr) {
+        ASSERT_EQUAL(b->song.getId(), a->song.getId());
+        a = a->next;
+        b = b->next;
+    }
+    
+    // The script moves no more songs than the net diff requires
+    int moves = 0;
+    for (const PlaylistEdit& edit : script) {
+        if (edit.type == PlaylistEdit::Type::MOVE) moves++;
+    }
+    ASSERT_EQUAL(result.moved, moves);
+    
+    return true;
+}
+
+bool testPlaylistDiffMinimalMoves() {
+    Playlist from("From");
+    Playlist to("To");
+    const char* before[] = {"a", "b", "c", "d", "e"};
+    const char* after[] = {"b", "c", "d", "e", "a", "f"};
+    for (const char* id : before) from.add_song(Song(id, id, "Artist", 180, 3));
+    for (const char* id : after) to.add_song(Song(id, id, "Artist", 180, 3));
+    
+    std::vector<PlaylistEdit> script = PlaylistEditor::diff(from, to);
+    ASSERT_EQUAL(2, static_cast<int>(script.size()));
+    ASSERT_TRUE(script[0].type == PlaylistEdit::Type::MOVE);
+    ASSERT_TRUE(script[1].type == PlaylistEdit::Type::INSERT);
+    
+    ASSERT_TRUE(PlaylistEditor::diff(from, from).empty());
+    
+    return true;
+}
+
+bool testPlaylistThreeWayMerge() {
+    Playlist base("Base");
+    const char* ids[] = {"a", "b", "c", "d", "e"};
+    for (const char* id : ids) base.add_song(Song(id, id, "Artist", 180, 3));
+    
+    // Ours deletes b and moves e to the front; theirs deletes d, moves a
+    // after e and inserts x after c
+    Playlist ours(base);
+    ours.delete_song(1);
+    ours.move_song(3, 0);
+    Playlist theirs(base);
+    theirs.delete_song(3);
+    theirs.move_song(0, 3);
+    theirs.add_song_at(Song("x", "x", "Artist", 180, 3), 2);
+    
+    PlaylistMergeResult merged = PlaylistEditor::merge(base, ours, theirs);
+    ASSERT_EQUAL(0, merged.conflicts);
+    ASSERT_TRUE(ours.apply_edits(merged.edits).success);
+    ASSERT_EQUAL(merged.mergedSize, ours.getSize());
+    
+    const char* expected[] = {"e", "a", "c", "x"};
+    PlaylistNode* node = ours.getHead();
+    for (const char* id : expected) {
+        ASSERT_TRUE(node != nullptr);
+        ASSERT_EQUAL(std::string(id), node->song.getId());
+        node = node->next;
+    }
+    
+    return true;
+}
+
+bool testPlaylistSortInPlaceStable() {
+    Playlist playlist("Sort");
+    playlist.add_song(Song("1", "B", "Artist", 200, 3));
+    playlist.add_song(Song("2", "A", "Artist", 180, 5));
+    playlist.add_song(Song("3", "C", "Artist", 180, 4));
+    playlist.add_song(Song("4", "D", "Artist", 150, 5));
+    PlaylistNode* firstNode = playlist.getHead();
+    
+    playlist.sort(Sorting::SortCriteria::DURATION_ASC);
+    
+    // Equal durations keep their original order and nodes are reused
+    const char* expected[] = {"4", "2", "3", "1"};
+    PlaylistNode* node = playlist.getHead();
+    ASSERT_TRUE(node->prev == nullptr);
+    for (const char* id : expected) {
+        ASSERT_EQUAL(std::string(id), node->song.getId());
+        ASSERT_TRUE(node->next == nullptr || node->next->prev == node);
+        node = node->next;
+    }
+    ASSERT_TRUE(playlist.getTail() == firstNode);
+    ASSERT_EQUAL(4, playlist.getSize());
+    
+    return true;
+}
+
+bool testPlaylistSortMatchesVectorSort() {
+    Playlist playlist("Sort");
+    std::vector<Song> songs;
+    for (int i = 0; i < 1000; i++) {
+        Song song(std::to_string(i), "Title " + std::to_string((i * 37) % 101), "Artist " + std::to_string(i % 13),
+                  100 + (i * 7) % 50, 1 + i % 5);
+        song.setAddedDate(std::to_string(1700000000 + (i * 11) % 97));
+        playlist.add_song(song);
+        songs.push_back(song);
+    }
+    
+    Sorting::SortCriteria criteria[] = {
+        Sorting::SortCriteria::TITLE_ASC, Sorting::SortCriteria::TITLE_DESC,
+        Sorting::SortCriteria::DURATION_ASC, Sorting::SortCriteria::DURATION_DESC,
+        Sorting::SortCriteria::RATING_ASC, Sorting::SortCriteria::RATING_DESC,
+        Sorting::SortCriteria::ARTIST_ASC, Sorting::SortCriteria::ARTIST_DESC,
+        Sorting::SortCriteria::DATE_ADDED_ASC, Sorting::SortCriteria::DATE_ADDED_DESC
+    };
+    for (Sorting::SortCriteria criterion : criteria) {
+        // Both sorts are stable, so they agree element for element
+        playlist.sort(criterion);
+        std::stable_sort(songs.begin(), songs.end(), Sorting::getComparator(criterion));
+        PlaylistNode* node = playlist.getHead();
+        for (const Song& song : songs) {
+            ASSERT_EQUAL(song.getId(), node->song.getId());
+            node = node->next;
+        }
+    }
+    
+    return true;
+}
+
+bool testPlaylistDurationIndexQueries() {
+    Playlist playlist("Timeline");
+    playlist.add_song(Song("1", "One", "Artist", 180, 3));
+    playlist.add_song(Song("2", "Two", "Artist", 240, 3));
+    playlist.add_song(Song("3", "Three", "Artist", 200, 3));
+    
+    ASSERT_EQUAL(620LL, playlist.get_total_duration());
+    ASSERT_EQUAL(0, playlist.find_index_at_offset(0));
+    ASSERT_EQUAL(0, playlist.find_index_at_offset(179));
+    ASSERT_EQUAL(1, playlist.find_index_at_offset(180));
+    ASSERT_EQUAL(2, playlist.find_index_at_offset(619));
+    ASSERT_EQUAL(-1, playlist.find_index_at_offset(620));
+    ASSERT_EQUAL(420LL, playlist.get_offset_of(2));
+    ASSERT_EQUAL(-1LL, playlist.get_offset_of(3));
+    ASSERT_EQUAL(1, playlist.count_songs_within(419));
+    ASSERT_EQUAL(2, playlist.count_songs_within(420));
+    
+    ASSERT_TRUE(playlist.set_song_duration(0, 60));
+    ASSERT_EQUAL(500LL, playlist.get_total_duration());
+    ASSERT_EQUAL(1, playlist.find_index_at_offset(60));
+    
+    return true;
+}
+
+bool testPlaylistDurationIndexUnderEdits() {
+    Playlist playlist("Timeline");
+    std::mt19937 rng(17);
+    for (int i = 0; i < 200; i++) {
+        playlist.add_song(Song(std::to_string(i), "Song", "Artist", 30 + static_cast<int>(rng() % 300), 3));
+    }
+    
+    for (int step = 0; step < 400; step++) {
+        int size = playlist.getSize();
+        switch (step % 7) {
+            case 0: playlist.add_song_at(Song("n" + std::to_string(step), "New", "Artist", 1 + static_cast<int>(rng() % 400), 3),
+                                         static_cast<int>(rng() % (size + 1))); break;
+            case 1: playlist.delete_song(static_cast<int>(rng() % size)); break;
+            case 2: playlist.move_song(static_cast<int>(rng() % size), static_cast<int>(rng() % size)); break;
+            case 3: if (step % 35 == 3) playlist.reverse_playlist(); break;
+            case 4: if (step % 70 == 4) playlist.shuffle(step); break;
+            case 5: if (step % 70 == 5) playlist.sort(Sorting::SortCriteria::DURATION_DESC); break;
+            case 6: if (step % 49 == 6) playlist.apply_edits(PlaylistEditor::generateRandomEdits(size, 20, step)); break;
+        }
+        
+        // Compare against sums over the linked list
+        long long offset = 0;
+        int index = 0;
+        for (PlaylistNode* node = playlist.getHead(); node != nullptr; node = node->next, index++) {
+            if (index % 23 == 0) {
+                ASSERT_EQUAL(offset, playlist.get_offset_of(index));
+                ASSERT_EQUAL(index, playlist.find_index_at_offset(offset));
+                ASSERT_TRUE(playlist.get_song_at(index) == &node->song);
+            }
+            offset += node->song.getDuration();
+        }
+        ASSERT_EQUAL(offset, playlist.get_total_duration());
+        ASSERT_EQUAL(index, playlist.getSize());
+    }
+    
+    return true;
+}
+
 // Register all Playlist tests
+bool testConcurrentPlaylistStress() {
+    const int initialSize = 2000;
+    const int writers = 4;
+    const int editsPerWriter = 2000;
+    std::vector<SongHandle> handles;
+    for (int i = 0; i < initialSize; i++) {
+        handles.push_back(static_cast<SongHandle>(i));
+    }
+    ConcurrentPlaylist playlist(PersistentPlaylist::from_handles(handles));
+    
+    std::atomic<bool> done(false);
+    std::atomic<int> netInserted(0);
+    std::atomic<int> successfulEdits(0);
+    bool consistent = true;
+    
+    // Every snapshot is a whole version: its size matches and no handle repeats
+    std::thread reader([&]() {
+        while (!done.load()) {
+            ConcurrentPlaylist::Snapshot version = playlist.snapshot();
+            std::vector<SongHandle> songs = version->to_handles();
+            std::vector<char> seen(initialSize + writers * editsPerWriter, 0);
+            consistent = consistent && static_cast<int>(songs.size()) == version->getSize();
+            for (SongHandle song : songs) {
+                consistent = consistent && !seen[song];
+                seen[song] = 1;
+            }
+        }
+    });
+    
+    std::vector<std::thread> threads;
+    for (int w = 0; w < writers; w++) {
+        threads.emplace_back([&, w]() {
+            std::mt19937 rng(w);
+            SongHandle nextHandle = static_cast<SongHandle>(initialSize + w * editsPerWriter);
+            for (int i = 0; i < editsPerWriter; i++) {
+                int position = static_cast<int>(rng() % 4000);
+                switch (rng() % 3) {
+                    case 0:
+                        if (playlist.insert_song_at(position % (playlist.getSize() + 1), nextHandle++)) {
+                            netInserted++;
+                            successfulEdits++;
+                        }
+                        break;
+                    case 1:
+                        if (playlist.delete_song(position)) {
+                            netInserted--;
+                            successfulEdits++;
+                        }
+                        break;
+                    default:
+                        if (playlist.move_song(position, static_cast<int>(rng() % 4000))) {
+                            successfulEdits++;
+                        }
+                        break;
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    done = true;
+    reader.join();
+    
+    // Each successful edit published exactly one version
+    ASSERT_TRUE(consistent);
+    ASSERT_EQUAL(initialSize + netInserted.load(), playlist.getSize());
+    ASSERT_EQUAL(static_cast<long long>(successfulEdits.load()), playlist.get_commit_count());
+    
+    return true;
+}
+
+bool testConcurrentPlaylistConditionalCommit() {
+    ConcurrentPlaylist playlist(PersistentPlaylist::from_handles({1, 2, 3}));
+    
+    // A snapshot stays readable and unchanged after later edits
+    ConcurrentPlaylist::Snapshot base = playlist.snapshot();
+    ASSERT_TRUE(playlist.add_song(4));
+    ASSERT_EQUAL(3, base->getSize());
+    ASSERT_EQUAL(4, playlist.getSize());
+    
+    // A change built from a stale snapshot is rejected, a fresh one commits
+    ASSERT_FALSE(playlist.commit_if_unchanged(base, base->delete_song(0)));
+    ConcurrentPlaylist::Snapshot fresh = playlist.snapshot();
+    ASSERT_TRUE(playlist.commit_if_unchanged(fresh, fresh->delete_song(0).move_song(0, 2)));
+    
+    std::vector<SongHandle> expected = {3, 4, 2};
+    ASSERT_TRUE(playlist.snapshot()->to_handles() == expected);
+    
+    // Invalid positions are refused without publishing a version
+    long long commits = playlist.get_commit_count();
+    ASSERT_FALSE(playlist.delete_song(3));
+    ASSERT_FALSE(playlist.insert_song_at(-1, 9));
+    ASSERT_FALSE(playlist.move_song(0, 5));
+    ASSERT_EQUAL(commits, playlist.get_commit_count());
+    
+    return true;
+}
+
+bool testPlaylistCrdtConvergence() {
+    PlaylistCRDT a(1);
+    PlaylistCRDT b(2);
+    PlaylistCRDT c(3);
+    CrdtElementId last = CRDT_ROOT_ID;
+    for (int i = 0; i < 20; i++) {
+        last = a.insert_after(last, static_cast<SongHandle>(i));
+    }
+    b.merge(a);
+    c.merge(a);
+    
+    // Concurrent inserts after the same song land together, newest id first
+    CrdtElementId anchor = a.element_at(4);
+    a.insert_after(anchor, 100);
+    b.insert_after(anchor, 200);
+    c.insert_after(anchor, 300);
+    a.merge(b);
+    a.merge(c);
+    ASSERT_EQUAL(300u, a.get_song(a.element_at(5)));
+    ASSERT_EQUAL(200u, a.get_song(a.element_at(6)));
+    ASSERT_EQUAL(100u, a.get_song(a.element_at(7)));
+    
+    // Random offline edits with syncs between random pairs
+    PlaylistCRDT* replicas[] = {&a, &b, &c};
+    std::mt19937 rng(5);
+    for (int round = 0; round < 600; round++) {
+        PlaylistCRDT& replica = *replicas[rng() % 3];
+        int size = replica.getSize();
+        switch (rng() % 4) {
+            case 0:
+            case 1:
+                replica.insert_at(static_cast<int>(rng() % (size + 1)), static_cast<SongHandle>(1000 + round));
+                break;
+            case 2:
+                if (size > 0) replica.remove_at(static_cast<int>(rng() % size));
+                break;
+            default:
+                if (size > 0) replica.move(static_cast<int>(rng() % size), static_cast<int>(rng() % size));
+                break;
+        }
+        if (round % 25 == 0) {
+            replicas[rng() % 3]->merge(*replicas[rng() % 3]);
+        }
+    }
+    
+    a.merge(b);
+    a.merge(c);
+    b.merge(a);
+    c.merge(a);
+    ASSERT_TRUE(a.to_handles() == b.to_handles());
+    ASSERT_TRUE(a.to_handles() == c.to_handles());
+    ASSERT_EQUAL(a.getSize(), static_cast<int>(a.to_handles().size()));
+    
+    // Re-merging is idempotent
+    ASSERT_EQUAL(0, b.merge(c));
+
+    // A child insert ahead of its parent waits instead of being marked seen
+    PlaylistCRDT parentSide(4);
+    PlaylistCRDT childSide(5);
+    parentSide.insert_at(0, 1);
+    childSide.merge(parentSide);
+    childSide.insert_at(1, 2);
+    std::vector<CrdtOperation> parentOps = parentSide.operations_since(CrdtVersionVector());
+    std::vector<CrdtOperation> childOps = childSide.operations_since(parentSide.get_version());
+
+    PlaylistCRDT late(6);
+    ASSERT_EQUAL(0, late.apply_operations(childOps));
+    ASSERT_EQUAL(0, late.getSize());
+    ASSERT_EQUAL(1, late.merge(parentSide));
+    ASSERT_EQUAL(1, late.merge(childSide));
+    ASSERT_TRUE(late.to_handles() == childSide.to_handles());
+
+    // Within one batch the child is applied once its parent is
+    PlaylistCRDT reversed(7);
+    std::vector<CrdtOperation> batch = childOps;
+    batch.insert(batch.end(), parentOps.begin(), parentOps.end());
+    ASSERT_EQUAL(2, reversed.apply_operations(batch));
+    ASSERT_TRUE(reversed.to_handles() == childSide.to_handles());
+
+    return true;
+}
+
+bool testPlaylistCrdtGarbageCollection() {
+    PlaylistCRDT a(1);
+    PlaylistCRDT b(2);
+    std::vector<CrdtReplicaId> members = {1, 2};
+    CrdtElementId last = CRDT_ROOT_ID;
+    for (int i = 0; i < 50; i++) {
+        last = a.insert_after(last, static_cast<SongHandle>(i));
+    }
+    b.merge(a);
+    
+    a.remove_at(10);
+    a.remove_at(10);
+    b.remove_at(30);
+    b.insert_after(b.element_at(29), 500);
+    
+    // Nothing is stable until both replicas have reported what they have seen
+    ASSERT_EQUAL(0u, a.collect_garbage(members));
+    a.merge(b);
+    b.merge(a);
+    ASSERT_EQUAL(0u, b.collect_garbage({1, 2, 3}));
+    a.merge(b);
+    
+    std::vector<SongHandle> before = a.to_handles();
+    ASSERT_EQUAL(3u, a.get_tombstone_count());
+    ASSERT_EQUAL(3u, a.collect_garbage(members));
+    ASSERT_EQUAL(3u, b.collect_garbage(members));
+    ASSERT_EQUAL(0u, a.get_tombstone_count());
+    ASSERT_EQUAL(0u, a.get_log_size());
+    ASSERT_TRUE(a.to_handles() == before);
+    
+    // Editing around the purged songs still converges
+    a.insert_after(a.element_at(9), 600);
+    b.insert_after(b.element_at(9), 700);
+    b.remove_at(28);
+    a.merge(b);
+    b.merge(a);
+    ASSERT_TRUE(a.to_handles() == b.to_handles());
+    ASSERT_EQUAL(49, a.getSize());
+    
+    return true;
+}
+
+bool testPlaylistCrdtToPlaylist() {
+    SongDatabase database;
+    PlaylistCRDT replica(1);
+    CrdtElementId last = CRDT_ROOT_ID;
+    for (int i = 0; i < 5; i++) {
+        Song song(std::to_string(i), "Song " + std::to_string(i), "Artist", 100 + i, 3);
+        database.insert_song(song);
+        last = replica.insert_after(last, database.get_handle(song.getId()));
+    }
+    replica.move(4, 0);
+    replica.remove_at(2);
+    
+    Playlist playlist = replica.to_playlist(database, "Merged");
+    ASSERT_EQUAL(4, playlist.getSize());
+    ASSERT_EQUAL(std::string("4"), playlist.getHead()->song.getId());
+    ASSERT_EQUAL(std::string("3"), playlist.getTail()->song.getId());
+    ASSERT_EQUAL(104LL + 100 + 102 + 103, playlist.get_total_duration());
+    
+    return true;
+}
+
+bool testPlaylistStatsUnderEdits() {
+    // Recomputes the aggregates by walking the playlist
+    auto statsMatchWalk = [](const Playlist& playlist) {
+        SongStats expected;
+        for (PlaylistNode* node = playlist.getHead(); node != nullptr; node = node->next) {
+            expected.add(node->song);
+        }
+        const SongStats& actual = playlist.get_stats();
+        if (actual.getSongCount() != playlist.getSize() || actual.getSongCount() != expected.getSongCount()) return false;
+        if (actual.getTotalDuration() != expected.getTotalDuration()) return false;
+        if (actual.getTotalDuration() != playlist.get_total_duration()) return false;
+        if (actual.getRatedCount() != expected.getRatedCount()) return false;
+        if (actual.getAverageRating() != expected.getAverageRating()) return false;
+        if (actual.getRatingCounts() != expected.getRatingCounts()) return false;
+        return actual.getGenreCounts() == expected.getGenreCounts() &&
+               actual.getArtistCounts() == expected.getArtistCounts();
+    };
+    
+    const std::string genres[] = {"Rock", "Jazz", "Pop"};
+    std::mt19937 rng(39);
+    Playlist playlist("Stats");
+    int nextId = 0;
+    auto makeSong = [&]() {
+        int id = nextId++;
+        return Song(std::to_string(id), "Song " + std::to_string(id), "Artist " + std::to_string(rng() % 5),
+                    60 + static_cast<int>(rng() % 240), static_cast<int>(rng() % 6), "Album", genres[rng() % 3]);
+    };
+    
+    for (int i = 0; i < 20; i++) {
+        playlist.add_song(makeSong());
+    }
+    ASSERT_TRUE(statsMatchWalk(playlist));
+    
+    for (int step = 0; step < 300; step++) {
+        int size = playlist.getSize();
+        int kind = static_cast<int>(rng() % 7);
+        if (kind == 0 || size == 0) {
+            playlist.add_song_at(makeSong(), static_cast<int>(rng() % (size + 1)));
+        } else if (kind == 1) {
+            playlist.delete_song(static_cast<int>(rng() % size));
+        } else if (kind == 2) {
+            playlist.move_song(static_cast<int>(rng() % size), static_cast<int>(rng() % size));
+        } else if (kind == 3) {
+            playlist.set_song_duration(static_cast<int>(rng() % size), static_cast<int>(rng() % 300));
+        } else if (kind == 4) {
+            playlist.set_song_rating(static_cast<int>(rng() % size), static_cast<int>(rng() % 6));
+        } else if (kind == 5) {
+            std::vector<PlaylistEdit> edits;
+            edits.push_back(PlaylistEdit::insert(makeSong(), 0));
+            edits.push_back(PlaylistEdit::remove(static_cast<int>(rng() % (size + 1))));
+            edits.push_back(PlaylistEdit::insert(makeSong(), size));
+            ASSERT_TRUE(playlist.apply_edits(edits).success);
+        } else {
+            playlist.shuffle(static_cast<unsigned int>(step));
+            playlist.reverse_playlist();
+        }
+        ASSERT_TRUE(statsMatchWalk(playlist));
+    }
+    
+    // Rejected edits and invalid ratings leave the aggregates alone
+    long long before = playlist.get_stats().getTotalDuration();
+    std::vector<PlaylistEdit> invalid;
+    invalid.push_back(PlaylistEdit::insert(makeSong(), 0));
+    invalid.push_back(PlaylistEdit::remove(playlist.getSize() + 5));
+    ASSERT_FALSE(playlist.apply_edits(invalid).success);
+    ASSERT_FALSE(playlist.set_song_rating(0, 7));
+    ASSERT_EQUAL(before, playlist.get_stats().getTotalDuration());
+    ASSERT_TRUE(statsMatchWalk(playlist));
+    
+    Playlist copy(playlist);
+    ASSERT_TRUE(statsMatchWalk(copy));
+    playlist.clear();
+    ASSERT_EQUAL(0, playlist.get_stats().getSongCount());
+    ASSERT_EQUAL(0LL, playlist.get_stats().getTotalDuration());
+    ASSERT_TRUE(playlist.get_stats().getArtistCounts().empty());
+    ASSERT_TRUE(statsMatchWalk(copy));
+    
+    return true;
+}
+
+bool testSongStatsAggregates() {
+    SongDatabase db;
+    db.insert_song(Song("1", "One", "Alpha", 100, 5, "Album", "Rock"));
+    db.insert_song(Song("2", "Two", "Alpha", 200, 3, "Album", "Rock"));
+    db.insert_song(Song("3", "Three", "Beta", 300, 0, "Album", "Jazz"));
+    
+    const SongStats& stats = db.get_stats();
+    ASSERT_EQUAL(3, stats.getSongCount());
+    ASSERT_EQUAL(600LL, stats.getTotalDuration());
+    ASSERT_EQUAL(2, stats.getRatedCount());
+    ASSERT_TRUE(stats.getAverageRating() == 4.0);
+    ASSERT_EQUAL(1, stats.getRatingCount(0));
+    ASSERT_EQUAL(2, stats.getArtistCount("Alpha"));
+    ASSERT_EQUAL(std::string("Alpha"), stats.top_artists(1).front().first);
+    ASSERT_EQUAL(std::string("Rock"), stats.top_genres(2).front().first);
+    
+    // Updates adjust only the fields that changed
+    ASSERT_TRUE(db.update_song_rating("2", 1));
+    ASSERT_TRUE(stats.getAverageRating() == 3.0);
+    ASSERT_TRUE(db.update_song(Song("3", "Three", "Gamma", 360, 4, "Album", "Rock")));
+    ASSERT_EQUAL(660LL, stats.getTotalDuration());
+    ASSERT_EQUAL(0, stats.getArtistCount("Beta"));
+    ASSERT_EQUAL(0, stats.getGenreCount("Jazz"));
+    ASSERT_EQUAL(3, stats.getGenreCount("Rock"));
+    ASSERT_EQUAL(0, stats.getRatingCount(0));
+    
+    ASSERT_TRUE(db.delete_song("1"));
+    ASSERT_EQUAL(2, stats.getSongCount());
+    ASSERT_EQUAL(1, stats.getArtistCount("Alpha"));
+    ASSERT_TRUE(stats.getAverageRating() == 2.5);
+    
+    // Histogram and average count a rating at the same value, 6 included
+    ASSERT_TRUE(db.update_song(Song("2", "Two", "Alpha", 200, 6, "Album", "Rock")));
+    ASSERT_EQUAL(1, stats.getRatingCount(6));
+    ASSERT_EQUAL(0, stats.getRatingCount(5));
+    ASSERT_TRUE(stats.getAverageRating() == 5.0);
+    ASSERT_TRUE(db.update_song_rating("2", 1));
+    ASSERT_TRUE(stats.getRatingCounts() == (std::map<int, int>{{1, 1}, {4, 1}}));
+
+    // The rating setters accept the same range as Song
+    ASSERT_TRUE(db.update_song_rating("2", Song::MAX_RATING));
+    ASSERT_FALSE(db.update_song_rating("2", Song::MAX_RATING + 1));
+    ASSERT_EQUAL(Song::MAX_RATING, db.search_by_id("2")->getRating());
+    Playlist rated("Rated");
+    rated.add_song(Song("9", "Nine", "Alpha", 90, 2));
+    ASSERT_TRUE(rated.set_song_rating(0, Song::MAX_RATING));
+    ASSERT_FALSE(rated.set_song_rating(0, Song::MAX_RATING + 1));
+    ASSERT_EQUAL(1, rated.get_stats().getRatingCount(Song::MAX_RATING));
+
+    SongDatabase copy(db);
+    ASSERT_EQUAL(560LL, copy.get_stats().getTotalDuration());
+    db.clear();
+    ASSERT_EQUAL(0, stats.getSongCount());
+    ASSERT_TRUE(stats.getGenreCounts().empty());
+    ASSERT_EQUAL(2, copy.get_stats().getSongCount());
+    
+    return true;
+}
+
+bool testSongMoveIngestionAllocations() {
+    // Strings longer than the small-string buffer so copies must allocate
+    auto makeSong = [](int i) {
+        return Song(std::to_string(i), "Allocation Test Title " + std::to_string(i), "Allocation Test Artist",
+                    200, 4, "Allocation Test Album", "Allocation Genre");
+    };
+    
+    // Getters and comparators read through references
+    Song first = makeSong(1);
+    Song second = makeSong(2);
+    auto compare = Sorting::getComparator(Sorting::SortCriteria::TITLE_ASC);
+    long long before = AllocationCounter::allocations();
+    bool ordered = compare(first, second) && first.getArtist() == second.getArtist();
+    ASSERT_TRUE(ordered);
+    ASSERT_EQUAL(0LL, AllocationCounter::allocations() - before);
+    
+    // Moving a song in costs only the container's own node; copying it
+    // also duplicates title, artist, album and genre
+    Playlist playlist("Allocations");
+    playlist.add_song(makeSong(0));
+    Song copied = makeSong(3);
+    Song moved = makeSong(4);
+    before = AllocationCounter::allocations();
+    playlist.add_song(copied);
+    long long copyCost = AllocationCounter::allocations() - before;
+    before = AllocationCounter::allocations();
+    playlist.add_song(std::move(moved));
+    long long moveCost = AllocationCounter::allocations() - before;
+    ASSERT_EQUAL(copyCost - 4, moveCost);
+    ASSERT_EQUAL(1LL, moveCost);
+    
+    playlist.emplace_song("5", "Allocation Test Title 5", "Allocation Test Artist", 180);
+    ASSERT_EQUAL(4, playlist.getSize());
+    ASSERT_EQUAL(std::string("Allocation Test Title 5"), playlist.getTail()->song.getTitle());
+    
+    SongDatabase db;
+    db.insert_song(makeSong(0));
+    copied = makeSong(6);
+    moved = makeSong(7);
+    before = AllocationCounter::allocations();
+    ASSERT_TRUE(db.insert_song(copied));
+    copyCost = AllocationCounter::allocations() - before;
+    before = AllocationCounter::allocations();
+    ASSERT_TRUE(db.insert_song(std::move(moved)));
+    moveCost = AllocationCounter::allocations() - before;
+    ASSERT_EQUAL(copyCost - 4, moveCost);
+    ASSERT_TRUE(db.emplace_song("8", "Allocation Test Title 8", "Allocation Test Artist", 180, 3));
+    ASSERT_FALSE(db.emplace_song("9", "Allocation Test Title 8", "Allocation Test Artist", 180, 3));
+    ASSERT_EQUAL(std::string("Allocation Genre"), db.search_by_id("7")->getGenre());
+    
+    History history;
+    history.add_played_song(makeSong(10));
+    history.emplace_played_song("11", "Allocation Test Title 11", "Allocation Test Artist", 180);
+    ASSERT_EQUAL(2, history.get_size());
+    ASSERT_EQUAL(std::string("11"), history.get_last_played().getId());
+    
+    RatingTree tree;
+    tree.insert_song(makeSong(12), 5);
+    FavoriteSongsQueue favorites;
+    favorites.addSong(makeSong(13));
+    ASSERT_EQUAL(1, tree.get_total_songs());
+    ASSERT_EQUAL(std::string("13"), favorites.getTopFavorite().getId());
+    
+    return true;
+}
+
+bool testHistoryRingBuffer() {
+    auto makeSong = [](int i) {
+        return Song(std::to_string(i), "Ring Buffer Song Title " + std::to_string(i), "Ring Buffer Artist", 180, 3);
+    };
+    
+    History history(3);
+    for (int i = 1; i <= 5; i++) {
+        history.add_played_song(makeSong(i));
+    }
+    ASSERT_EQUAL(3, history.get_size());
+    ASSERT_EQUAL(std::string("5"), history.get_recent_song(0)->getId());
+    ASSERT_EQUAL(std::string("3"), history.get_recent_song(2)->getId());
+    ASSERT_NULL(history.get_recent_song(3));
+    ASSERT_FALSE(history.contains_song("2"));
+    
+    // Undo pops the newest; the next play reuses its slot
+    ASSERT_EQUAL(std::string("5"), history.undo_last_play().getId());
+    history.add_played_song(makeSong(6));
+    std::string expected[] = {"6", "4", "3"};
+    int age = 0;
+    for (const Song& song : history.recent_view(10)) {
+        ASSERT_EQUAL(expected[age], song.getId());
+        age++;
+    }
+    ASSERT_EQUAL(3, age);
+    
+    // A full buffer evicts in place: moving a play in allocates nothing
+    Song next = makeSong(7);
+    long long before = AllocationCounter::allocations();
+    history.add_played_song(std::move(next));
+    ASSERT_EQUAL(0LL, AllocationCounter::allocations() - before);
+    ASSERT_EQUAL(std::string("4"), history.get_recent_song(2)->getId());
+    
+    // Growing keeps every play, shrinking keeps the newest
+    history.set_max_size(5);
+    history.add_played_song(makeSong(8));
+    history.add_played_song(makeSong(7));
+    ASSERT_EQUAL(5, history.get_size());
+    ASSERT_EQUAL(std::string("4"), history.get_recent_song(4)->getId());
+    ASSERT_EQUAL(2, history.get_song_play_count("7"));
+    history.set_max_size(2);
+    ASSERT_EQUAL(2, history.get_size());
+    ASSERT_EQUAL(std::string("8"), history.get_recent_song(1)->getId());
+    
+    history.remove_oldest_songs(1);
+    std::vector<Song> recent = history.get_recent_songs(5);
+    ASSERT_EQUAL(1, static_cast<int>(recent.size()));
+    ASSERT_EQUAL(std::string("7"), recent[0].getId());
+    history.clear_history();
+    ASSERT_TRUE(history.is_empty());
+    ASSERT_TRUE(history.recent_view(3).empty());
+    
+    return true;
+}
+
+bool testHistoryPlayCountIndex() {
+    auto makeSong = [](int i) {
+        return Song("id" + std::to_string(i), "Song " + std::to_string(i), "Artist " + std::to_string(i % 2), 200, 4);
+    };
+    
+    History history(4);
+    int plays[] = {1, 2, 1, 3, 1};
+    for (int id : plays) {
+        history.add_played_song(makeSong(id));
+    }
+    // "id1" at ages 4 (evicted), 2 and 0
+    ASSERT_EQUAL(2, history.get_song_play_count("id1"));
+    ASSERT_EQUAL(0, history.get_last_played_age("id1"));
+    ASSERT_EQUAL(1, history.get_last_played_age("id3"));
+    ASSERT_EQUAL(-1, history.get_last_played_age("id9"));
+    ASSERT_FALSE(history.contains_song("id9"));
+    
+    // Undo restores the song's previous play as its latest
+    history.undo_last_play();
+    ASSERT_EQUAL(1, history.get_song_play_count("id1"));
+    ASSERT_EQUAL(1, history.get_last_played_age("id1"));
+    auto top = history.get_most_played(2);
+    ASSERT_EQUAL(2, static_cast<int>(top.size()));
+    ASSERT_EQUAL(std::string("id3"), top[0].first);  // tie on one play: most recent first
+    
+    // Evictions, undos, resizes and removals against a scan of the buffer
+    unsigned int state = 7;
+    for (int step = 0; step < 500; step++) {
+        state = state * 1103515245u + 12345u;
+        int op = static_cast<int>((state >> 16) % 10);
+        int id = static_cast<int>((state >> 8) % 5);
+        if (op < 6) {
+            history.emplace_played_song("id" + std::to_string(id), "Song", "Artist", 200, 4);
+        } else if (op < 8) {
+            history.undo_last_play();
+        } else if (op == 8) {
+            history.set_max_size(2 + id);
+        } else {
+            history.remove_oldest_songs(1);
+        }
+        for (int check = 0; check < 5; check++) {
+            std::string songId = "id" + std::to_string(check);
+            int count = 0;
+            int latest = -1;
+            int age = 0;
+            for (const Song& song : history.recent_view(history.get_size())) {
+                if (song.getId() == songId) {
+                    if (latest < 0) latest = age;
+                    count++;
+                }
+                age++;
+            }
+            ASSERT_EQUAL(count, history.get_song_play_count(songId));
+            ASSERT_EQUAL(latest, history.get_last_played_age(songId));
+            ASSERT_EQUAL(count > 0, history.contains_song(songId));
+        }
+    }
+    
+    // Copies carry the index but not the recycled node, and stay independent
+    History copy(history);
+    copy = history;
+    for (int check = 0; check < 5; check++) {
+        std::string songId = "id" + std::to_string(check);
+        ASSERT_EQUAL(history.get_song_play_count(songId), copy.get_song_play_count(songId));
+    }
+    copy.emplace_played_song("id7", "Song", "Artist", 200, 4);
+    ASSERT_EQUAL(1, copy.get_song_play_count("id7"));
+    ASSERT_FALSE(history.contains_song("id7"));
+    
+    history.clear_history();
+    ASSERT_TRUE(history.get_most_played(3).empty());
+    ASSERT_EQUAL(0, history.get_song_play_count("id1"));
+    
+    return true;
+}
+
+bool testHistoryTimeWindows() {
+    typedef History::Clock Clock;
+    Clock::time_point base = Clock::now();
+    auto at = [base](int minutes) { return base + std::chrono::minutes(minutes); };
+    auto song = [](int i) { return Song("w" + std::to_string(i), "Window Song", "Artist", 240, 3); };
+    
+    History history(5);
+    history.record_play(song(1), at(0), 240);
+    history.record_play(song(2), at(10), 60);
+    history.record_play(song(1), at(20), 120);
+    history.record_play(song(3), at(30), 240);
+    // Out of order: raised to the newest play so the log stays sorted
+    history.record_play(song(4), at(25), -1);
+    ASSERT_TRUE(history.get_play_time(0) == at(30));
+    ASSERT_EQUAL(240, history.get_listened_seconds(0));
+    
+    ASSERT_EQUAL(2, history.count_plays_between(at(5), at(25)));
+    ASSERT_EQUAL(0, history.count_plays_between(at(25), at(5)));
+    HistoryView window = history.plays_between(at(10), at(30));
+    ASSERT_EQUAL(2, window.size());
+    ASSERT_EQUAL(std::string("w1"), window[0].getId());  // newest first
+    ASSERT_EQUAL(std::string("w2"), window[1].getId());
+    ASSERT_EQUAL(2, window.age(0));
+    
+    PlayWindowStats stats = history.window_stats(at(0), at(31));
+    ASSERT_EQUAL(5, stats.plays);
+    ASSERT_EQUAL(900LL, stats.listenedSeconds);
+    ASSERT_EQUAL(4, stats.distinctSongs);
+    
+    // Undo drops the newest play with its timestamp; eviction the oldest
+    ASSERT_EQUAL(std::string("w4"), history.undo_last_play().getId());
+    ASSERT_EQUAL(1, history.count_plays_between(at(30), at(31)));
+    history.record_play(song(5), at(40), 100);
+    history.record_play(song(6), at(50), 100);
+    ASSERT_EQUAL(0, history.count_plays_between(at(0), at(5)));
+    stats = history.window_stats(at(0), at(60));
+    ASSERT_EQUAL(5, stats.plays);
+    ASSERT_EQUAL(620LL, stats.listenedSeconds);
+    
+    // Resizing keeps timestamps with their plays
+    history.set_max_size(2);
+    ASSERT_EQUAL(2, history.count_plays_between(at(35), at(60)));
+    ASSERT_TRUE(history.get_play_time(1) == at(40));
+    
+    return true;
+}
+
+bool testHistoryLogHotTail() {
+    std::string directory = (std::filesystem::temp_directory_path() / "playwise_history_log_test").string();
+    std::filesystem::remove_all(directory);
+    
+    SongDatabase database;
+    for (int i = 0; i < 4; i++) {
+        database.insert_song(Song("log" + std::to_string(i), "Log Song " + std::to_string(i), "Artist", 200, 3));
+    }
+    History::Clock::time_point now = History::Clock::now();
+    std::int64_t startMillis = HistoryLog::now_millis();
+    
+    {
+        // Four records per segment and a three-record buffer, so both roll over
+        HistoryLog log(directory, &database, 4, 3);
+        ASSERT_TRUE(log.is_open());
+        History history(3);
+        history.attach_log(&log);
+        for (int i = 0; i < 10; i++) {
+            history.record_play(*database.search_by_id("log" + std::to_string(i % 4)),
+                                now - std::chrono::seconds(100 - i), 60 + i);
+        }
+        ASSERT_EQUAL(10, static_cast<int>(log.get_record_count()));
+        ASSERT_EQUAL(3, static_cast<int>(log.get_segment_count()));  // 9 saved, 1 buffered
+        
+        // Undo retracts the newest play; the evicted ones stay in the log
+        ASSERT_EQUAL(std::string("log1"), history.undo_last_play().getId());
+        PlayWindowStats all = log.window_stats(0, startMillis + 1000, 1);
+        ASSERT_EQUAL(9, all.plays);
+        ASSERT_EQUAL(4, all.distinctSongs);
+        ASSERT_EQUAL(9 * 60LL + 36, all.listenedSeconds);
+        PlayWindowStats parallel = log.window_stats(0, startMillis + 1000, 3);
+        ASSERT_EQUAL(all.plays, parallel.plays);
+        ASSERT_EQUAL(all.listenedSeconds, parallel.listenedSeconds);
+        ASSERT_EQUAL(all.distinctSongs, parallel.distinctSongs);
+        
+        int visited = 0;
+        log.for_each_between(startMillis - 95500, startMillis + 1000,
+                             [&visited](std::uint64_t, const HistoryLog::LogRecord&) { visited++; });
+        ASSERT_EQUAL(4, visited);  // plays 5 to 8 within the last 95 seconds
+        
+        // Undo below the buffer flips the flag on disk
+        log.flush();
+        ASSERT_EQUAL(std::string("log0"), history.undo_last_play().getId());
+    }
+    
+    // Reopen: the tail comes back through the database, retracted plays skipped
+    HistoryLog reopened(directory, &database, 64, 16);
+    ASSERT_EQUAL(10, static_cast<int>(reopened.get_record_count()));
+    ASSERT_EQUAL(8, reopened.window_stats(0, startMillis + 1000).plays);
+    std::vector<HistoryLog::LoggedPlay> tail = reopened.recent_plays(2);
+    ASSERT_EQUAL(2, static_cast<int>(tail.size()));
+    ASSERT_EQUAL(std::string("log3"), tail[1].songId);
+    ASSERT_EQUAL(7, static_cast<int>(tail[1].index));
+    
+    History restored(3);
+    PlayTrends restoredTrends;
+    restored.attach_log(&reopened);
+    restored.add_listener(&restoredTrends);
+    ASSERT_EQUAL(3, restored.restore_tail_from_log());
+    ASSERT_EQUAL(0, static_cast<int>(restoredTrends.get_play_count(PlayTrends::ALL_TIME)));  // counted when first played
+    ASSERT_EQUAL(std::string("log3"), restored.get_recent_song(0)->getId());
+    ASSERT_EQUAL(std::string("log1"), restored.get_recent_song(2)->getId());
+    ASSERT_EQUAL(67, restored.get_listened_seconds(0));
+    restored.add_played_song(*database.search_by_id("log2"));
+    ASSERT_EQUAL(11, static_cast<int>(reopened.get_record_count()));
+    restored.undo_last_play();
+    restored.undo_last_play();  // a restored play retracts its original record
+    ASSERT_EQUAL(7, reopened.window_stats(0, startMillis + 1000).plays);
+
+    // A copy takes the plays but neither the log nor the listeners
+    long long trendPlays = restoredTrends.get_play_count(PlayTrends::ALL_TIME);
+    History copy(restored);
+    ASSERT_TRUE(copy.get_log() == nullptr);
+    copy.add_played_song(*database.search_by_id("log0"));
+    ASSERT_EQUAL(11, static_cast<int>(reopened.get_record_count()));
+    ASSERT_EQUAL(trendPlays, static_cast<long long>(restoredTrends.get_play_count(PlayTrends::ALL_TIME)));
+    copy.undo_last_play();
+    copy.undo_last_play();  // a copied play leaves the original's record alone
+    ASSERT_EQUAL(7, reopened.window_stats(0, startMillis + 1000).plays);
+    ASSERT_EQUAL(1, restored.get_size());
+
+    std::filesystem::remove_all(directory);
+    return true;
+}
+
+bool testPlaybackIngestPolicies() {
+    // The ring rounds up to a power of two and is FIFO
+    MpscRing<int> ring(5);
+    ASSERT_EQUAL(8, static_cast<int>(ring.capacity()));
+    for (int i = 0; i < 8; i++) {
+        int value = i;
+        ASSERT_TRUE(ring.try_push(std::move(value)));
+    }
+    int extra = 8;
+    ASSERT_FALSE(ring.try_push(std::move(extra)));
+    int popped = -1;
+    ASSERT_TRUE(ring.try_pop(popped));
+    ASSERT_EQUAL(0, popped);
+    
+    SongDatabase database;
+    for (int i = 0; i < 10; i++) {
+        database.insert_song(Song("in" + std::to_string(i), "Ingest " + std::to_string(i), "Artist", 100, 3));
+    }
+    
+    // Blocking: every event from every producer arrives exactly once
+    {
+        History history(50000);
+        FavoriteSongsQueue favorites;
+        PlaybackIngest ingest(&database, &history, &favorites, 64, BackpressurePolicy::BLOCK, 4, 16);
+        ingest.start();
+        std::vector<std::thread> producers;
+        for (int p = 0; p < 4; p++) {
+            producers.emplace_back([&ingest, p]() {
+                for (int i = 0; i < 5000; i++) {
+                    ingest.publish("in" + std::to_string((p + i) % 10), 30);
+                }
+            });
+        }
+        for (std::thread& producer : producers) producer.join();
+        ingest.stop();
+        ASSERT_EQUAL(20000LL, ingest.get_applied_count());
+        ASSERT_EQUAL(0LL, ingest.get_dropped_count());
+        ASSERT_EQUAL(20000, history.get_size());
+        int favoritePlays = 0;
+        for (int i = 0; i < 10; i++) {
+            favoritePlays += favorites.getPlayCount(*database.search_by_id("in" + std::to_string(i)));
+        }
+        ASSERT_EQUAL(20000, favoritePlays);
+        ASSERT_EQUAL(2000, history.get_song_play_count("in3"));
+    }
+    
+    // Drop-oldest keeps the newest events
+    {
+        History history(100);
+        PlaybackIngest ingest(&database, &history, nullptr, 8, BackpressurePolicy::DROP_OLDEST);
+        for (int i = 0; i < 20; i++) {
+            ASSERT_TRUE(ingest.publish("in" + std::to_string(i % 10), 10));
+        }
+        ASSERT_EQUAL(12LL, ingest.get_dropped_count());
+        ASSERT_EQUAL(8, ingest.drain(100));
+        ASSERT_EQUAL(8, history.get_size());
+        ASSERT_EQUAL(std::string("in9"), history.get_recent_song(0)->getId());
+        ASSERT_EQUAL(std::string("in2"), history.get_recent_song(7)->getId());
+    }
+    
+    // Sampling thins the stream past half full and never blocks
+    {
+        History history(100);
+        PlaybackIngest ingest(&database, &history, nullptr, 16, BackpressurePolicy::SAMPLE, 4);
+        for (int i = 0; i < 100; i++) {
+            ingest.publish("in" + std::to_string(i % 10), 10);
+        }
+        ASSERT_EQUAL(100LL, ingest.get_published_count() + ingest.get_dropped_count());
+        ASSERT_TRUE(ingest.get_published_count() >= 9 && ingest.get_published_count() <= 16);
+        ASSERT_EQUAL(static_cast<int>(ingest.get_published_count()), ingest.drain(1000));
+
+        // Each ingest samples on its own count, whatever ran before on this thread
+        PlaybackIngest again(&database, nullptr, nullptr, 16, BackpressurePolicy::SAMPLE, 4);
+        for (int i = 0; i < 100; i++) {
+            again.publish("in" + std::to_string(i % 10), 10);
+        }
+        ASSERT_EQUAL(ingest.get_published_count(), again.get_published_count());
+    }
+    
+    // Unknown ids are counted, not applied; blocking without a consumer drops
+    {
+        History history(10);
+        PlaybackIngest ingest(&database, &history, nullptr, 2, BackpressurePolicy::BLOCK);
+        ASSERT_TRUE(ingest.publish("missing", 10));
+        ASSERT_TRUE(ingest.publish("in1", 10));
+        ASSERT_FALSE(ingest.publish("in2", 10));
+        ASSERT_EQUAL(2, ingest.drain(10));
+        ASSERT_EQUAL(1LL, ingest.get_unresolved_count());
+        ASSERT_EQUAL(1LL, ingest.get_applied_count());
+        ASSERT_EQUAL(1, history.get_size());
+    }
+
+    // A negative listenedSeconds is the whole song in both History and favorites
+    {
+        History history(10);
+        FavoriteSongsQueue favorites;
+        PlaybackIngest ingest(&database, &history, &favorites, 8, BackpressurePolicy::BLOCK);
+        ASSERT_TRUE(ingest.publish("in3", -1));
+        ASSERT_TRUE(ingest.publish("in3", -1));
+        ASSERT_EQUAL(2, ingest.drain(10));
+        ASSERT_EQUAL(100, history.get_listened_seconds(0));
+        ASSERT_EQUAL(100, history.get_listened_seconds(1));
+        ASSERT_EQUAL(200, favorites.getTotalListeningTime());
+    }
+
+    return true;
+}
+
+bool testCompressedHistoryBlocks() {
+    // Mixed value sizes so both varint and fixed-width columns are exercised
+    std::vector<CompressedHistory::Event> expected;
+    CompressedHistory compressed;
+    std::mt19937 random(7);
+    std::int64_t millis = 1700000000000LL;
+    for (int i = 0; i < 3000; i++) {
+        millis += i % 500 == 0 ? 40LL * 24 * 3600 * 1000 : static_cast<std::int64_t>(random() % 400000);
+        std::uint32_t songRef = i < 1024 ? static_cast<std::uint32_t>(random() % 100) : static_cast<std::uint32_t>(random() % 5000000);
+        int listened = static_cast<int>(random() % 400);
+        compressed.append(millis, songRef, listened);
+        expected.push_back(CompressedHistory::Event{millis, songRef, static_cast<std::uint32_t>(listened)});
+    }
+    // Out of order plays are raised to the previous time
+    compressed.append(millis - 5000, 3, 10);
+    expected.push_back(CompressedHistory::Event{millis, 3, 10});
+    ASSERT_EQUAL(3001, static_cast<int>(compressed.get_event_count()));
+    ASSERT_EQUAL(2, static_cast<int>(compressed.get_block_count()));  // the third block is still open
+    
+    auto sameEvents = [&expected](const CompressedHistory& history, std::int64_t from, std::int64_t to) {
+        std::vector<CompressedHistory::Event> visited;
+        history.for_each_between(from, to, [&visited](const CompressedHistory::Event& event) { visited.push_back(event); });
+        size_t at = 0;
+        for (const CompressedHistory::Event& event : expected) {
+            if (event.playedAtMillis < from || event.playedAtMillis >= to) continue;
+            if (at >= visited.size() || visited[at].playedAtMillis != event.playedAtMillis ||
+                visited[at].songRef != event.songRef || visited[at].listenedSeconds != event.listenedSeconds) {
+                return false;
+            }
+            at++;
+        }
+        return at == visited.size();
+    };
+    ASSERT_TRUE(sameEvents(compressed, expected.front().playedAtMillis, millis + 1));
+    ASSERT_TRUE(sameEvents(compressed, expected[700].playedAtMillis, expected[2500].playedAtMillis));
+    ASSERT_TRUE(sameEvents(compressed, expected[2999].playedAtMillis - 1, millis + 1));
+    
+    // Each block header bounds its plays, so windows between blocks decode nothing
+    compressed.finish();
+    ASSERT_EQUAL(3, static_cast<int>(compressed.get_block_count()));
+    ASSERT_TRUE(compressed.get_block_header(0).lastMillis == expected[1023].playedAtMillis);
+    ASSERT_TRUE(compressed.get_encoded_bytes() < 3001 * sizeof(HistoryLog::LogRecord));
+    
+    std::string filename = (std::filesystem::temp_directory_path() / "playwise_compressed_test.bin").string();
+    ASSERT_TRUE(compressed.save_to_file(filename));
+    CompressedHistory loaded;
+    ASSERT_TRUE(loaded.load_from_file(filename));
+    ASSERT_EQUAL(3001, static_cast<int>(loaded.get_event_count()));
+    ASSERT_TRUE(sameEvents(loaded, expected.front().playedAtMillis, millis + 1));
+    
+    // A damaged block is rejected and leaves the history untouched
+    {
+        std::fstream file(filename, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(-1, std::ios::end);
+        char byte = static_cast<char>(0x80);
+        file.write(&byte, 1);
+    }
+    ASSERT_FALSE(loaded.load_from_file(filename));
+    ASSERT_EQUAL(3001, static_cast<int>(loaded.get_event_count()));
+    std::filesystem::remove(filename);
+    
+    return true;
+}
+
+bool testPlayTrendsHeavyHitters() {
+    // Space-Saving: a key above total / capacity is always tracked, and its
+    // true count lies in [count - errorBound, count]
+    SpaceSaving summary(10);
+    for (int i = 0; i < 2000; i++) {
+        summary.add("cold-" + std::to_string(i));
+        if (i % 4 == 0) summary.add("hot");
+    }
+    ASSERT_EQUAL(2500, static_cast<int>(summary.get_total()));
+    std::vector<HeavyHitter> hitters = summary.top(3);
+    ASSERT_EQUAL(3, static_cast<int>(hitters.size()));
+    ASSERT_TRUE(hitters[0].key == "hot");
+    ASSERT_TRUE(hitters[0].count >= 500 && hitters[0].count - hitters[0].errorBound <= 500);
+    ASSERT_TRUE(hitters[0].count >= hitters[1].count && hitters[1].count >= hitters[2].count);
+    HeavyHitter untracked = summary.estimate("missing");
+    ASSERT_TRUE(untracked.count - untracked.errorBound == 0);
+    
+    // With room for every key the counts are exact
+    SpaceSaving exact(8);
+    for (int i = 0; i < 6; i++) {
+        for (int j = 0; j <= i; j++) exact.add("key-" + std::to_string(i));
+    }
+    hitters = exact.top(10);
+    ASSERT_EQUAL(6, static_cast<int>(hitters.size()));
+    for (int i = 0; i < 6; i++) {
+        ASSERT_TRUE(hitters[i].key == "key-" + std::to_string(5 - i));
+        ASSERT_EQUAL(6 - i, static_cast<int>(hitters[i].count));
+        ASSERT_EQUAL(0, static_cast<int>(hitters[i].errorBound));
+    }
+    
+    // Count-Min never underestimates and rarely exceeds its bound; subtracting
+    // a sketch from itself empties it
+    CountMinSketch sketch(256, 4);
+    std::unordered_map<std::string, int> truth;
+    std::mt19937 random(11);
+    for (int i = 0; i < 5000; i++) {
+        std::string key = "song-" + std::to_string(random() % 1000);
+        truth[key]++;
+        sketch.add(CountMinSketch::hashKey(key));
+    }
+    int beyondBound = 0;
+    for (const auto& entry : truth) {
+        long long estimate = sketch.estimate(CountMinSketch::hashKey(entry.first));
+        ASSERT_TRUE(estimate >= entry.second);
+        if (estimate > entry.second + sketch.error_bound()) beyondBound++;
+    }
+    ASSERT_TRUE(beyondBound <= static_cast<int>(truth.size()) / 20);
+    CountMinSketch copy = sketch;
+    sketch.subtract(copy);
+    ASSERT_EQUAL(0, static_cast<int>(sketch.get_total()));
+    ASSERT_EQUAL(0, static_cast<int>(sketch.estimate(CountMinSketch::hashKey("song-1"))));
+    
+    // Sliding windows expire whole buckets as time moves on
+    const std::int64_t hour = 3600LL * 1000;
+    const std::int64_t base = 50000LL * 6 * hour;  // on a bucket boundary for every window
+    Song a("trend-a", "Alpha", "Artist One", 200, 5);
+    Song b("trend-b", "Beta", "Artist Two", 200, 4);
+    Song c("trend-c", "Gamma", "Artist Two", 200, 3);
+    PlayTrends trends;
+    for (int i = 0; i < 5; i++) trends.record_play(a, base + i * 1000);
+    for (int i = 0; i < 3; i++) trends.record_play(b, base + 10000 + i * 1000);
+    hitters = trends.top_songs(5, PlayTrends::LAST_HOUR);
+    ASSERT_EQUAL(2, static_cast<int>(hitters.size()));
+    ASSERT_TRUE(hitters[0].key == "trend-a" && hitters[0].count >= 5 && hitters[0].count - hitters[0].errorBound <= 5);
+    ASSERT_TRUE(hitters[1].key == "trend-b");
+    
+    for (int i = 0; i < 4; i++) trends.record_play(c, base + 2 * hour + i * 1000);
+    hitters = trends.top_songs(5, PlayTrends::LAST_HOUR);
+    ASSERT_EQUAL(1, static_cast<int>(hitters.size()));
+    ASSERT_TRUE(hitters[0].key == "trend-c");
+    ASSERT_EQUAL(4, static_cast<int>(trends.get_play_count(PlayTrends::LAST_HOUR)));
+    hitters = trends.top_songs(2, PlayTrends::LAST_DAY);
+    ASSERT_EQUAL(2, static_cast<int>(hitters.size()));
+    ASSERT_TRUE(hitters[0].key == "trend-a" && hitters[1].key == "trend-c");
+    ASSERT_EQUAL(1, static_cast<int>(hitters[0].errorBound));  // ceil(e / 512 * 12)
+    hitters = trends.top_artists(5, PlayTrends::ALL_TIME);
+    ASSERT_TRUE(hitters[0].key == "Artist Two" && hitters[0].count == 7);
+    
+    // A week later only the all-time ranking remains; late plays outside
+    // every window count all time only
+    trends.advance_to(base + 8 * 24 * hour);
+    ASSERT_EQUAL(0, static_cast<int>(trends.get_play_count(PlayTrends::LAST_WEEK)));
+    ASSERT_TRUE(trends.top_songs(5, PlayTrends::LAST_WEEK).empty());
+    trends.record_play(b, base);
+    ASSERT_EQUAL(0, static_cast<int>(trends.get_play_count(PlayTrends::LAST_WEEK)));
+    ASSERT_EQUAL(13, static_cast<int>(trends.get_play_count(PlayTrends::ALL_TIME)));
+    ASSERT_TRUE(trends.top_songs(1, PlayTrends::ALL_TIME)[0].key == "trend-a");
+    
+    // Memory follows the configuration
+    ASSERT_TRUE(PlayTrends(64, 128, 2).get_memory_bytes() < trends.get_memory_bytes());
+    
+    // Fed by the history, the trends keep counting plays the buffer evicted
+    History history(3);
+    PlayTrends fed;
+    history.add_listener(&fed);
+    for (int i = 0; i < 6; i++) history.add_played_song(a);
+    for (int i = 0; i < 3; i++) history.add_played_song(b);
+    ASSERT_EQUAL(0, history.get_song_play_count("trend-a"));
+    hitters = fed.top_songs(2, PlayTrends::ALL_TIME);
+    ASSERT_TRUE(hitters[0].key == "trend-a" && hitters[0].count == 6);
+    ASSERT_TRUE(fed.top_songs(1, PlayTrends::LAST_HOUR)[0].key == "trend-a");
+    history.remove_listener(&fed);
+    history.add_played_song(b);
+    ASSERT_EQUAL(9, static_cast<int>(fed.get_play_count(PlayTrends::ALL_TIME)));
+    
+    return true;
+}
+
+bool testHyperLogLogDistinctCounts() {
+    // Estimates stay within a few standard errors at every scale
+    for (int distinct : {10, 1000, 100000}) {
+        HyperLogLog sketch(12);
+        for (int i = 0; i < distinct; i++) {
+            sketch.add("key-" + std::to_string(i));
+            sketch.add("key-" + std::to_string(i / 2));  // repeats do not count
+        }
+        double error = std::abs(static_cast<double>(sketch.estimate()) - distinct) / distinct;
+        ASSERT_TRUE(error <= 4 * sketch.get_relative_error());
+    }
+    ASSERT_TRUE(HyperLogLog(12).is_empty());
+    ASSERT_EQUAL(0, static_cast<int>(HyperLogLog(12).estimate()));
+    ASSERT_EQUAL(4096, static_cast<int>(HyperLogLog(12).get_register_count()));
+    ASSERT_EQUAL(HyperLogLog::MAX_PRECISION, HyperLogLog(40).get_precision());
+    
+    // Merging gives the sketch of the union
+    HyperLogLog left(12);
+    HyperLogLog right(12);
+    HyperLogLog both(12);
+    for (int i = 0; i < 30000; i++) {
+        std::string key = "song-" + std::to_string(i);
+        (i < 20000 ? left : right).add(key);
+        if (i >= 10000) left.add(key);  // overlap 10000..19999 in both
+        both.add(key);
+    }
+    ASSERT_TRUE(left.merge(right));
+    ASSERT_EQUAL(static_cast<int>(both.estimate()), static_cast<int>(left.estimate()));
+    ASSERT_FALSE(left.merge(HyperLogLog(10)));
+    
+    // Windows: distinct songs, artists and listeners per bucketed window
+    const std::int64_t hour = 3600LL * 1000;
+    const std::int64_t base = 50000LL * 6 * hour;
+    PlayDistincts distincts(12, 10);
+    std::vector<Song> songs;
+    for (int i = 0; i < 300; i++) {
+        songs.emplace_back("distinct-" + std::to_string(i), "Song " + std::to_string(i),
+                           "Artist " + std::to_string(i % 30), 180, 3);
+    }
+    size_t memory = distincts.get_memory_bytes();
+    for (int i = 0; i < 3000; i++) {
+        distincts.record_play(songs[i % 100], "listener-" + std::to_string(i % 7), base + i * 100);
+    }
+    distincts.set_listener("late");
+    for (int i = 0; i < 200; i++) {
+        distincts.record_play(songs[100 + i], base + 2 * hour + i * 100);
+    }
+    auto near = [](long long estimate, long long truth) {
+        return std::abs(estimate - truth) <= truth / 20 + 1;
+    };
+    ASSERT_TRUE(near(distincts.distinct_songs(PlayTrends::LAST_HOUR), 200));
+    ASSERT_TRUE(near(distincts.distinct_songs(PlayTrends::LAST_DAY), 300));
+    ASSERT_TRUE(near(distincts.distinct_artists(PlayTrends::LAST_DAY), 30));
+    ASSERT_TRUE(near(distincts.distinct_listeners(PlayTrends::LAST_DAY), 8));
+    ASSERT_TRUE(near(distincts.distinct_listeners(PlayTrends::LAST_HOUR), 1));
+    ASSERT_TRUE(near(distincts.listener_distinct_songs("listener-3"), 100));
+    ASSERT_TRUE(near(distincts.listener_distinct_songs("late"), 200));
+    ASSERT_TRUE(near(distincts.listeners_distinct_songs({"listener-0", "listener-1", "late"}), 300));
+    ASSERT_EQUAL(0, static_cast<int>(distincts.listener_distinct_songs("nobody")));
+    ASSERT_EQUAL(8 * 1024, static_cast<int>(distincts.get_memory_bytes() - memory));  // one sketch per listener
+    
+    // Fixed memory: more traffic adds nothing but listeners do
+    for (int i = 0; i < 20000; i++) distincts.record_play(songs[i % 300], base + 3 * hour + i);
+    ASSERT_EQUAL(static_cast<int>(memory + 8 * 1024), static_cast<int>(distincts.get_memory_bytes()));
+    
+    distincts.advance_to(base + 9 * 24 * hour);
+    ASSERT_EQUAL(0, static_cast<int>(distincts.distinct_songs(PlayTrends::LAST_WEEK)));
+    ASSERT_TRUE(near(distincts.distinct_songs(PlayTrends::ALL_TIME), 300));
+    
+    // Fed by the history, read by the dashboard
+    History history(5);
+    PlayDistincts fed;
+    history.add_listener(&fed);
+    for (int i = 0; i < 40; i++) history.add_played_song(songs[i]);
+    Dashboard dashboard(nullptr, &history, nullptr, nullptr);
+    dashboard.setPlayDistincts(&fed);
+    ASSERT_TRUE(near(dashboard.getDistinctSongs(PlayTrends::LAST_HOUR), 40));
+    ASSERT_TRUE(near(dashboard.getDistinctArtists(PlayTrends::ALL_TIME), 30));
+    ASSERT_EQUAL(1, static_cast<int>(dashboard.getDistinctListeners(PlayTrends::LAST_DAY)));
+    
+    return true;
+}
+
+bool testListeningSessions() {
+    const std::int64_t minute = 60LL * 1000;
+    const std::int64_t base = 1700000000000LL;
+    Song pop("session-pop", "Pop Song", "Artist", 200, 4, "", "Pop");
+    Song rock("session-rock", "Rock Song", "Artist", 240, 4, "", "Rock");
+    
+    std::vector<ListeningSession> emitted;
+    Sessionizer sessionizer([&emitted](const ListeningSession& session) { emitted.push_back(session); }, 30 * minute);
+    sessionizer.set_listener("alice");
+    sessionizer.record_play(pop, -1, base);                    // ends at +200 s
+    sessionizer.record_play(rock, 10, base + 4 * minute);      // a skip
+    sessionizer.record_play(pop, 150, base + 20 * minute);
+    sessionizer.record_play(SessionPlay{"bob", &rock, -1, base + 5 * minute});
+    ASSERT_EQUAL(2, static_cast<int>(sessionizer.get_open_count()));
+    ASSERT_TRUE(emitted.empty());
+    
+    // A pause longer than the gap after playback ended closes the session
+    sessionizer.record_play(rock, -1, base + 20 * minute + 150 * 1000 + 31 * minute);
+    ASSERT_EQUAL(1, static_cast<int>(emitted.size()));
+    const ListeningSession& first = emitted[0];
+    ASSERT_TRUE(first.listener == "alice");
+    ASSERT_EQUAL(3, first.plays);
+    ASSERT_EQUAL(1, first.skips);
+    ASSERT_EQUAL(360, static_cast<int>(first.listenedSeconds));
+    ASSERT_TRUE(first.startMillis == base && first.endMillis == base + 20 * minute + 150 * 1000);
+    ASSERT_EQUAL(2, first.genreMix.at("Pop"));
+    ASSERT_EQUAL(1, first.genreMix.at("Rock"));
+    ASSERT_TRUE(first.skip_rate() > 0.33 && first.skip_rate() < 0.34);
+    ASSERT_EQUAL(1, sessionizer.get_open_session("alice")->plays);
+    
+    // Idle listeners are flushed; the rest stay open
+    ASSERT_EQUAL(1, sessionizer.flush_idle(base + 60 * minute));  // bob went quiet
+    ASSERT_TRUE(emitted.back().listener == "bob");
+    ASSERT_TRUE(sessionizer.get_open_session("bob") == nullptr);
+    ASSERT_EQUAL(1, sessionizer.flush_all());
+    ASSERT_EQUAL(3, static_cast<int>(sessionizer.get_emitted_count()));
+    
+    // The aggregator sums sessions
+    SessionAggregator totals;
+    for (const ListeningSession& session : emitted) totals.add(session);
+    ASSERT_EQUAL(3, static_cast<int>(totals.get_session_count()));
+    ASSERT_EQUAL(5, static_cast<int>(totals.get_play_count()));
+    ASSERT_TRUE(totals.top_genres(1)[0].first == "Rock");
+    
+    // Parallel backfill finds exactly the sessions of a streaming pass
+    std::vector<Song> catalog;
+    for (int i = 0; i < 50; i++) {
+        catalog.emplace_back("backfill-" + std::to_string(i), "Song", "Artist", 180, 3, "", i % 2 ? "Jazz" : "Pop");
+    }
+    std::mt19937 random(3);
+    std::vector<SessionPlay> plays;
+    std::int64_t millis = base;
+    for (int i = 0; i < 20000; i++) {
+        millis += random() % 20000;
+        if (random() % 500 == 0) millis += 2 * 3600 * 1000;
+        int listened = random() % 3 == 0 ? static_cast<int>(random() % 40) : -1;
+        plays.push_back(SessionPlay{"user-" + std::to_string(random() % 40), &catalog[random() % 50], listened, millis});
+    }
+    SessionAggregator streamed;
+    Sessionizer streaming(streamed.as_sink());
+    for (const SessionPlay& play : plays) streaming.record_play(play);
+    streaming.flush_all();
+    for (int threads : {1, 3, 8}) {
+        SessionAggregator backfilled;
+        Sessionizer::backfill(plays, backfilled.as_sink(), Sessionizer::DEFAULT_GAP_MILLIS, threads);
+        ASSERT_EQUAL(static_cast<int>(streamed.get_session_count()), static_cast<int>(backfilled.get_session_count()));
+        ASSERT_EQUAL(20000, static_cast<int>(backfilled.get_play_count()));
+        ASSERT_TRUE(streamed.get_skip_rate() == backfilled.get_skip_rate());
+        ASSERT_TRUE(streamed.get_average_length_minutes() == backfilled.get_average_length_minutes());
+    }
+
+    // An hour-long play overlapped by short ones: the gap runs from the latest play's end
+    Song hour("session-hour", "Long Mix", "Artist", 3600, 4, "", "Ambient");
+    std::vector<SessionPlay> overlapping = {
+        SessionPlay{"carol", &hour, -1, base},
+        SessionPlay{"carol", &pop, 5, base + 5000},
+        SessionPlay{"carol", &pop, 5, base + 10000},
+        SessionPlay{"carol", &pop, 5, base + 10000 + 31 * minute},
+    };
+    SessionAggregator overlapStreamed;
+    Sessionizer overlapStreaming(overlapStreamed.as_sink());
+    for (const SessionPlay& play : overlapping) overlapStreaming.record_play(play);
+    overlapStreaming.flush_all();
+    ASSERT_EQUAL(2, static_cast<int>(overlapStreamed.get_session_count()));
+    for (int threads : {1, 2, 4}) {
+        SessionAggregator backfilled;
+        Sessionizer::backfill(overlapping, backfilled.as_sink(), Sessionizer::DEFAULT_GAP_MILLIS, threads);
+        ASSERT_EQUAL(2, static_cast<int>(backfilled.get_session_count()));
+        ASSERT_TRUE(overlapStreamed.get_average_length_minutes() == backfilled.get_average_length_minutes());
+    }
+
+    // Fed by the history, and backfilled from an on-disk log
+    std::string directory = (std::filesystem::temp_directory_path() / "playwise_sessions_test").string();
+    std::filesystem::remove_all(directory);
+    {
+        SongDatabase database;
+        database.insert_song(pop);
+        database.insert_song(rock);
+        HistoryLog log(directory, &database, 64);
+        History history(10);
+        SessionAggregator live;
+        Sessionizer fed(live.as_sink());
+        history.attach_log(&log);
+        history.add_listener(&fed);
+        History::Clock::time_point start = History::Clock::now() - std::chrono::hours(30);
+        for (int i = 0; i < 300; i++) {
+            // A three hour break after every 100 plays
+            history.record_play(i % 3 ? pop : rock, start + std::chrono::minutes(4 * i + (i / 100) * 180), 5);
+        }
+        fed.flush_all();
+        ASSERT_EQUAL(3, static_cast<int>(live.get_session_count()));
+        ASSERT_TRUE(live.get_skip_rate() == 1.0);
+        
+        SessionAggregator archived;
+        Sessionizer::backfill(log, 0, HistoryLog::now_millis() + 1, "User", archived.as_sink(),
+                              Sessionizer::DEFAULT_GAP_MILLIS, 4);
+        ASSERT_EQUAL(3, static_cast<int>(archived.get_session_count()));
+        ASSERT_EQUAL(300, static_cast<int>(archived.get_play_count()));
+    }
+    std::filesystem::remove_all(directory);
+    
+    return true;
+}
+
+bool testEditJournal() {
+    Playlist playlist("Journal");
+    History history(10);
+    RatingTree tree;
+    SongDatabase database;
+    FavoriteSongsQueue favorites;
+    EditJournal journal(&playlist, &history, &tree, &database, &favorites);
+    Song a("journal-a", "Song A", "Artist", 180, 0);
+    Song b("journal-b", "Song B", "Artist", 200, 0);
+    Song c("journal-c", "Song C", "Artist", 220, 0);
+    database.insert_song(a);
+    
+    auto order = [&playlist]() {
+        std::string ids;
+        for (int i = 0; i < playlist.getSize(); i++) ids += playlist.get_song_at(i)->getTitle().back();
+        return ids;
+    };
+    
+    // Multi-level undo and redo of playlist edits
+    ASSERT_TRUE(journal.add_song(a) && journal.add_song(b) && journal.add_song_at(c, 0));
+    ASSERT_TRUE(journal.move_song(0, 2));
+    ASSERT_TRUE(journal.set_song_rating(0, 5));
+    ASSERT_TRUE(journal.delete_song(1));
+    ASSERT_TRUE(order() == "AC");
+    ASSERT_EQUAL(6, journal.get_undo_count());
+    ASSERT_FALSE(journal.delete_song(5));  // rejected edits are not recorded
+    ASSERT_EQUAL(6, journal.get_undo_count());
+    
+    ASSERT_TRUE(journal.undo());
+    ASSERT_TRUE(order() == "ABC");
+    ASSERT_TRUE(journal.undo());
+    ASSERT_EQUAL(0, playlist.get_song_at(0)->getRating());
+    ASSERT_TRUE(journal.undo());
+    ASSERT_TRUE(order() == "CAB");
+    ASSERT_EQUAL(3, journal.get_redo_count());
+    ASSERT_TRUE(journal.redo() && journal.redo());
+    ASSERT_TRUE(order() == "ABC");
+    ASSERT_EQUAL(5, playlist.get_song_at(0)->getRating());
+    
+    // A new edit drops what was undone
+    ASSERT_TRUE(journal.delete_song(2));
+    ASSERT_FALSE(journal.can_redo());
+    ASSERT_FALSE(journal.redo());
+    while (journal.undo()) {}
+    ASSERT_EQUAL(0, playlist.getSize());
+    ASSERT_EQUAL(6, journal.get_redo_count());
+    
+    // History pushes come back with their original time
+    ASSERT_TRUE(journal.play_song(b, 90));
+    History::Clock::time_point playedAt = history.get_play_time(0);
+    ASSERT_TRUE(journal.undo());
+    ASSERT_TRUE(history.is_empty());
+    ASSERT_TRUE(journal.redo());
+    ASSERT_TRUE(history.get_last_played().getId() == "journal-b");
+    ASSERT_TRUE(history.get_play_time(0) == playedAt);
+    ASSERT_EQUAL(90, history.get_listened_seconds(0));
+    
+    // Ratings keep the database and the rating tree in step; 0 unrates
+    ASSERT_TRUE(journal.rate_song("journal-a", 4));
+    ASSERT_TRUE(journal.rate_song("journal-a", 2));
+    ASSERT_TRUE(journal.undo());
+    ASSERT_EQUAL(4, database.search_by_id("journal-a")->getRating());
+    ASSERT_EQUAL(1, static_cast<int>(tree.search_by_rating(4).size()));
+    ASSERT_TRUE(tree.search_by_rating(2).empty());
+    ASSERT_TRUE(journal.undo());
+    ASSERT_EQUAL(0, database.search_by_id("journal-a")->getRating());
+    ASSERT_TRUE(tree.search_by_rating(4).empty());
+    ASSERT_FALSE(journal.rate_song("missing", 3));
+    
+    // A grouped play undoes favorites and history together
+    favorites.autoUpdateFromPlayback(c, 60);
+    journal.begin_group();
+    ASSERT_TRUE(journal.update_favorite(a, 120, true));
+    ASSERT_TRUE(journal.update_favorite(c, 30, false));
+    ASSERT_TRUE(journal.play_song(a, 120));
+    journal.end_group();
+    ASSERT_EQUAL(120, favorites.getListeningTime(a));
+    ASSERT_EQUAL(90, favorites.getListeningTime(c));
+    int steps = journal.get_undo_count();
+    ASSERT_TRUE(journal.undo());
+    ASSERT_EQUAL(steps - 1, journal.get_undo_count());
+    ASSERT_FALSE(favorites.isInFavorites(a));  // the update started tracking it
+    ASSERT_EQUAL(60, favorites.getListeningTime(c));
+    ASSERT_EQUAL(1, favorites.getPlayCount(c));
+    ASSERT_TRUE(history.get_last_played().getId() == "journal-b");
+    ASSERT_TRUE(journal.redo());
+    ASSERT_EQUAL(120, favorites.getListeningTime(a));
+    ASSERT_EQUAL(90, favorites.getListeningTime(c));
+    ASSERT_TRUE(history.get_last_played().getId() == "journal-a");
+    
+    // A change made around the journal fails the inverse and clears it
+    history.undo_last_play();
+    ASSERT_FALSE(journal.undo());
+    ASSERT_FALSE(journal.can_undo());
+    ASSERT_EQUAL(0, static_cast<int>(journal.get_memory_bytes()));
+    
+    // A reverse is journaled as its own inverse
+    ASSERT_TRUE(journal.add_song(a) && journal.add_song(b) && journal.add_song(c));
+    ASSERT_TRUE(journal.reverse_playlist());
+    ASSERT_TRUE(order() == "CBA");
+    ASSERT_TRUE(journal.undo());
+    ASSERT_TRUE(order() == "ABC");
+    ASSERT_TRUE(journal.redo());
+    ASSERT_TRUE(order() == "CBA");
+    
+    // Moves and ratings check that their song is still in place
+    ASSERT_TRUE(journal.move_song(0, 2));
+    ASSERT_TRUE(playlist.move_song(0, 2));  // outside the journal
+    ASSERT_TRUE(order() == "ACB");
+    ASSERT_FALSE(journal.undo());
+    ASSERT_TRUE(order() == "ACB");
+    ASSERT_TRUE(journal.set_song_rating(0, 3));
+    ASSERT_TRUE(playlist.delete_song(0));
+    ASSERT_FALSE(journal.undo());
+    ASSERT_FALSE(journal.can_undo());
+    playlist.clear();
+    
+    // The byte cap drops the oldest entries
+    EditJournal capped(&playlist, &history, &tree, &database, &favorites);
+    for (int i = 0; i < 4; i++) capped.add_song(a);
+    size_t perEntry = capped.get_memory_bytes() / 4;
+    capped.set_max_bytes(perEntry * 3);
+    ASSERT_EQUAL(3, capped.get_undo_count());
+    ASSERT_TRUE(capped.get_memory_bytes() <= capped.get_max_bytes());
+    for (int i = 0; i < 3; i++) capped.add_song(b);
+    ASSERT_EQUAL(3, capped.get_undo_count());
+    while (capped.undo()) {}
+    ASSERT_EQUAL(4, playlist.getSize());  // the evicted adds stay
+    return true;
+}
+
 void registerPlaylistTests() {
     testFramework.addTest("Playlist Constructor", "Test constructor with name", testPlaylistConstructor);
     testFramework.addTest("Playlist Default Constructor", "Test default constructor", testPlaylistDefaultConstructor);
@@ -513,6 +2321,8 @@ void registerPlaylistTests() {
     testFramework.addTest("Playlist Shuffle", "Test shuffling playlist", testPlaylistShuffle);
     testFramework.addTest("Playlist Shuffle Empty", "Test shuffling empty playlist", testPlaylistShuffleEmpty);
     testFramework.addTest("Playlist Shuffle Single", "Test shuffling single song playlist", testPlaylistShuffleSingle);
+    testFramework.addTest("Playlist Shuffle Seeded", "Test seeded in-place shuffle is reproducible", testPlaylistShuffleSeeded);
+    testFramework.addTest("Shuffle Iterator Matches Shuffle", "Test lazy shuffle order covers every song once", testShuffleIteratorMatchesShuffle);
     testFramework.addTest("Playlist Clear", "Test clearing playlist", testPlaylistClear);
     testFramework.addTest("Playlist Clear Empty", "Test clearing empty playlist", testPlaylistClearEmpty);
     testFramework.addTest("Playlist Find Song By ID", "Test finding song by ID", testPlaylistFindSongById);
@@ -530,4 +2340,35 @@ void registerPlaylistTests() {
     testFramework.addTest("Playlist Edge Case Names", "Test with edge case playlist names", testPlaylistEdgeCaseNames);
     testFramework.addTest("Playlist Delete By Song ID", "Test deleting song by ID", testPlaylistDeleteBySongId);
     testFramework.addTest("Playlist Delete By Song ID Not Found", "Test deleting non-existent song by ID", testPlaylistDeleteBySongIdNotFound);
+    testFramework.addTest("Persistent Playlist Edits", "Test edits create new versions without modifying old ones", testPersistentPlaylistEdits);
+    testFramework.addTest("Playlist Version History Sharing", "Test versions share structure and roll back in O(1)", testPlaylistVersionHistorySharing);
+    testFramework.addTest("Playlist Apply Edits", "Test batch insert, delete and move with net diff", testPlaylistApplyEdits);
+    testFramework.addTest("Playlist Apply Edits All Or Nothing", "Test an invalid edit leaves the playlist unchanged", testPlaylistApplyEditsAllOrNothing);
+    testFramework.addTest("Playlist Apply Edits Matches Sequential", "Test batch and one-by-one edits agree", testPlaylistApplyEditsMatchesSequential);
+    testFramework.addTest("Playlist Apply Edits Notifies Originals", "Test batch removals report only original songs with their surviving successor", testPlaylistApplyEditsNotifiesOriginals);
+    testFramework.addTest("Playlist Diff Reproduces Target", "Test applying a diff turns one playlist into the other", testPlaylistDiffReproducesTarget);
+    testFramework.addTest("Playlist Diff Minimal Moves", "Test diff emits only the necessary moves", testPlaylistDiffMinimalMoves);
+    testFramework.addTest("Playlist Three Way Merge", "Test merging concurrent deletes, moves and inserts", testPlaylistThreeWayMerge);
+    testFramework.addTest("Playlist Sort In Place Stable", "Test in-place sort relinks nodes and keeps ties in order", testPlaylistSortInPlaceStable);
+    testFramework.addTest("Playlist Sort Matches Vector Sort", "Test in-place sort agrees with a stable vector sort for every criteria", testPlaylistSortMatchesVectorSort);
+    testFramework.addTest("Playlist Duration Index Queries", "Test total duration and offset lookups", testPlaylistDurationIndexQueries);
+    testFramework.addTest("Playlist Duration Index Under Edits", "Test offsets stay correct through inserts, deletes, moves, reverse, shuffle and sort", testPlaylistDurationIndexUnderEdits);
+    testFramework.addTest("Concurrent Playlist Stress", "Test concurrent writers with a snapshot reader stay consistent", testConcurrentPlaylistStress);
+    testFramework.addTest("Concurrent Playlist Conditional Commit", "Test snapshots are stable and stale commits are rejected", testConcurrentPlaylistConditionalCommit);
+    testFramework.addTest("Playlist CRDT Convergence", "Test replicas converge after concurrent offline edits", testPlaylistCrdtConvergence);
+    testFramework.addTest("Playlist CRDT Garbage Collection", "Test stable tombstones and log entries are purged safely", testPlaylistCrdtGarbageCollection);
+    testFramework.addTest("Playlist CRDT To Playlist", "Test converting a replica into a plain playlist", testPlaylistCrdtToPlaylist);
+    testFramework.addTest("Playlist Stats Under Edits", "Test running aggregates match a full walk after every kind of edit", testPlaylistStatsUnderEdits);
+    testFramework.addTest("Song Stats Aggregates", "Test database aggregates through insert, update, delete and clear", testSongStatsAggregates);
+    testFramework.addTest("Song Move Ingestion Allocations", "Test move and emplace paths skip string copies and comparators do not allocate", testSongMoveIngestionAllocations);
+    testFramework.addTest("History Ring Buffer", "Test O(1) eviction, indexed access, views and resizing", testHistoryRingBuffer);
+    testFramework.addTest("History Play Count Index", "Test O(1) play counts through pushes, undo and eviction", testHistoryPlayCountIndex);
+    testFramework.addTest("History Time Windows", "Test timestamped plays and binary-searched window queries", testHistoryTimeWindows);
+    testFramework.addTest("History Log Hot Tail", "Test segmented log appends, retraction, parallel scans and tail restore", testHistoryLogHotTail);
+    testFramework.addTest("Playback Ingest Policies", "Test the MPSC ring, batched consumer and backpressure policies", testPlaybackIngestPolicies);
+    testFramework.addTest("Compressed History Blocks", "Test packed play blocks, time skipping and file round trips", testCompressedHistoryBlocks);
+    testFramework.addTest("Play Trends Heavy Hitters", "Test Space-Saving and Count-Min bounds and windowed top songs and artists", testPlayTrendsHeavyHitters);
+    testFramework.addTest("HyperLogLog Distinct Counts", "Test HyperLogLog accuracy and merges, windowed and per-listener distinct counts", testHyperLogLogDistinctCounts);
+    testFramework.addTest("Listening Sessions", "Test session gaps, skips and genre mix, idle flushing and parallel backfill", testListeningSessions);
+    testFramework.addTest("Edit Journal Undo Redo", "Test multi-level undo/redo across playlist, history, ratings and favorites, grouping and the byte cap", testEditJournal);
 } 
\ No newline at end of file
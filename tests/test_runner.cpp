@@ -2,6 +2,12 @@
 #include "test_song.cpp"
 #include "test_playlist.cpp"
 #include "test_integration.cpp"
+
+// The allocation tests need counting operator new; only the test binary gets it
+#ifndef PLAYWISE_COUNT_ALLOCATIONS
+#define PLAYWISE_COUNT_ALLOCATIONS
+#include "../src/allocation_hooks.cpp"
+#endif
 #include <iostream>
 #include <string>
 